@@ -152,6 +152,7 @@ void main(int argc, char** argv) {
 		demo_trng_hw(512, verb, interface);
 		demo_trng_hw(1024, verb, interface);
 		demo_trng_hw(2048, verb, interface);
+		demo_drbg_hw(verb, interface);
 	}
 	
 
@@ -289,24 +289,24 @@ void main(int argc, char** argv) {
 		time_result tr;
 
 		test_trng_hw(0, 128, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "TRNG", "128 bits", tr);
-		// test_trng_hw(1, 128, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "CTR-DRBG", "128 bits", tr);
-		// test_trng_hw(2, 128, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "HMAC-DRBG", "128 bits", tr);
+		test_trng_hw(1, 128, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "CTR-DRBG", "128 bits", tr);
+		test_trng_hw(2, 128, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "HASH-DRBG", "128 bits", tr);
 
 		test_trng_hw(0, 256, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "TRNG", "256 bits", tr);
-		// test_trng_hw(1, 256, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "CTR-DRBG", "256 bits", tr);
-		// test_trng_hw(2, 256, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "HMAC-DRBG", "256 bits", tr);
+		test_trng_hw(1, 256, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "CTR-DRBG", "256 bits", tr);
+		test_trng_hw(2, 256, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "HASH-DRBG", "256 bits", tr);
 
 		test_trng_hw(0, 512, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "TRNG", "512 bits", tr);
-		// test_trng_hw(1, 512, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "CTR-DRBG", "512 bits", tr);
-		// test_trng_hw(2, 512, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "HMAC-DRBG", "512 bits", tr);
+		test_trng_hw(1, 512, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "CTR-DRBG", "512 bits", tr);
+		test_trng_hw(2, 512, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "HASH-DRBG", "512 bits", tr);
 
 		test_trng_hw(0, 1024, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "TRNG", "1024 bits", tr);
-		// test_trng_hw(1, 1024, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "CTR-DRBG", "1024 bits", tr);
-		// test_trng_hw(2, 1024, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "HMAC-DRBG", "1024 bits", tr);
+		test_trng_hw(1, 1024, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "CTR-DRBG", "1024 bits", tr);
+		test_trng_hw(2, 1024, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "HASH-DRBG", "1024 bits", tr);
 
 		test_trng_hw(0, 2048, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "TRNG", "2048 bits", tr);
-		// test_trng_hw(1, 2048, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "CTR-DRBG", "2048 bits", tr);
-		// test_trng_hw(2, 2048, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "HMAC-DRBG", "2048 bits", tr);
+		test_trng_hw(1, 2048, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "CTR-DRBG", "2048 bits", tr);
+		test_trng_hw(2, 2048, data_conf.n_test, &tr, verb, interface); print_results_str_2_tab_1(data_conf.n_test, "HASH-DRBG", "2048 bits", tr);
 	}
 	else {
 		printf("\n TRNG has not been selected ... Moving to next test ... ");
@@ -0,0 +1,167 @@
+/**
+  * @file merkle.c
+  * @brief Merkle-Tree File Hasher Tool
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#include "src/demo.h"
+
+static void print_hash(unsigned char* h)
+{
+	for (int i = 0; i < MERKLE_HASH_LEN; i++) printf("%02x", h[i]);
+}
+
+void main(int argc, char** argv) {
+
+	unsigned long long leaf_size = 1024 * 1024;
+	int VERSION = MERKLE_SHA3_256;
+	unsigned int n_dev = 1;
+	unsigned int n_host = 0;
+	long long proof_leaf = -1;
+	int verb = 0;
+	char* path = NULL;
+
+	for (int arg = 1; arg < argc; arg++) {
+
+		if (argv[arg][0] == '-') {
+			if (argv[arg][1] == 'h') {
+				printf("\n Usage: ./merkle-XXX [-h] [-v] [-s] [-l KB] [-d N] [-t N] [-p LEAF] FILE \n");
+				printf("\n -h      : Show the help.");
+				printf("\n -v      : Verbose level 1");
+				printf("\n -s      : SHA-256 leaves (default SHA3-256)");
+				printf("\n -l KB   : Leaf size in KB (default 1024)");
+				printf("\n -d N    : Number of SE devices (consecutive I2C addresses from 0x%02x)", INTF_ADDRESS);
+				printf("\n -t N    : Number of host threads as overflow capacity (default 0)");
+				printf("\n -p LEAF : Print and check the inclusion proof of LEAF");
+				printf("\n \n");
+
+				return;
+			}
+			else if (argv[arg][1] == 'v')						verb = 1;
+			else if (argv[arg][1] == 's')						VERSION = MERKLE_SHA2_256;
+			else if (argv[arg][1] == 'l' && arg + 1 < argc)		leaf_size = strtoull(argv[++arg], NULL, 0) * 1024;
+			else if (argv[arg][1] == 'd' && arg + 1 < argc)		n_dev = (unsigned int)strtoul(argv[++arg], NULL, 0);
+			else if (argv[arg][1] == 't' && arg + 1 < argc)		n_host = (unsigned int)strtoul(argv[++arg], NULL, 0);
+			else if (argv[arg][1] == 'p' && arg + 1 < argc)		proof_leaf = strtoll(argv[++arg], NULL, 0);
+			else {
+				printf("\n Unknow option: %s\n", argv[arg]);
+
+				return;
+			}
+		}
+		else path = argv[arg];
+	}
+
+	if (path == NULL) {
+		printf("\n Missing FILE. Type -h for help.\n");
+		return;
+	}
+
+#ifdef AXI
+	if (n_dev > 1) n_dev = 1;	// One MMIO window per board
+#endif
+
+	// --- Open Interfaces --- //
+	INTF interface[(n_dev) ? n_dev : 1];
+	for (unsigned int d = 0; d < n_dev; d++) open_INTF(&interface[d], INTF_ADDRESS + d, INTF_LENGTH);
+
+#ifdef AXI
+	// --- Loading Bitstream --- //
+	if (n_dev) load_bitstream(BITSTREAM_AXI);
+#endif
+
+	merkle_tree tree;
+	unsigned long long tic, toc;
+
+	tic = Wtime();
+	if (merkle_file_hw(&tree, path, leaf_size, VERSION, interface, n_dev, n_host)) {
+		for (unsigned int d = 0; d < n_dev; d++) close_INTF(interface[d]);
+		return;
+	}
+	toc = Wtime() - tic;
+
+	printf("\n %-10s: %s", "File", path);
+	printf("\n %-10s: %s", "Hash", (VERSION == MERKLE_SHA2_256) ? "SHA-256" : "SHA3-256");
+	printf("\n %-10s: %llu B / %llu leaves of %llu B / %u levels", "Tree", tree.length, tree.n_leaves, tree.leaf_size, tree.n_levels);
+	printf("\n %-10s: ", "Root");	print_hash(tree.root);
+	if (verb >= 1) {
+		printf("\n %-10s: %llu on %u device(s), %llu on %u host thread(s)", "Leaves", tree.leaves_hw, n_dev, tree.leaves_sw, n_host);
+		printf("\n %-10s: %llu us.", "ET", toc);
+	}
+
+	if (proof_leaf >= 0 && (unsigned long long)proof_leaf >= tree.n_leaves) {
+		printf("\n %-10s: %lld out of range", "Proof leaf", proof_leaf);
+	}
+	else if (proof_leaf >= 0) {
+		unsigned char proof[MERKLE_MAX_LEVELS * MERKLE_HASH_LEN];
+		unsigned int n = merkle_proof(&tree, (unsigned long long)proof_leaf, proof);
+
+		printf("\n %-10s: %lld", "Proof leaf", proof_leaf);
+		printf("\n %-10s: ", "Leaf hash");	print_hash(tree.nodes + proof_leaf * MERKLE_HASH_LEN);
+		for (unsigned int i = 0; i < n; i++) {
+			printf("\n %-10s: ", (i == 0) ? "Siblings" : "");	print_hash(proof + i * MERKLE_HASH_LEN);
+		}
+		print_result_valid("Proof", !merkle_verify(tree.root, tree.nodes + proof_leaf * MERKLE_HASH_LEN, (unsigned long long)proof_leaf, tree.n_leaves, proof, n, VERSION));
+	}
+
+	printf("\n\n");
+
+	merkle_free(&tree);
+
+	// --- Close Interfaces --- //
+	for (unsigned int d = 0; d < n_dev; d++) close_INTF(interface[d]);
+}
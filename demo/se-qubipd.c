@@ -0,0 +1,140 @@
+/**
+  * @file se-qubipd.c
+  * @brief SE broker daemon: owns the SE and serves unprivileged clients
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#include "src/demo.h"
+#include <signal.h>
+
+static void on_signal(int sig)
+{
+	(void)sig;
+	se_broker_stop();
+}
+
+int main(int argc, char** argv) {
+
+	const char* path = NULL;
+	unsigned int mode = 0660;
+	unsigned int n_dev = 1;
+	int verb = 0;
+
+	for (int arg = 1; arg < argc; arg++) {
+
+		if (argv[arg][0] == '-') {
+			if (argv[arg][1] == 'h') {
+				printf("\n Usage: ./se-qubipd-XXX [-h] [-v] [-s PATH] [-m MODE] [-d N] \n");
+				printf("\n -h      : Show the help.");
+				printf("\n -v      : Print the request counters on exit");
+				printf("\n -s PATH : Socket path (default %s)", SE_BROKER_PATH);
+				printf("\n -m MODE : Socket permissions, octal (default 0660)");
+				printf("\n -d N    : Number of SE devices (consecutive I2C addresses from 0x%02x)", INTF_ADDRESS);
+				printf("\n \n");
+
+				return 0;
+			}
+			else if (argv[arg][1] == 'v')						verb = 1;
+			else if (argv[arg][1] == 's' && arg + 1 < argc)		path = argv[++arg];
+			else if (argv[arg][1] == 'm' && arg + 1 < argc)		mode = (unsigned int)strtoul(argv[++arg], NULL, 8);
+			else if (argv[arg][1] == 'd' && arg + 1 < argc)		n_dev = (unsigned int)strtoul(argv[++arg], NULL, 0);
+			else {
+				printf("\n Unknow option: %s\n", argv[arg]);
+
+				return 1;
+			}
+		}
+	}
+
+#ifdef AXI
+	if (n_dev > 1) n_dev = 1;	// One MMIO window per board
+#endif
+	if (n_dev == 0 || n_dev > SE_BROKER_MAX_DEV) {
+		printf("\n -d: 1 to %d devices\n", SE_BROKER_MAX_DEV);
+		return 1;
+	}
+
+	// --- Open Interfaces --- //
+	INTF interface[n_dev];
+	for (unsigned int d = 0; d < n_dev; d++) open_INTF(&interface[d], INTF_ADDRESS + d, INTF_LENGTH);
+
+#ifdef AXI
+	// --- Loading Bitstream --- //
+	load_bitstream(BITSTREAM_AXI);
+#endif
+
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+	signal(SIGPIPE, SIG_IGN);
+
+	int ret = se_broker_serve(path, mode, interface, n_dev);
+
+	if (verb >= 1 && ret == 0) {
+		se_broker_stat st;
+		const char* name[SE_N_CORE] = { "SHA3", "SHA2", "EdDSA", "X25519", "TRNG", "AES", "ML-KEM" };
+		se_broker_stats(&st);
+		for (int c = 0; c < SE_N_CORE; c++) if (st.ops[c]) printf("\n %-10s: %llu requests in %llu batches", name[c], st.ops[c], st.batches[c]);
+		printf("\n %-10s: %llu", "Rejected", st.rejected);
+		printf("\n %-10s: %llu", "Wake-ups", st.wakeups);
+		printf("\n\n");
+	}
+
+	// --- Close Interfaces --- //
+	for (unsigned int d = 0; d < n_dev; d++) close_INTF(interface[d]);
+
+	return (ret == 0) ? 0 : 1;
+}
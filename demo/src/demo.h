@@ -74,6 +74,7 @@ void demo_aes_hw(unsigned int bits, unsigned int verb, INTF interface);
 void demo_sha2_hw(unsigned int verb, INTF interface);
 void demo_sha3_hw(unsigned int verb, INTF interface);
 void demo_trng_hw(unsigned int bits, unsigned verb, INTF interface);
+void demo_drbg_hw(unsigned verb, INTF interface);
 void demo_mlkem_hw(unsigned int mode, unsigned int verb, INTF interface);
 
 // test - speed
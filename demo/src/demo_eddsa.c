@@ -61,6 +61,140 @@
 #include "demo.h"
 #include "test_func.h"
 
+static int demo_eddsa_read(void *ctx, unsigned long long offset, unsigned char *buf, unsigned int len)
+{
+    memcpy(buf, (unsigned char*) ctx + offset, len);
+    return 0;
+}
+
+//-- RFC 8032 section 7.2 (Ed25519ctx) and 7.3 (Ed25519ph) test vectors on the
+//-- host signer. Each signature must also fail under another context / variant.
+static unsigned int demo_eddsa_rfc8032(unsigned int verb)
+{
+    typedef struct {
+        char* name;
+        int variant;
+        char* pri_key;
+        char* pub_key;
+        char* msg;
+        char* ctx;
+        char* exp_sig;
+    } sample_eddsa;
+
+    static const sample_eddsa samples[] = {
+        { "Ed25519ctx #1", EDDSA_VARIANT_CTX,
+          "0305334e381af78f141cb666f6199f57bc3495335a256a95bd2a55bf546663f6", "dfc9425e4f968f7f0c29f0259cf5f9aed6851c2bb4ad8bfb860cfee0ab248292",
+          "f726936d19c800494e3fdaff20b276a8", "666f6f",
+          "55a4cc2f70a54e04288c5f4cd1e45a7bb520b36292911876cada7323198dd87a8b36950b95130022907a7fb7c4e9b2d5f6cca685a587b4b21f4b888e4e7edb0d" },
+        { "Ed25519ctx #2", EDDSA_VARIANT_CTX,
+          "0305334e381af78f141cb666f6199f57bc3495335a256a95bd2a55bf546663f6", "dfc9425e4f968f7f0c29f0259cf5f9aed6851c2bb4ad8bfb860cfee0ab248292",
+          "f726936d19c800494e3fdaff20b276a8", "626172",
+          "fc60d5872fc46b3aa69f8b5b4351d5808f92bcc044606db097abab6dbcb1aee3216c48e8b3b66431b5b186d1d28f8ee15a5ca2df6668346291c2043d4eb3e90d" },
+        { "Ed25519ctx #3", EDDSA_VARIANT_CTX,
+          "0305334e381af78f141cb666f6199f57bc3495335a256a95bd2a55bf546663f6", "dfc9425e4f968f7f0c29f0259cf5f9aed6851c2bb4ad8bfb860cfee0ab248292",
+          "508e9e6882b979fea900f62adceaca35", "666f6f",
+          "8b70c1cc8310e1de20ac53ce28ae6e7207f33c3295e03bb5c0732a1d20dc64908922a8b052cf99b7c4fe107a5abb5b2c4085ae75890d02df26269d8945f84b0b" },
+        { "Ed25519ctx #4", EDDSA_VARIANT_CTX,
+          "ab9c2853ce297ddab85c993b3ae14bcad39b2c682beabc27d6d4eb20711d6560", "0f1d1274943b91415889152e893d80e93275a1fc0b65fd71b4b0dda10ad7d772",
+          "f726936d19c800494e3fdaff20b276a8", "666f6f",
+          "21655b5f1aa965996b3f97b3c849eafba922a0a62992f73b3d1b73106a84ad85e9b86a7b6005ea868337ff2d20a7f5fbd4cd10b0be49a68da2b2e0dc0ad8960f" },
+        { "Ed25519ph #1", EDDSA_VARIANT_PH,
+          "833fe62409237b9d62ec77587520911e9a759cec1d19755b7da901b96dca3d42", "ec172b93ad5e563bf4932c70e1245034c35467ef2efd4d64ebf819683467e2bf",
+          "616263", "",
+          "98a70222f0b8121aa9d30f813d683f809e462b469c7ff87639499bb94e6dae4131f85042463c2a355a2003d062adf5aaa10b8c61e636062aaad11c2a26083406" }
+    };
+
+    unsigned char pri_key[32], pub_key[32], pub_ref[32];
+    unsigned char msg[64], ctx[16], ph[64];
+    unsigned char exp_sig[64], sig[64];
+    unsigned int msg_len, ctx_len;
+    unsigned int result;
+    unsigned int fail;
+    unsigned int fail_all = 0;
+
+    for (unsigned int i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+        const sample_eddsa* t = &samples[i];
+        const unsigned char* m = msg;
+
+        char2hex(t->pri_key, pri_key);
+        char2hex(t->pub_key, pub_ref);
+        char2hex(t->msg, msg);
+        char2hex(t->ctx, ctx);
+        char2hex(t->exp_sig, exp_sig);
+        msg_len = strlen(t->msg) / 2;
+        ctx_len = strlen(t->ctx) / 2;
+
+        //-- Ed25519ph signs the SHA-512 of the message
+        if (t->variant == EDDSA_VARIANT_PH) {
+            sha_512_sw(msg, msg_len, ph);
+            m = ph;
+            msg_len = 64;
+        }
+
+        eddsa25519_pubkey_sw(pri_key, pub_key);
+        fail = memcmp(pub_key, pub_ref, 32) != 0;
+
+        fail |= eddsa25519_sign_sw(m, msg_len, ctx, ctx_len, t->variant, pri_key, pub_key, sig) != 0 || memcmp(sig, exp_sig, 64) != 0;
+        fail |= eddsa25519_verify_sw(m, msg_len, ctx, ctx_len, t->variant, pub_key, exp_sig, &result) != 0 || !result;
+
+        //-- Domain separation: another context or the plain variant rejects it
+        ctx[0] ^= 0x01;
+        fail |= eddsa25519_verify_sw(m, msg_len, ctx, (ctx_len) ? ctx_len : 1, t->variant, pub_key, exp_sig, &result) != 0 || result;
+        fail |= eddsa25519_verify_sw(m, msg_len, NULL, 0, EDDSA_VARIANT_PURE, pub_key, exp_sig, &result) != 0 || result;
+
+        if (verb >= 1) {
+            printf("\n Obtained Result: ");  show_array(sig, 64, 32);
+            printf("\n Expected Result: ");  show_array(exp_sig, 64, 32);
+        }
+        print_result_valid(t->name, fail);
+
+        fail_all |= fail;
+    }
+
+    return fail_all;
+}
+
+//-- Streamed sign/verify (buffer, callback and key handle) against the one-shot
+//-- host signature, at message lengths around the 128-byte block edges
+static unsigned int demo_eddsa_stream(const unsigned char *pri_key, const unsigned char *pub_key, INTF interface)
+{
+    const unsigned int sizes[] = { 0, 63, 64, 65, 191, 192, 1000 };
+    unsigned char msg[1000];
+    unsigned char ref[64];
+    unsigned char sig[64];
+    unsigned int result;
+    unsigned int fail = 0;
+    eddsa_key key;
+
+    for (int i = 0; i < sizeof(msg); i++) msg[i] = (unsigned char)(7 * i + 1);
+
+    eddsa_key_init(&key, pri_key, pub_key, EDDSA_KEY_RESIDENT);
+
+    for (int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        unsigned int len = sizes[s];
+
+        eddsa25519_sign_sw(msg, len, NULL, 0, EDDSA_VARIANT_PURE, pri_key, pub_key, ref);
+
+        fail |= eddsa25519_sign_hw_buf(msg, len, pri_key, pub_key, sig, interface) != 0 || memcmp(sig, ref, 64);
+        fail |= eddsa25519_sign_hw_cb(demo_eddsa_read, msg, len, pri_key, pub_key, sig, interface) != 0 || memcmp(sig, ref, 64);
+
+        //-- Twice: keys loaded, then resident in the core
+        fail |= eddsa25519_sign_key_hw(msg, len, &key, sig, interface) != 0 || memcmp(sig, ref, 64);
+        fail |= eddsa25519_sign_key_hw(msg, len, &key, sig, interface) != 0 || memcmp(sig, ref, 64);
+
+        fail |= eddsa25519_verify_hw_buf(msg, len, pub_key, ref, &result, interface) != 0 || !result;
+        fail |= eddsa25519_verify_hw_cb(demo_eddsa_read, msg, len, pub_key, ref, &result, interface) != 0 || !result;
+
+        //-- A rejected signature is a result of the call, not an error
+        ref[len % 64] ^= 0x01;
+        fail |= eddsa25519_verify_hw_buf(msg, len, pub_key, ref, &result, interface) != 0 || result;
+    }
+
+    eddsa_key_clear(&key);
+
+    return fail;
+}
+
 void demo_eddsa_hw(unsigned int mode, unsigned int verb, INTF interface) {
 
 #ifdef AXI
@@ -104,6 +238,10 @@ void demo_eddsa_hw(unsigned int mode, unsigned int verb, INTF interface) {
         eddsa25519_verify_hw(msg, strlen(msg), pub_key, pub_len, sig, sig_len, &result, interface);
 
         print_result_valid("EdDSA-25519", !result);
+
+        print_result_valid("EdDSA-25519 STREAM", demo_eddsa_stream(pri_key, pub_key, interface));
+
+        demo_eddsa_rfc8032(verb);
     }
     else {
         /*
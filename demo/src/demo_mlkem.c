@@ -61,6 +61,88 @@
 #include "demo.h"
 #include "test_func.h"
 
+//-- Host ML-KEM (FIPS 203): derandomized key generation and encapsulation from
+//-- fixed seeds (d = 00..1f, z = 64..83, m = c8..e7) against SHA3-256 digests of
+//-- ek and ct and the shared key, decapsulation round trip, and implicit
+//-- rejection of a ciphertext with one bit flipped (ss = J(z || ct)).
+//-- Expected values from an independent spec-level FIPS 203 implementation.
+static unsigned int demo_mlkem_sw(int k, unsigned int verb) {
+
+    typedef struct {
+        int k;
+        char* ek;
+        char* ct;
+        char* ss;
+        char* ss_rej;
+    } sample_mlkem;
+
+    static const sample_mlkem samples[] = {
+        { 2, "82f101ff648063b376e2bb6c5b7455f655a50c2feadade150efa0e0e6f365aea",
+             "dcb31cd878e6332b6a5b32a2e9595ada8818ab64f6464e07922d36c34aeda43b",
+             "a42a37b488e7032ddc274b5ae191b19c974ac54d9d699500c19e035e0ca3de9c",
+             "90184de2013ecfd8ad850eb22c1ec41aea35cc6443ad180bd5504b51887e802e" },
+        { 3, "a24e16d8f8f9383a95b77050f4d9fd2f5733eec1d63ef3c23ebf9918173669a7",
+             "f86cbba7a1c878d7a28dbd91d1d37723f395acda36bc8c3a26cbdf4db370ad94",
+             "bf290b679c23d05d40a6a5714647425c88a02e656f34a3124158c416c7c99aa0",
+             "9532e0f9047d3a5d204f0b95951bc8e219677b5cd5d0cc2f69f8b97cc8086234" },
+        { 4, "61349e5c131a7e116a0463861d7d18663c5627c38c7147ddaadfd48acd7a4535",
+             "11ff69d834d52da407563c6b6c46f070511237e0911273f92dc5d0c85fa8ac25",
+             "7407d87bcf6e6ecd0e8454361d1ce4d05d779dd368fa67ef06c790a52bfd3b05",
+             "20beb6d975021f4289c959d4b31fd2c6122c3837e7ee350f34342b6999ddba41" }
+    };
+
+    const sample_mlkem* t = &samples[k - 2];
+    unsigned char d[32], z[32], m[32];
+    unsigned char exp_ek[32], exp_ct[32], exp_ss[32], exp_ss_rej[32];
+    unsigned char md[32], ss[32], ss1[32];
+    unsigned char* pk = malloc(MLKEM_SW_PK_BYTES(k));
+    unsigned char* sk = malloc(MLKEM_SW_SK_BYTES(k));
+    unsigned char* ct = malloc(MLKEM_SW_CT_BYTES(k));
+    unsigned int result = 0;
+    unsigned int fail = 0;
+
+    for (int i = 0; i < 32; i++) { d[i] = i; z[i] = 100 + i; m[i] = 200 + i; }
+    char2hex(t->ek, exp_ek);
+    char2hex(t->ct, exp_ct);
+    char2hex(t->ss, exp_ss);
+    char2hex(t->ss_rej, exp_ss_rej);
+
+    // ---- known answers ---- //
+    mlkem_gen_keys_sw_derand(k, d, z, pk, sk);
+    sha3_256_sw(pk, MLKEM_SW_PK_BYTES(k), md);
+    fail |= memcmp(md, exp_ek, 32) != 0;
+
+    mlkem_enc_sw_derand(k, pk, m, ct, ss);
+    sha3_256_sw(ct, MLKEM_SW_CT_BYTES(k), md);
+    fail |= memcmp(md, exp_ct, 32) != 0;
+    fail |= memcmp(ss, exp_ss, 32) != 0;
+
+    mlkem_dec_sw(k, sk, ct, ss1, &result);
+    fail |= result != 3 || memcmp(ss1, exp_ss, 32) != 0;
+
+    // ---- implicit rejection ---- //
+    ct[0] ^= 0x01;
+    mlkem_dec_sw(k, sk, ct, ss1, &result);
+    fail |= result != 1 || memcmp(ss1, exp_ss_rej, 32) != 0;
+
+    if (verb >= 1) {
+        printf("\n Obtained Result: ");  show_array(ss1, 32, 32);
+        printf("\n Expected Result: ");  show_array(exp_ss_rej, 32, 32);
+    }
+
+    // ---- random round trip ---- //
+    mlkem_gen_keys_sw(k, pk, sk);
+    mlkem_enc_sw(k, pk, ct, ss);
+    mlkem_dec_sw(k, sk, ct, ss1, &result);
+    fail |= result != 3 || memcmp(ss1, ss, 32) != 0;
+
+    free(pk);
+    free(sk);
+    free(ct);
+
+    return fail;
+}
+
 void demo_mlkem_hw(unsigned int mode, unsigned int verb, INTF interface) {
 
 #ifdef AXI
@@ -200,6 +282,10 @@ void demo_mlkem_hw(unsigned int mode, unsigned int verb, INTF interface) {
 
     }
 
+    if (mode == 512)        print_result_valid("MLKEM-512 SW", demo_mlkem_sw(2, verb));
+    else if (mode == 768)   print_result_valid("MLKEM-768 SW", demo_mlkem_sw(3, verb));
+    else                    print_result_valid("MLKEM-1024 SW", demo_mlkem_sw(4, verb));
+
 #ifdef AXI
     set_clk_frequency = FREQ_TYPICAL;
     Set_Clk_Freq(clk_index, &clk_frequency, &set_clk_frequency, (int)verb);
@@ -161,6 +161,80 @@ void demo_sha3_hw(unsigned int verb, INTF interface) {
     print_result_valid("SHAKE-256", memcmp(md, res_s_256, 64));
     free(md);
 
+    // ---- SP 800-185 (NIST samples: cSHAKE 1-4, KMAC 1-6, KMACXOF 1-6) ---- //
+    typedef struct {
+        char* name;
+        int type;                   // 0: cSHAKE, 1: KMAC, 2: KMACXOF
+        int level;                  // 128 or 256
+        unsigned int len_data;
+        char* custom;
+        char* exp_res;
+    } sample_185;
+
+    static const sample_185 samples[] = {
+        { "cSHAKE-128 #1",   0, 128,   4, "Email Signature",       "c1c36925b6409a04f1b504fcbca9d82b4017277cb5ed2b2065fc1d3814d5aaf5" },
+        { "cSHAKE-128 #2",   0, 128, 200, "Email Signature",       "c5221d50e4f822d96a2e8881a961420f294b7b24fe3d2094baed2c6524cc166b" },
+        { "cSHAKE-256 #3",   0, 256,   4, "Email Signature",       "d008828e2b80ac9d2218ffee1d070c48b8e4c87bff32c9699d5b6896eee0edd164020e2be0560858d9c00c037e34a96937c561a74c412bb4c746469527281c8c" },
+        { "cSHAKE-256 #4",   0, 256, 200, "Email Signature",       "07dc27b11e51fbac75bc7b3c1d983e8b4b85fb1defaf218912ac86430273091727f42b17ed1df63e8ec118f04b23633c1dfb1574c8fb55cb45da8e25afb092bb" },
+        { "KMAC-128 #1",     1, 128,   4, "",                      "e5780b0d3ea6f7d3a429c5706aa43a00fadbd7d49628839e3187243f456ee14e" },
+        { "KMAC-128 #2",     1, 128,   4, "My Tagged Application", "3b1fba963cd8b0b59e8c1a6d71888b7143651af8ba0a7070c0979e2811324aa5" },
+        { "KMAC-128 #3",     1, 128, 200, "My Tagged Application", "1f5b4e6cca02209e0dcb5ca635b89a15e271ecc760071dfd805faa38f9729230" },
+        { "KMAC-256 #4",     1, 256,   4, "My Tagged Application", "20c570c31346f703c9ac36c61c03cb64c3970d0cfc787e9b79599d273a68d2f7f69d4cc3de9d104a351689f27cf6f5951f0103f33f4f24871024d9c27773a8dd" },
+        { "KMAC-256 #5",     1, 256, 200, "",                      "75358cf39e41494e949707927cee0af20a3ff553904c86b08f21cc414bcfd691589d27cf5e15369cbbff8b9a4c2eb17800855d0235ff635da82533ec6b759b69" },
+        { "KMAC-256 #6",     1, 256, 200, "My Tagged Application", "b58618f71f92e1d56c1b8c55ddd7cd188b97b4ca4d99831eb2699a837da2e4d970fbacfde50033aea585f1a2708510c32d07880801bd182898fe476876fc8965" },
+        { "KMACXOF-128 #1",  2, 128,   4, "",                      "cd83740bbd92ccc8cf032b1481a0f4460e7ca9dd12b08a0c4031178bacd6ec35" },
+        { "KMACXOF-128 #2",  2, 128,   4, "My Tagged Application", "31a44527b4ed9f5c6101d11de6d26f0620aa5c341def41299657fe9df1a3b16c" },
+        { "KMACXOF-128 #3",  2, 128, 200, "My Tagged Application", "47026c7cd793084aa0283c253ef658490c0db61438b8326fe9bddf281b83ae0f" },
+        { "KMACXOF-256 #4",  2, 256,   4, "My Tagged Application", "1755133f1534752aad0748f2c706fb5c784512cab835cd15676b16c0c6647fa96faa7af634a0bf8ff6df39374fa00fad9a39e322a7c92065a64eb1fb0801eb2b" },
+        { "KMACXOF-256 #5",  2, 256, 200, "",                      "ff7b171f1e8a2b24683eed37830ee797538ba8dc563f6da1e667391a75edc02ca633079f81ce12a25f45615ec89972031d18337331d24ceb8f8ca8e6a19fd98b" },
+        { "KMACXOF-256 #6",  2, 256, 200, "My Tagged Application", "d5be731c954ed7732846bb59dbe3a8e30f83e77a4bff4459f2f1c2b4ecebb8ce67ba01c62e8ab8578d2d499bd1bb276768781190020a306a97de281dcc30305d" }
+    };
+
+    unsigned char* exp_res_ph_128 = "ba8dc1d1d979331d3f813603c67f72609ab5e44b94a0b8f9af46514454a2b4f5";
+    unsigned char res_ph_128[32]; char2hex(exp_res_ph_128, res_ph_128);
+
+    unsigned char data_185[200];
+    unsigned char data_ph[24];
+    unsigned char key_185[32];
+    unsigned char res_185[64];
+    unsigned int len_185;
+    for (int i = 0; i < 200; i++) data_185[i] = i;
+    for (int i = 0; i < 24; i++) data_ph[i] = ((i / 8) << 4) + (i % 8);
+    for (int i = 0; i < 32; i++) key_185[i] = 0x40 + i;
+
+    for (unsigned int i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+        const sample_185* t = &samples[i];
+        unsigned char* custom = (unsigned char*)t->custom;
+        unsigned int len_custom = strlen(t->custom);
+
+        len_185 = strlen(t->exp_res) / 2;
+        char2hex(t->exp_res, res_185);
+
+        md = malloc(len_185);
+        if (t->type == 0 && t->level == 128)        cshake_128_hw(data_185, t->len_data, md, len_185, "", 0, custom, len_custom, interface);
+        else if (t->type == 0)                      cshake_256_hw(data_185, t->len_data, md, len_185, "", 0, custom, len_custom, interface);
+        else if (t->type == 1 && t->level == 128)   kmac_128_hw(key_185, 32, data_185, t->len_data, md, len_185, custom, len_custom, interface);
+        else if (t->type == 1)                      kmac_256_hw(key_185, 32, data_185, t->len_data, md, len_185, custom, len_custom, interface);
+        else if (t->level == 128)                   kmacxof_128_hw(key_185, 32, data_185, t->len_data, md, len_185, custom, len_custom, interface);
+        else                                        kmacxof_256_hw(key_185, 32, data_185, t->len_data, md, len_185, custom, len_custom, interface);
+        if (verb >= 1) {
+            printf("\n Obtained Result: ");  show_array(md, len_185, 32);
+            printf("\n Expected Result: ");  show_array(res_185, len_185, 32);
+        }
+        print_result_valid(t->name, memcmp(md, res_185, len_185));
+        free(md);
+    }
+
+    // ---- parallelhash_128 ---- //
+    md = malloc(32);
+    parallelhash_128_hw(data_ph, 24, 8, md, 32, "", 0, interface);
+    if (verb >= 1) {
+        printf("\n Obtained Result: ");  show_array(md, 32, 32);
+        printf("\n Expected Result: ");  show_array(res_ph_128, 32, 32);
+    }
+    print_result_valid("ParallelHash-128", memcmp(md, res_ph_128, 32));
+    free(md);
+
 
 #ifdef AXI
     set_clk_frequency = FREQ_TYPICAL;
@@ -77,10 +77,10 @@ void demo_trng_hw(unsigned int bits, unsigned verb, INTF interface) {
     }
 
     print_result_double_valid("TRNG", buf, test_random(random, bytes));
-    /*
+
     memset(random, 0, bytes);
 
-    ctr_drbg(random, bytes);
+    ctr_drbg_hw(random, bytes, interface);
 
     if (verb >= 1) {
         printf("\n CTR-DRBG Random %d bits: ", bits);  show_array(random, bytes, 32);
@@ -90,12 +90,100 @@ void demo_trng_hw(unsigned int bits, unsigned verb, INTF interface) {
 
     memset(random, 0, bytes);
 
-    hash_drbg(random, bytes);
+    hash_drbg_hw(random, bytes, interface);
 
     if (verb >= 1) {
         printf("\n HASH-DRBG Random %d bits: ", bits);  show_array(random, bytes, 32);
     }
 
     print_result_double_valid("HASH-DRBG", buf, test_random(random, bytes));
-    */
+
+    free(random);
+}
+
+//-- SP 800-90A known answers: instantiate, optional reseed, generate twice and
+//-- check the second output (the CAVP drbgvectors procedure, no prediction
+//-- resistance). #1 are the first CAVP samples of CTR_DRBG AES-256 use df and
+//-- Hash_DRBG SHA-512; #2 and #3 add personalization, additional input and reseed.
+void demo_drbg_hw(unsigned verb, INTF interface) {
+
+    typedef struct {
+        char* name;
+        int type;
+        char* entropy;
+        char* nonce;
+        char* pers;
+        char* entropy_reseed;
+        char* add_reseed;
+        char* add_1;
+        char* add_2;
+        char* exp_res;
+    } sample_drbg;
+
+    static const sample_drbg samples[] = {
+        { "CTR-DRBG #1", DRBG_CTR_AES256,
+          "36401940fa8b1fba91a1661f211d78a0b9389a74e5bccfece8d766af1a6d3b14", "496f25b0f1301b4f501be30380a137eb",
+          "", "", "", "", "",
+          "5862eb38bd558dd978a696e6df164782ddd887e7e9a6c9f3f1fbafb78941b535a64912dfd224c6dc7454e5250b3d97165e16260c2faf1cc7735cb75fb4f07e1d" },
+        { "CTR-DRBG #2", DRBG_CTR_AES256,
+          "36401940fa8b1fba91a1661f211d78a0b9389a74e5bccfece8d766af1a6d3b14", "496f25b0f1301b4f501be30380a137eb",
+          "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f", "", "", "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f", "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf",
+          "f492edc40ebae92f888fa5fcfbf96a1fdb08cc472eacd0915655718cdcfc8eee981847e31f9c0fd544e7a52a97342a20607c6f76037217626de1764bb600682a" },
+        { "CTR-DRBG #3", DRBG_CTR_AES256,
+          "36401940fa8b1fba91a1661f211d78a0b9389a74e5bccfece8d766af1a6d3b14", "496f25b0f1301b4f501be30380a137eb",
+          "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f", "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f", "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf", "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f", "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf",
+          "ace6657ac5da6e24a0aad3fe1c2de58555c12f440e5f5061c689607540f1494cf35efb680904fd5c52806a50bf17413b53676363d6cb6500da905927744ff29b" },
+        { "HASH-DRBG #1", DRBG_HASH_SHA512,
+          "6b50a7d8f8a55d7a3df8bb40bcc3b722d8708de67fda010b03c4c84d72096f8c", "3ec649cc6256d9fa31db7a2904aaf025",
+          "", "", "", "", "",
+          "95b7f17e9802d3577392c6a9c08083b67dd1292265b5f42d237f1c55bb9b10bfcfd82c77a378b8266a0099143b3c2d64611eeeb69acdc055957c139e8b190c7a06955f2c797c2778de940396a501f40e91396acf8d7e45ebdbb53bbf8c975230d2f0ff9106c76119ae498e7fbc03d90f8e4c51627aed5c8d4263d5d2b978873a" },
+        { "HASH-DRBG #2", DRBG_HASH_SHA512,
+          "6b50a7d8f8a55d7a3df8bb40bcc3b722d8708de67fda010b03c4c84d72096f8c", "3ec649cc6256d9fa31db7a2904aaf025",
+          "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f", "", "", "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f", "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf",
+          "c5cc5719c60f4793e3d9a61218250ac13ab1babb12c1e4450e8af29f2458e45835a563456426debc395bb15c6e39aa8f119f45dee550f401e2c2664d9a1389c8f42a2b324cf4af1f47d4d07fc9aa8068709bec8b137d34b36c41811d986eed09b79c3dd90dc7e7dedb11dbef18aa6397061559dc3fda01a5f1cc144bbd7bcb30" },
+        { "HASH-DRBG #3", DRBG_HASH_SHA512,
+          "6b50a7d8f8a55d7a3df8bb40bcc3b722d8708de67fda010b03c4c84d72096f8c", "3ec649cc6256d9fa31db7a2904aaf025",
+          "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f", "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f", "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf", "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f", "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf",
+          "0a489bd28398ec42157bd1708c6f40324c520af15e60ffa6defce0dfd1b8ae75b04578ed61c2cf8003b0e2c08357359d74d8859d6f7c0c7c7adcddade7bd10ab1cc2893d782a2cb18c4c7c24b37a4b6b56759ca84ff9cbb6399c6ddc4bfb4e1e7ffd7b534739226a116e236a8b7900ef0b2c1d9e6f085459c4dcd1aa5d1df330" }
+    };
+
+    const int backends[] = { DRBG_BACKEND_HW, DRBG_BACKEND_HOST };
+    unsigned char entropy[32], nonce[16], pers[32], entropy_reseed[32], add_reseed[32], add_1[32], add_2[32];
+    unsigned char exp_res[128], res[128];
+    unsigned int len;
+    unsigned int fail;
+    drbg_ctx ctx;
+
+    for (unsigned int i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+        const sample_drbg* t = &samples[i];
+
+        char2hex(t->entropy, entropy);
+        char2hex(t->nonce, nonce);
+        char2hex(t->pers, pers);
+        char2hex(t->entropy_reseed, entropy_reseed);
+        char2hex(t->add_reseed, add_reseed);
+        char2hex(t->add_1, add_1);
+        char2hex(t->add_2, add_2);
+        char2hex(t->exp_res, exp_res);
+        len = strlen(t->exp_res) / 2;
+
+        for (int b = 0; b < 2; b++) {
+            if (backends[b] == DRBG_BACKEND_HOST && t->type == DRBG_CTR_AES256 && !drbg_host_aes()) continue;
+
+            memset(res, 0, sizeof(res));
+            fail = drbg_init_kat(&ctx, t->type, backends[b], entropy, strlen(t->entropy) / 2, nonce, strlen(t->nonce) / 2, pers, strlen(t->pers) / 2, interface) != DRBG_OK;
+            if (!fail && strlen(t->entropy_reseed))
+                fail = drbg_reseed_kat(&ctx, entropy_reseed, strlen(t->entropy_reseed) / 2, add_reseed, strlen(t->add_reseed) / 2) != DRBG_OK;
+            if (!fail) fail = drbg_generate(&ctx, res, len, add_1, strlen(t->add_1) / 2) != DRBG_OK;
+            if (!fail) fail = drbg_generate(&ctx, res, len, add_2, strlen(t->add_2) / 2) != DRBG_OK;
+            if (!fail) fail = memcmp(res, exp_res, len) != 0;
+            drbg_free(&ctx);
+
+            if (verb >= 1) {
+                printf("\n Obtained Result: ");  show_array(res, len, 32);
+                printf("\n Expected Result: ");  show_array(exp_res, len, 32);
+            }
+            print_result_double_valid(t->name, (backends[b] == DRBG_BACKEND_HW) ? "SE" : "HOST", fail);
+        }
+    }
 }
\ No newline at end of file
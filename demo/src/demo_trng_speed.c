@@ -98,22 +98,18 @@ void test_trng_hw(unsigned int mode, unsigned int bits, unsigned int n_test, tim
             if (verb >= 2) show_array(random_trng, bytes, 32);
         }
         else if (mode == 1) {
-        /*
             start_t = timeInMicroseconds();
-            ctr_drbg(random_ctr, bytes); // from crypto_api_sw.h
-            stop_t = timeInMicroseconds(); if (verb >= 1) printf("\n SW: ET: %.3f s \t %.3f ms \t %d us", (stop_t - start_t) / 1000000.0, (stop_t - start_t) / 1000.0, (unsigned int)(stop_t - start_t));
+            ctr_drbg_hw(random_ctr, bytes, interface);
+            stop_t = timeInMicroseconds(); if (verb >= 1) printf("\n HW: ET: %.3f s \t %.3f ms \t %d us", (stop_t - start_t) / 1000000.0, (stop_t - start_t) / 1000.0, (unsigned int)(stop_t - start_t));
             if (!test_random(random_ctr, bytes)) tr->val_result++;
             if (verb >= 2) show_array(random_ctr, bytes, 32);
-        */
         }
         else if (mode == 2) {
-        /*    
             start_t = timeInMicroseconds();
-            hash_drbg(random_hmac, bytes); // from crypto_api_sw.h
-            stop_t = timeInMicroseconds(); if (verb >= 1) printf("\n SW: ET: %.3f s \t %.3f ms \t %d us", (stop_t - start_t) / 1000000.0, (stop_t - start_t) / 1000.0, (unsigned int)(stop_t - start_t));
+            hash_drbg_hw(random_hmac, bytes, interface);
+            stop_t = timeInMicroseconds(); if (verb >= 1) printf("\n HW: ET: %.3f s \t %.3f ms \t %d us", (stop_t - start_t) / 1000000.0, (stop_t - start_t) / 1000.0, (unsigned int)(stop_t - start_t));
             if (!test_random(random_hmac, bytes)) tr->val_result++;
             if (verb >= 2) show_array(random_hmac, bytes, 32);
-        */
         }
 
         time_hw = stop_t - start_t;
@@ -0,0 +1,155 @@
+/**
+  * @file  se-qubip-client.h
+  * @brief SEQUBIP client header: the se-qubip.h operations served by se-qubipd
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef SE_QUBIP_CLIENT_H_INCLUDED
+#define SE_QUBIP_CLIENT_H_INCLUDED
+
+//-- Unprivileged programs include this header instead of se-qubip.h: the same
+//-- names take an se_client* (from se_client_open) where the library takes
+//-- the INTF, and return an SE_BROKER_* status.
+
+#include <stdlib.h>
+
+#include "se-qubip/src/broker/broker_client.h"
+
+//-- Connection
+#define se_client_open              se_client_open
+#define se_client_close             se_client_close
+#define se_client_set_deadline      se_client_set_deadline
+#define se_clock_ns                 intf_clock_ns
+
+//-- SHA-3 / SHAKE
+#define sha3_512_hw                 sha3_512_cl
+#define sha3_256_hw                 sha3_256_cl
+#define shake_128_hw                shake128_cl
+#define shake_256_hw                shake256_cl
+
+//-- SHA-2
+#define sha_256_hw                  sha_256_cl
+#define sha_384_hw                  sha_384_cl
+#define sha_512_hw                  sha_512_cl
+#define sha_512_256_hw              sha_512_256_cl
+
+//-- EdDSA25519
+#define eddsa25519_genkeys_hw_buf   eddsa25519_genkeys_cl
+#define eddsa25519_sign_hw_buf      eddsa25519_sign_cl
+#define eddsa25519_verify_hw_buf    eddsa25519_verify_cl
+
+//-- X25519
+#define x25519_genkeys_hw_buf       x25519_genkeys_cl
+#define x25519_ss_gen_hw_buf        x25519_ss_gen_cl
+
+//-- TRNG
+#define trng_hw                     trng_cl
+
+//-- AES-128/192/256-ECB
+#define aes_128_ecb_encrypt_hw(...) aes_ecb_encrypt_cl(128, __VA_ARGS__)
+#define aes_128_ecb_decrypt_hw(...) aes_ecb_decrypt_cl(128, __VA_ARGS__)
+#define aes_192_ecb_encrypt_hw(...) aes_ecb_encrypt_cl(192, __VA_ARGS__)
+#define aes_192_ecb_decrypt_hw(...) aes_ecb_decrypt_cl(192, __VA_ARGS__)
+#define aes_256_ecb_encrypt_hw(...) aes_ecb_encrypt_cl(256, __VA_ARGS__)
+#define aes_256_ecb_decrypt_hw(...) aes_ecb_decrypt_cl(256, __VA_ARGS__)
+
+//-- AES-128/192/256-CBC
+#define aes_128_cbc_encrypt_hw(...) aes_cbc_encrypt_cl(128, __VA_ARGS__)
+#define aes_128_cbc_decrypt_hw(...) aes_cbc_decrypt_cl(128, __VA_ARGS__)
+#define aes_192_cbc_encrypt_hw(...) aes_cbc_encrypt_cl(192, __VA_ARGS__)
+#define aes_192_cbc_decrypt_hw(...) aes_cbc_decrypt_cl(192, __VA_ARGS__)
+#define aes_256_cbc_encrypt_hw(...) aes_cbc_encrypt_cl(256, __VA_ARGS__)
+#define aes_256_cbc_decrypt_hw(...) aes_cbc_decrypt_cl(256, __VA_ARGS__)
+
+//-- AES-128/192/256-CMAC
+#define aes_128_cmac_hw(...)        aes_cmac_cl(128, __VA_ARGS__)
+#define aes_192_cmac_hw(...)        aes_cmac_cl(192, __VA_ARGS__)
+#define aes_256_cmac_hw(...)        aes_cmac_cl(256, __VA_ARGS__)
+
+//-- AES-128/192/256-CCM-8
+#define aes_128_ccm_8_encrypt_hw(...)   aes_ccm_8_encrypt_cl(128, __VA_ARGS__)
+#define aes_128_ccm_8_decrypt_hw(...)   aes_ccm_8_decrypt_cl(128, __VA_ARGS__)
+#define aes_192_ccm_8_encrypt_hw(...)   aes_ccm_8_encrypt_cl(192, __VA_ARGS__)
+#define aes_192_ccm_8_decrypt_hw(...)   aes_ccm_8_decrypt_cl(192, __VA_ARGS__)
+#define aes_256_ccm_8_encrypt_hw(...)   aes_ccm_8_encrypt_cl(256, __VA_ARGS__)
+#define aes_256_ccm_8_decrypt_hw(...)   aes_ccm_8_decrypt_cl(256, __VA_ARGS__)
+
+//-- AES-128/192/256-GCM
+#define aes_128_gcm_encrypt_hw(...) aes_gcm_encrypt_cl(128, __VA_ARGS__)
+#define aes_128_gcm_decrypt_hw(...) aes_gcm_decrypt_cl(128, __VA_ARGS__)
+#define aes_192_gcm_encrypt_hw(...) aes_gcm_encrypt_cl(192, __VA_ARGS__)
+#define aes_192_gcm_decrypt_hw(...) aes_gcm_decrypt_cl(192, __VA_ARGS__)
+#define aes_256_gcm_encrypt_hw(...) aes_gcm_encrypt_cl(256, __VA_ARGS__)
+#define aes_256_gcm_decrypt_hw(...) aes_gcm_decrypt_cl(256, __VA_ARGS__)
+
+//-- MLKEM
+#define mlkem512_genkeys_hw(...)    mlkem_gen_keys_cl(2, __VA_ARGS__)
+#define mlkem768_genkeys_hw(...)    mlkem_gen_keys_cl(3, __VA_ARGS__)
+#define mlkem1024_genkeys_hw(...)   mlkem_gen_keys_cl(4, __VA_ARGS__)
+#define mlkem_gen_keys_hw           mlkem_gen_keys_cl
+
+#define mlkem512_enc_hw(...)        mlkem_enc_cl(2, __VA_ARGS__)
+#define mlkem768_enc_hw(...)        mlkem_enc_cl(3, __VA_ARGS__)
+#define mlkem1024_enc_hw(...)       mlkem_enc_cl(4, __VA_ARGS__)
+#define mlkem_enc_hw                mlkem_enc_cl
+
+#define mlkem512_dec_hw(...)        mlkem_dec_cl(2, __VA_ARGS__)
+#define mlkem768_dec_hw(...)        mlkem_dec_cl(3, __VA_ARGS__)
+#define mlkem1024_dec_hw(...)       mlkem_dec_cl(4, __VA_ARGS__)
+#define mlkem_dec_hw                mlkem_dec_cl
+
+#endif // SE_QUBIP_CLIENT_H_INCLUDED
@@ -65,12 +65,66 @@
 
 #include "se-qubip/src/common/intf.h"
 #include "se-qubip/src/sha3/sha3_shake_hw.h"
+#include "se-qubip/src/sha3/sp800_185_hw.h"
+#include "se-qubip/src/sha3/sha3_sw.h"
 #include "se-qubip/src/sha2/sha2_hw.h"
+#include "se-qubip/src/sha2/sha2_sw.h"
 #include "se-qubip/src/eddsa/eddsa_hw.h"
+#include "se-qubip/src/eddsa/eddsa_sw.h"
 #include "se-qubip/src/x25519/x25519_hw.h"
 #include "se-qubip/src/trng/trng_hw.h"
+#include "se-qubip/src/trng/trng_pool.h"
 #include "se-qubip/src/aes/aes_hw.h"
 #include "se-qubip/src/mlkem/mlkem_hw.h"
+#include "se-qubip/src/mlkem/mlkem_sw.h"
+#include "se-qubip/src/merkle/merkle_hw.h"
+#include "se-qubip/src/dispatch/dispatch.h"
+#include "se-qubip/src/memo/memo.h"
+#include "se-qubip/src/pool/kpool.h"
+#include "se-qubip/src/hybrid/hybrid_hw.h"
+#include "se-qubip/src/drbg/drbg.h"
+#include "se-qubip/src/broker/broker.h"
+#include "se-qubip/src/op/se_op.h"
+
+//-- Device context (thread-safe: drivers hold per-core locks, see intf.h)
+#define se_open                     se_open
+#define se_close                    se_close
+#define se_ctx_of                   se_ctx_of
+#define se_core_stats               intf_core_stats
+#define se_shm_enable               intf_shm_enable
+#define se_shm_stats                intf_shm_stats
+
+//-- Faults and circuit breaker (see intf_core_fault)
+#define se_status                   intf_status
+#define se_clear_status             intf_clear_status
+#define se_core_available           intf_core_available
+#define se_core_health              intf_core_health
+#define se_breaker_set              intf_breaker_set
+
+//-- Deadlines (see intf_set_deadline)
+#define se_set_deadline             intf_set_deadline
+#define se_get_deadline             intf_get_deadline
+#define se_clock_ns                 intf_clock_ns
+
+//-- SE broker (se-qubipd side; clients use se-qubip-client.h)
+#define se_broker_serve             se_broker_serve
+#define se_broker_stop              se_broker_stop
+#define se_broker_stats             se_broker_stats
+
+//-- Non-blocking operations (see se_op_submit)
+#define se_op_submit                se_op_submit
+#define se_op_poll                  se_op_poll
+#define se_op_result                se_op_result
+#define se_op_run                   se_op_run
+#define se_op_x25519_genkeys        se_op_x25519_genkeys
+#define se_op_x25519_ss             se_op_x25519_ss
+#define se_op_mlkem_genkeys         se_op_mlkem_gen_keys
+#define se_op_mlkem_enc             se_op_mlkem_enc
+#define se_op_mlkem_dec             se_op_mlkem_dec
+#define se_op_post                  se_op_post
+#define se_op_fd                    se_op_fd
+#define se_op_reap                  se_op_reap
+#define se_op_stop                  se_op_stop
 
 //-- SHA-3 / SHAKE
 #define sha3_512_hw			        sha3_512_hw_func
@@ -78,22 +132,115 @@
 #define shake_128_hw		        shake128_hw_func
 #define shake_256_hw		        shake256_hw_func
 
+//-- SP 800-185: cSHAKE / KMAC / ParallelHash
+#define cshake_128_hw		        cshake128_hw_func
+#define cshake_256_hw		        cshake256_hw_func
+#define kmac_128_hw			        kmac128_hw_func
+#define kmac_256_hw			        kmac256_hw_func
+#define kmacxof_128_hw		        kmacxof128_hw_func
+#define kmacxof_256_hw		        kmacxof256_hw_func
+#define parallelhash_128_hw	        parallelhash128_hw_func
+#define parallelhash_256_hw	        parallelhash256_hw_func
+#define parallelhash_128_multi_hw   parallelhash128_multi_hw_func
+#define parallelhash_256_multi_hw   parallelhash256_multi_hw_func
+
 #define sha_256_hw			        sha_256_hw_func
 #define sha_384_hw			        sha_384_hw_func
 #define sha_512_hw			        sha_512_hw_func
 #define sha_512_256_hw		        sha_512_256_hw_func
 
+//-- Merkle tree (mmap'd file, leaves over the SHA-2/SHA-3 cores)
+#define merkle_file_hw              merkle_file_hw
+#define merkle_buffer_hw            merkle_buffer_hw
+#define merkle_leaf                 merkle_leaf
+#define merkle_proof                merkle_proof
+#define merkle_verify               merkle_verify
+#define merkle_free                 merkle_free
+
+//-- HW/SW auto-dispatch (calibrated crossover, see dispatch_set_policy)
+#define sha3_256_auto               sha3_256_auto_func
+#define sha3_512_auto               sha3_512_auto_func
+#define shake_128_auto              shake128_auto_func
+#define shake_256_auto              shake256_auto_func
+#define sha_256_auto                sha_256_auto_func
+#define sha_384_auto                sha_384_auto_func
+#define sha_512_auto                sha_512_auto_func
+#define sha_512_256_auto            sha_512_256_auto_func
+#define cshake_128_auto             cshake128_auto_func
+#define cshake_256_auto             cshake256_auto_func
+#define kmac_128_auto               kmac128_auto_func
+#define kmac_256_auto               kmac256_auto_func
+#define kmacxof_128_auto            kmacxof128_auto_func
+#define kmacxof_256_auto            kmacxof256_auto_func
+
+//-- ML-KEM with queue-depth diversion to the host (see dispatch_mlkem_set_limits)
+#define mlkem512_genkeys_auto       mlkem_512_gen_keys_auto
+#define mlkem768_genkeys_auto       mlkem_768_gen_keys_auto
+#define mlkem1024_genkeys_auto      mlkem_1024_gen_keys_auto
+#define mlkem512_enc_auto           mlkem_512_enc_auto
+#define mlkem768_enc_auto           mlkem_768_enc_auto
+#define mlkem1024_enc_auto          mlkem_1024_enc_auto
+#define mlkem512_dec_auto           mlkem_512_dec_auto
+#define mlkem768_dec_auto           mlkem_768_dec_auto
+#define mlkem1024_dec_auto          mlkem_1024_dec_auto
+#define mlkem512_genkeys_sw         mlkem_512_gen_keys_sw
+#define mlkem768_genkeys_sw         mlkem_768_gen_keys_sw
+#define mlkem1024_genkeys_sw        mlkem_1024_gen_keys_sw
+#define mlkem512_enc_sw             mlkem_512_enc_sw
+#define mlkem768_enc_sw             mlkem_768_enc_sw
+#define mlkem1024_enc_sw            mlkem_1024_enc_sw
+#define mlkem512_dec_sw             mlkem_512_dec_sw
+#define mlkem768_dec_sw             mlkem_768_dec_sw
+#define mlkem1024_dec_sw            mlkem_1024_dec_sw
+
+//-- Verification / static-DH memoization (see memo_init)
+#define eddsa25519_verify_memo      eddsa25519_verify_memo
+#define x25519_ss_gen_memo          x25519_ss_gen_memo
+
+//-- Ephemeral key-pair pools (see kpool_init)
+#define x25519_genkeys_pool         x25519_genkeys_pool
+#define mlkem512_genkeys_pool       mlkem_512_gen_keys_pool
+#define mlkem768_genkeys_pool       mlkem_768_gen_keys_pool
+#define mlkem1024_genkeys_pool      mlkem_1024_gen_keys_pool
+
+//-- Hybrid X25519MLKEM768 (draft-ietf-tls-ecdhe-mlkem)
+#define x25519mlkem768_genkeys_hw   x25519mlkem768_gen_keys_hw
+#define x25519mlkem768_enc_hw       x25519mlkem768_enc_hw
+#define x25519mlkem768_dec_hw       x25519mlkem768_dec_hw
+
 //-- EdDSA25519
 #define eddsa25519_genkeys_hw       eddsa25519_genkeys_hw
 #define eddsa25519_sign_hw          eddsa25519_sign_hw
+#define eddsa25519_genkeys_hw_buf   eddsa25519_genkeys_hw_buf
+#define eddsa25519_sign_hw_buf      eddsa25519_sign_hw_buf
 #define eddsa25519_verify_hw        eddsa25519_verify_hw
+#define eddsa25519_verify_hw_buf    eddsa25519_verify_hw_buf
+#define eddsa25519_sign_hw_cb       eddsa25519_sign_hw_cb
+#define eddsa25519_verify_hw_cb     eddsa25519_verify_hw_cb
+#define eddsa25519ph_sign_hw        eddsa25519ph_sign_hw
+#define eddsa25519_sign_key_hw      eddsa25519_sign_key_hw
+#define eddsa25519_sign_key_hw_cb   eddsa25519_sign_key_hw_cb
+#define eddsa25519ph_verify_hw      eddsa25519ph_verify_hw
+#define eddsa25519_pubkey_sw        eddsa25519_pubkey_sw
+#define eddsa25519_sign_sw          eddsa25519_sign_sw
+#define eddsa25519_verify_sw        eddsa25519_verify_sw
+#define eddsa25519_verify_batch     eddsa25519_verify_batch
+#define eddsa25519_verify_batch_sw  eddsa25519_verify_batch_sw
 
 //-- X25519
 #define x25519_genkeys_hw           x25519_genkeys_hw
 #define x25519_ss_gen_hw            x25519_ss_gen_hw
+#define x25519_genkeys_hw_buf       x25519_genkeys_hw_buf
+#define x25519_ss_gen_hw_buf        x25519_ss_gen_hw_buf
 
 //-- TRNG
 #define trng_hw        			    trng_hw
+#define trng_pool_get               trng_pool_get
+#define trng_health_startup         trng_health_startup
+
+//-- SP 800-90A DRBGs (per-thread instances, see drbg.h)
+#define ctr_drbg_hw                 ctr_drbg_hw
+#define hash_drbg_hw                hash_drbg_hw
 
 //-- AES-128/192/256-ECB
 #define aes_128_ecb_encrypt_hw      aes_128_ecb_encrypt_hw
@@ -148,6 +295,17 @@
 #define mlkem1024_dec_hw            mlkem_1024_dec_hw
 #define mlkem_dec_hw                mlkem_dec_hw     
 
+#define mlkem512_enc_batch_hw       mlkem_512_enc_batch_hw
+#define mlkem768_enc_batch_hw       mlkem_768_enc_batch_hw
+#define mlkem1024_enc_batch_hw      mlkem_1024_enc_batch_hw
+#define mlkem512_dec_batch_hw       mlkem_512_dec_batch_hw
+#define mlkem768_dec_batch_hw       mlkem_768_dec_batch_hw
+#define mlkem1024_dec_batch_hw      mlkem_1024_dec_batch_hw
+
+#define mlkem_ek_handle_init        mlkem_ek_handle_init
+#define mlkem_ek_handle_clear       mlkem_ek_handle_clear
+#define mlkem_enc_hw_handle         mlkem_enc_hw_handle
+
 //-- INTERFACE
 #ifdef I2C
     #define INTF_ADDRESS            0x1A            //-- I2C_DEVICE_ADDRESS
@@ -99,7 +99,8 @@ module I2C_QUBIP #(
                    parameter IMP_X25519           = 1,      //-- Implement X25519
                    parameter IMP_TRNG             = 1,      //-- Implement TRNG
                    parameter IMP_AES              = 1,      //-- Implement AES
-                   parameter IMP_MLKEM            = 1       //-- Implement MLKEM
+                   parameter IMP_MLKEM            = 1,      //-- Implement MLKEM
+                   parameter PARALLEL_CORES       = 0       //-- Keep X25519/MLKEM running while deselected
 				   ) 
 				   (
 					input wire clk,           //-- Clock Signal
@@ -166,7 +167,8 @@ module I2C_QUBIP #(
                .IMP_X25519(IMP_X25519),
                .IMP_TRNG(IMP_TRNG),
                .IMP_AES(IMP_AES),
-               .IMP_MLKEM(IMP_MLKEM)
+               .IMP_MLKEM(IMP_MLKEM),
+               .PARALLEL_CORES(PARALLEL_CORES)
                )
                
                SE_QUBIP
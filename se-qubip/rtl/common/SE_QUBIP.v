@@ -67,7 +67,8 @@ module SE_QUBIP #(
                   parameter IMP_X25519    = 1,
                   parameter IMP_TRNG      = 1,
                   parameter IMP_AES       = 1,
-                  parameter IMP_MLKEM     = 1
+                  parameter IMP_MLKEM     = 1,
+                  parameter PARALLEL_CORES = 0     //-- Keep X25519/MLKEM running while another module is addressed
                   )
                   (
                    input  wire i_clk,
@@ -261,6 +262,67 @@ module SE_QUBIP #(
         
     endgenerate
         
+    // --- PARALLEL CORES --- //
+    //-- By default a module is held in reset while it is not addressed. With PARALLEL_CORES
+    //-- the X25519 and MLKEM cores only see the global reset and keep the last control,
+    //-- address and data they were given, so one can compute while the other is driven.
+    
+    reg [31:0] control_x25519_reg;
+    reg [63:0] add_x25519_reg;
+    reg [63:0] data_in_x25519_reg;
+    reg [31:0] control_mlkem_reg;
+    reg [63:0] add_mlkem_reg;
+    reg [63:0] data_in_mlkem_reg;
+    
+    always @(posedge i_clk) begin
+        if(!i_rst) begin
+            control_x25519_reg  <= 0;
+            add_x25519_reg      <= 0;
+            data_in_x25519_reg  <= 0;
+        end
+        else if(sel_x25519) begin
+            control_x25519_reg  <= control_module;
+            add_x25519_reg      <= i_add;
+            data_in_x25519_reg  <= i_data_in;
+        end
+    end
+    
+    always @(posedge i_clk) begin
+        if(!i_rst) begin
+            control_mlkem_reg   <= 0;
+            add_mlkem_reg       <= 0;
+            data_in_mlkem_reg   <= 0;
+        end
+        else if(sel_mlkem) begin
+            control_mlkem_reg   <= control_module;
+            add_mlkem_reg       <= i_add;
+            data_in_mlkem_reg   <= i_data_in;
+        end
+    end
+    
+    wire        hold_x25519;
+    wire        hold_mlkem;
+    assign hold_x25519 = PARALLEL_CORES & !sel_x25519;
+    assign hold_mlkem  = PARALLEL_CORES & !sel_mlkem;
+    
+    wire        rst_x25519;
+    wire [31:0] control_x25519;
+    wire [63:0] add_x25519;
+    wire [63:0] data_in_x25519;
+    assign rst_x25519       = (PARALLEL_CORES)  ? i_rst                 : (i_rst & sel_x25519);
+    assign control_x25519   = (hold_x25519)     ? control_x25519_reg    : control_module;
+    assign add_x25519       = (hold_x25519)     ? add_x25519_reg        : i_add;
+    assign data_in_x25519   = (hold_x25519)     ? data_in_x25519_reg    : i_data_in;
+    
+    wire        rst_mlkem;
+    wire [31:0] control_mlkem;
+    wire [63:0] add_mlkem;
+    wire [63:0] data_in_mlkem;
+    assign rst_mlkem        = (PARALLEL_CORES)  ? i_rst                 : (i_rst & sel_mlkem);
+    assign control_mlkem    = (hold_mlkem)      ? control_mlkem_reg     : control_module;
+    assign add_mlkem        = (hold_mlkem)      ? add_mlkem_reg         : i_add;
+    assign data_in_mlkem    = (hold_mlkem)      ? data_in_mlkem_reg     : i_data_in;
+    
     // --- X25519 DEFINITION --- //
     generate 
         if(IMP_X25519) begin
@@ -269,10 +331,10 @@ module SE_QUBIP #(
             x25519_xl
             (
                 .clk(i_clk),
-                .i_rst(i_rst & sel_x25519),
-                .data_in(i_data_in),
-                .address(i_add),
-                .control(control_module[3:0]),
+                .i_rst(rst_x25519),
+                .data_in(data_in_x25519),
+                .address(add_x25519),
+                .control(control_x25519[3:0]),
                 .data_out(o_data_out_x25519),
                 .end_op(o_end_op_x25519)
             );
@@ -283,10 +345,10 @@ module SE_QUBIP #(
             x25519_xl
             (
                 .i_clk(i_clk),
-                .i_rst(i_rst & sel_x25519),
-                .i_data_in(i_data_in),
-                .i_add(i_add),
-                .i_control(control_module),
+                .i_rst(rst_x25519),
+                .i_data_in(data_in_x25519),
+                .i_add(add_x25519),
+                .i_control(control_x25519),
                 .o_data_out(o_data_out_x25519),
                 .o_end_op(o_end_op_x25519)
             );
@@ -369,10 +431,10 @@ module SE_QUBIP #(
             TOP_MLKEM 
             mlkem_xl
             (   .clk(i_clk), 
-                .rst(i_rst & sel_mlkem), 
-                .data_in(i_data_in),
-                .add(i_add[15:0]),
-                .control(control_module[7:0]),
+                .rst(rst_mlkem), 
+                .data_in(data_in_mlkem),
+                .add(add_mlkem[15:0]),
+                .control(control_mlkem[7:0]),
                 .end_op(o_end_op_mlkem),
                 .data_out(o_data_out_mlkem)
             );
@@ -383,10 +445,10 @@ module SE_QUBIP #(
             mlkem_xl
             (
                 .i_clk(i_clk),
-                .i_rst(i_rst & sel_mlkem),
-                .i_data_in(i_data_in),
-                .i_add(i_add),
-                .i_control(control_module),
+                .i_rst(rst_mlkem),
+                .i_data_in(data_in_mlkem),
+                .i_add(add_mlkem),
+                .i_control(control_mlkem),
                 .o_data_out(o_data_out_mlkem),
                 .o_end_op(o_end_op_mlkem)
             );
@@ -11,6 +11,7 @@
         parameter integer IMP_TRNG            = 1,
         parameter integer IMP_AES             = 1,
         parameter integer IMP_MLKEM           = 1,
+        parameter integer PARALLEL_CORES      = 0,
         // I2C Parameters
         parameter integer IMP_I2C             = 1,
         parameter [6:0] DEVICE_ADDRESS        = 7'h1A,
@@ -63,6 +64,7 @@
         .IMP_TRNG(IMP_TRNG),
         .IMP_AES(IMP_AES),
         .IMP_MLKEM(IMP_MLKEM),
+        .PARALLEL_CORES(PARALLEL_CORES),
         .IMP_I2C(IMP_I2C),
         .DEVICE_ADDRESS(DEVICE_ADDRESS),		
 		.C_S_AXI_DATA_WIDTH(C_S00_AXI_DATA_WIDTH),
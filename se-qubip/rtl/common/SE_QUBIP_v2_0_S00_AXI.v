@@ -11,6 +11,7 @@
         parameter integer IMP_TRNG            = 1,  
         parameter integer IMP_AES             = 1, 
         parameter integer IMP_MLKEM           = 1, 
+        parameter integer PARALLEL_CORES      = 0, 
         // I2C Parameters
         parameter integer IMP_I2C             = 1,                         
         parameter [6:0] DEVICE_ADDRESS        = 7'h1A,
@@ -452,6 +453,7 @@
                     .IMP_TRNG(IMP_TRNG),
                     .IMP_AES(IMP_AES),
                     .IMP_MLKEM(IMP_MLKEM),
+                    .PARALLEL_CORES(PARALLEL_CORES),
                     .DEVICE_ADDRESS(DEVICE_ADDRESS)
                     )
                     I2C_QUBIP
@@ -471,7 +473,8 @@
                    .IMP_X25519(IMP_X25519),
                    .IMP_TRNG(IMP_TRNG),
                    .IMP_AES(IMP_AES),
-                   .IMP_MLKEM(IMP_MLKEM)
+                   .IMP_MLKEM(IMP_MLKEM),
+                   .PARALLEL_CORES(PARALLEL_CORES)
                    )
                    SE_QUBIP
                    (
@@ -74,6 +74,23 @@
 
 #include "aes_hw.h"
 
+//-- ADDITIONAL FUCNTIONS
+static void aes_block_padding(unsigned int len, unsigned int *complete_len, unsigned int *blocks);
+static void aes_block_load(unsigned char *block, unsigned char *data, unsigned int len, unsigned int offset);
+static void cmacMul(uint8_t* x, const uint8_t* a, size_t n, uint8_t rb);
+static void GenSubKeys(unsigned char* key, unsigned int key_len, unsigned char K1[AES_BLOCK], unsigned char K2[AES_BLOCK], INTF interface);
+static void ccmFormatBlock0(size_t q, const uint8_t *n, size_t nLen, size_t aLen, size_t tLen, uint8_t *b);
+static void ccmXorBlock(uint8_t *x, const uint8_t *a, const uint8_t *b, size_t n);
+static void ccmFormatCounter0(const uint8_t *n, size_t nLen, uint8_t *ctr);
+static void ccmIncCounter(uint8_t *ctr, size_t n);
+static void gf_mult(const unsigned char *x, const unsigned char *y, unsigned char *z);
+static void ghash(const unsigned char *h, const unsigned char *x, size_t xlen, unsigned char *y);
+static void aes_gctr(const unsigned char *icb, const unsigned char *x, size_t xlen, unsigned char *y, INTF interface);
+static void aes_gcm_init_hash_key(unsigned long long aes_control, unsigned char *key, size_t key_len, unsigned char *H, INTF interface);
+static void aes_gcm_prepare_j0(unsigned char *iv, size_t iv_len, unsigned char *H, unsigned char *J0);
+static void aes_gcm_gctr(const unsigned char *J0, const unsigned char *in, size_t len, unsigned char *out, INTF interface);
+static void aes_gcm_ghash(const unsigned char *H, const unsigned char *aad, size_t aad_len, const unsigned char *crypt, size_t crypt_len, unsigned char *S);
+
 /////////////////////////////////////////////////////////////////////////////////////////////
 // INTERFACE INIT/START & READ/WRITE & INIT/OPERATE
 /////////////////////////////////////////////////////////////////////////////////////////////
@@ -147,8 +164,35 @@ void aes_init(unsigned long long aes_control, unsigned char *key, INTF interface
     aes_write(AES_KEY, AES_256_KEY / AXI_BYTES, key_256, AES_RST_ON, interface);
 }
 
-void aes_op(unsigned char *data_in, unsigned char *data_out, INTF interface)
+//-- Reset the core and report err: returns the status recorded
+static int aes_abort(int err, INTF interface)
+{
+    unsigned long long info = (ADD_AES << 32) + AES_INTF_RST + AES_RST_ON;
+
+    write_INTF(interface, &info, CONTROL, AXI_BYTES);
+
+    return intf_core_fault(interface, SE_CORE_AES, err);
+}
+
+//-- SE_OK, or SE_ERR_TIMEOUT / SE_ERR_DEADLINE with the core reset and data_out
+//-- wiped. Once the core has faulted, or a block would end past the caller's
+//-- deadline, the remaining blocks of the operation are not sent to it.
+int aes_op(unsigned char *data_in, unsigned char *data_out, INTF interface)
 {   
+    int ret;
+
+    if (intf_core_faulted(interface, SE_CORE_AES))
+    {
+        memset(data_out, 0, AES_BLOCK);
+        return intf_status(interface);
+    }
+
+    if (intf_core_admit(interface, SE_CORE_AES, 1) != SE_OK)
+    {
+        memset(data_out, 0, AES_BLOCK);
+        return aes_abort(SE_ERR_DEADLINE, interface);
+    }
+
     //-- Write Input Data
     unsigned char data_in_swap[AES_BLOCK];
     memcpy(data_in_swap, data_in, AES_BLOCK);
@@ -156,43 +200,67 @@ void aes_op(unsigned char *data_in, unsigned char *data_out, INTF interface)
     aes_write(AES_PLAINTEXT, AES_BLOCK / AXI_BYTES, data_in_swap, AES_RST_ON, interface);
 
     //-- Control Signals
-    unsigned long long count = 0;
+    unsigned long long limit;
     unsigned long long info  = 0;
     
     //-- Start Execution
     aes_start(interface);
 
     //-- Detect when finish
-    while (count < AES_WAIT_TIME)
+    limit = intf_wait_limit(interface, AES_WAIT_TIME);
+    do
     {
         read_INTF(interface, &info, END_OP, AXI_BYTES);
+    } while (!(info & 0x1) && intf_clock_ns() < limit);
 
-        if (info & 0x1)
-            break;
+    if (!(info & 0x1))
+    {
+        ret = aes_abort(SE_ERR_TIMEOUT, interface);
+        if (ret == SE_ERR_TIMEOUT) printf("AES FAIL!: TIMEOUT \t%d us\n", AES_WAIT_TIME);
 
-        count++;
+        memset(data_out, 0, AES_BLOCK);
+        return ret;
     }
 
-    if (count == AES_WAIT_TIME)
-        printf("AES FAIL!: TIMEOUT \t%lld\n", count);
-
     //-- Read Output Data
     aes_read(AES_CIPHERTEXT, AES_BLOCK / AXI_BYTES, data_out, interface);
     swapEndianness(data_out, AES_BLOCK);
+
+    return SE_OK;
+}
+
+//-- Ends an operation and releases the core: SE_OK, or the status of the block
+//-- that faulted with every output wiped (and *result set to a failed check)
+static int aes_end(unsigned char *out, unsigned int out_len, unsigned char *tag, unsigned int tag_len, unsigned int *result, INTF interface)
+{
+    int ret = intf_core_faulted(interface, SE_CORE_AES) ? intf_status(interface) : SE_OK;
+
+    if (ret != SE_OK)
+    {
+        memset(out, 0, out_len);
+        if (tag != NULL)    memset(tag, 0, tag_len);
+        if (result != NULL) *result = 1;
+    }
+
+    intf_core_unlock(interface, SE_CORE_AES);
+
+    return ret;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // ADDITIONAL FUNCTIONS
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-static void aes_block_padding(unsigned int len, unsigned int *complete_len, unsigned int *blocks, unsigned char *data, unsigned char **data_padded)
+static void aes_block_padding(unsigned int len, unsigned int *complete_len, unsigned int *blocks)
 {
     *blocks = (len + AES_BLOCK - 1) / AES_BLOCK; 
     *complete_len = *blocks * AES_BLOCK;
-    
-    *data_padded =  malloc(*complete_len);
-    memset(*data_padded, 0, *complete_len);
-    memcpy(*data_padded, data, len);
+}
+
+//-- Block at offset of data, zero-padded past len (no padded copy of the whole input)
+static void aes_block_load(unsigned char *block, unsigned char *data, unsigned int len, unsigned int offset)
+{
+    pack_block(block, data + offset, (offset < len) ? len - offset : 0, AES_BLOCK);
 }
 
 //-- CMAC
@@ -589,13 +657,15 @@ static void aes_gcm_ghash(const unsigned char *H, const unsigned char *aad, size
 // AES-128-ECB
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void aes_128_ecb_encrypt_hw(unsigned char *key, unsigned char *ciphertext, unsigned int *ciphertext_len, unsigned char *plaintext, unsigned int plaintext_len, INTF interface)
+int aes_128_ecb_encrypt_hw(unsigned char *key, unsigned char *ciphertext, unsigned int *ciphertext_len, unsigned char *plaintext, unsigned int plaintext_len, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int plaintext_blocks;
-    unsigned char *plaintext_padded;
+    unsigned char block[AES_BLOCK];
 
-    aes_block_padding(plaintext_len, ciphertext_len, &plaintext_blocks, plaintext, &plaintext_padded);
+    aes_block_padding(plaintext_len, ciphertext_len, &plaintext_blocks);
 
     /*printf("\nplaintext_padded = 0x");
     for (int i = 0; i < AES_BLOCK * plaintext_blocks; i++) printf("%02x", plaintext_padded[i]); printf("\n");*/
@@ -608,20 +678,25 @@ void aes_128_ecb_encrypt_hw(unsigned char *key, unsigned char *ciphertext, unsig
     //-- START AES Operation
     for (int i = 0; i < plaintext_blocks; i++)
     {   
-        aes_op(plaintext_padded + i * AES_BLOCK, ciphertext + i * AES_BLOCK, interface);
+        aes_block_load(block, plaintext, plaintext_len, i * AES_BLOCK);
+        aes_op(block, ciphertext + i * AES_BLOCK, interface);
         /*printf("ciphertext = 0x");
         for (int j = 0; j < AES_BLOCK; j++) printf("%02x", ciphertext[i * AES_BLOCK + j]); printf("\n");*/
     }
     // printf("\nciphertext = %s\n", ciphertext);
+
+    return aes_end(ciphertext, *ciphertext_len, NULL, 0, NULL, interface);
 }
 
-void aes_128_ecb_decrypt_hw(unsigned char *key, unsigned char *ciphertext, unsigned int ciphertext_len, unsigned char *plaintext, unsigned int *plaintext_len, INTF interface)
+int aes_128_ecb_decrypt_hw(unsigned char *key, unsigned char *ciphertext, unsigned int ciphertext_len, unsigned char *plaintext, unsigned int *plaintext_len, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int ciphertext_blocks;
-    unsigned char *ciphertext_padded;
+    unsigned char block[AES_BLOCK];
 
-    aes_block_padding(ciphertext_len, plaintext_len, &ciphertext_blocks, ciphertext, &ciphertext_padded);
+    aes_block_padding(ciphertext_len, plaintext_len, &ciphertext_blocks);
 
     /*printf("\nciphertext_padded = 0x");
     for (int i = 0; i < ciphertext_blocks; i++) printf("%02x", ciphertext_padded[i]); printf("\n");*/
@@ -634,24 +709,29 @@ void aes_128_ecb_decrypt_hw(unsigned char *key, unsigned char *ciphertext, unsig
     //-- START AES Operation
     for (int i = 0; i < ciphertext_blocks; i++)
     { 
-        aes_op(ciphertext_padded + i * AES_BLOCK, plaintext + i * AES_BLOCK, interface);
+        aes_block_load(block, ciphertext, ciphertext_len, i * AES_BLOCK);
+        aes_op(block, plaintext + i * AES_BLOCK, interface);
         /*printf("plaintext = 0x");
         for (int j = 0; j < AES_BLOCK; j++) printf("%02x", plaintext[i * AES_BLOCK + j]); printf("\n");*/
     }
     // printf("\nplaintext = %s\n", ciphertext);
+
+    return aes_end(plaintext, *plaintext_len, NULL, 0, NULL, interface);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // AES-192-ECB
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void aes_192_ecb_encrypt_hw(unsigned char *key, unsigned char *ciphertext, unsigned int *ciphertext_len, unsigned char *plaintext, unsigned int plaintext_len, INTF interface)
+int aes_192_ecb_encrypt_hw(unsigned char *key, unsigned char *ciphertext, unsigned int *ciphertext_len, unsigned char *plaintext, unsigned int plaintext_len, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int plaintext_blocks;
-    unsigned char *plaintext_padded;
+    unsigned char block[AES_BLOCK];
 
-    aes_block_padding(plaintext_len, ciphertext_len, &plaintext_blocks, plaintext, &plaintext_padded);
+    aes_block_padding(plaintext_len, ciphertext_len, &plaintext_blocks);
 
     /*printf("\nplaintext_padded = 0x");
     for (int i = 0; i < AES_BLOCK * plaintext_blocks; i++) printf("%02x", plaintext_padded[i]); printf("\n");*/
@@ -664,20 +744,25 @@ void aes_192_ecb_encrypt_hw(unsigned char *key, unsigned char *ciphertext, unsig
     //-- START AES Operation
     for (int i = 0; i < plaintext_blocks; i++)
     {
-        aes_op(plaintext_padded + i * AES_BLOCK, ciphertext + i * AES_BLOCK, interface);
+        aes_block_load(block, plaintext, plaintext_len, i * AES_BLOCK);
+        aes_op(block, ciphertext + i * AES_BLOCK, interface);
         /*printf("ciphertext = 0x");
         for (int j = 0; j < AES_BLOCK; j++) printf("%02x", ciphertext[i * AES_BLOCK + j]); printf("\n");*/
     }
     // printf("\nciphertext = %s\n", ciphertext);
+
+    return aes_end(ciphertext, *ciphertext_len, NULL, 0, NULL, interface);
 }
 
-void aes_192_ecb_decrypt_hw(unsigned char *key, unsigned char *ciphertext, unsigned int ciphertext_len, unsigned char *plaintext, unsigned int *plaintext_len, INTF interface)
+int aes_192_ecb_decrypt_hw(unsigned char *key, unsigned char *ciphertext, unsigned int ciphertext_len, unsigned char *plaintext, unsigned int *plaintext_len, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int ciphertext_blocks;
-    unsigned char *ciphertext_padded;
+    unsigned char block[AES_BLOCK];
 
-    aes_block_padding(ciphertext_len, plaintext_len, &ciphertext_blocks, ciphertext, &ciphertext_padded);
+    aes_block_padding(ciphertext_len, plaintext_len, &ciphertext_blocks);
 
     /*printf("\nciphertext_padded = 0x");
     for (int i = 0; i < ciphertext_blocks; i++) printf("%02x", ciphertext_padded[i]); printf("\n");*/
@@ -690,24 +775,29 @@ void aes_192_ecb_decrypt_hw(unsigned char *key, unsigned char *ciphertext, unsig
     //-- START AES Operation
     for (int i = 0; i < ciphertext_blocks; i++)
     {
-        aes_op(ciphertext_padded + i * AES_BLOCK, plaintext + i * AES_BLOCK, interface);
+        aes_block_load(block, ciphertext, ciphertext_len, i * AES_BLOCK);
+        aes_op(block, plaintext + i * AES_BLOCK, interface);
         /*printf("plaintext = 0x");
         for (int j = 0; j < AES_BLOCK; j++) printf("%02x", plaintext[i * AES_BLOCK + j]); printf("\n");*/
     }
     // printf("\nplaintext = %s\n", ciphertext);
+
+    return aes_end(plaintext, *plaintext_len, NULL, 0, NULL, interface);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // AES-256-ECB
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void aes_256_ecb_encrypt_hw(unsigned char *key, unsigned char *ciphertext, unsigned int *ciphertext_len, unsigned char *plaintext, unsigned int plaintext_len, INTF interface)
+int aes_256_ecb_encrypt_hw(unsigned char *key, unsigned char *ciphertext, unsigned int *ciphertext_len, unsigned char *plaintext, unsigned int plaintext_len, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int plaintext_blocks;
-    unsigned char *plaintext_padded;
+    unsigned char block[AES_BLOCK];
 
-    aes_block_padding(plaintext_len, ciphertext_len, &plaintext_blocks, plaintext, &plaintext_padded);
+    aes_block_padding(plaintext_len, ciphertext_len, &plaintext_blocks);
 
     /*printf("\nplaintext_padded = 0x");
     for (int i = 0; i < AES_BLOCK * plaintext_blocks; i++) printf("%02x", plaintext_padded[i]); printf("\n");*/
@@ -720,20 +810,25 @@ void aes_256_ecb_encrypt_hw(unsigned char *key, unsigned char *ciphertext, unsig
     //-- START AES Operation
     for (int i = 0; i < plaintext_blocks; i++)
     {
-        aes_op(plaintext_padded + i * AES_BLOCK, ciphertext + i * AES_BLOCK, interface);
+        aes_block_load(block, plaintext, plaintext_len, i * AES_BLOCK);
+        aes_op(block, ciphertext + i * AES_BLOCK, interface);
         /*printf("ciphertext = 0x");
         for (int j = 0; j < AES_BLOCK; j++) printf("%02x", ciphertext[i * AES_BLOCK + j]); printf("\n");*/
     }
     // printf("\nciphertext = %s\n", ciphertext);
+
+    return aes_end(ciphertext, *ciphertext_len, NULL, 0, NULL, interface);
 }
 
-void aes_256_ecb_decrypt_hw(unsigned char *key, unsigned char *ciphertext, unsigned int ciphertext_len, unsigned char *plaintext, unsigned int *plaintext_len, INTF interface)
+int aes_256_ecb_decrypt_hw(unsigned char *key, unsigned char *ciphertext, unsigned int ciphertext_len, unsigned char *plaintext, unsigned int *plaintext_len, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int ciphertext_blocks;
-    unsigned char *ciphertext_padded;
+    unsigned char block[AES_BLOCK];
 
-    aes_block_padding(ciphertext_len, plaintext_len, &ciphertext_blocks, ciphertext, &ciphertext_padded);
+    aes_block_padding(ciphertext_len, plaintext_len, &ciphertext_blocks);
 
     /*printf("\nciphertext_padded = 0x");
     for (int i = 0; i < ciphertext_blocks; i++) printf("%02x", ciphertext_padded[i]); printf("\n");*/
@@ -746,24 +841,28 @@ void aes_256_ecb_decrypt_hw(unsigned char *key, unsigned char *ciphertext, unsig
     //-- START AES Operation
     for (int i = 0; i < ciphertext_blocks; i++)
     {
-        aes_op(ciphertext_padded + i * AES_BLOCK, plaintext + i * AES_BLOCK, interface);
+        aes_block_load(block, ciphertext, ciphertext_len, i * AES_BLOCK);
+        aes_op(block, plaintext + i * AES_BLOCK, interface);
         /*printf("plaintext = 0x");
         for (int j = 0; j < AES_BLOCK; j++) printf("%02x", plaintext[i * AES_BLOCK + j]); printf("\n");*/
     }
     // printf("\nplaintext = %s\n", ciphertext);
+
+    return aes_end(plaintext, *plaintext_len, NULL, 0, NULL, interface);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // AES-128-CBC
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void aes_128_cbc_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned char *ciphertext, unsigned int *ciphertext_len, unsigned char *plaintext, unsigned int plaintext_len, INTF interface)
+int aes_128_cbc_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned char *ciphertext, unsigned int *ciphertext_len, unsigned char *plaintext, unsigned int plaintext_len, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int plaintext_blocks;
-    unsigned char *plaintext_padded;
 
-    aes_block_padding(plaintext_len, ciphertext_len, &plaintext_blocks, plaintext, &plaintext_padded);
+    aes_block_padding(plaintext_len, ciphertext_len, &plaintext_blocks);
 
     //-- Plaintext/Ciphertext
     unsigned char p[AES_BLOCK];
@@ -784,7 +883,7 @@ void aes_128_cbc_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned char
     //-- Start loop
     while (len < plaintext_len)
     {
-        memcpy(p, plaintext_padded + len, AES_BLOCK);
+        aes_block_load(p, plaintext, plaintext_len, len);
 
         for (int i = 0; i < AES_BLOCK; i++)
         {
@@ -804,15 +903,18 @@ void aes_128_cbc_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned char
 
         memcpy(iv_block, c, AES_BLOCK);
     }
+
+    return aes_end(ciphertext, *ciphertext_len, NULL, 0, NULL, interface);
 }
 
-void aes_128_cbc_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned char *ciphertext, unsigned int ciphertext_len, unsigned char *plaintext, unsigned int *plaintext_len, INTF interface)
+int aes_128_cbc_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned char *ciphertext, unsigned int ciphertext_len, unsigned char *plaintext, unsigned int *plaintext_len, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int ciphertext_blocks;
-    unsigned char *ciphertext_padded;
 
-    aes_block_padding(ciphertext_len, plaintext_len, &ciphertext_blocks, ciphertext, &ciphertext_padded);
+    aes_block_padding(ciphertext_len, plaintext_len, &ciphertext_blocks);
 
     //-- Plaintext/Ciphertext
     unsigned char p[AES_BLOCK];
@@ -833,7 +935,7 @@ void aes_128_cbc_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned char
     //-- Start loop
     while (len < ciphertext_len)
     {
-        memcpy(c, ciphertext_padded + len, AES_BLOCK);
+        aes_block_load(c, ciphertext, ciphertext_len, len);
 
         //-- Decrypt current block
         aes_op(c, p, interface);
@@ -848,19 +950,22 @@ void aes_128_cbc_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned char
 
         memcpy(iv_block, c, AES_BLOCK);
     }
+
+    return aes_end(plaintext, *plaintext_len, NULL, 0, NULL, interface);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // AES-192-CBC
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void aes_192_cbc_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned char *ciphertext, unsigned int *ciphertext_len, unsigned char *plaintext, unsigned int plaintext_len, INTF interface)
+int aes_192_cbc_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned char *ciphertext, unsigned int *ciphertext_len, unsigned char *plaintext, unsigned int plaintext_len, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int plaintext_blocks;
-    unsigned char *plaintext_padded;
 
-    aes_block_padding(plaintext_len, ciphertext_len, &plaintext_blocks, plaintext, &plaintext_padded);
+    aes_block_padding(plaintext_len, ciphertext_len, &plaintext_blocks);
 
     //-- Plaintext/Ciphertext
     unsigned char p[AES_BLOCK];
@@ -881,7 +986,7 @@ void aes_192_cbc_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned char
     //-- Start loop
     while (len < plaintext_len)
     {
-        memcpy(p, plaintext_padded + len, AES_BLOCK);
+        aes_block_load(p, plaintext, plaintext_len, len);
 
         for (int i = 0; i < AES_BLOCK; i++)
         {
@@ -901,15 +1006,18 @@ void aes_192_cbc_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned char
 
         memcpy(iv_block, c, AES_BLOCK);
     }
+
+    return aes_end(ciphertext, *ciphertext_len, NULL, 0, NULL, interface);
 }
 
-void aes_192_cbc_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned char *ciphertext, unsigned int ciphertext_len, unsigned char *plaintext, unsigned int *plaintext_len, INTF interface)
+int aes_192_cbc_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned char *ciphertext, unsigned int ciphertext_len, unsigned char *plaintext, unsigned int *plaintext_len, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int ciphertext_blocks;
-    unsigned char *ciphertext_padded;
 
-    aes_block_padding(ciphertext_len, plaintext_len, &ciphertext_blocks, ciphertext, &ciphertext_padded);
+    aes_block_padding(ciphertext_len, plaintext_len, &ciphertext_blocks);
 
     //-- Plaintext/Ciphertext
     unsigned char p[AES_BLOCK];
@@ -930,7 +1038,7 @@ void aes_192_cbc_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned char
     //-- Start loop
     while (len < ciphertext_len)
     {
-        memcpy(c, ciphertext_padded + len, AES_BLOCK);
+        aes_block_load(c, ciphertext, ciphertext_len, len);
 
         //-- Decrypt current block
         aes_op(c, p, interface);
@@ -945,19 +1053,22 @@ void aes_192_cbc_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned char
 
         memcpy(iv_block, c, AES_BLOCK);
     }
+
+    return aes_end(plaintext, *plaintext_len, NULL, 0, NULL, interface);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // AES-256-CBC
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void aes_256_cbc_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned char *ciphertext, unsigned int *ciphertext_len, unsigned char *plaintext, unsigned int plaintext_len, INTF interface)
+int aes_256_cbc_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned char *ciphertext, unsigned int *ciphertext_len, unsigned char *plaintext, unsigned int plaintext_len, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int plaintext_blocks;
-    unsigned char *plaintext_padded;
 
-    aes_block_padding(plaintext_len, ciphertext_len, &plaintext_blocks, plaintext, &plaintext_padded);
+    aes_block_padding(plaintext_len, ciphertext_len, &plaintext_blocks);
 
     //-- Plaintext/Ciphertext
     unsigned char p[AES_BLOCK];
@@ -978,7 +1089,7 @@ void aes_256_cbc_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned char
     //-- Start loop
     while (len < plaintext_len)
     {
-        memcpy(p, plaintext_padded + len, AES_BLOCK);
+        aes_block_load(p, plaintext, plaintext_len, len);
 
         for (int i = 0; i < AES_BLOCK; i++)
         {
@@ -998,15 +1109,18 @@ void aes_256_cbc_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned char
 
         memcpy(iv_block, c, AES_BLOCK);
     }
+
+    return aes_end(ciphertext, *ciphertext_len, NULL, 0, NULL, interface);
 }
 
-void aes_256_cbc_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned char *ciphertext, unsigned int ciphertext_len, unsigned char *plaintext, unsigned int *plaintext_len, INTF interface)
+int aes_256_cbc_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned char *ciphertext, unsigned int ciphertext_len, unsigned char *plaintext, unsigned int *plaintext_len, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int ciphertext_blocks;
-    unsigned char *ciphertext_padded;
 
-    aes_block_padding(ciphertext_len, plaintext_len, &ciphertext_blocks, ciphertext, &ciphertext_padded);
+    aes_block_padding(ciphertext_len, plaintext_len, &ciphertext_blocks);
 
     //-- Plaintext/Ciphertext
     unsigned char p[AES_BLOCK];
@@ -1027,7 +1141,7 @@ void aes_256_cbc_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned char
     //-- Start loop
     while (len < ciphertext_len)
     {
-        memcpy(c, ciphertext_padded + len, AES_BLOCK);
+        aes_block_load(c, ciphertext, ciphertext_len, len);
 
         //-- Decrypt current block
         aes_op(c, p, interface);
@@ -1042,27 +1156,28 @@ void aes_256_cbc_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned char
 
         memcpy(iv_block, c, AES_BLOCK);
     }
+
+    return aes_end(plaintext, *plaintext_len, NULL, 0, NULL, interface);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // AES-128-CMAC
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void aes_128_cmac_hw(unsigned char *key, unsigned char *mac, unsigned int *mac_len, unsigned char *msg, unsigned int msg_len, INTF interface)
+int aes_128_cmac_hw(unsigned char *key, unsigned char *mac, unsigned int *mac_len, unsigned char *msg, unsigned int msg_len, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int complete_len;
     unsigned int msg_blocks;
-    unsigned char *msg_padded;
 
-    aes_block_padding(msg_len, &complete_len, &msg_blocks, msg, &msg_padded);
+    aes_block_padding(msg_len, &complete_len, &msg_blocks);
     
     //-- Complete Blocks Condition and missing bytes
     unsigned int missing_bytes = complete_len - msg_len;
     unsigned int complete_cond = (missing_bytes == 0) ? 1 : 0;
 
-    if (!complete_cond) msg_padded[msg_len] = 0x80;
-
     //-- Subkey Generation
     unsigned char K1[AES_BLOCK];
     unsigned char K2[AES_BLOCK];
@@ -1081,7 +1196,8 @@ void aes_128_cmac_hw(unsigned char *key, unsigned char *mac, unsigned int *mac_l
 
     for (int i = 0; i < msg_blocks; i++)
     {
-        memcpy(p, msg_padded + len, AES_BLOCK);
+        aes_block_load(p, msg, msg_len, len);
+        if (i == msg_blocks - 1 && !complete_cond) p[msg_len % AES_BLOCK] = 0x80;
 
         if (i < msg_blocks - 1)
         {
@@ -1117,27 +1233,28 @@ void aes_128_cmac_hw(unsigned char *key, unsigned char *mac, unsigned int *mac_l
         memcpy(xor_block, c, AES_BLOCK);
     }
     memcpy(mac, c, AES_BLOCK);
+
+    return aes_end(mac, AES_BLOCK, NULL, 0, NULL, interface);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // AES-192-CMAC
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void aes_192_cmac_hw(unsigned char *key, unsigned char *mac, unsigned int *mac_len, unsigned char *msg, unsigned int msg_len, INTF interface)
+int aes_192_cmac_hw(unsigned char *key, unsigned char *mac, unsigned int *mac_len, unsigned char *msg, unsigned int msg_len, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int complete_len;
     unsigned int msg_blocks;
-    unsigned char *msg_padded;
 
-    aes_block_padding(msg_len, &complete_len, &msg_blocks, msg, &msg_padded);
+    aes_block_padding(msg_len, &complete_len, &msg_blocks);
 
     //-- Complete Blocks Condition and missing bytes
     unsigned int missing_bytes = complete_len - msg_len;
     unsigned int complete_cond = (missing_bytes == 0) ? 1 : 0;
 
-    if (!complete_cond) msg_padded[msg_len] = 0x80;
-
     //-- Subkey Generation
     unsigned char K1[AES_BLOCK];
     unsigned char K2[AES_BLOCK];
@@ -1156,7 +1273,8 @@ void aes_192_cmac_hw(unsigned char *key, unsigned char *mac, unsigned int *mac_l
 
     for (int i = 0; i < msg_blocks; i++)
     {
-        memcpy(p, msg_padded + len, AES_BLOCK);
+        aes_block_load(p, msg, msg_len, len);
+        if (i == msg_blocks - 1 && !complete_cond) p[msg_len % AES_BLOCK] = 0x80;
 
         if (i < msg_blocks - 1)
         {
@@ -1192,27 +1310,28 @@ void aes_192_cmac_hw(unsigned char *key, unsigned char *mac, unsigned int *mac_l
         memcpy(xor_block, c, AES_BLOCK);
     }
     memcpy(mac, c, AES_BLOCK);
+
+    return aes_end(mac, AES_BLOCK, NULL, 0, NULL, interface);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // AES-256-CMAC
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void aes_256_cmac_hw(unsigned char *key, unsigned char *mac, unsigned int *mac_len, unsigned char *msg, unsigned int msg_len, INTF interface)
+int aes_256_cmac_hw(unsigned char *key, unsigned char *mac, unsigned int *mac_len, unsigned char *msg, unsigned int msg_len, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int complete_len;
     unsigned int msg_blocks;
-    unsigned char *msg_padded;
 
-    aes_block_padding(msg_len, &complete_len, &msg_blocks, msg, &msg_padded);
+    aes_block_padding(msg_len, &complete_len, &msg_blocks);
 
     //-- Complete Blocks Condition and missing bytes
     unsigned int missing_bytes = complete_len - msg_len;
     unsigned int complete_cond = (missing_bytes == 0) ? 1 : 0;
 
-    if (!complete_cond) msg_padded[msg_len] = 0x80;
-
     //-- Subkey Generation
     unsigned char K1[AES_BLOCK];
     unsigned char K2[AES_BLOCK];
@@ -1231,7 +1350,8 @@ void aes_256_cmac_hw(unsigned char *key, unsigned char *mac, unsigned int *mac_l
 
     for (int i = 0; i < msg_blocks; i++)
     {
-        memcpy(p, msg_padded + len, AES_BLOCK);
+        aes_block_load(p, msg, msg_len, len);
+        if (i == msg_blocks - 1 && !complete_cond) p[msg_len % AES_BLOCK] = 0x80;
 
         if (i < msg_blocks - 1)
         {
@@ -1267,21 +1387,24 @@ void aes_256_cmac_hw(unsigned char *key, unsigned char *mac, unsigned int *mac_l
         memcpy(xor_block, c, AES_BLOCK);
     }
     memcpy(mac, c, AES_BLOCK);
+
+    return aes_end(mac, AES_BLOCK, NULL, 0, NULL, interface);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // AES-128-CCM-8
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void aes_128_ccm_8_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int *ciphertext_len,
+int aes_128_ccm_8_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int *ciphertext_len,
                               unsigned char *plaintext, unsigned int plaintext_len, unsigned char *aad, unsigned int aad_len, unsigned char *tag, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int complete_len;
     unsigned int plaintext_blocks;
-    unsigned char *plaintext_padded;
 
-    aes_block_padding(plaintext_len, &complete_len, &plaintext_blocks, plaintext, &plaintext_padded);
+    aes_block_padding(plaintext_len, &complete_len, &plaintext_blocks);
 
     //-- INITIALIZATION: General/Interface Reset & Select Operation & Load Key
     unsigned long long aes_control = (AES_128 << 1) + AES_ENC;
@@ -1391,7 +1514,7 @@ void aes_128_ccm_8_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned in
     // ECB mode operates in a block-by-block fashion
     while (len < plaintext_len)
     {
-        memcpy(p, plaintext_padded + len, 16);
+        aes_block_load(p, plaintext, plaintext_len, len);
         ccmXorBlock(y, p, y, 16);
         // Encrypt current block
         aes_op(y, y ,interface);
@@ -1408,17 +1531,20 @@ void aes_128_ccm_8_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned in
     // Compute MAC
     ccmXorBlock(tag, tag, y, 8);
     *ciphertext_len = plaintext_len;
+
+    return aes_end(ciphertext, *ciphertext_len, tag, 8, NULL, interface);
 }
 
-void aes_128_ccm_8_decrypt_hw(unsigned char* key, unsigned char* iv, unsigned int iv_len, unsigned char* ciphertext, unsigned int ciphertext_len,
+int aes_128_ccm_8_decrypt_hw(unsigned char* key, unsigned char* iv, unsigned int iv_len, unsigned char* ciphertext, unsigned int ciphertext_len,
                               unsigned char* plaintext, unsigned int* plaintext_len, unsigned char* aad, unsigned int aad_len, unsigned char* tag, unsigned int* result, INTF interface) 
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int complete_len;
     unsigned int ciphertext_blocks;
-    unsigned char *ciphertext_padded;
 
-    aes_block_padding(ciphertext_len, &complete_len, &ciphertext_blocks, ciphertext, &ciphertext_padded);
+    aes_block_padding(ciphertext_len, &complete_len, &ciphertext_blocks);
 
     //-- INITIALIZATION: General/Interface Reset & Select Operation & Load Key
     unsigned long long aes_control = (AES_128 << 1) + AES_ENC;
@@ -1559,21 +1685,24 @@ void aes_128_ccm_8_decrypt_hw(unsigned char* key, unsigned char* iv, unsigned in
     else            *result = 1;
 
     *plaintext_len = ciphertext_len;
+
+    return aes_end(plaintext, *plaintext_len, NULL, 0, result, interface);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // AES-192-CCM-8
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void aes_192_ccm_8_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int *ciphertext_len,
+int aes_192_ccm_8_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int *ciphertext_len,
                               unsigned char *plaintext, unsigned int plaintext_len, unsigned char *aad, unsigned int aad_len, unsigned char *tag, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int complete_len;
     unsigned int plaintext_blocks;
-    unsigned char *plaintext_padded;
 
-    aes_block_padding(plaintext_len, &complete_len, &plaintext_blocks, plaintext, &plaintext_padded);
+    aes_block_padding(plaintext_len, &complete_len, &plaintext_blocks);
 
     //-- INITIALIZATION: General/Interface Reset & Select Operation & Load Key
     unsigned long long aes_control = (AES_192 << 1) + AES_ENC;
@@ -1683,7 +1812,7 @@ void aes_192_ccm_8_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned in
     // ECB mode operates in a block-by-block fashion
     while (len < plaintext_len)
     {
-        memcpy(p, plaintext_padded + len, 16);
+        aes_block_load(p, plaintext, plaintext_len, len);
         ccmXorBlock(y, p, y, 16);
         // Encrypt current block
         aes_op(y, y ,interface);
@@ -1700,17 +1829,20 @@ void aes_192_ccm_8_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned in
     // Compute MAC
     ccmXorBlock(tag, tag, y, 8);
     *ciphertext_len = plaintext_len;
+
+    return aes_end(ciphertext, *ciphertext_len, tag, 8, NULL, interface);
 }
 
-void aes_192_ccm_8_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int ciphertext_len,
+int aes_192_ccm_8_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int ciphertext_len,
                               unsigned char *plaintext, unsigned int *plaintext_len, unsigned char *aad, unsigned int aad_len, unsigned char *tag, unsigned int *result, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int complete_len;
     unsigned int ciphertext_blocks;
-    unsigned char *ciphertext_padded;
 
-    aes_block_padding(ciphertext_len, &complete_len, &ciphertext_blocks, ciphertext, &ciphertext_padded);
+    aes_block_padding(ciphertext_len, &complete_len, &ciphertext_blocks);
 
     //-- INITIALIZATION: General/Interface Reset & Select Operation & Load Key
     unsigned long long aes_control = (AES_192 << 1) + AES_ENC;
@@ -1853,21 +1985,24 @@ void aes_192_ccm_8_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned in
         *result = 1;
 
     *plaintext_len = ciphertext_len;
+
+    return aes_end(plaintext, *plaintext_len, NULL, 0, result, interface);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // AES-256-CCM-8
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void aes_256_ccm_8_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int *ciphertext_len,
+int aes_256_ccm_8_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int *ciphertext_len,
                               unsigned char *plaintext, unsigned int plaintext_len, unsigned char *aad, unsigned int aad_len, unsigned char *tag, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int complete_len;
     unsigned int plaintext_blocks;
-    unsigned char *plaintext_padded;
 
-    aes_block_padding(plaintext_len, &complete_len, &plaintext_blocks, plaintext, &plaintext_padded);
+    aes_block_padding(plaintext_len, &complete_len, &plaintext_blocks);
 
     //-- INITIALIZATION: General/Interface Reset & Select Operation & Load Key
     unsigned long long aes_control = (AES_256 << 1) + AES_ENC;
@@ -1977,7 +2112,7 @@ void aes_256_ccm_8_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned in
     // ECB mode operates in a block-by-block fashion
     while (len < plaintext_len)
     {
-        memcpy(p, plaintext_padded + len, 16);
+        aes_block_load(p, plaintext, plaintext_len, len);
         ccmXorBlock(y, p, y, 16);
         // Encrypt current block
         aes_op(y, y, interface);
@@ -1994,17 +2129,20 @@ void aes_256_ccm_8_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned in
     // Compute MAC
     ccmXorBlock(tag, tag, y, 8);
     *ciphertext_len = plaintext_len;
+
+    return aes_end(ciphertext, *ciphertext_len, tag, 8, NULL, interface);
 }
 
-void aes_256_ccm_8_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int ciphertext_len,
+int aes_256_ccm_8_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int ciphertext_len,
                               unsigned char *plaintext, unsigned int *plaintext_len, unsigned char *aad, unsigned int aad_len, unsigned char *tag, unsigned int *result, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
+
     //-- Number of Blocks and Padding
     unsigned int complete_len;
     unsigned int ciphertext_blocks;
-    unsigned char *ciphertext_padded;
 
-    aes_block_padding(ciphertext_len, &complete_len, &ciphertext_blocks, ciphertext, &ciphertext_padded);
+    aes_block_padding(ciphertext_len, &complete_len, &ciphertext_blocks);
 
     //-- INITIALIZATION: General/Interface Reset & Select Operation & Load Key
     unsigned long long aes_control = (AES_256 << 1) + AES_ENC;
@@ -2147,15 +2285,18 @@ void aes_256_ccm_8_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned in
         *result = 1;
 
     *plaintext_len = ciphertext_len;
+
+    return aes_end(plaintext, *plaintext_len, NULL, 0, result, interface);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // AES-128-GCM
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void aes_128_gcm_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int *ciphertext_len,
+int aes_128_gcm_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int *ciphertext_len,
                             unsigned char *plaintext, unsigned int plaintext_len, unsigned char *aad, unsigned int aad_len, unsigned char *tag, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
 
     unsigned char H[16];
     unsigned char J0[16];
@@ -2179,11 +2320,13 @@ void aes_128_gcm_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned int
     
     *ciphertext_len = plaintext_len;
 
+    return aes_end(ciphertext, *ciphertext_len, tag, AES_BLOCK, NULL, interface);
 }
 
-void aes_128_gcm_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int ciphertext_len,
+int aes_128_gcm_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int ciphertext_len,
                             unsigned char *plaintext, unsigned int *plaintext_len, unsigned char *aad, unsigned int aad_len, unsigned char *tag, unsigned int *result, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
 
     unsigned char H[16];
     unsigned char J0[16];
@@ -2207,16 +2350,18 @@ void aes_128_gcm_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned int
     *result = memcmp(tag, T, 16);
 
     *plaintext_len = ciphertext_len;
-  
+
+    return aes_end(plaintext, *plaintext_len, NULL, 0, result, interface);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // AES-192-GCM
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void aes_192_gcm_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int *ciphertext_len,
+int aes_192_gcm_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int *ciphertext_len,
                             unsigned char *plaintext, unsigned int plaintext_len, unsigned char *aad, unsigned int aad_len, unsigned char *tag, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
 
     unsigned char H[16];
     unsigned char J0[16];
@@ -2239,11 +2384,14 @@ void aes_192_gcm_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned int
     /* Return (C, T) */
 
     *ciphertext_len = plaintext_len;
+
+    return aes_end(ciphertext, *ciphertext_len, tag, AES_BLOCK, NULL, interface);
 }
 
-void aes_192_gcm_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int ciphertext_len,
+int aes_192_gcm_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int ciphertext_len,
                             unsigned char *plaintext, unsigned int *plaintext_len, unsigned char *aad, unsigned int aad_len, unsigned char *tag, unsigned int *result, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
 
     unsigned char H[16];
     unsigned char J0[16];
@@ -2267,15 +2415,18 @@ void aes_192_gcm_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned int
     *result = memcmp(tag, T, 16);
 
     *plaintext_len = ciphertext_len;
+
+    return aes_end(plaintext, *plaintext_len, NULL, 0, result, interface);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // AES-256-GCM
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void aes_256_gcm_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int *ciphertext_len,
+int aes_256_gcm_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int *ciphertext_len,
                             unsigned char *plaintext, unsigned int plaintext_len, unsigned char *aad, unsigned int aad_len, unsigned char *tag, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
 
     unsigned char H[16];
     unsigned char J0[16];
@@ -2298,11 +2449,14 @@ void aes_256_gcm_encrypt_hw(unsigned char *key, unsigned char *iv, unsigned int
     /* Return (C, T) */
 
     *ciphertext_len = plaintext_len;
+
+    return aes_end(ciphertext, *ciphertext_len, tag, AES_BLOCK, NULL, interface);
 }
 
-void aes_256_gcm_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int ciphertext_len,
+int aes_256_gcm_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned int iv_len, unsigned char *ciphertext, unsigned int ciphertext_len,
                             unsigned char *plaintext, unsigned int *plaintext_len, unsigned char *aad, unsigned int aad_len, unsigned char *tag, unsigned int *result, INTF interface)
 {
+    intf_core_lock(interface, SE_CORE_AES);
 
     unsigned char H[16];
     unsigned char J0[16];
@@ -2326,4 +2480,6 @@ void aes_256_gcm_decrypt_hw(unsigned char *key, unsigned char *iv, unsigned int
     *result = memcmp(tag, T, 16);
 
     *plaintext_len = ciphertext_len;
+
+    return aes_end(plaintext, *plaintext_len, NULL, 0, result, interface);
 }
\ No newline at end of file
@@ -0,0 +1,694 @@
+/**
+  * @file broker.c
+  * @brief SE broker daemon side: client rings, per-core queues and workers
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "broker.h"
+#include "../sha3/sha3_shake_hw.h"
+#include "../sha2/sha2_hw.h"
+#include "../eddsa/eddsa_hw.h"
+#include "../x25519/x25519_hw.h"
+#include "../trng/trng_hw.h"
+#include "../aes/aes_hw.h"
+#include "../mlkem/mlkem_hw.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+typedef struct broker_client broker_client;
+
+typedef struct broker_job {
+	broker_client* cl;
+	unsigned int slot;
+	struct broker_job* next;
+} broker_job;
+
+struct broker_client {
+	int sock, sq_efd, cq_efd;
+	se_broker_ring* ring;
+	unsigned int sq_head;				// Private copies: the segment is writable by the client
+	unsigned int cq_tail;
+	unsigned int refs;					// Connection + requests in flight (broker_mutex)
+	int dead;
+	pthread_mutex_t cq_lock;
+	unsigned char busy[SE_BROKER_SLOTS];
+	broker_job job[SE_BROKER_SLOTS];
+};
+
+typedef struct {
+	broker_job* head;
+	broker_job** tail;
+	pthread_cond_t cond;
+} broker_queue;
+
+typedef struct {
+	INTF interface;
+	unsigned int dev;
+	int core;
+} broker_worker;
+
+static broker_client* broker_cl[SE_BROKER_MAX_CLIENT];
+static broker_queue broker_q[SE_N_CORE];
+static pthread_mutex_t broker_mutex = PTHREAD_MUTEX_INITIALIZER;		// Queues, refs, stats
+static int broker_stop = 0;
+static int broker_epfd = -1;
+static se_broker_stat broker_st;
+static INTF broker_dev[SE_BROKER_MAX_DEV];
+static unsigned int broker_n_dev = 0;
+
+#define BROKER_EV_LISTEN		0
+#define BROKER_EV_SOCK			1
+#define BROKER_EV_SQ			2
+#define BROKER_EV(idx, kind)	(((unsigned long long)(idx) << 2) | (kind))
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// REQUESTS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+int se_broker_core(unsigned int op)
+{
+	switch (op) {
+	case SE_OP_SHA3_256: case SE_OP_SHA3_512: case SE_OP_SHAKE128: case SE_OP_SHAKE256:
+		return SE_CORE_SHA3;
+	case SE_OP_SHA_256: case SE_OP_SHA_384: case SE_OP_SHA_512: case SE_OP_SHA_512_256:
+		return SE_CORE_SHA2;
+	case SE_OP_EDDSA_GENKEYS: case SE_OP_EDDSA_SIGN: case SE_OP_EDDSA_VERIFY:
+		return SE_CORE_EDDSA;
+	case SE_OP_X25519_GENKEYS: case SE_OP_X25519_SS:
+		return SE_CORE_X25519;
+	case SE_OP_TRNG:
+		return SE_CORE_TRNG;
+	case SE_OP_AES_ECB_ENC: case SE_OP_AES_ECB_DEC: case SE_OP_AES_CBC_ENC: case SE_OP_AES_CBC_DEC: case SE_OP_AES_CMAC:
+	case SE_OP_AES_CCM_8_ENC: case SE_OP_AES_CCM_8_DEC: case SE_OP_AES_GCM_ENC: case SE_OP_AES_GCM_DEC:
+		return SE_CORE_AES;
+	case SE_OP_MLKEM_GENKEYS: case SE_OP_MLKEM_ENC: case SE_OP_MLKEM_DEC:
+		return SE_CORE_MLKEM;
+	}
+
+	return -1;
+}
+
+typedef int (*broker_aes_enc_f)(unsigned char*, unsigned char*, unsigned int*, unsigned char*, unsigned int, INTF);
+typedef int (*broker_aes_dec_f)(unsigned char*, unsigned char*, unsigned int, unsigned char*, unsigned int*, INTF);
+typedef int (*broker_aes_cbc_enc_f)(unsigned char*, unsigned char*, unsigned char*, unsigned int*, unsigned char*, unsigned int, INTF);
+typedef int (*broker_aes_cbc_dec_f)(unsigned char*, unsigned char*, unsigned char*, unsigned int, unsigned char*, unsigned int*, INTF);
+typedef int (*broker_aes_aead_enc_f)(unsigned char*, unsigned char*, unsigned int, unsigned char*, unsigned int*, unsigned char*, unsigned int, unsigned char*, unsigned int, unsigned char*, INTF);
+typedef int (*broker_aes_aead_dec_f)(unsigned char*, unsigned char*, unsigned int, unsigned char*, unsigned int, unsigned char*, unsigned int*, unsigned char*, unsigned int, unsigned char*, unsigned int*, INTF);
+
+//-- Indexed by (bits / 64) - 2: AES-128, AES-192, AES-256
+static const broker_aes_enc_f broker_ecb_enc[3] = { aes_128_ecb_encrypt_hw, aes_192_ecb_encrypt_hw, aes_256_ecb_encrypt_hw };
+static const broker_aes_dec_f broker_ecb_dec[3] = { aes_128_ecb_decrypt_hw, aes_192_ecb_decrypt_hw, aes_256_ecb_decrypt_hw };
+static const broker_aes_cbc_enc_f broker_cbc_enc[3] = { aes_128_cbc_encrypt_hw, aes_192_cbc_encrypt_hw, aes_256_cbc_encrypt_hw };
+static const broker_aes_cbc_dec_f broker_cbc_dec[3] = { aes_128_cbc_decrypt_hw, aes_192_cbc_decrypt_hw, aes_256_cbc_decrypt_hw };
+static const broker_aes_enc_f broker_cmac[3] = { aes_128_cmac_hw, aes_192_cmac_hw, aes_256_cmac_hw };
+static const broker_aes_aead_enc_f broker_ccm_enc[3] = { aes_128_ccm_8_encrypt_hw, aes_192_ccm_8_encrypt_hw, aes_256_ccm_8_encrypt_hw };
+static const broker_aes_aead_dec_f broker_ccm_dec[3] = { aes_128_ccm_8_decrypt_hw, aes_192_ccm_8_decrypt_hw, aes_256_ccm_8_decrypt_hw };
+static const broker_aes_aead_enc_f broker_gcm_enc[3] = { aes_128_gcm_encrypt_hw, aes_192_gcm_encrypt_hw, aes_256_gcm_encrypt_hw };
+static const broker_aes_aead_dec_f broker_gcm_dec[3] = { aes_128_gcm_decrypt_hw, aes_192_gcm_decrypt_hw, aes_256_gcm_decrypt_hw };
+
+//-- Driver status (SE_OK, SE_ERR_*) to request status
+static int broker_status(int ret)
+{
+	if (ret == SE_OK)					return SE_BROKER_OK;
+	if (ret == SE_ERR_DEADLINE)			return SE_BROKER_ERR_DEADLINE;
+	if (ret == SE_ERR_ARG)				return SE_BROKER_ERR_SIZE;
+	return SE_BROKER_ERR_HW;
+}
+
+//-- The slot lives in memory the client can write at any time: every field that
+//-- sizes an access is copied first, and the drivers only see lengths checked
+//-- against the slot. The drivers write exactly the output sizes given to
+//-- BROKER_FIELDS, and their status is the status of the request.
+int se_broker_run(se_broker_slot* s, INTF interface)
+{
+	unsigned int op = s->op, arg = s->arg, n_in = s->n_in;
+	unsigned int len[SE_BROKER_FIELDS] = { 0 }, ol[SE_BROKER_FIELDS] = { 0 }, n_out = 0;
+	unsigned char* in[SE_BROKER_FIELDS] = { 0 };
+	unsigned char* out[SE_BROKER_FIELDS] = { 0 };
+	unsigned long long off = 0, room;
+	unsigned int result = 0, a, pk, sk, ct;
+	int ret = SE_BROKER_OK;
+
+	if (n_in > SE_BROKER_FIELDS) return SE_BROKER_ERR_OP;
+	for (unsigned int i = 0; i < n_in; i++) {
+		len[i] = s->in_len[i];
+		in[i] = s->data + off;
+		off += SE_BROKER_ALIGN(len[i]);
+		if (off > SE_BROKER_DATA) return SE_BROKER_ERR_SIZE;
+	}
+	room = SE_BROKER_DATA - off;
+
+	//-- n inputs, outputs of the given sizes packed after them
+#define BROKER_FIELDS(n, ...) do { \
+		unsigned long long sz[] = { __VA_ARGS__ }, o = off; \
+		if (n_in != (n)) return SE_BROKER_ERR_OP; \
+		n_out = sizeof(sz) / sizeof(sz[0]); \
+		for (unsigned int i = 0; i < n_out; i++) { out[i] = s->data + o; ol[i] = (unsigned int)sz[i]; o += SE_BROKER_ALIGN(sz[i]); } \
+		if (o - off > room) return SE_BROKER_ERR_SIZE; \
+	} while (0)
+#define BROKER_LEN(i, n)	do { if (len[i] != (n)) return SE_BROKER_ERR_SIZE; } while (0)
+#define BROKER_AES()		do { if ((arg != 128 && arg != 192 && arg != 256) || len[0] != arg / 8) return SE_BROKER_ERR_SIZE; a = arg / 64 - 2; } while (0)
+#define BROKER_MLKEM()		do { if (arg < 2 || arg > 4) return SE_BROKER_ERR_OP; pk = 384 * arg + 32; sk = 768 * arg + 96; ct = (arg == 4) ? 1568 : 320 * arg + 128; } while (0)
+
+	switch (op) {
+	case SE_OP_SHA3_256:	BROKER_FIELDS(1, 32);	ret = broker_status(sha3_256_hw_func(in[0], len[0], out[0], interface));			break;
+	case SE_OP_SHA3_512:	BROKER_FIELDS(1, 64);	ret = broker_status(sha3_512_hw_func(in[0], len[0], out[0], interface));			break;
+	case SE_OP_SHAKE128:	BROKER_FIELDS(1, arg);	ret = broker_status(shake128_hw_func(in[0], len[0], out[0], arg, interface));	break;
+	case SE_OP_SHAKE256:	BROKER_FIELDS(1, arg);	ret = broker_status(shake256_hw_func(in[0], len[0], out[0], arg, interface));	break;
+	case SE_OP_SHA_256:		BROKER_FIELDS(1, 32);	ret = broker_status(sha_256_hw_func(in[0], len[0], out[0], interface));			break;
+	case SE_OP_SHA_384:		BROKER_FIELDS(1, 48);	ret = broker_status(sha_384_hw_func(in[0], len[0], out[0], interface));			break;
+	case SE_OP_SHA_512:		BROKER_FIELDS(1, 64);	ret = broker_status(sha_512_hw_func(in[0], len[0], out[0], interface));			break;
+	case SE_OP_SHA_512_256:	BROKER_FIELDS(1, 32);	ret = broker_status(sha_512_256_hw_func(in[0], len[0], out[0], interface));		break;
+
+	// -- the EdDSA calls return -1 for any failure: the device status tells a core fault apart
+	case SE_OP_EDDSA_GENKEYS:
+		BROKER_FIELDS(0, 32, 32);
+		eddsa25519_genkeys_hw_buf(out[0], out[1], interface);
+		ret = broker_status(intf_status(interface));
+		break;
+	case SE_OP_EDDSA_SIGN:
+		BROKER_FIELDS(3, 64);	BROKER_LEN(1, 32);	BROKER_LEN(2, 32);
+		if (eddsa25519_sign_hw_buf(in[0], len[0], in[1], in[2], out[0], interface) != 0)
+			ret = (intf_status(interface) != SE_OK) ? broker_status(intf_status(interface)) : SE_BROKER_ERR_SIZE;
+		break;
+	case SE_OP_EDDSA_VERIFY:
+		BROKER_FIELDS(3);		BROKER_LEN(1, 32);	BROKER_LEN(2, 64);
+		if (eddsa25519_verify_hw_buf(in[0], len[0], in[1], in[2], &result, interface) != 0)
+			ret = (intf_status(interface) != SE_OK) ? broker_status(intf_status(interface)) : SE_BROKER_ERR_SIZE;
+		break;
+
+	case SE_OP_X25519_GENKEYS:
+		BROKER_FIELDS(0, 32, 32);
+		ret = broker_status(x25519_genkeys_hw_buf(out[0], out[1], interface));
+		break;
+	case SE_OP_X25519_SS:
+		BROKER_FIELDS(2, 32);	BROKER_LEN(0, 32);	BROKER_LEN(1, 32);
+		ret = broker_status(x25519_ss_gen_hw_buf(out[0], in[0], in[1], interface));
+		break;
+
+	case SE_OP_TRNG:
+		BROKER_FIELDS(0, arg);
+		result = (unsigned int)trng_hw(out[0], arg, interface);
+		if ((int)result == TRNG_ERR_DEADLINE)	ret = SE_BROKER_ERR_DEADLINE;
+		else if ((int)result != TRNG_OK)		ret = SE_BROKER_ERR_HW;
+		break;
+
+	case SE_OP_AES_ECB_ENC:
+		BROKER_AES();	BROKER_FIELDS(2, (unsigned long long)len[1] + 16);
+		ret = broker_status(broker_ecb_enc[a](in[0], out[0], &ol[0], in[1], len[1], interface));
+		break;
+	case SE_OP_AES_ECB_DEC:
+		BROKER_AES();	BROKER_FIELDS(2, len[1]);
+		ret = broker_status(broker_ecb_dec[a](in[0], in[1], len[1], out[0], &ol[0], interface));
+		break;
+	case SE_OP_AES_CBC_ENC:
+		BROKER_AES();	BROKER_FIELDS(3, (unsigned long long)len[2] + 16);	BROKER_LEN(1, 16);
+		ret = broker_status(broker_cbc_enc[a](in[0], in[1], out[0], &ol[0], in[2], len[2], interface));
+		break;
+	case SE_OP_AES_CBC_DEC:
+		BROKER_AES();	BROKER_FIELDS(3, len[2]);	BROKER_LEN(1, 16);
+		ret = broker_status(broker_cbc_dec[a](in[0], in[1], in[2], len[2], out[0], &ol[0], interface));
+		break;
+	case SE_OP_AES_CMAC:
+		BROKER_AES();	BROKER_FIELDS(2, 16);
+		ret = broker_status(broker_cmac[a](in[0], out[0], &ol[0], in[1], len[1], interface));
+		break;
+	case SE_OP_AES_CCM_8_ENC:
+	case SE_OP_AES_GCM_ENC:
+		BROKER_AES();	BROKER_FIELDS(4, (unsigned long long)len[2] + 16, (op == SE_OP_AES_GCM_ENC) ? 16 : 8);
+		if (op == SE_OP_AES_GCM_ENC && len[1] == 0) return SE_BROKER_ERR_SIZE;
+		if (op == SE_OP_AES_CCM_8_ENC && (len[1] < 7 || len[1] > 13)) return SE_BROKER_ERR_SIZE;
+		ret = broker_status(((op == SE_OP_AES_GCM_ENC) ? broker_gcm_enc : broker_ccm_enc)[a](in[0], in[1], len[1], out[0], &ol[0], in[2], len[2], in[3], len[3], out[1], interface));
+		break;
+	case SE_OP_AES_CCM_8_DEC:
+	case SE_OP_AES_GCM_DEC:
+		BROKER_AES();	BROKER_FIELDS(5, (unsigned long long)len[2] + 16);
+		BROKER_LEN(4, (op == SE_OP_AES_GCM_DEC) ? 16 : 8);
+		if (op == SE_OP_AES_GCM_DEC && len[1] == 0) return SE_BROKER_ERR_SIZE;
+		if (op == SE_OP_AES_CCM_8_DEC && (len[1] < 7 || len[1] > 13)) return SE_BROKER_ERR_SIZE;
+		ret = broker_status(((op == SE_OP_AES_GCM_DEC) ? broker_gcm_dec : broker_ccm_dec)[a](in[0], in[1], len[1], in[2], len[2], out[0], &ol[0], in[3], len[3], in[4], &result, interface));
+		break;
+
+	case SE_OP_MLKEM_GENKEYS:
+		BROKER_MLKEM();	BROKER_FIELDS(0, pk, sk);
+		ret = broker_status(mlkem_gen_keys_hw(arg, out[0], out[1], interface));
+		break;
+	case SE_OP_MLKEM_ENC:
+		BROKER_MLKEM();	BROKER_FIELDS(1, ct, 32);	BROKER_LEN(0, pk);
+		ret = broker_status(mlkem_enc_hw(arg, in[0], out[0], out[1], interface));
+		break;
+	case SE_OP_MLKEM_DEC:
+		BROKER_MLKEM();	BROKER_FIELDS(2, 32);	BROKER_LEN(0, sk);	BROKER_LEN(1, ct);
+		ret = broker_status(mlkem_dec_hw(arg, in[0], in[1], out[0], &result, interface));
+		break;
+
+	default:
+		return SE_BROKER_ERR_OP;
+	}
+
+#undef BROKER_FIELDS
+#undef BROKER_LEN
+#undef BROKER_AES
+#undef BROKER_MLKEM
+
+	s->n_out = n_out;
+	for (unsigned int i = 0; i < n_out; i++) s->out_len[i] = ol[i];
+	s->result = result;
+
+	return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// CLIENTS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static void broker_kick(int efd)
+{
+	unsigned long long one = 1;
+
+	if (write(efd, &one, sizeof(one)) < 0) { /* counter saturated: the peer is awake anyway */ }
+}
+
+//-- broker_mutex held
+static void broker_release(broker_client* c)
+{
+	if (--c->refs) return;
+
+	munmap(c->ring, sizeof(se_broker_ring));
+	close(c->cq_efd);
+	pthread_mutex_destroy(&c->cq_lock);
+	free(c);
+}
+
+static void broker_drop(int idx)
+{
+	broker_client* c = broker_cl[idx];
+
+	epoll_ctl(broker_epfd, EPOLL_CTL_DEL, c->sock, NULL);
+	epoll_ctl(broker_epfd, EPOLL_CTL_DEL, c->sq_efd, NULL);
+	close(c->sock);
+	close(c->sq_efd);
+	broker_cl[idx] = NULL;
+
+	pthread_mutex_lock(&broker_mutex);
+	c->dead = 1;
+	broker_st.clients--;
+	broker_release(c);
+	pthread_mutex_unlock(&broker_mutex);
+}
+
+static void broker_accept(int lsock)
+{
+	se_broker_hello hello = { SE_BROKER_MAGIC, SE_BROKER_VERSION, SE_BROKER_SLOTS, sizeof(se_broker_ring) };
+	char cbuf[CMSG_SPACE(3 * sizeof(int))];
+	struct iovec iov = { &hello, sizeof(hello) };
+	struct msghdr msg;
+	struct cmsghdr* cm;
+	struct epoll_event ev;
+	broker_client* c;
+	int sock, mfd, idx, fds[3];
+
+	while ((sock = accept4(lsock, NULL, NULL, SOCK_CLOEXEC | SOCK_NONBLOCK)) >= 0) {
+		for (idx = 0; idx < SE_BROKER_MAX_CLIENT && broker_cl[idx] != NULL; idx++);
+		c = (idx < SE_BROKER_MAX_CLIENT) ? calloc(1, sizeof(broker_client)) : NULL;
+		if (c == NULL) {
+			close(sock);
+			continue;
+		}
+
+		mfd = memfd_create("se-qubipd", MFD_CLOEXEC);
+		c->ring = MAP_FAILED;
+		if (mfd >= 0 && ftruncate(mfd, sizeof(se_broker_ring)) == 0)
+			c->ring = mmap(NULL, sizeof(se_broker_ring), PROT_READ | PROT_WRITE, MAP_SHARED, mfd, 0);
+		c->sq_efd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+		c->cq_efd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+		if (c->ring == MAP_FAILED || c->sq_efd < 0 || c->cq_efd < 0) {
+			printf("\n BROKER FAIL!: client setup: %s\n", strerror(errno));
+			if (c->ring != MAP_FAILED) munmap(c->ring, sizeof(se_broker_ring));
+			if (mfd >= 0) close(mfd);
+			if (c->sq_efd >= 0) close(c->sq_efd);
+			if (c->cq_efd >= 0) close(c->cq_efd);
+			close(sock);
+			free(c);
+			continue;
+		}
+		c->ring->magic = SE_BROKER_MAGIC;
+		c->ring->version = SE_BROKER_VERSION;
+		c->ring->slots = SE_BROKER_SLOTS;
+		c->ring->data = SE_BROKER_DATA;
+
+		fds[0] = mfd;
+		fds[1] = c->sq_efd;
+		fds[2] = c->cq_efd;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = cbuf;
+		msg.msg_controllen = sizeof(cbuf);
+		cm = CMSG_FIRSTHDR(&msg);
+		cm->cmsg_level = SOL_SOCKET;
+		cm->cmsg_type = SCM_RIGHTS;
+		cm->cmsg_len = CMSG_LEN(sizeof(fds));
+		memcpy(CMSG_DATA(cm), fds, sizeof(fds));
+		if (sendmsg(sock, &msg, MSG_NOSIGNAL) != sizeof(hello)) {
+			munmap(c->ring, sizeof(se_broker_ring));
+			close(mfd);
+			close(c->sq_efd);
+			close(c->cq_efd);
+			close(sock);
+			free(c);
+			continue;
+		}
+		close(mfd);
+
+		c->sock = sock;
+		c->refs = 1;
+		pthread_mutex_init(&c->cq_lock, NULL);
+		broker_cl[idx] = c;
+
+		ev.events = EPOLLIN | EPOLLRDHUP;
+		ev.data.u64 = BROKER_EV(idx, BROKER_EV_SOCK);
+		epoll_ctl(broker_epfd, EPOLL_CTL_ADD, sock, &ev);
+		ev.events = EPOLLIN;
+		ev.data.u64 = BROKER_EV(idx, BROKER_EV_SQ);
+		epoll_ctl(broker_epfd, EPOLL_CTL_ADD, c->sq_efd, &ev);
+
+		pthread_mutex_lock(&broker_mutex);
+		broker_st.clients++;
+		pthread_mutex_unlock(&broker_mutex);
+	}
+}
+
+//-- Moves new SQ entries of every client to the core queues; a client that
+//-- breaks the protocol (bad index, slot submitted twice) is disconnected
+static int broker_poll_sq()
+{
+	unsigned int tail, idx, n = 0;
+	broker_client* c;
+	broker_job* j;
+	int core;
+
+	for (int i = 0; i < SE_BROKER_MAX_CLIENT; i++) {
+		if ((c = broker_cl[i]) == NULL) continue;
+		tail = __atomic_load_n(&c->ring->sq_tail, __ATOMIC_ACQUIRE);
+		if (tail == c->sq_head) continue;
+		if (tail - c->sq_head > SE_BROKER_SLOTS) {
+			broker_drop(i);
+			continue;
+		}
+
+		pthread_mutex_lock(&broker_mutex);
+		for (; c->sq_head != tail; c->sq_head++, n++) {
+			idx = __atomic_load_n(&c->ring->sq[c->sq_head & (SE_BROKER_SLOTS - 1)], __ATOMIC_RELAXED);
+			if (idx >= SE_BROKER_SLOTS || c->busy[idx]) break;
+			c->busy[idx] = 1;
+			c->refs++;
+			core = se_broker_core(__atomic_load_n(&c->ring->slot[idx].op, __ATOMIC_RELAXED));
+			j = &c->job[idx];
+			j->cl = c;
+			j->slot = idx;
+			j->next = NULL;
+			// -- unknown operations go to any queue: se_broker_run rejects them
+			if (core < 0) core = SE_CORE_SHA3;
+			*broker_q[core].tail = j;
+			broker_q[core].tail = &j->next;
+			pthread_cond_signal(&broker_q[core].cond);
+		}
+		pthread_mutex_unlock(&broker_mutex);
+		__atomic_store_n(&c->ring->sq_head, c->sq_head, __ATOMIC_RELEASE);
+
+		if (c->sq_head != tail) broker_drop(i);
+	}
+
+	return n;
+}
+
+static void broker_sleep_flag(unsigned int v)
+{
+	for (int i = 0; i < SE_BROKER_MAX_CLIENT; i++)
+		if (broker_cl[i] != NULL) __atomic_store_n(&broker_cl[i]->ring->sq_sleep, v, __ATOMIC_SEQ_CST);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// WORKERS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static void broker_complete(broker_client* c, unsigned int idx)
+{
+	se_broker_ring* r = c->ring;
+
+	pthread_mutex_lock(&c->cq_lock);
+	__atomic_store_n(&r->cq[c->cq_tail & (SE_BROKER_SLOTS - 1)], idx, __ATOMIC_RELAXED);
+	__atomic_store_n(&r->cq_tail, ++c->cq_tail, __ATOMIC_SEQ_CST);
+	pthread_mutex_unlock(&c->cq_lock);
+
+	if (__atomic_load_n(&r->cq_sleep, __ATOMIC_SEQ_CST)) broker_kick(c->cq_efd);
+}
+
+//-- 1 while the worker's core has its circuit breaker open and the same core of
+//-- another device can take the queue
+static int broker_worker_open(broker_worker* w)
+{
+	if (intf_core_available(w->interface, w->core)) return 0;
+
+	for (unsigned int d = 0; d < broker_n_dev; d++) {
+		if (d != w->dev && intf_core_available(broker_dev[d], w->core)) return 1;
+	}
+
+	return 0;
+}
+
+static void* broker_worker_run(void* arg)
+{
+	broker_worker* w = (broker_worker*)arg;
+	broker_queue* q = &broker_q[w->core];
+	broker_job* batch[SE_BROKER_BATCH];
+	unsigned int n;
+	se_broker_slot* s;
+	int ret;
+
+	pthread_mutex_lock(&broker_mutex);
+	while (!__atomic_load_n(&broker_stop, __ATOMIC_ACQUIRE)) {
+		if (q->head == NULL) {
+			pthread_cond_wait(&q->cond, &broker_mutex);
+			continue;
+		}
+		if (broker_worker_open(w)) {
+			// -- pass the wake-up on and stay out of the queue until the cool-down ends
+			pthread_cond_signal(&q->cond);
+			pthread_mutex_unlock(&broker_mutex);
+			usleep(SE_BROKER_OPEN_US);
+			pthread_mutex_lock(&broker_mutex);
+			continue;
+		}
+		for (n = 0; n < SE_BROKER_BATCH && q->head != NULL; n++) {
+			batch[n] = q->head;
+			if ((q->head = q->head->next) == NULL) q->tail = &q->head;
+		}
+		broker_st.ops[w->core] += n;
+		broker_st.batches[w->core]++;
+		pthread_mutex_unlock(&broker_mutex);
+
+		// -- one core lock for the whole batch; other devices take what is left
+		intf_core_lock(w->interface, w->core);
+		for (unsigned int i = 0; i < n; i++) {
+			if (__atomic_load_n(&batch[i]->cl->dead, __ATOMIC_ACQUIRE)) continue;
+			s = &batch[i]->cl->ring->slot[batch[i]->slot];
+			intf_clear_status(w->interface);
+			// -- a request that waited in the queue past its deadline is not run at all
+			if (s->deadline != 0 && intf_clock_ns() >= s->deadline) ret = SE_BROKER_ERR_DEADLINE;
+			else {
+				intf_set_deadline(w->interface, s->deadline);
+				ret = (se_broker_core(s->op) == w->core) ? se_broker_run(s, w->interface) : SE_BROKER_ERR_OP;
+				intf_set_deadline(w->interface, 0);
+				if (intf_status(w->interface) == SE_ERR_DEADLINE) ret = SE_BROKER_ERR_DEADLINE;
+				else if (ret == SE_BROKER_OK && intf_status(w->interface) != SE_OK) ret = SE_BROKER_ERR_HW;
+			}
+			s->status = ret;
+			if (ret != SE_BROKER_OK) __atomic_add_fetch(&broker_st.rejected, 1, __ATOMIC_RELAXED);
+		}
+		intf_core_unlock(w->interface, w->core);
+
+		pthread_mutex_lock(&broker_mutex);
+		for (unsigned int i = 0; i < n; i++) {
+			batch[i]->cl->busy[batch[i]->slot] = 0;
+			if (!batch[i]->cl->dead) broker_complete(batch[i]->cl, batch[i]->slot);
+			broker_release(batch[i]->cl);
+		}
+	}
+	pthread_mutex_unlock(&broker_mutex);
+
+	return NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// CONTROL FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+int se_broker_serve(const char* path, unsigned int mode, INTF* interface, unsigned int n_dev)
+{
+	struct sockaddr_un addr;
+	struct epoll_event ev[16];
+	broker_worker w[SE_BROKER_MAX_DEV * SE_N_CORE];
+	pthread_t th[SE_BROKER_MAX_DEV * SE_N_CORE];
+	unsigned int n_th = 0, idle = 0;
+	unsigned long long cnt;
+	int lsock, n;
+
+	if (n_dev == 0 || n_dev > SE_BROKER_MAX_DEV) return -1;
+	if (path == NULL) path = SE_BROKER_PATH;
+	if (strlen(path) >= sizeof(addr.sun_path)) return -1;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+	unlink(path);
+
+	lsock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+	if (lsock < 0 || bind(lsock, (struct sockaddr*)&addr, sizeof(addr)) != 0 || chmod(path, mode) != 0 || listen(lsock, SE_BROKER_MAX_CLIENT) != 0) {
+		printf("\n BROKER FAIL!: %s: %s\n", path, strerror(errno));
+		if (lsock >= 0) close(lsock);
+		return -1;
+	}
+	broker_epfd = epoll_create1(EPOLL_CLOEXEC);
+	ev[0].events = EPOLLIN;
+	ev[0].data.u64 = BROKER_EV(0, BROKER_EV_LISTEN);
+	epoll_ctl(broker_epfd, EPOLL_CTL_ADD, lsock, &ev[0]);
+
+	__atomic_store_n(&broker_stop, 0, __ATOMIC_RELEASE);
+	for (int c = 0; c < SE_N_CORE; c++) {
+		broker_q[c].head = NULL;
+		broker_q[c].tail = &broker_q[c].head;
+		pthread_cond_init(&broker_q[c].cond, NULL);
+	}
+	for (unsigned int d = 0; d < n_dev; d++) broker_dev[d] = interface[d];
+	broker_n_dev = n_dev;
+	for (unsigned int d = 0; d < n_dev; d++) {
+		for (int c = 0; c < SE_N_CORE; c++) {
+			w[n_th].interface = interface[d];
+			w[n_th].dev = d;
+			w[n_th].core = c;
+			if (pthread_create(&th[n_th], NULL, broker_worker_run, &w[n_th]) == 0) n_th++;
+		}
+	}
+
+	// -- dispatcher: poll the SQs while there is work, sleep on epoll once idle
+	while (!__atomic_load_n(&broker_stop, __ATOMIC_ACQUIRE)) {
+		if (broker_poll_sq()) {
+			idle = 0;
+			continue;
+		}
+		if (++idle < SE_BROKER_SPIN) continue;
+
+		broker_sleep_flag(1);
+		if (broker_poll_sq() == 0) {
+			broker_st.wakeups++;
+			n = epoll_wait(broker_epfd, ev, 16, 1000);
+			for (int i = 0; i < n; i++) {
+				unsigned int idx = (unsigned int)(ev[i].data.u64 >> 2);
+				switch (ev[i].data.u64 & 3) {
+				case BROKER_EV_LISTEN:
+					broker_accept(lsock);
+					break;
+				case BROKER_EV_SOCK:
+					// -- clients never write the socket: readable means gone
+					if (broker_cl[idx] != NULL) broker_drop(idx);
+					break;
+				case BROKER_EV_SQ:
+					if (broker_cl[idx] != NULL && read(broker_cl[idx]->sq_efd, &cnt, sizeof(cnt)) < 0) { /* already drained */ }
+					break;
+				}
+			}
+		}
+		broker_sleep_flag(0);
+		idle = 0;
+	}
+
+	pthread_mutex_lock(&broker_mutex);
+	for (int c = 0; c < SE_N_CORE; c++) pthread_cond_broadcast(&broker_q[c].cond);
+	pthread_mutex_unlock(&broker_mutex);
+	for (unsigned int i = 0; i < n_th; i++) pthread_join(th[i], NULL);
+
+	for (int i = 0; i < SE_BROKER_MAX_CLIENT; i++) if (broker_cl[i] != NULL) broker_drop(i);
+	close(broker_epfd);
+	close(lsock);
+	unlink(path);
+
+	return 0;
+}
+
+void se_broker_stop()
+{
+	__atomic_store_n(&broker_stop, 1, __ATOMIC_RELEASE);
+}
+
+void se_broker_stats(se_broker_stat* st)
+{
+	pthread_mutex_lock(&broker_mutex);
+	memcpy(st, &broker_st, sizeof(se_broker_stat));
+	pthread_mutex_unlock(&broker_mutex);
+}
@@ -0,0 +1,195 @@
+/**
+  * @file broker.h
+  * @brief SE broker: shared-memory request rings between se-qubipd and its clients
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef BROKER_H
+#define BROKER_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../common/intf.h"
+
+/************************ Broker Constant Definitions **********************/
+
+#define SE_BROKER_PATH				"/run/se-qubipd.sock"	// Default socket (SE_QUBIPD_SOCK overrides)
+#define SE_BROKER_MAGIC				0x53454251				// "SEBQ"
+#define SE_BROKER_VERSION			2
+#define SE_BROKER_SLOTS				64						// Requests in flight per client (power of two)
+#define SE_BROKER_DATA				16384					// Bytes per request: inputs, then outputs
+#define SE_BROKER_FIELDS			6						// Inputs / outputs per request
+#define SE_BROKER_ALIGN(x)			(((x) + 7ULL) & ~7ULL)	// Fields are packed on 8-byte boundaries
+#define SE_BROKER_SPIN				4096					// Empty polls before sleeping on the eventfd
+#define SE_BROKER_BATCH				8						// Requests run back to back under one core lock
+#define SE_BROKER_MAX_CLIENT		64
+#define SE_BROKER_MAX_DEV			8
+#define SE_BROKER_OPEN_US			1000					// Back-off of a worker whose core's circuit breaker is open
+
+//-- Request status (se_broker_slot.status and client return values)
+#define SE_BROKER_OK				0
+#define SE_BROKER_ERR_OP			-1		// Unknown operation or wrong number of fields
+#define SE_BROKER_ERR_SIZE			-2		// A field has the wrong size or the request does not fit a slot
+#define SE_BROKER_ERR_IO			-3		// No daemon, or the connection was lost
+#define SE_BROKER_ERR_HW			-4		// The core timed out or failed and was reset (outputs wiped)
+#define SE_BROKER_ERR_DEADLINE		-5		// Refused or stopped at its deadline (outputs wiped)
+
+//-- Operations. arg: output length (SHAKE, TRNG), key bits (AES) or k (ML-KEM)
+enum {
+	SE_OP_SHA3_256 = 1,		// in: msg								out: md[32]
+	SE_OP_SHA3_512,			// in: msg								out: md[64]
+	SE_OP_SHAKE128,			// in: msg								out: md[arg]
+	SE_OP_SHAKE256,			// in: msg								out: md[arg]
+	SE_OP_SHA_256,			// in: msg								out: md[32]
+	SE_OP_SHA_384,			// in: msg								out: md[48]
+	SE_OP_SHA_512,			// in: msg								out: md[64]
+	SE_OP_SHA_512_256,		// in: msg								out: md[32]
+	SE_OP_EDDSA_GENKEYS,	// in: -								out: pri[32], pub[32]
+	SE_OP_EDDSA_SIGN,		// in: msg, pri[32], pub[32]			out: sig[64]
+	SE_OP_EDDSA_VERIFY,		// in: msg, pub[32], sig[64]			out: -, result
+	SE_OP_X25519_GENKEYS,	// in: -								out: pri[32], pub[32]
+	SE_OP_X25519_SS,		// in: pub[32], pri[32]					out: ss[32]
+	SE_OP_TRNG,				// in: -								out: rnd[arg], result = trng_hw()
+	SE_OP_AES_ECB_ENC,		// in: key, pt							out: ct
+	SE_OP_AES_ECB_DEC,		// in: key, ct							out: pt
+	SE_OP_AES_CBC_ENC,		// in: key, iv[16], pt					out: ct
+	SE_OP_AES_CBC_DEC,		// in: key, iv[16], ct					out: pt
+	SE_OP_AES_CMAC,			// in: key, msg							out: mac
+	SE_OP_AES_CCM_8_ENC,	// in: key, iv, pt, aad					out: ct, tag[8]
+	SE_OP_AES_CCM_8_DEC,	// in: key, iv, ct, aad, tag[8]			out: pt, result
+	SE_OP_AES_GCM_ENC,		// in: key, iv, pt, aad					out: ct, tag[16]
+	SE_OP_AES_GCM_DEC,		// in: key, iv, ct, aad, tag[16]		out: pt, result
+	SE_OP_MLKEM_GENKEYS,	// in: -								out: pk, sk
+	SE_OP_MLKEM_ENC,		// in: pk								out: ct, ss[32]
+	SE_OP_MLKEM_DEC,		// in: sk, ct							out: ss[32], result
+	SE_OP_N
+};
+
+	/************************ Shared Memory Layout **********************/
+
+	//-- One request. The client owns the slot until it submits its index on the
+	//-- SQ, the daemon until it posts the index on the CQ. Inputs are packed from
+	//-- data[0]; the daemon packs the outputs right after the last input.
+	typedef struct {
+		unsigned int op;
+		unsigned int arg;
+		unsigned int n_in;
+		unsigned int in_len[SE_BROKER_FIELDS];
+		unsigned int n_out;							// Set by the daemon
+		unsigned int out_len[SE_BROKER_FIELDS];		// Set by the daemon
+		unsigned int result;						// Set by the daemon
+		int status;									// Set by the daemon
+		unsigned long long deadline;				// Absolute CLOCK_MONOTONIC ns, 0: none
+		unsigned long long cookie;					// Client's own, left untouched
+		unsigned char data[SE_BROKER_DATA];
+	} __attribute__((aligned(64))) se_broker_slot;
+
+	//-- Per-client segment (memfd passed over the socket). Each index is written
+	//-- by one side only; a side that goes to sleep raises its *_sleep flag and
+	//-- the other side then writes the matching eventfd after publishing.
+	typedef struct {
+		unsigned int magic;
+		unsigned int version;
+		unsigned int slots;
+		unsigned int data;
+		unsigned int sq_tail __attribute__((aligned(64)));	// Client
+		unsigned int cq_head;								// Client
+		unsigned int cq_sleep;								// Client: waiting on the CQ eventfd
+		unsigned int sq_head __attribute__((aligned(64)));	// Daemon
+		unsigned int cq_tail;								// Daemon
+		unsigned int sq_sleep;								// Daemon: waiting on the SQ eventfd
+		unsigned int sq[SE_BROKER_SLOTS] __attribute__((aligned(64)));
+		unsigned int cq[SE_BROKER_SLOTS] __attribute__((aligned(64)));
+		se_broker_slot slot[SE_BROKER_SLOTS];
+	} se_broker_ring;
+
+	//-- Sent by the daemon on connect, with SCM_RIGHTS: segment, SQ eventfd, CQ eventfd
+	typedef struct {
+		unsigned int magic;
+		unsigned int version;
+		unsigned int slots;
+		unsigned int size;							// sizeof(se_broker_ring)
+	} se_broker_hello;
+
+	typedef struct {
+		unsigned int clients;						// Connected now
+		unsigned long long ops[SE_N_CORE];			// Requests run per core
+		unsigned long long batches[SE_N_CORE];		// Core lock acquisitions
+		unsigned long long rejected;				// Requests completed with an error status
+		unsigned long long wakeups;					// Times the dispatcher slept on epoll
+	} se_broker_stat;
+
+	/************************ Daemon Functions **********************/
+
+	//-- Serve clients on the Unix socket at path (mode: its permission bits)
+	//-- until se_broker_stop. A dispatcher thread drains every client's SQ into
+	//-- per-core queues; one worker per core and device takes up to
+	//-- SE_BROKER_BATCH requests at a time and runs them under one core lock, so
+	//-- a free device picks up work queued for a busy one. Returns -1 if the
+	//-- socket cannot be set up.
+	int se_broker_serve(const char* path, unsigned int mode, INTF* interface, unsigned int n_dev);
+	void se_broker_stop();
+	void se_broker_stats(se_broker_stat* st);
+
+	//-- Runs one request on the given device (the daemon's workers use it)
+	int se_broker_run(se_broker_slot* s, INTF interface);
+	int se_broker_core(unsigned int op);
+
+#endif
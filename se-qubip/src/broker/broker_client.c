@@ -0,0 +1,540 @@
+/**
+  * @file broker_client.c
+  * @brief SE broker client: rings, completion wait and the operation wrappers
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "broker_client.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+struct se_client {
+	int sock, sq_efd, cq_efd;
+	se_broker_ring* ring;
+	pthread_mutex_t lock;				// Everything below
+	pthread_cond_t cond;				// Slot freed or completions reaped
+	unsigned int sq_tail;
+	unsigned int cq_head;
+	unsigned int free[SE_BROKER_SLOTS];
+	unsigned int n_free;
+	unsigned char done[SE_BROKER_SLOTS];
+	int sleeper;						// A thread is waiting on the CQ eventfd
+	int broken;							// Daemon gone
+};
+
+static __thread unsigned long long client_deadline;		// Copied into each request of the thread
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// CONTROL FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+se_client* se_client_open(const char* path)
+{
+	struct sockaddr_un addr;
+	se_broker_hello hello;
+	char cbuf[CMSG_SPACE(3 * sizeof(int))];
+	struct iovec iov = { &hello, sizeof(hello) };
+	struct msghdr msg;
+	struct cmsghdr* cm;
+	int fds[3] = { -1, -1, -1 };
+	se_client* cl;
+
+	if (path == NULL) path = getenv("SE_QUBIPD_SOCK");
+	if (path == NULL) path = SE_BROKER_PATH;
+	if (strlen(path) >= sizeof(addr.sun_path)) return NULL;
+
+	if ((cl = calloc(1, sizeof(se_client))) == NULL) return NULL;
+	cl->ring = MAP_FAILED;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+	cl->sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (cl->sock < 0 || connect(cl->sock, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+		printf("\n BROKER FAIL!: %s: %s\n", path, strerror(errno));
+		goto fail;
+	}
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = cbuf;
+	msg.msg_controllen = sizeof(cbuf);
+	if (recvmsg(cl->sock, &msg, MSG_CMSG_CLOEXEC) != sizeof(hello) || (cm = CMSG_FIRSTHDR(&msg)) == NULL ||
+		cm->cmsg_type != SCM_RIGHTS || cm->cmsg_len != CMSG_LEN(sizeof(fds))) {
+		printf("\n BROKER FAIL!: %s: no rings from the daemon\n", path);
+		goto fail;
+	}
+	memcpy(fds, CMSG_DATA(cm), sizeof(fds));
+	cl->sq_efd = fds[1];
+	cl->cq_efd = fds[2];
+
+	if (hello.magic != SE_BROKER_MAGIC || hello.version != SE_BROKER_VERSION || hello.slots != SE_BROKER_SLOTS || hello.size != sizeof(se_broker_ring)) {
+		printf("\n BROKER FAIL!: %s: daemon speaks another protocol version\n", path);
+		goto fail;
+	}
+	cl->ring = mmap(NULL, sizeof(se_broker_ring), PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+	close(fds[0]);
+	fds[0] = -1;
+	if (cl->ring == MAP_FAILED) goto fail;
+
+	pthread_mutex_init(&cl->lock, NULL);
+	pthread_cond_init(&cl->cond, NULL);
+	for (unsigned int i = 0; i < SE_BROKER_SLOTS; i++) cl->free[i] = SE_BROKER_SLOTS - 1 - i;
+	cl->n_free = SE_BROKER_SLOTS;
+
+	return cl;
+
+fail:
+	if (cl->ring != MAP_FAILED) munmap(cl->ring, sizeof(se_broker_ring));
+	for (int i = 0; i < 3; i++) if (fds[i] >= 0) close(fds[i]);
+	if (cl->sock >= 0) close(cl->sock);
+	free(cl);
+
+	return NULL;
+}
+
+void se_client_set_deadline(unsigned long long deadline_ns)
+{
+	client_deadline = deadline_ns;
+}
+
+void se_client_close(se_client* cl)
+{
+	if (cl == NULL) return;
+
+	munmap(cl->ring, sizeof(se_broker_ring));
+	close(cl->sq_efd);
+	close(cl->cq_efd);
+	close(cl->sock);
+	pthread_mutex_destroy(&cl->lock);
+	pthread_cond_destroy(&cl->cond);
+	free(cl);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// RINGS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- cl->lock held
+static unsigned int client_reap(se_client* cl)
+{
+	unsigned int tail = __atomic_load_n(&cl->ring->cq_tail, __ATOMIC_ACQUIRE), idx, n = 0;
+
+	for (; cl->cq_head != tail; cl->cq_head++, n++) {
+		idx = __atomic_load_n(&cl->ring->cq[cl->cq_head & (SE_BROKER_SLOTS - 1)], __ATOMIC_RELAXED);
+		if (idx < SE_BROKER_SLOTS) cl->done[idx] = 1;
+	}
+	if (n) {
+		__atomic_store_n(&cl->ring->cq_head, cl->cq_head, __ATOMIC_RELEASE);
+		pthread_cond_broadcast(&cl->cond);
+	}
+
+	return n;
+}
+
+//-- Spin on the CQ, then sleep on its eventfd; one thread sleeps, the others
+//-- wait for it on the condition variable
+static int client_wait(se_client* cl, unsigned int idx)
+{
+	struct pollfd pfd[2];
+	unsigned long long cnt;
+	unsigned int spin, head;
+
+	while (!cl->done[idx]) {
+		if (cl->broken) return SE_BROKER_ERR_IO;
+		if (client_reap(cl)) continue;
+		if (cl->sleeper) {
+			pthread_cond_wait(&cl->cond, &cl->lock);
+			continue;
+		}
+		cl->sleeper = 1;
+		head = cl->cq_head;
+		pthread_mutex_unlock(&cl->lock);
+
+		for (spin = 0; spin < SE_BROKER_SPIN; spin++)
+			if (__atomic_load_n(&cl->ring->cq_tail, __ATOMIC_ACQUIRE) != head) break;
+
+		if (spin == SE_BROKER_SPIN) {
+			__atomic_store_n(&cl->ring->cq_sleep, 1, __ATOMIC_SEQ_CST);
+			if (__atomic_load_n(&cl->ring->cq_tail, __ATOMIC_SEQ_CST) == head) {
+				pfd[0].fd = cl->cq_efd;
+				pfd[0].events = POLLIN;
+				pfd[1].fd = cl->sock;
+				pfd[1].events = POLLIN | POLLRDHUP;
+				if (poll(pfd, 2, -1) > 0) {
+					if (pfd[0].revents & POLLIN) {
+						if (read(cl->cq_efd, &cnt, sizeof(cnt)) < 0) { /* another reader drained it */ }
+					}
+					// -- the daemon never writes the socket after the hello: readable means gone
+					if (pfd[1].revents) cl->broken = 1;
+				}
+			}
+			__atomic_store_n(&cl->ring->cq_sleep, 0, __ATOMIC_RELAXED);
+		}
+
+		pthread_mutex_lock(&cl->lock);
+		cl->sleeper = 0;
+		pthread_cond_broadcast(&cl->cond);
+	}
+
+	return SE_BROKER_OK;
+}
+
+int se_client_call(se_client* cl, unsigned int op, unsigned int arg,
+				   const void* const* in, const unsigned int* in_len, unsigned int n_in,
+				   void* const* out, unsigned int* out_len, unsigned int n_out, unsigned int* result)
+{
+	unsigned long long off = 0;
+	se_broker_slot* s;
+	unsigned int idx;
+	int ret, kick;
+
+	if (n_in > SE_BROKER_FIELDS || n_out > SE_BROKER_FIELDS) return SE_BROKER_ERR_OP;
+
+	pthread_mutex_lock(&cl->lock);
+	while (cl->n_free == 0 && !cl->broken) pthread_cond_wait(&cl->cond, &cl->lock);
+	if (cl->broken) {
+		pthread_mutex_unlock(&cl->lock);
+		return SE_BROKER_ERR_IO;
+	}
+	idx = cl->free[--cl->n_free];
+	cl->done[idx] = 0;
+	pthread_mutex_unlock(&cl->lock);
+
+	// -- the slot is this thread's until it is submitted
+	s = &cl->ring->slot[idx];
+	s->op = op;
+	s->arg = arg;
+	s->deadline = client_deadline;
+	s->n_in = n_in;
+	for (unsigned int i = 0; i < n_in; i++) {
+		if (off + in_len[i] > SE_BROKER_DATA) {
+			pthread_mutex_lock(&cl->lock);
+			cl->free[cl->n_free++] = idx;
+			pthread_cond_broadcast(&cl->cond);
+			pthread_mutex_unlock(&cl->lock);
+			return SE_BROKER_ERR_SIZE;
+		}
+		s->in_len[i] = in_len[i];
+		if (in_len[i]) memcpy(s->data + off, in[i], in_len[i]);
+		off += SE_BROKER_ALIGN(in_len[i]);
+	}
+
+	pthread_mutex_lock(&cl->lock);
+	__atomic_store_n(&cl->ring->sq[cl->sq_tail & (SE_BROKER_SLOTS - 1)], idx, __ATOMIC_RELAXED);
+	__atomic_store_n(&cl->ring->sq_tail, ++cl->sq_tail, __ATOMIC_SEQ_CST);
+	kick = __atomic_load_n(&cl->ring->sq_sleep, __ATOMIC_SEQ_CST);
+	pthread_mutex_unlock(&cl->lock);
+
+	if (kick) {
+		unsigned long long one = 1;
+		if (write(cl->sq_efd, &one, sizeof(one)) < 0) { /* counter saturated: the daemon is awake anyway */ }
+	}
+
+	pthread_mutex_lock(&cl->lock);
+	ret = client_wait(cl, idx);
+	if (ret == SE_BROKER_OK) ret = s->status;
+	if (ret == SE_BROKER_OK) {
+		for (unsigned int i = 0; i < n_out && i < s->n_out; i++) {
+			unsigned int n = s->out_len[i];
+			if (off + n > SE_BROKER_DATA || n > out_len[i]) {
+				ret = SE_BROKER_ERR_SIZE;
+				break;
+			}
+			if (n) memcpy(out[i], s->data + off, n);
+			out_len[i] = n;
+			off += SE_BROKER_ALIGN(n);
+		}
+		if (result != NULL) *result = s->result;
+	}
+	// -- a slot still owned by a lost daemon is never reused
+	if (!cl->broken) cl->free[cl->n_free++] = idx;
+	pthread_cond_broadcast(&cl->cond);
+	pthread_mutex_unlock(&cl->lock);
+
+	return ret;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// MAIN FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static int client_hash(unsigned int op, unsigned int arg, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, se_client* cl)
+{
+	const void* i[1] = { in };
+	void* o[1] = { out };
+
+	return se_client_call(cl, op, arg, i, &length, 1, o, &length_out, 1, NULL);
+}
+
+int sha3_256_cl(unsigned char* in, unsigned int length, unsigned char* out, se_client* cl)		{ return client_hash(SE_OP_SHA3_256, 0, in, length, out, 32, cl); }
+int sha3_512_cl(unsigned char* in, unsigned int length, unsigned char* out, se_client* cl)		{ return client_hash(SE_OP_SHA3_512, 0, in, length, out, 64, cl); }
+int sha_256_cl(unsigned char* in, unsigned int length, unsigned char* out, se_client* cl)		{ return client_hash(SE_OP_SHA_256, 0, in, length, out, 32, cl); }
+int sha_384_cl(unsigned char* in, unsigned int length, unsigned char* out, se_client* cl)		{ return client_hash(SE_OP_SHA_384, 0, in, length, out, 48, cl); }
+int sha_512_cl(unsigned char* in, unsigned int length, unsigned char* out, se_client* cl)		{ return client_hash(SE_OP_SHA_512, 0, in, length, out, 64, cl); }
+int sha_512_256_cl(unsigned char* in, unsigned int length, unsigned char* out, se_client* cl)	{ return client_hash(SE_OP_SHA_512_256, 0, in, length, out, 32, cl); }
+
+int shake128_cl(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, se_client* cl)
+{
+	return client_hash(SE_OP_SHAKE128, length_out, in, length, out, length_out, cl);
+}
+
+int shake256_cl(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, se_client* cl)
+{
+	return client_hash(SE_OP_SHAKE256, length_out, in, length, out, length_out, cl);
+}
+
+static int client_genkeys(unsigned int op, unsigned int arg, unsigned char* a, unsigned int len_a, unsigned char* b, unsigned int len_b, se_client* cl)
+{
+	void* o[2] = { a, b };
+	unsigned int ol[2] = { len_a, len_b };
+
+	return se_client_call(cl, op, arg, NULL, NULL, 0, o, ol, 2, NULL);
+}
+
+int eddsa25519_genkeys_cl(unsigned char* pri_key, unsigned char* pub_key, se_client* cl)
+{
+	return client_genkeys(SE_OP_EDDSA_GENKEYS, 0, pri_key, 32, pub_key, 32, cl);
+}
+
+int eddsa25519_sign_cl(const unsigned char* msg, unsigned long long msg_len, const unsigned char* pri_key, const unsigned char* pub_key, unsigned char* sig, se_client* cl)
+{
+	const void* i[3] = { msg, pri_key, pub_key };
+	unsigned int il[3] = { (unsigned int)msg_len, 32, 32 };
+	void* o[1] = { sig };
+	unsigned int ol[1] = { 64 };
+
+	if (msg_len > SE_BROKER_DATA) return SE_BROKER_ERR_SIZE;
+
+	return se_client_call(cl, SE_OP_EDDSA_SIGN, 0, i, il, 3, o, ol, 1, NULL);
+}
+
+int eddsa25519_verify_cl(const unsigned char* msg, unsigned long long msg_len, const unsigned char* pub_key, const unsigned char* sig, unsigned int* result, se_client* cl)
+{
+	const void* i[3] = { msg, pub_key, sig };
+	unsigned int il[3] = { (unsigned int)msg_len, 32, 64 };
+
+	if (msg_len > SE_BROKER_DATA) return SE_BROKER_ERR_SIZE;
+
+	return se_client_call(cl, SE_OP_EDDSA_VERIFY, 0, i, il, 3, NULL, NULL, 0, result);
+}
+
+int x25519_genkeys_cl(unsigned char* pri_key, unsigned char* pub_key, se_client* cl)
+{
+	return client_genkeys(SE_OP_X25519_GENKEYS, 0, pri_key, 32, pub_key, 32, cl);
+}
+
+int x25519_ss_gen_cl(unsigned char* shared_secret, const unsigned char* pub_key, const unsigned char* pri_key, se_client* cl)
+{
+	const void* i[2] = { pub_key, pri_key };
+	unsigned int il[2] = { 32, 32 };
+	void* o[1] = { shared_secret };
+	unsigned int ol[1] = { 32 };
+
+	return se_client_call(cl, SE_OP_X25519_SS, 0, i, il, 2, o, ol, 1, NULL);
+}
+
+int trng_cl(unsigned char* out, unsigned int bytes, se_client* cl)
+{
+	void* o[1] = { out };
+	unsigned int result = 0;
+	int ret = se_client_call(cl, SE_OP_TRNG, bytes, NULL, NULL, 0, o, &bytes, 1, &result);
+
+	return (ret != SE_BROKER_OK) ? ret : (int)result;
+}
+
+int aes_ecb_encrypt_cl(unsigned int bits, unsigned char* key, unsigned char* ciphertext, unsigned int* ciphertext_len, unsigned char* plaintext, unsigned int plaintext_len, se_client* cl)
+{
+	const void* i[2] = { key, plaintext };
+	unsigned int il[2] = { bits / 8, plaintext_len };
+	void* o[1] = { ciphertext };
+
+	*ciphertext_len = plaintext_len + 16;
+
+	return se_client_call(cl, SE_OP_AES_ECB_ENC, bits, i, il, 2, o, ciphertext_len, 1, NULL);
+}
+
+int aes_ecb_decrypt_cl(unsigned int bits, unsigned char* key, unsigned char* ciphertext, unsigned int ciphertext_len, unsigned char* plaintext, unsigned int* plaintext_len, se_client* cl)
+{
+	const void* i[2] = { key, ciphertext };
+	unsigned int il[2] = { bits / 8, ciphertext_len };
+	void* o[1] = { plaintext };
+
+	*plaintext_len = ciphertext_len;
+
+	return se_client_call(cl, SE_OP_AES_ECB_DEC, bits, i, il, 2, o, plaintext_len, 1, NULL);
+}
+
+int aes_cbc_encrypt_cl(unsigned int bits, unsigned char* key, unsigned char* iv, unsigned char* ciphertext, unsigned int* ciphertext_len, unsigned char* plaintext, unsigned int plaintext_len, se_client* cl)
+{
+	const void* i[3] = { key, iv, plaintext };
+	unsigned int il[3] = { bits / 8, 16, plaintext_len };
+	void* o[1] = { ciphertext };
+
+	*ciphertext_len = plaintext_len + 16;
+
+	return se_client_call(cl, SE_OP_AES_CBC_ENC, bits, i, il, 3, o, ciphertext_len, 1, NULL);
+}
+
+int aes_cbc_decrypt_cl(unsigned int bits, unsigned char* key, unsigned char* iv, unsigned char* ciphertext, unsigned int ciphertext_len, unsigned char* plaintext, unsigned int* plaintext_len, se_client* cl)
+{
+	const void* i[3] = { key, iv, ciphertext };
+	unsigned int il[3] = { bits / 8, 16, ciphertext_len };
+	void* o[1] = { plaintext };
+
+	*plaintext_len = ciphertext_len;
+
+	return se_client_call(cl, SE_OP_AES_CBC_DEC, bits, i, il, 3, o, plaintext_len, 1, NULL);
+}
+
+int aes_cmac_cl(unsigned int bits, unsigned char* key, unsigned char* mac, unsigned int* mac_len, unsigned char* msg, unsigned int msg_len, se_client* cl)
+{
+	const void* i[2] = { key, msg };
+	unsigned int il[2] = { bits / 8, msg_len };
+	void* o[1] = { mac };
+
+	*mac_len = 16;
+
+	return se_client_call(cl, SE_OP_AES_CMAC, bits, i, il, 2, o, mac_len, 1, NULL);
+}
+
+static int client_aead_enc(unsigned int op, unsigned int tag_len, unsigned int bits, unsigned char* key, unsigned char* iv, unsigned int iv_len, unsigned char* ciphertext, unsigned int* ciphertext_len,
+						   unsigned char* plaintext, unsigned int plaintext_len, unsigned char* aad, unsigned int aad_len, unsigned char* tag, se_client* cl)
+{
+	const void* i[4] = { key, iv, plaintext, aad };
+	unsigned int il[4] = { bits / 8, iv_len, plaintext_len, aad_len };
+	void* o[2] = { ciphertext, tag };
+	unsigned int ol[2] = { plaintext_len + 16, tag_len };
+	int ret = se_client_call(cl, op, bits, i, il, 4, o, ol, 2, NULL);
+
+	*ciphertext_len = ol[0];
+
+	return ret;
+}
+
+static int client_aead_dec(unsigned int op, unsigned int tag_len, unsigned int bits, unsigned char* key, unsigned char* iv, unsigned int iv_len, unsigned char* ciphertext, unsigned int ciphertext_len,
+						   unsigned char* plaintext, unsigned int* plaintext_len, unsigned char* aad, unsigned int aad_len, unsigned char* tag, unsigned int* result, se_client* cl)
+{
+	const void* i[5] = { key, iv, ciphertext, aad, tag };
+	unsigned int il[5] = { bits / 8, iv_len, ciphertext_len, aad_len, tag_len };
+	void* o[1] = { plaintext };
+
+	*plaintext_len = ciphertext_len + 16;
+
+	return se_client_call(cl, op, bits, i, il, 5, o, plaintext_len, 1, result);
+}
+
+int aes_ccm_8_encrypt_cl(unsigned int bits, unsigned char* key, unsigned char* iv, unsigned int iv_len, unsigned char* ciphertext, unsigned int* ciphertext_len,
+						 unsigned char* plaintext, unsigned int plaintext_len, unsigned char* aad, unsigned int aad_len, unsigned char* tag, se_client* cl)
+{
+	return client_aead_enc(SE_OP_AES_CCM_8_ENC, 8, bits, key, iv, iv_len, ciphertext, ciphertext_len, plaintext, plaintext_len, aad, aad_len, tag, cl);
+}
+
+int aes_ccm_8_decrypt_cl(unsigned int bits, unsigned char* key, unsigned char* iv, unsigned int iv_len, unsigned char* ciphertext, unsigned int ciphertext_len,
+						 unsigned char* plaintext, unsigned int* plaintext_len, unsigned char* aad, unsigned int aad_len, unsigned char* tag, unsigned int* result, se_client* cl)
+{
+	return client_aead_dec(SE_OP_AES_CCM_8_DEC, 8, bits, key, iv, iv_len, ciphertext, ciphertext_len, plaintext, plaintext_len, aad, aad_len, tag, result, cl);
+}
+
+int aes_gcm_encrypt_cl(unsigned int bits, unsigned char* key, unsigned char* iv, unsigned int iv_len, unsigned char* ciphertext, unsigned int* ciphertext_len,
+					   unsigned char* plaintext, unsigned int plaintext_len, unsigned char* aad, unsigned int aad_len, unsigned char* tag, se_client* cl)
+{
+	return client_aead_enc(SE_OP_AES_GCM_ENC, 16, bits, key, iv, iv_len, ciphertext, ciphertext_len, plaintext, plaintext_len, aad, aad_len, tag, cl);
+}
+
+int aes_gcm_decrypt_cl(unsigned int bits, unsigned char* key, unsigned char* iv, unsigned int iv_len, unsigned char* ciphertext, unsigned int ciphertext_len,
+					   unsigned char* plaintext, unsigned int* plaintext_len, unsigned char* aad, unsigned int aad_len, unsigned char* tag, unsigned int* result, se_client* cl)
+{
+	return client_aead_dec(SE_OP_AES_GCM_DEC, 16, bits, key, iv, iv_len, ciphertext, ciphertext_len, plaintext, plaintext_len, aad, aad_len, tag, result, cl);
+}
+
+#define CLIENT_MLKEM_PK(k)		(384 * (k) + 32)
+#define CLIENT_MLKEM_SK(k)		(768 * (k) + 96)
+#define CLIENT_MLKEM_CT(k)		(((k) == 4) ? 1568 : 320 * (k) + 128)
+
+int mlkem_gen_keys_cl(int k, unsigned char* pk, unsigned char* sk, se_client* cl)
+{
+	return client_genkeys(SE_OP_MLKEM_GENKEYS, k, pk, CLIENT_MLKEM_PK(k), sk, CLIENT_MLKEM_SK(k), cl);
+}
+
+int mlkem_enc_cl(int k, unsigned char* pk, unsigned char* ct, unsigned char* ss, se_client* cl)
+{
+	const void* i[1] = { pk };
+	unsigned int il[1] = { CLIENT_MLKEM_PK(k) };
+	void* o[2] = { ct, ss };
+	unsigned int ol[2] = { CLIENT_MLKEM_CT(k), 32 };
+
+	return se_client_call(cl, SE_OP_MLKEM_ENC, k, i, il, 1, o, ol, 2, NULL);
+}
+
+int mlkem_dec_cl(int k, unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, se_client* cl)
+{
+	const void* i[2] = { sk, ct };
+	unsigned int il[2] = { CLIENT_MLKEM_SK(k), CLIENT_MLKEM_CT(k) };
+	void* o[1] = { ss };
+	unsigned int ol[1] = { 32 };
+
+	return se_client_call(cl, SE_OP_MLKEM_DEC, k, i, il, 2, o, ol, 1, result);
+}
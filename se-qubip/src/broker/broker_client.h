@@ -0,0 +1,134 @@
+/**
+  * @file broker_client.h
+  * @brief SE broker client: se-qubip.h operations served by se-qubipd
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef BROKER_CLIENT_H
+#define BROKER_CLIENT_H
+
+#include "broker.h"
+
+	typedef struct se_client se_client;
+
+	/************************ Control Functions **********************/
+
+	//-- Connects to se-qubipd (path NULL: $SE_QUBIPD_SOCK, else SE_BROKER_PATH)
+	//-- and maps the request rings it hands over. After that a request costs no
+	//-- system call while the daemon is busy: the client copies the inputs into a
+	//-- slot, publishes its index on the SQ and spins on the CQ; the eventfds are
+	//-- only written when the other side has gone to sleep. A client may be
+	//-- shared by threads; up to SE_BROKER_SLOTS requests are in flight at once.
+	se_client* se_client_open(const char* path);
+	void se_client_close(se_client* cl);
+
+	//-- Every request the calling thread makes from now on carries this
+	//-- absolute CLOCK_MONOTONIC deadline in ns (intf_clock_ns; 0: none). The
+	//-- daemon drops a request still queued at its deadline and runs the others
+	//-- under it; both end with SE_BROKER_ERR_DEADLINE.
+	void se_client_set_deadline(unsigned long long deadline_ns);
+
+	//-- One request: n_in inputs, up to n_out outputs copied back (out_len: room
+	//-- in, length written out). Returns an SE_BROKER_* status; result gets the
+	//-- operation's own result word (verify, decrypt, decapsulation, TRNG).
+	int se_client_call(se_client* cl, unsigned int op, unsigned int arg,
+					   const void* const* in, const unsigned int* in_len, unsigned int n_in,
+					   void* const* out, unsigned int* out_len, unsigned int n_out, unsigned int* result);
+
+	/************************ Main Functions **********************/
+
+	//-- Same arguments as the library functions, the client in place of the
+	//-- INTF; each returns an SE_BROKER_* status (se-qubip-client.h maps the
+	//-- library names onto them)
+	int sha3_256_cl(unsigned char* in, unsigned int length, unsigned char* out, se_client* cl);
+	int sha3_512_cl(unsigned char* in, unsigned int length, unsigned char* out, se_client* cl);
+	int shake128_cl(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, se_client* cl);
+	int shake256_cl(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, se_client* cl);
+	int sha_256_cl(unsigned char* in, unsigned int length, unsigned char* out, se_client* cl);
+	int sha_384_cl(unsigned char* in, unsigned int length, unsigned char* out, se_client* cl);
+	int sha_512_cl(unsigned char* in, unsigned int length, unsigned char* out, se_client* cl);
+	int sha_512_256_cl(unsigned char* in, unsigned int length, unsigned char* out, se_client* cl);
+
+	int eddsa25519_genkeys_cl(unsigned char* pri_key, unsigned char* pub_key, se_client* cl);
+	int eddsa25519_sign_cl(const unsigned char* msg, unsigned long long msg_len, const unsigned char* pri_key, const unsigned char* pub_key, unsigned char* sig, se_client* cl);
+	int eddsa25519_verify_cl(const unsigned char* msg, unsigned long long msg_len, const unsigned char* pub_key, const unsigned char* sig, unsigned int* result, se_client* cl);
+
+	int x25519_genkeys_cl(unsigned char* pri_key, unsigned char* pub_key, se_client* cl);
+	int x25519_ss_gen_cl(unsigned char* shared_secret, const unsigned char* pub_key, const unsigned char* pri_key, se_client* cl);
+
+	//-- SE_BROKER_* on transport errors, else the TRNG_* result of trng_hw
+	int trng_cl(unsigned char* out, unsigned int bytes, se_client* cl);
+
+	int aes_ecb_encrypt_cl(unsigned int bits, unsigned char* key, unsigned char* ciphertext, unsigned int* ciphertext_len, unsigned char* plaintext, unsigned int plaintext_len, se_client* cl);
+	int aes_ecb_decrypt_cl(unsigned int bits, unsigned char* key, unsigned char* ciphertext, unsigned int ciphertext_len, unsigned char* plaintext, unsigned int* plaintext_len, se_client* cl);
+	int aes_cbc_encrypt_cl(unsigned int bits, unsigned char* key, unsigned char* iv, unsigned char* ciphertext, unsigned int* ciphertext_len, unsigned char* plaintext, unsigned int plaintext_len, se_client* cl);
+	int aes_cbc_decrypt_cl(unsigned int bits, unsigned char* key, unsigned char* iv, unsigned char* ciphertext, unsigned int ciphertext_len, unsigned char* plaintext, unsigned int* plaintext_len, se_client* cl);
+	int aes_cmac_cl(unsigned int bits, unsigned char* key, unsigned char* mac, unsigned int* mac_len, unsigned char* msg, unsigned int msg_len, se_client* cl);
+	int aes_ccm_8_encrypt_cl(unsigned int bits, unsigned char* key, unsigned char* iv, unsigned int iv_len, unsigned char* ciphertext, unsigned int* ciphertext_len,
+							 unsigned char* plaintext, unsigned int plaintext_len, unsigned char* aad, unsigned int aad_len, unsigned char* tag, se_client* cl);
+	int aes_ccm_8_decrypt_cl(unsigned int bits, unsigned char* key, unsigned char* iv, unsigned int iv_len, unsigned char* ciphertext, unsigned int ciphertext_len,
+							 unsigned char* plaintext, unsigned int* plaintext_len, unsigned char* aad, unsigned int aad_len, unsigned char* tag, unsigned int* result, se_client* cl);
+	int aes_gcm_encrypt_cl(unsigned int bits, unsigned char* key, unsigned char* iv, unsigned int iv_len, unsigned char* ciphertext, unsigned int* ciphertext_len,
+						   unsigned char* plaintext, unsigned int plaintext_len, unsigned char* aad, unsigned int aad_len, unsigned char* tag, se_client* cl);
+	int aes_gcm_decrypt_cl(unsigned int bits, unsigned char* key, unsigned char* iv, unsigned int iv_len, unsigned char* ciphertext, unsigned int ciphertext_len,
+						   unsigned char* plaintext, unsigned int* plaintext_len, unsigned char* aad, unsigned int aad_len, unsigned char* tag, unsigned int* result, se_client* cl);
+
+	int mlkem_gen_keys_cl(int k, unsigned char* pk, unsigned char* sk, se_client* cl);
+	int mlkem_enc_cl(int k, unsigned char* pk, unsigned char* ct, unsigned char* ss, se_client* cl);
+	int mlkem_dec_cl(int k, unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, se_client* cl);
+
+#endif
@@ -58,18 +58,11 @@
   * @version 1.0
   **/
 #include "extra_func.h"
+#include "../trng/trng_pool.h"
 
 void swapEndianness(unsigned char *data, size_t size)
 {
-    size_t i;
-    unsigned char temp;
-
-    for (i = 0; i < size / 2; ++i)
-    {
-        temp = data[i];
-        data[i] = data[size - 1 - i];
-        data[size - 1 - i] = temp;
-    }
+    pack_reverse(data, size);
 }
 
 void seed_rng()
@@ -77,17 +70,10 @@ void seed_rng()
     srand((unsigned int)time(NULL)); // Initialization, should only be called once.
 }
 
+//-- Drawn from the TRNG entropy pool (OS generator until trng_pool_init)
 void gen_priv_key(unsigned char *priv_key, unsigned int priv_len)
 {
-    unsigned int r;    // Returns a pseudo-random integer between 0 and RAND_MAX.
-
-    for (int i = 0; i < priv_len / sizeof(int); i++)
-    {
-        r = rand();
-        // printf("r = 0x%08X\n", r);
-
-        memcpy(priv_key + i*sizeof(int), &r, sizeof(int));
-    }
+    trng_pool_get(priv_key, priv_len);
 
     /*
     printf("priv_key = 0x");
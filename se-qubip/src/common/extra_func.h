@@ -64,6 +64,7 @@
 #include <string.h>
 #include <time.h>
 #include <sys/time.h>
+#include "pack.h"
 
 void swapEndianness(unsigned char *data, size_t size);
 void seed_rng();
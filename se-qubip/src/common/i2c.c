@@ -204,27 +204,25 @@ void read_I2C_ull(I2C_FD i2c_fd, void* data, size_t offset, size_t size_data)
     //-- Write Pointer Index
     write(i2c_fd, &ptr_idx, 1);
     //-- Read from I2C Port
-    unsigned char data_char[size_data];
+    size_t size_data_ull = (size_data % 8 == 0) ? (size_data / 8) : (size_data / 8 + 1);
+    unsigned char data_char[8 * size_data_ull];
+    unsigned long long data_ull[size_data_ull];
+    memset(data_char, 0, sizeof(data_char));
     read(i2c_fd, data_char, size_data);
     //-- Cast char to unsigned long long
-    size_t size_data_ull = (size_data % 8 == 0) ? (size_data / 8) : (size_data / 8 + 1);
-    for (int i = 0; i < size_data_ull; i++)
-    {
-        swapEndianness(data_char + 8 * i, 8);
-    }
-    memcpy(data, data_char, size_data);
+    pack_be64(data_ull, data_char, size_data_ull);
+    memcpy(data, data_ull, size_data);
 }
 
 void write_I2C_ull(I2C_FD i2c_fd, void* data, size_t offset, size_t size_data)
 {
     //-- Cast unsigned long long to char
-    unsigned char data_char[size_data];
     size_t size_data_ull = (size_data % 8 == 0) ? (size_data / 8) : (size_data / 8 + 1);
-    memcpy(data_char, data, size_data);
-    for (int i = 0; i < size_data_ull; i++)
-    {
-        swapEndianness(data_char + 8 * i, 8);
-    }
+    unsigned long long data_ull[size_data_ull];
+    unsigned char data_char[8 * size_data_ull];
+    data_ull[size_data_ull - 1] = 0;
+    memcpy(data_ull, data, size_data);
+    unpack_be64(data_char, data_ull, size_data_ull);
     //-- Buffer -> {Pointer_index, data_char}
     unsigned char buf[1 + size_data];
     //-- Pointer Index
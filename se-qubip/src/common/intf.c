@@ -75,6 +75,376 @@
 ////////////////////////////////////////////////////////////////////////////////////
 
 #include "intf.h"
+#include "conf.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define INTF_DEV_SHARED     1
+#define INTF_DEV_EXCL       2
+
+#ifdef SE_PARALLEL_CORES
+    #define INTF_CORE_SHARED(core)  ((core) == SE_CORE_X25519 || (core) == SE_CORE_MLKEM)
+#else
+    #define INTF_CORE_SHARED(core)  0
+#endif
+
+//-- One context per open device; close_INTF releases the slot for the next open
+static se_ctx intf_track[INTF_MAX_TRACK];
+
+//-- Per thread and device: registers as this thread last wrote them and the locks it holds
+static __thread struct {
+    unsigned int gen;                   // se_ctx.gen this entry belongs to
+    unsigned long long control;
+    unsigned long long address;
+    unsigned char valid;                // bit 0: control, bit 1: address
+    unsigned char core[SE_N_CORE];      // recursion depth
+    unsigned char device;               // cores held
+    unsigned char mode;                 // INTF_DEV_SHARED / INTF_DEV_EXCL
+    unsigned int shm;                   // Lock table entries held (bit INTF_SHM_DEVICE: the device)
+    int status;                         // First error since the thread took the device
+    unsigned char fault;                // Held cores that faulted
+    unsigned long long deadline;        // CLOCK_MONOTONIC ns, 0 = none
+    unsigned long long since[SE_N_CORE];    // When the core was taken
+    unsigned long long units[SE_N_CORE];    // Units admitted on it since
+} intf_thread[INTF_MAX_TRACK];
+
+//-- Device this thread used last: register accesses skip the slot search
+static __thread se_ctx* intf_last;
+
+static unsigned int intf_breaker_fails = SE_BREAKER_FAILS;
+static unsigned long long intf_breaker_cool = SE_BREAKER_COOL_MS * 1000000ULL;
+
+#define INTF_SHM_MAGIC      0x5345514dU         // "SEQM"
+#define INTF_SHM_VERSION    1
+#define INTF_SHM_DEVICE     SE_N_CORE           // Index of the device lock
+#define INTF_SHM_WAIT_US    1000000             // Attach: how long to wait for the creator
+
+struct intf_shm {
+    unsigned int magic;                         // Written last by the creator
+    unsigned int version;
+    unsigned int size;
+    pthread_mutex_t lock[SE_N_CORE + 1];        // Cores, then the device
+    int owner;                                  // Process that last took a lock
+    intf_shm_stat st;
+};
+
+static char intf_shm_name[64];
+static int intf_shm_env = 0;
+
+static size_t intf_id(INTF interface)
+{
+#ifdef I2C
+    return (size_t)interface;
+#else
+    return (size_t)interface.address_base;
+#endif
+}
+
+static pthread_mutex_t intf_track_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void intf_ctx_init(se_ctx* c, INTF interface, size_t id, int slot)
+{
+    pthread_rwlockattr_t attr;
+    unsigned int gen = c->gen + 1;
+
+    memset(c, 0, sizeof(se_ctx));
+    c->interface = interface;
+    c->id = id;
+    c->slot = slot;
+    c->gen = gen;
+    pthread_mutex_init(&c->transport, NULL);
+    pthread_rwlockattr_init(&attr);
+#ifdef __GLIBC__
+    // -- a waiting exclusive core is not starved by a stream of X25519 / ML-KEM operations
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+    pthread_rwlock_init(&c->device, &attr);
+    pthread_rwlockattr_destroy(&attr);
+    for (int k = 0; k < SE_N_CORE; k++) pthread_mutex_init(&c->core[k], NULL);
+}
+
+//-- The thread's entry of a slot reopened since the thread last used it starts afresh
+static int intf_slot_found(se_ctx* c)
+{
+    if (intf_thread[c->slot].gen != c->gen)
+    {
+        memset(&intf_thread[c->slot], 0, sizeof(intf_thread[0]));
+        intf_thread[c->slot].gen = c->gen;
+    }
+    intf_last = c;
+
+    return c->slot;
+}
+
+static int intf_slot(INTF interface, int add)
+{
+    size_t id = intf_id(interface);
+    se_ctx* c = intf_last;
+    int slot = -1;
+
+    if (c != NULL && __atomic_load_n(&c->used, __ATOMIC_ACQUIRE) && c->id == id) return intf_slot_found(c);
+
+    // -- closed slots leave holes: look at all of them
+    for (int i = 0; i < INTF_MAX_TRACK; i++)
+        if (__atomic_load_n(&intf_track[i].used, __ATOMIC_ACQUIRE) && intf_track[i].id == id) return intf_slot_found(&intf_track[i]);
+
+    if (!add) return -1;
+
+    pthread_mutex_lock(&intf_track_lock);
+    for (int i = 0; i < INTF_MAX_TRACK; i++)
+    {
+        if (intf_track[i].used && intf_track[i].id == id)   { slot = i; break; }
+        if (!intf_track[i].used && slot < 0)                slot = i;
+    }
+    if (slot >= 0 && !intf_track[slot].used)
+    {
+        intf_ctx_init(&intf_track[slot], interface, id, slot);
+        __atomic_store_n(&intf_track[slot].used, 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&intf_track_lock);
+
+    return (slot >= 0) ? intf_slot_found(&intf_track[slot]) : -1;
+}
+
+//-- The caller guarantees that no thread still uses the device. A context whose
+//-- completion thread runs (se_op_post) keeps its slot until se_op_stop.
+static void intf_slot_release(INTF interface)
+{
+    size_t id = intf_id(interface);
+    se_ctx* c = NULL;
+
+    pthread_mutex_lock(&intf_track_lock);
+    for (int i = 0; i < INTF_MAX_TRACK && c == NULL; i++)
+        if (intf_track[i].used && intf_track[i].id == id) c = &intf_track[i];
+    if (c != NULL && __atomic_load_n(&c->engine, __ATOMIC_ACQUIRE) != NULL)
+    {
+        printf("\n SE FAIL!: close with the completion thread running (se_op_stop first)\n");
+        c = NULL;
+    }
+    if (c != NULL)
+    {
+        __atomic_store_n(&c->used, 0, __ATOMIC_RELEASE);
+        if (c->shm != NULL) munmap(c->shm, sizeof(struct intf_shm));
+        c->shm = NULL;
+        free(c->trng);
+        c->trng = NULL;
+        pthread_mutex_destroy(&c->transport);
+        pthread_rwlock_destroy(&c->device);
+        for (int k = 0; k < SE_N_CORE; k++) pthread_mutex_destroy(&c->core[k]);
+    }
+    pthread_mutex_unlock(&intf_track_lock);
+
+    if (intf_last == c) intf_last = NULL;
+}
+
+//------------------------------------------------------------------
+//-- Cross-process lock table
+//------------------------------------------------------------------
+
+static struct intf_shm* intf_shm_attach(size_t address)
+{
+    char path[96];
+    struct stat st;
+    struct intf_shm* shm;
+    pthread_mutexattr_t attr;
+    int fd, created = 1, waited = 0;
+
+    snprintf(path, sizeof(path), "/%s-%zx", intf_shm_name, address);
+
+    fd = shm_open(path, O_RDWR | O_CREAT | O_EXCL, 0660);
+    if (fd < 0 && errno == EEXIST)
+    {
+        created = 0;
+        fd = shm_open(path, O_RDWR, 0);
+    }
+    if (fd < 0 || (created && ftruncate(fd, sizeof(struct intf_shm)) != 0))
+    {
+        printf("\n SHM FAIL!: %s: %s\n", path, strerror(errno));
+        if (fd >= 0) close(fd);
+        return NULL;
+    }
+
+    // -- another process may have created the segment and not sized it yet
+    while (!created && fstat(fd, &st) == 0 && st.st_size < (off_t)sizeof(struct intf_shm) && waited < INTF_SHM_WAIT_US)
+    {
+        usleep(1000);
+        waited += 1000;
+    }
+
+    shm = mmap(NULL, sizeof(struct intf_shm), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shm == MAP_FAILED)
+    {
+        printf("\n SHM FAIL!: %s: %s\n", path, strerror(errno));
+        return NULL;
+    }
+
+    if (created)
+    {
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+        for (int i = 0; i <= INTF_SHM_DEVICE; i++) pthread_mutex_init(&shm->lock[i], &attr);
+        pthread_mutexattr_destroy(&attr);
+        shm->version = INTF_SHM_VERSION;
+        shm->size = sizeof(struct intf_shm);
+        __atomic_store_n(&shm->magic, INTF_SHM_MAGIC, __ATOMIC_RELEASE);
+    }
+
+    while (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != INTF_SHM_MAGIC && waited < INTF_SHM_WAIT_US)
+    {
+        usleep(1000);
+        waited += 1000;
+    }
+    if (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != INTF_SHM_MAGIC || shm->version != INTF_SHM_VERSION || shm->size != sizeof(struct intf_shm))
+    {
+        printf("\n SHM FAIL!: %s: not a lock table of this library version\n", path);
+        munmap(shm, sizeof(struct intf_shm));
+        return NULL;
+    }
+
+    __atomic_add_fetch(&shm->st.attached, 1, __ATOMIC_RELAXED);
+
+    return shm;
+}
+
+//-- Called by open_INTF: attach once per device when the lock table is enabled
+static void intf_shm_open(se_ctx* c, size_t address)
+{
+    const char* env;
+
+    pthread_mutex_lock(&intf_track_lock);
+    if (!intf_shm_env)
+    {
+        intf_shm_env = 1;
+        if ((env = getenv("SE_QUBIP_SHM")) != NULL && strlen(env) < sizeof(intf_shm_name))
+            strcpy(intf_shm_name, (env[0] == '/') ? env + 1 : env);
+    }
+    if (c->shm == NULL && intf_shm_name[0] != '\0')
+        __atomic_store_n(&c->shm, intf_shm_attach(address), __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&intf_track_lock);
+}
+
+int intf_shm_enable(const char* name)
+{
+    if (name != NULL && name[0] == '/') name++;
+    if (name != NULL && (strlen(name) >= sizeof(intf_shm_name) || strchr(name, '/') != NULL)) return -1;
+
+    pthread_mutex_lock(&intf_track_lock);
+    intf_shm_env = 1;
+    strcpy(intf_shm_name, (name != NULL) ? name : "");
+    pthread_mutex_unlock(&intf_track_lock);
+
+    return 0;
+}
+
+int intf_shm_stats(INTF interface, intf_shm_stat* st)
+{
+    int slot = intf_slot(interface, 0);
+    struct intf_shm* shm = (slot >= 0) ? __atomic_load_n(&intf_track[slot].shm, __ATOMIC_ACQUIRE) : NULL;
+
+    memset(st, 0, sizeof(intf_shm_stat));
+    if (shm == NULL) return -1;
+
+    for (int k = 0; k < SE_N_CORE; k++)
+    {
+        st->ops[k] = __atomic_load_n(&shm->st.ops[k], __ATOMIC_RELAXED);
+        st->contended[k] = __atomic_load_n(&shm->st.contended[k], __ATOMIC_RELAXED);
+    }
+    st->recovered = __atomic_load_n(&shm->st.recovered, __ATOMIC_RELAXED);
+    st->attached = __atomic_load_n(&shm->st.attached, __ATOMIC_RELAXED);
+
+    return 0;
+}
+
+static int intf_shm_take(struct intf_shm* shm, int i, int wait)
+{
+    int ret = wait ? pthread_mutex_lock(&shm->lock[i]) : pthread_mutex_trylock(&shm->lock[i]);
+
+    // -- the owner died holding it: its operation is lost, and the next one resets the core
+    if (ret == EOWNERDEAD)
+    {
+        pthread_mutex_consistent(&shm->lock[i]);
+        __atomic_add_fetch(&shm->st.recovered, 1, __ATOMIC_RELAXED);
+        ret = 0;
+    }
+
+    return (ret == 0) ? 0 : -1;
+}
+
+//-- Entries a thread needs for the cores it holds (plus core): its cores, and
+//-- for an exclusive one the device and the X25519 / ML-KEM entries, so that no
+//-- process has one of those running either
+static unsigned int intf_shm_need(int slot, int core)
+{
+    unsigned int need = (core >= 0) ? (1u << core) : 0;
+    int excl = (core >= 0 && !INTF_CORE_SHARED(core));
+
+    for (int k = 0; k < SE_N_CORE; k++)
+    {
+        if (!intf_thread[slot].core[k]) continue;
+        need |= 1u << k;
+        if (!INTF_CORE_SHARED(k)) excl = 1;
+    }
+    if (excl)
+    {
+        need |= 1u << INTF_SHM_DEVICE;
+        for (int k = 0; k < SE_N_CORE; k++) if (INTF_CORE_SHARED(k)) need |= 1u << k;
+    }
+
+    return need;
+}
+
+//-- Order: ML-KEM, X25519, the device, then the cores only taken under it. It is
+//-- the nesting order of intf_core_lock, so a thread that holds ML-KEM and takes
+//-- X25519 (the hybrid KEM) never waits for a process doing the opposite.
+static int intf_shm_lock(se_ctx* c, int slot, int core, int wait)
+{
+    struct intf_shm* shm = __atomic_load_n(&c->shm, __ATOMIC_ACQUIRE);
+    unsigned int miss, got = 0;
+    int rank;
+
+    if (shm == NULL) return 0;
+
+    miss = intf_shm_need(slot, core) & ~intf_thread[slot].shm;
+    for (int pass = 0; pass < 4; pass++)
+    {
+        for (int i = 0; i <= INTF_SHM_DEVICE; i++)
+        {
+            if (i == INTF_SHM_DEVICE)       rank = 2;
+            else if (INTF_CORE_SHARED(i))   rank = (i == SE_CORE_MLKEM) ? 0 : 1;
+            else                            rank = 3;
+            if (rank != pass || !(miss & (1u << i))) continue;
+            if (intf_shm_take(shm, i, wait) != 0)
+            {
+                for (int j = 0; j <= INTF_SHM_DEVICE; j++) if (got & (1u << j)) pthread_mutex_unlock(&shm->lock[j]);
+                return -1;
+            }
+            got |= 1u << i;
+        }
+    }
+    intf_thread[slot].shm |= got;
+
+    return 0;
+}
+
+static void intf_shm_release(se_ctx* c, int slot)
+{
+    struct intf_shm* shm = __atomic_load_n(&c->shm, __ATOMIC_ACQUIRE);
+    unsigned int drop;
+
+    if (shm == NULL) return;
+
+    drop = intf_thread[slot].shm & ~intf_shm_need(slot, -1);
+    for (int i = 0; i <= INTF_SHM_DEVICE; i++) if (drop & (1u << i)) pthread_mutex_unlock(&shm->lock[i]);
+    intf_thread[slot].shm &= ~drop;
+}
 
 //------------------------------------------------------------------
 //-- Open and Close Interface
@@ -88,10 +458,18 @@ void open_INTF(INTF* interface, size_t address, size_t length)
 #else
     createMMIOWindow(interface, address, length);
 #endif
+    int slot = intf_slot(*interface, 1);
+    if (slot >= 0)
+    {
+        intf_track[slot].interface = *interface;
+        __atomic_store_n(&intf_track[slot].token, 0, __ATOMIC_RELEASE);
+        intf_shm_open(&intf_track[slot], address);
+    }
 }
 
 void close_INTF(INTF interface)
 {
+    intf_slot_release(interface);
 #ifdef I2C
     close_I2C(interface);
 #else
@@ -99,25 +477,507 @@ void close_INTF(INTF interface)
 #endif
 }
 
+se_ctx* se_open(size_t address, size_t length)
+{
+    INTF interface;
+    int slot;
+
+    open_INTF(&interface, address, length);
+    slot = intf_slot(interface, 0);
+    if (slot < 0)
+    {
+        printf("\n SE FAIL!: more than %d devices\n", INTF_MAX_TRACK);
+        close_INTF(interface);
+        return NULL;
+    }
+
+    return &intf_track[slot];
+}
+
+void se_close(se_ctx* ctx)
+{
+    if (ctx != NULL) close_INTF(ctx->interface);
+}
+
+se_ctx* se_ctx_of(INTF interface)
+{
+    int slot = intf_slot(interface, 0);
+
+    return (slot >= 0) ? &intf_track[slot] : NULL;
+}
+
 //------------------------------------------------------------------
 //--Read & Write
 //------------------------------------------------------------------
 
+static void intf_raw_write(INTF interface, void* data, size_t offset, size_t size_data)
+{
+#ifdef I2C
+    write_I2C_ull(interface, data, offset, size_data);
+#else
+    writeMMIO(&interface, data, offset, size_data);
+#endif
+}
+
+static void intf_track_control(int slot, unsigned long long control)
+{
+    unsigned long long module = control >> 32;
+
+    if (intf_track[slot].module != module)
+    {
+        intf_track[slot].module = module;
+        __atomic_store_n(&intf_track[slot].token, 0, __ATOMIC_RELEASE);
+    }
+}
+
+#ifdef SE_PARALLEL_CORES
+//-- Another thread may have addressed its own core since this thread's last
+//-- access: put back this thread's CONTROL (and ADDRESS for data accesses)
+static void intf_restore(INTF interface, int slot, size_t offset)
+{
+    se_ctx* c = &intf_track[slot];
+    unsigned long long v;
+
+    if (offset != CONTROL && (intf_thread[slot].valid & 1) && c->control != intf_thread[slot].control)
+    {
+        v = intf_thread[slot].control;
+        intf_track_control(slot, v);
+        intf_raw_write(interface, &v, CONTROL, sizeof(v));
+        c->control = v;
+    }
+    if (offset != CONTROL && offset != ADDRESS && (intf_thread[slot].valid & 2) && c->address != intf_thread[slot].address)
+    {
+        v = intf_thread[slot].address;
+        intf_raw_write(interface, &v, ADDRESS, sizeof(v));
+        c->address = v;
+    }
+}
+#endif
+
 void read_INTF(INTF interface, void* data, size_t offset, size_t size_data)
 {
+#ifdef SE_PARALLEL_CORES
+    int slot = intf_slot(interface, 0);
+
+    if (slot >= 0)
+    {
+        pthread_mutex_lock(&intf_track[slot].transport);
+        intf_restore(interface, slot, offset);
+    }
+#endif
+
 #ifdef I2C
     read_I2C_ull(interface, data, offset, size_data);
 #else
     readMMIO(&interface, data, offset, size_data);
 #endif
+
+#ifdef SE_PARALLEL_CORES
+    if (slot >= 0) pthread_mutex_unlock(&intf_track[slot].transport);
+#endif
 }
 
 void write_INTF(INTF interface, void* data, size_t offset, size_t size_data)
 {
-#ifdef I2C
-    write_I2C_ull(interface, data, offset, size_data);
+#ifdef SE_PARALLEL_CORES
+    int slot = intf_slot(interface, 0);
+
+    if (slot >= 0)
+    {
+        pthread_mutex_lock(&intf_track[slot].transport);
+        intf_restore(interface, slot, offset);
+        if (offset == CONTROL || offset == ADDRESS)
+        {
+            unsigned long long v = *(unsigned long long*)data;
+            int bit = (offset == CONTROL) ? 1 : 2;
+            if (offset == CONTROL)  intf_thread[slot].control = intf_track[slot].control = v;
+            else                    intf_thread[slot].address = intf_track[slot].address = v;
+            intf_thread[slot].valid |= bit;
+        }
+    }
 #else
-    writeMMIO(&interface, data, offset, size_data);
+    int slot = (offset == CONTROL) ? intf_slot(interface, 0) : -1;
+#endif
+
+    if (slot >= 0 && offset == CONTROL) intf_track_control(slot, *(unsigned long long*)data);
+
+    intf_raw_write(interface, data, offset, size_data);
+
+#ifdef SE_PARALLEL_CORES
+    if (slot >= 0) pthread_mutex_unlock(&intf_track[slot].transport);
 #endif
 }
 
+//------------------------------------------------------------------
+//-- Resident data tracking
+//------------------------------------------------------------------
+
+void intf_set_resident(INTF interface, unsigned long long token)
+{
+    int slot = intf_slot(interface, 0);
+
+    if (slot >= 0) __atomic_store_n(&intf_track[slot].token, token, __ATOMIC_RELEASE);
+}
+
+unsigned long long intf_resident(INTF interface)
+{
+    int slot = intf_slot(interface, 0);
+
+    return (slot >= 0) ? __atomic_load_n(&intf_track[slot].token, __ATOMIC_ACQUIRE) : 0;
+}
+
+//------------------------------------------------------------------
+//-- Core locking
+//------------------------------------------------------------------
+
+//-- Device lock in the mode the core needs. A thread holding the device shared
+//-- that now needs it exclusively drops it first: the cores it holds are the
+//-- ones the SE keeps running while unaddressed. The lock order is X25519 /
+//-- ML-KEM mutexes, the device, then the other core mutexes; a thread never
+//-- waits for an X25519 / ML-KEM mutex holding the device, so the readers an
+//-- upgrading thread waits for never wait for it.
+static int intf_device_lock(se_ctx* c, int slot, int mode, int wait)
+{
+    int ret;
+
+    if (intf_thread[slot].mode >= mode) return 0;
+
+    if (!wait)
+    {
+        if (intf_thread[slot].mode != 0) return -1;
+        ret = (mode == INTF_DEV_SHARED) ? pthread_rwlock_tryrdlock(&c->device) : pthread_rwlock_trywrlock(&c->device);
+        if (ret != 0) return -1;
+    }
+    else
+    {
+        if (intf_thread[slot].mode != 0) pthread_rwlock_unlock(&c->device);
+        if (mode == INTF_DEV_SHARED)    pthread_rwlock_rdlock(&c->device);
+        else                            pthread_rwlock_wrlock(&c->device);
+    }
+    intf_thread[slot].mode = mode;
+
+    return 0;
+}
+
+static unsigned long long intf_now()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+//-- Racing threads may drop a sample: the average only steers admission
+static void intf_core_sample(se_ctx* c, int core, unsigned long long ns)
+{
+    unsigned long long avg = __atomic_load_n(&c->unit_ns[core], __ATOMIC_RELAXED);
+
+    avg = (avg == 0) ? ns : avg - (avg >> SE_UNIT_EWMA_SHIFT) + (ns >> SE_UNIT_EWMA_SHIFT);
+    __atomic_store_n(&c->unit_ns[core], avg, __ATOMIC_RELAXED);
+}
+
+static int intf_core_acquire(INTF interface, int core, int wait)
+{
+    int slot = intf_slot(interface, 0);
+    int mode = INTF_CORE_SHARED(core) ? INTF_DEV_SHARED : INTF_DEV_EXCL;
+    int held, contended = 0;
+    se_ctx* c;
+
+    // -- interfaces not opened with open_INTF / se_open are not tracked
+    if (slot < 0 || core < 0 || core >= SE_N_CORE) return 0;
+    c = &intf_track[slot];
+
+    if (intf_thread[slot].core[core])
+    {
+        intf_thread[slot].core[core]++;
+        return 0;
+    }
+
+    if (!wait && __atomic_load_n(&c->waiters[core], __ATOMIC_ACQUIRE)) return -1;
+
+    // -- other processes first: a thread never waits for them holding a lock of its own process
+    if (intf_shm_lock(c, slot, core, 0) != 0)
+    {
+        if (!wait) return -1;
+        contended = 1;
+        __atomic_add_fetch(&c->shm->st.contended[core], 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&c->waiters[core], 1, __ATOMIC_ACQ_REL);
+        intf_shm_lock(c, slot, core, 1);
+        __atomic_sub_fetch(&c->waiters[core], 1, __ATOMIC_ACQ_REL);
+    }
+    if (c->shm != NULL)
+    {
+        __atomic_add_fetch(&c->shm->st.ops[core], 1, __ATOMIC_RELAXED);
+        // -- another process may have reloaded the core since this one left data in it
+        if (__atomic_exchange_n(&c->shm->owner, (int)getpid(), __ATOMIC_ACQ_REL) != (int)getpid())
+            __atomic_store_n(&c->token, 0, __ATOMIC_RELEASE);
+    }
+
+    held = (intf_thread[slot].mode != 0);
+    if (intf_device_lock(c, slot, mode, 0) != 0 || pthread_mutex_trylock(&c->core[core]) != 0)
+    {
+        if (!held && intf_thread[slot].mode != 0)
+        {
+            pthread_rwlock_unlock(&c->device);
+            intf_thread[slot].mode = 0;
+        }
+        if (!wait)
+        {
+            intf_shm_release(c, slot);
+            return -1;
+        }
+
+        // -- X25519 / ML-KEM wait for the core first, so a waiter never holds the
+        // -- device shared while the owner of its core needs it exclusively or
+        // -- waits behind a queued writer for it. A thread that already holds the
+        // -- other shared core lets the device go for the wait. The other cores
+        // -- are only taken under the exclusive lock, which leaves their mutexes
+        // -- free to whoever holds it.
+        __atomic_add_fetch(&c->waiters[core], 1, __ATOMIC_ACQ_REL);
+        if (mode == INTF_DEV_SHARED)
+        {
+            if (intf_thread[slot].mode == INTF_DEV_SHARED)
+            {
+                pthread_rwlock_unlock(&c->device);
+                intf_thread[slot].mode = 0;
+            }
+            pthread_mutex_lock(&c->core[core]);
+            intf_device_lock(c, slot, mode, 1);
+        }
+        else
+        {
+            intf_device_lock(c, slot, mode, 1);
+            pthread_mutex_lock(&c->core[core]);
+        }
+        __atomic_sub_fetch(&c->waiters[core], 1, __ATOMIC_ACQ_REL);
+        contended = 1;
+    }
+    if (contended) __atomic_add_fetch(&c->contended[core], 1, __ATOMIC_RELAXED);
+
+    if (intf_thread[slot].device == 0)
+    {
+        intf_thread[slot].status = SE_OK;
+        intf_thread[slot].fault = 0;
+    }
+    intf_thread[slot].core[core] = 1;
+    intf_thread[slot].since[core] = intf_now();
+    intf_thread[slot].device++;
+    __atomic_add_fetch(&c->ops[core], 1, __ATOMIC_RELAXED);
+
+    return 0;
+}
+
+void intf_core_lock(INTF interface, int core)
+{
+    intf_core_acquire(interface, core, 1);
+}
+
+int intf_core_trylock(INTF interface, int core)
+{
+    return intf_core_acquire(interface, core, 0);
+}
+
+void intf_core_unlock(INTF interface, int core)
+{
+    int slot = intf_slot(interface, 0);
+    se_ctx* c;
+
+    if (slot < 0 || core < 0 || core >= SE_N_CORE || intf_thread[slot].core[core] == 0) return;
+    c = &intf_track[slot];
+
+    if (--intf_thread[slot].core[core]) return;
+
+    // -- an operation without fault closes the breaker and times the core
+    if (intf_thread[slot].fault & (1U << core))     intf_thread[slot].fault &= ~(1U << core);
+    else
+    {
+        if (__atomic_load_n(&c->fails[core], __ATOMIC_RELAXED))    __atomic_store_n(&c->fails[core], 0, __ATOMIC_RELAXED);
+        if (intf_thread[slot].units[core])          intf_core_sample(c, core, (intf_now() - intf_thread[slot].since[core]) / intf_thread[slot].units[core]);
+    }
+    intf_thread[slot].units[core] = 0;
+
+    pthread_mutex_unlock(&c->core[core]);
+    if (--intf_thread[slot].device == 0)
+    {
+        pthread_rwlock_unlock(&c->device);
+        intf_thread[slot].mode = 0;
+    }
+    intf_shm_release(c, slot);
+}
+
+int intf_core_shared(int core)
+{
+    return (core >= 0 && core < SE_N_CORE) ? INTF_CORE_SHARED(core) : 0;
+}
+
+void intf_core_stats(INTF interface, int core, unsigned long long* ops, unsigned long long* contended)
+{
+    int slot = intf_slot(interface, 0);
+
+    *ops = 0;
+    *contended = 0;
+    if (slot < 0 || core < 0 || core >= SE_N_CORE) return;
+
+    *ops = __atomic_load_n(&intf_track[slot].ops[core], __ATOMIC_RELAXED);
+    *contended = __atomic_load_n(&intf_track[slot].contended[core], __ATOMIC_RELAXED);
+}
+
+//------------------------------------------------------------------
+//-- Faults and circuit breaker
+//------------------------------------------------------------------
+
+//-- Returns the status recorded: a wait cut short by the caller's deadline is
+//-- SE_ERR_DEADLINE whatever err says, and leaves the breaker alone
+int intf_core_fault(INTF interface, int core, int err)
+{
+    int slot = intf_slot(interface, 0);
+    unsigned long long now, until;
+    se_ctx* c;
+
+    if (slot < 0 || core < 0 || core >= SE_N_CORE) return err;
+    c = &intf_track[slot];
+
+    if (intf_deadline_passed(interface)) err = SE_ERR_DEADLINE;
+
+    if (intf_thread[slot].status == SE_OK) intf_thread[slot].status = err;
+    intf_thread[slot].fault |= 1U << core;
+    if (err == SE_ERR_DEADLINE) return err;
+
+    __atomic_add_fetch(&c->faults[core], 1, __ATOMIC_RELAXED);
+
+    if (__atomic_add_fetch(&c->fails[core], 1, __ATOMIC_ACQ_REL) < __atomic_load_n(&intf_breaker_fails, __ATOMIC_RELAXED)) return err;
+
+    now = intf_now();
+    until = __atomic_exchange_n(&c->open_until[core], now + __atomic_load_n(&intf_breaker_cool, __ATOMIC_RELAXED), __ATOMIC_ACQ_REL);
+    if (until <= now) __atomic_add_fetch(&c->trips[core], 1, __ATOMIC_RELAXED);
+
+    return err;
+}
+
+int intf_core_faulted(INTF interface, int core)
+{
+    int slot = intf_slot(interface, 0);
+
+    if (slot < 0 || core < 0 || core >= SE_N_CORE) return 0;
+
+    return (intf_thread[slot].fault >> core) & 1;
+}
+
+int intf_status(INTF interface)
+{
+    int slot = intf_slot(interface, 0);
+
+    return (slot >= 0) ? intf_thread[slot].status : SE_OK;
+}
+
+void intf_clear_status(INTF interface)
+{
+    int slot = intf_slot(interface, 0);
+
+    if (slot < 0) return;
+
+    intf_thread[slot].status = SE_OK;
+    intf_thread[slot].fault = 0;
+}
+
+int intf_core_available(INTF interface, int core)
+{
+    int slot = intf_slot(interface, 0);
+    unsigned long long until;
+
+    if (slot < 0 || core < 0 || core >= SE_N_CORE) return 1;
+
+    until = __atomic_load_n(&intf_track[slot].open_until[core], __ATOMIC_ACQUIRE);
+
+    return until == 0 || until <= intf_now();
+}
+
+void intf_core_health(INTF interface, int core, intf_health_stat* st)
+{
+    int slot = intf_slot(interface, 0);
+    se_ctx* c;
+
+    memset(st, 0, sizeof(intf_health_stat));
+    if (slot < 0 || core < 0 || core >= SE_N_CORE) return;
+    c = &intf_track[slot];
+
+    st->faults = __atomic_load_n(&c->faults[core], __ATOMIC_RELAXED);
+    st->trips = __atomic_load_n(&c->trips[core], __ATOMIC_RELAXED);
+    st->fails = __atomic_load_n(&c->fails[core], __ATOMIC_RELAXED);
+    st->open = !intf_core_available(interface, core);
+}
+
+void intf_breaker_set(unsigned int fails, unsigned int cool_ms)
+{
+    __atomic_store_n(&intf_breaker_fails, (fails) ? fails : 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&intf_breaker_cool, cool_ms * 1000000ULL, __ATOMIC_RELAXED);
+}
+
+int intf_core_retry(INTF interface, int core, int ret)
+{
+    if (ret != SE_ERR_TIMEOUT && ret != SE_ERR_CORE) return 0;
+
+    return intf_core_available(interface, core) && !intf_deadline_passed(interface);
+}
+
+//------------------------------------------------------------------
+//-- Deadlines
+//------------------------------------------------------------------
+
+void intf_set_deadline(INTF interface, unsigned long long deadline_ns)
+{
+    int slot = intf_slot(interface, 0);
+
+    if (slot >= 0) intf_thread[slot].deadline = deadline_ns;
+}
+
+unsigned long long intf_get_deadline(INTF interface)
+{
+    int slot = intf_slot(interface, 0);
+
+    return (slot >= 0) ? intf_thread[slot].deadline : 0;
+}
+
+unsigned long long intf_clock_ns()
+{
+    return intf_now();
+}
+
+unsigned long long intf_wait_limit(INTF interface, unsigned long long wait_us)
+{
+    unsigned long long limit = intf_now() + wait_us * 1000ULL;
+    unsigned long long deadline = intf_get_deadline(interface);
+
+    return (deadline != 0 && deadline < limit) ? deadline : limit;
+}
+
+int intf_deadline_passed(INTF interface)
+{
+    unsigned long long deadline = intf_get_deadline(interface);
+
+    return deadline != 0 && intf_now() >= deadline;
+}
+
+//-- The units are charged to the core's next (or current) hold by this thread,
+//-- whose length the final unlock turns into the time per unit
+int intf_core_admit(INTF interface, int core, unsigned long long units)
+{
+    int slot = intf_slot(interface, 0);
+    unsigned long long deadline, unit;
+
+    if (slot < 0 || core < 0 || core >= SE_N_CORE) return SE_OK;
+
+    deadline = intf_thread[slot].deadline;
+    unit = __atomic_load_n(&intf_track[slot].unit_ns[core], __ATOMIC_RELAXED);
+
+    if (deadline != 0 && intf_now() + units * unit > deadline)
+    {
+        if (intf_thread[slot].status == SE_OK) intf_thread[slot].status = SE_ERR_DEADLINE;
+        return SE_ERR_DEADLINE;
+    }
+
+    intf_thread[slot].units[core] += units;
+
+    return SE_OK;
+}
@@ -74,6 +74,9 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////
 
+#ifndef INTF_H
+#define INTF_H
+
 //-- Include Interfaces
 #ifdef I2C
     #include "i2c.h"
@@ -81,6 +84,8 @@
     #include "mmio.h"
 #endif
 
+#include <pthread.h>
+
 //-- Interface Definition
 #ifdef I2C
     typedef I2C_FD INTF;
@@ -88,10 +93,176 @@
     typedef MMIO_WINDOW INTF;
 #endif
 
+//-- Hardware Cores
+#define SE_CORE_SHA3        0
+#define SE_CORE_SHA2        1
+#define SE_CORE_EDDSA       2
+#define SE_CORE_X25519      3
+#define SE_CORE_TRNG        4
+#define SE_CORE_AES         5
+#define SE_CORE_MLKEM       6
+#define SE_N_CORE           7
+
+#define INTF_MAX_TRACK      16          // Devices open at a time (open_INTF / se_open)
+
+//-- Operation status (intf_status)
+#define SE_OK               0
+#define SE_ERR_TIMEOUT      -1          // The core did not finish; it was reset
+#define SE_ERR_CORE         -2          // The core raised its error flag; it was reset
+#define SE_ERR_DEADLINE     -3          // Refused or aborted at the caller's deadline (core reset if started)
+#define SE_ERR_ARG          -4          // Bad argument or no memory: the core was not used
+#define SE_RETRY            1           // Reset-and-retry attempts of idempotent operations
+
+//-- Circuit breaker defaults (see intf_breaker_set)
+#define SE_BREAKER_FAILS    3           // Consecutive faulted operations that open it
+#define SE_BREAKER_COOL_MS  1000        // Cool-down before the core is tried again
+
+#define SE_UNIT_EWMA_SHIFT  3           // Service time per unit: average weight 1/8
+
+typedef struct {
+    unsigned long long faults;                  // Timeouts and core errors
+    unsigned long long trips;                   // Times the breaker opened
+    unsigned int fails;                         // Consecutive faulted operations now
+    int open;                                   // Breaker open now
+} intf_health_stat;
+
+//-- Cross-process lock table (see intf_shm_enable)
+struct intf_shm;
+//-- Completion thread and eventfd of the device (see se_op_fd)
+struct se_op_engine;
+//-- TRNG health test state of the device (see trng_health_stats)
+struct trng_ht_state;
+
+typedef struct {
+    unsigned long long ops[SE_N_CORE];          // Operations run, all processes
+    unsigned long long contended[SE_N_CORE];    // Operations that had to wait
+    unsigned long long recovered;               // Locks taken over from a dead owner
+    unsigned long long attached;                // open_INTF calls that attached
+} intf_shm_stat;
+
+//-- Device context: the interface, a lock per core and the register state of
+//-- the device. One per opened device; open_INTF and se_open share it.
+typedef struct {
+    INTF interface;
+    size_t id;
+    int used;
+    int slot;                                   // Index in the device table
+    unsigned int gen;                           // Times the slot has been opened
+    unsigned long long module;                  // Module last selected on CONTROL
+    unsigned long long token;                   // Resident data token
+    unsigned long long control;                 // CONTROL / ADDRESS as last written
+    unsigned long long address;
+    pthread_mutex_t transport;                  // One register access at a time
+    pthread_rwlock_t device;                    // Shared: X25519 / ML-KEM with SE_PARALLEL_CORES; exclusive: the rest
+    pthread_mutex_t core[SE_N_CORE];            // One operation per core
+    unsigned int waiters[SE_N_CORE];            // Foreground callers waiting for the core
+    unsigned long long ops[SE_N_CORE];          // Operations run
+    unsigned long long contended[SE_N_CORE];    // Operations that had to wait
+    unsigned int fails[SE_N_CORE];              // Consecutive faulted operations
+    unsigned long long open_until[SE_N_CORE];   // Breaker open until (CLOCK_MONOTONIC ns)
+    unsigned long long faults[SE_N_CORE];
+    unsigned long long trips[SE_N_CORE];
+    unsigned long long unit_ns[SE_N_CORE];      // Service time per admitted unit (0 = not measured)
+    struct intf_shm* shm;                       // Lock table shared with other processes
+    struct se_op_engine* engine;                // Posted non-blocking operations
+    struct trng_ht_state* trng;                 // SP 800-90B test state and latch
+} se_ctx;
+
 //-- Open and Close Interface
 void open_INTF(INTF* interface, size_t address, size_t length);
 void close_INTF(INTF interface);
 
+//-- Context handle: se_intf(ctx) is passed to the driver functions. At most
+//-- INTF_MAX_TRACK devices are open at a time. se_close / close_INTF close
+//-- the interface and free the context for the next open, so call them once no
+//-- thread uses the device any more (and after se_op_stop); ctx is invalid after.
+se_ctx* se_open(size_t address, size_t length);
+void se_close(se_ctx* ctx);
+se_ctx* se_ctx_of(INTF interface);
+#define se_intf(ctx)        ((ctx)->interface)
+
 //-- Read & Write
 void read_INTF(INTF interface, void* data, size_t offset, size_t size_data);
-void write_INTF(INTF interface, void* data, size_t offset, size_t size_data);
\ No newline at end of file
+void write_INTF(INTF interface, void* data, size_t offset, size_t size_data);
+
+//-- Resident data tracking: the SE clears the input registers of a core when
+//-- another core is addressed. A driver that leaves data loaded in its core
+//-- tags the device with a non-zero token; the token is dropped as soon as a
+//-- CONTROL write selects a different module. Tracking is per process; with
+//-- the lock table, use of the device by another process drops it as well.
+void intf_set_resident(INTF interface, unsigned long long token);
+unsigned long long intf_resident(INTF interface);
+
+//-- Core locking: every driver holds its core for a whole operation (start to
+//-- finish for the split X25519 / ML-KEM calls), so threads sharing a device
+//-- serialise per operation. Cores that the SE resets while another module is
+//-- addressed (all of them, or all but X25519 / ML-KEM with SE_PARALLEL_CORES)
+//-- also take the device exclusively. Locks are recursive per thread; a thread
+//-- that nests cores takes ML-KEM, then X25519, then the rest; with the lock
+//-- table and SE_PARALLEL_CORES any other core needs ML-KEM from the other
+//-- processes, so a thread holding X25519 only takes no further core. With
+//-- SE_PARALLEL_CORES each register access is atomic and first restores the
+//-- CONTROL / ADDRESS the calling thread last wrote.
+//-- intf_core_trylock is for background work: it fails while the core is
+//-- busy or a foreground caller waits for it.
+void intf_core_lock(INTF interface, int core);
+int intf_core_trylock(INTF interface, int core);
+void intf_core_unlock(INTF interface, int core);
+void intf_core_stats(INTF interface, int core, unsigned long long* ops, unsigned long long* contended);
+//-- 1 for a core the SE keeps running while another module is addressed
+int intf_core_shared(int core);
+
+//-- Faults: a driver whose core times out or raises its error flag resets the
+//-- core, wipes its outputs and reports it with intf_core_fault. intf_status
+//-- returns the first error the calling thread got since it last took a core
+//-- of the device with none held (or since intf_clear_status); void drivers
+//-- report through it. intf_core_faulted is 1 while the thread holds a core
+//-- that faulted, so multi-block drivers stop feeding it. After
+//-- SE_BREAKER_FAILS faulted operations in a row the core's circuit breaker
+//-- opens for SE_BREAKER_COOL_MS: intf_core_available is then 0 and the
+//-- routing layers (auto-dispatch, broker) send the work elsewhere. The first
+//-- operation after the cool-down closes it again, or reopens it on failure.
+//-- Idempotent blocking calls run again up to SE_RETRY times while the
+//-- breaker stays closed.
+int intf_core_fault(INTF interface, int core, int err);
+int intf_core_faulted(INTF interface, int core);
+int intf_status(INTF interface);
+void intf_clear_status(INTF interface);
+int intf_core_available(INTF interface, int core);
+void intf_core_health(INTF interface, int core, intf_health_stat* st);
+void intf_breaker_set(unsigned int fails, unsigned int cool_ms);
+//-- 1 if ret is a fault worth another run: a timeout or core error, with the
+//-- breaker closed and the deadline not passed
+int intf_core_retry(INTF interface, int core, int ret);
+
+//-- Deadlines: intf_set_deadline gives every operation the calling thread
+//-- starts on the device an absolute CLOCK_MONOTONIC limit in ns (0: none),
+//-- until it is set again; intf_clock_ns reads the same clock. Drivers wait
+//-- for END_OP until intf_wait_limit: *_WAIT_TIME us after the wait starts,
+//-- or the deadline if that comes first. intf_core_admit refuses an operation
+//-- of the given size in units (blocks, k, bursts) when the core's measured
+//-- time per unit says it would end past the deadline, and multi-block
+//-- drivers stop between blocks once intf_deadline_passed, resetting the core.
+//-- A refused or aborted call wipes its outputs and ends with SE_ERR_DEADLINE,
+//-- which is not a fault of the core: it never opens the breaker.
+void intf_set_deadline(INTF interface, unsigned long long deadline_ns);
+unsigned long long intf_get_deadline(INTF interface);
+unsigned long long intf_clock_ns();
+unsigned long long intf_wait_limit(INTF interface, unsigned long long wait_us);
+int intf_deadline_passed(INTF interface);
+int intf_core_admit(INTF interface, int core, unsigned long long units);
+
+//-- Cross-process locking (opt-in): after intf_shm_enable(name), or with
+//-- SE_QUBIP_SHM=name in the environment, open_INTF attaches the device to the
+//-- POSIX shared-memory segment "/name-<address>". It holds a robust
+//-- process-shared mutex per core plus one for the device, taken with the same
+//-- rules as the in-process locks, so independent processes can drive one SE.
+//-- A lock whose owner died is taken over; the core is reset by the next
+//-- operation as usual. Call intf_shm_enable before the device is opened. The
+//-- segment outlives the processes; remove it (/dev/shm/name-<address>) only
+//-- while none uses the device. intf_shm_stats returns -1 for a device not
+//-- attached.
+int intf_shm_enable(const char* name);
+int intf_shm_stats(INTF interface, intf_shm_stat* st);
+
+#endif
@@ -0,0 +1,314 @@
+/**
+  * @file pack.c
+  * @brief Word packing / endianness kernels
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#include <stdint.h>
+#include "pack.h"
+
+#if defined(PACK_SSSE3)
+	#include <tmmintrin.h>
+#elif defined(PACK_NEON)
+	#include <arm_neon.h>
+#endif
+
+//-- Host words are little-endian on every supported board; keep big-endian hosts correct anyway
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	#define BE64(x)		(x)
+	#define BE32(x)		(x)
+#else
+	#define BE64(x)		__builtin_bswap64(x)
+	#define BE32(x)		__builtin_bswap32(x)
+#endif
+
+static inline uint64_t load64(const unsigned char* p) { uint64_t w; memcpy(&w, p, 8); return w; }
+static inline void store64(unsigned char* p, uint64_t w) { memcpy(p, &w, 8); }
+static inline uint32_t load32(const unsigned char* p) { uint32_t w; memcpy(&w, p, 4); return w; }
+static inline void store32(unsigned char* p, uint32_t w) { memcpy(p, &w, 4); }
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// VECTOR KERNELS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- Each kernel does the whole 16-byte steps and returns how far it got; the scalar
+//-- loops of the public functions finish the rest (or all of it without SIMD)
+
+#if defined(PACK_SSSE3)
+
+static int pack_simd()
+{
+	return __builtin_cpu_supports("ssse3") ? 1 : 0;
+}
+
+__attribute__((target("ssse3")))
+static size_t pack_reverse_simd(unsigned char* data, size_t size)
+{
+	const __m128i rev = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	size_t i = 0;
+
+	for (; size - 2 * i >= 32; i += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i*)(data + i));
+		__m128i b = _mm_loadu_si128((const __m128i*)(data + size - i - 16));
+		_mm_storeu_si128((__m128i*)(data + i), _mm_shuffle_epi8(b, rev));
+		_mm_storeu_si128((__m128i*)(data + size - i - 16), _mm_shuffle_epi8(a, rev));
+	}
+
+	return i;
+}
+
+__attribute__((target("ssse3")))
+static size_t pack_be64_simd(unsigned long long* dst, const unsigned char* src, size_t n_words)
+{
+	const __m128i bs = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+	size_t i = 0;
+
+	for (; i + 2 <= n_words; i += 2)
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + 8 * i)), bs));
+
+	return i;
+}
+
+__attribute__((target("ssse3")))
+static size_t unpack_be64_simd(unsigned char* dst, const unsigned long long* src, size_t n_words)
+{
+	const __m128i bs = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+	size_t i = 0;
+
+	for (; i + 2 <= n_words; i += 2)
+		_mm_storeu_si128((__m128i*)(dst + 8 * i), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + i)), bs));
+
+	return i;
+}
+
+__attribute__((target("ssse3")))
+static size_t pack_be32_simd(unsigned long long* dst, const unsigned char* src, size_t n_words)
+{
+	const __m128i bs = _mm_set_epi8(-1, -1, -1, -1, 4, 5, 6, 7, -1, -1, -1, -1, 0, 1, 2, 3);
+	size_t i = 0;
+
+	for (; i + 2 <= n_words; i += 2)
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_shuffle_epi8(_mm_loadl_epi64((const __m128i*)(src + 4 * i)), bs));
+
+	return i;
+}
+
+__attribute__((target("ssse3")))
+static size_t unpack_be32_simd(unsigned char* dst, const unsigned long long* src, size_t n_words)
+{
+	const __m128i bs = _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 8, 9, 10, 11, 0, 1, 2, 3);
+	size_t i = 0;
+
+	for (; i + 2 <= n_words; i += 2)
+		_mm_storel_epi64((__m128i*)(dst + 4 * i), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + i)), bs));
+
+	return i;
+}
+
+#elif defined(PACK_NEON)
+
+static int pack_simd()
+{
+	return 1;
+}
+
+static size_t pack_reverse_simd(unsigned char* data, size_t size)
+{
+	size_t i = 0;
+
+	for (; size - 2 * i >= 32; i += 16) {
+		uint8x16_t a = vrev64q_u8(vld1q_u8(data + i));
+		uint8x16_t b = vrev64q_u8(vld1q_u8(data + size - i - 16));
+		vst1q_u8(data + i, vextq_u8(b, b, 8));
+		vst1q_u8(data + size - i - 16, vextq_u8(a, a, 8));
+	}
+
+	return i;
+}
+
+static size_t pack_be64_simd(unsigned long long* dst, const unsigned char* src, size_t n_words)
+{
+	size_t i = 0;
+
+	for (; i + 2 <= n_words; i += 2)
+		vst1q_u8((uint8_t*)(dst + i), vrev64q_u8(vld1q_u8(src + 8 * i)));
+
+	return i;
+}
+
+static size_t unpack_be64_simd(unsigned char* dst, const unsigned long long* src, size_t n_words)
+{
+	size_t i = 0;
+
+	for (; i + 2 <= n_words; i += 2)
+		vst1q_u8(dst + 8 * i, vrev64q_u8(vld1q_u8((const uint8_t*)(src + i))));
+
+	return i;
+}
+
+static size_t pack_be32_simd(unsigned long long* dst, const unsigned char* src, size_t n_words)
+{
+	size_t i = 0;
+
+	for (; i + 2 <= n_words; i += 2)
+		vst1q_u64((uint64_t*)(dst + i), vmovl_u32(vreinterpret_u32_u8(vrev32_u8(vld1_u8(src + 4 * i)))));
+
+	return i;
+}
+
+static size_t unpack_be32_simd(unsigned char* dst, const unsigned long long* src, size_t n_words)
+{
+	size_t i = 0;
+
+	for (; i + 2 <= n_words; i += 2)
+		vst1_u8(dst + 4 * i, vrev32_u8(vreinterpret_u8_u32(vmovn_u64(vld1q_u64((const uint64_t*)(src + i))))));
+
+	return i;
+}
+
+#endif
+
+//-- The word kernels assume a little-endian host
+#if (defined(PACK_SSSE3) || defined(PACK_NEON)) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	#define PACK_SIMD_WORDS
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// BUFFER REVERSAL
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+void pack_reverse(unsigned char* data, size_t size)
+{
+	unsigned char* lo = data;
+	unsigned char* hi = data + size;
+	unsigned char t;
+
+	// -- 16 bytes from each end per step
+#if defined(PACK_SSSE3) || defined(PACK_NEON)
+	if (pack_simd()) {
+		size_t n = pack_reverse_simd(data, size);
+		lo += n; hi -= n;
+	}
+#endif
+
+	// -- 8 bytes from each end per step
+	while (hi - lo >= 16) {
+		uint64_t a = load64(lo);
+		uint64_t b = load64(hi - 8);
+		store64(lo, __builtin_bswap64(b));
+		store64(hi - 8, __builtin_bswap64(a));
+		lo += 8; hi -= 8;
+	}
+
+	while (hi - lo >= 2) {
+		t = *lo;
+		*lo++ = *--hi;
+		*hi = t;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// 64-BIT BIG-ENDIAN WORDS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+void pack_be64(unsigned long long* dst, const unsigned char* src, size_t n_words)
+{
+	size_t i = 0;
+
+#if defined(PACK_SIMD_WORDS)
+	if (pack_simd()) i = pack_be64_simd(dst, src, n_words);
+#endif
+
+	for (; i < n_words; i++) dst[i] = BE64(load64(src + 8 * i));
+}
+
+void unpack_be64(unsigned char* dst, const unsigned long long* src, size_t n_words)
+{
+	size_t i = 0;
+
+#if defined(PACK_SIMD_WORDS)
+	if (pack_simd()) i = unpack_be64_simd(dst, src, n_words);
+#endif
+
+	for (; i < n_words; i++) store64(dst + 8 * i, BE64((uint64_t)src[i]));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// 32-BIT BIG-ENDIAN WORDS (LOW HALF OF THE REGISTER)
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+void pack_be32(unsigned long long* dst, const unsigned char* src, size_t n_words)
+{
+	size_t i = 0;
+
+#if defined(PACK_SIMD_WORDS)
+	if (pack_simd()) i = pack_be32_simd(dst, src, n_words);
+#endif
+
+	for (; i < n_words; i++) dst[i] = (unsigned long long)BE32(load32(src + 4 * i));
+}
+
+void unpack_be32(unsigned char* dst, const unsigned long long* src, size_t n_words)
+{
+	size_t i = 0;
+
+#if defined(PACK_SIMD_WORDS)
+	if (pack_simd()) i = unpack_be32_simd(dst, src, n_words);
+#endif
+
+	for (; i < n_words; i++) store32(dst + 4 * i, BE32((uint32_t)src[i]));
+}
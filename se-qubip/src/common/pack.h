@@ -0,0 +1,96 @@
+/**
+  * @file pack.h
+  * @brief Word packing / endianness kernels header
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef PACK_H
+#define PACK_H
+
+#include <stddef.h>
+#include <string.h>
+
+//-- Kernel selection: SSSE3 byte shuffle on x86, NEON on ARM, bswap64 otherwise.
+//-- The SSSE3 kernels are built with target("ssse3") and only run when the CPU has
+//-- it; AArch64 has NEON by default and ARMv7 (PYNQ-Z2) gets -mfpu=neon from the Makefile.
+#if defined(__x86_64__) || defined(__i386__)
+	#define PACK_SSSE3
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define PACK_NEON
+#endif
+
+//-- Reverse the byte order of a whole buffer (swapEndianness)
+void pack_reverse(unsigned char* data, size_t size);
+
+//-- Bytes <-> 64-bit big-endian words (SHA-384/512, I2C ull registers)
+void pack_be64(unsigned long long* dst, const unsigned char* src, size_t n_words);
+void unpack_be64(unsigned char* dst, const unsigned long long* src, size_t n_words);
+
+//-- Bytes <-> 32-bit big-endian words held in the low half of a 64-bit register (SHA-256)
+void pack_be32(unsigned long long* dst, const unsigned char* src, size_t n_words);
+void unpack_be32(unsigned char* dst, const unsigned long long* src, size_t n_words);
+
+//-- Copy the available bytes of a block and zero the tail
+static inline void pack_block(unsigned char* dst, const unsigned char* src, unsigned long long avail, size_t block)
+{
+	size_t n = (avail < block) ? (size_t)avail : block;
+
+	if (n) memcpy(dst, src, n);
+	if (n < block) memset(dst + n, 0, block - n);
+}
+
+#endif
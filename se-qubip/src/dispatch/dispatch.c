@@ -0,0 +1,794 @@
+/**
+  * @file dispatch.c
+  * @brief HW/SW Auto-Dispatch Layer
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "dispatch.h"
+
+#if defined(I2C)
+	#define DISPATCH_TRANSPORT	"I2C"
+#elif defined(AXI)
+	#define DISPATCH_TRANSPORT	"AXI"
+#else
+	#define DISPATCH_TRANSPORT	"NONE"
+#endif
+
+#if defined(PYNQZ2)
+	#define DISPATCH_BOARD		"PYNQZ2"
+#elif defined(ZCU104)
+	#define DISPATCH_BOARD		"ZCU104"
+#else
+	#define DISPATCH_BOARD		"NONE"
+#endif
+
+typedef struct {
+	const char* name;
+	int secret;
+	int core;
+} dispatch_info;
+
+static const dispatch_info dispatch_alg[DISPATCH_N_ALG] = {
+	{ "SHA3-256",		0,	SE_CORE_SHA3 },
+	{ "SHA3-512",		0,	SE_CORE_SHA3 },
+	{ "SHAKE-128",		0,	SE_CORE_SHA3 },
+	{ "SHAKE-256",		0,	SE_CORE_SHA3 },
+	{ "SHA-256",		0,	SE_CORE_SHA2 },
+	{ "SHA-384",		0,	SE_CORE_SHA2 },
+	{ "SHA-512",		0,	SE_CORE_SHA2 },
+	{ "SHA-512/256",	0,	SE_CORE_SHA2 },
+	{ "cSHAKE-128",		0,	SE_CORE_SHA3 },
+	{ "cSHAKE-256",		0,	SE_CORE_SHA3 },
+	{ "KMAC-128",		1,	SE_CORE_SHA3 },
+	{ "KMAC-256",		1,	SE_CORE_SHA3 }
+};
+
+//-- dispatch_table[alg] = smallest message (bytes) the core is faster for
+static unsigned int dispatch_table[DISPATCH_N_ALG];
+static int dispatch_ready = 0;
+static int dispatch_policy = DISPATCH_POLICY_AUTO;
+static char dispatch_cache[256];					// Set by dispatch_set_cache
+static int dispatch_cache_set = 0;					// 0: default per-user file
+static float dispatch_clock = 0.0f;					// Core clock (MHz) set by dispatch_set_clock, 0: unknown
+static pthread_mutex_t dispatch_lock = PTHREAD_MUTEX_INITIALIZER;
+
+//-- ML-KEM queue: the core lock (intf_core_lock) is held for the whole operation,
+//-- the state lock only while a routing decision or a latency sample is taken
+static pthread_mutex_t dispatch_mlkem_lock = PTHREAD_MUTEX_INITIALIZER;
+static dispatch_mlkem_stats dispatch_mlkem;
+static unsigned int dispatch_mlkem_max_depth = DISPATCH_MLKEM_MAX_DEPTH;
+static unsigned long long dispatch_mlkem_max_wait = 0;
+static int dispatch_mlkem_hw = 1;
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// CALIBRATION
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static unsigned long long dispatch_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void dispatch_run(int alg, int hw, unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
+{
+	static unsigned char key[32];
+	static unsigned char custom[] = "calibration";
+
+	switch (alg) {
+	case DISPATCH_SHA3_256:		if (hw) sha3_256_hw_func(in, length, out, interface);		else sha3_256_sw(in, length, out);			break;
+	case DISPATCH_SHA3_512:		if (hw) sha3_512_hw_func(in, length, out, interface);		else sha3_512_sw(in, length, out);			break;
+	case DISPATCH_SHAKE128:		if (hw) shake128_hw_func(in, length, out, 32, interface);	else shake128_sw(in, length, out, 32);		break;
+	case DISPATCH_SHAKE256:		if (hw) shake256_hw_func(in, length, out, 64, interface);	else shake256_sw(in, length, out, 64);		break;
+	case DISPATCH_SHA_256:		if (hw) sha_256_hw_func(in, length, out, interface);		else sha_256_sw(in, length, out);			break;
+	case DISPATCH_SHA_384:		if (hw) sha_384_hw_func(in, length, out, interface);		else sha_384_sw(in, length, out);			break;
+	case DISPATCH_SHA_512:		if (hw) sha_512_hw_func(in, length, out, interface);		else sha_512_sw(in, length, out);			break;
+	case DISPATCH_SHA_512_256:	if (hw) sha_512_256_hw_func(in, length, out, interface);	else sha_512_256_sw(in, length, out);		break;
+	case DISPATCH_CSHAKE128:
+	case DISPATCH_CSHAKE256:
+		if (hw) cshake_hw(in, length, out, 32, NULL, 0, custom, sizeof(custom) - 1, (alg == DISPATCH_CSHAKE128) ? 3 : 4, interface);
+		else	cshake_sw(in, length, out, 32, NULL, 0, custom, sizeof(custom) - 1, (alg == DISPATCH_CSHAKE128) ? 3 : 4);
+		break;
+	case DISPATCH_KMAC128:
+	case DISPATCH_KMAC256:
+		if (hw) kmac_hw(key, sizeof(key), in, length, out, 32, NULL, 0, 0, (alg == DISPATCH_KMAC128) ? 3 : 4, interface);
+		else	kmac_sw(key, sizeof(key), in, length, out, 32, NULL, 0, 0, (alg == DISPATCH_KMAC128) ? 3 : 4);
+		break;
+	}
+}
+
+//-- Best-of-N time per operation in ns. Fast (host) paths are looped until the
+//-- sample is long enough to be above the clock resolution.
+static double dispatch_time(int alg, int hw, unsigned char* in, unsigned int length, INTF interface)
+{
+	unsigned char out[64];
+	unsigned long long t0, t;
+	unsigned int n;
+	double best = 0.0;
+
+	for (int r = 0; r < DISPATCH_CAL_REPS; r++) {
+		n = 0;
+		t0 = dispatch_ns();
+		do {
+			dispatch_run(alg, hw, in, length, out, interface);
+			n++;
+			t = dispatch_ns() - t0;
+		} while (t < DISPATCH_CAL_MIN_NS);
+
+		if (r == 0 || (double)t / n < best) best = (double)t / n;
+	}
+
+	return best;
+}
+
+//-- t(n) = a + b*n for each path, fitted on the two calibration sizes. The core is
+//-- used from the size where its line crosses below the host one.
+static unsigned int dispatch_fit(double hw_s, double hw_l, double sw_s, double sw_l)
+{
+	double b_hw = (hw_l - hw_s) / (DISPATCH_CAL_LONG - DISPATCH_CAL_SHORT);
+	double b_sw = (sw_l - sw_s) / (DISPATCH_CAL_LONG - DISPATCH_CAL_SHORT);
+	double a_hw = hw_s - b_hw * DISPATCH_CAL_SHORT;
+	double a_sw = sw_s - b_sw * DISPATCH_CAL_SHORT;
+	double n;
+
+	if (a_hw <= a_sw && b_hw <= b_sw)	return 0;
+	if (b_hw >= b_sw)					return DISPATCH_NEVER;
+
+	n = (a_hw - a_sw) / (b_sw - b_hw);
+
+	return (n >= (double)DISPATCH_MAX_HW) ? DISPATCH_NEVER : (unsigned int)n + 1;
+}
+
+static void dispatch_measure(INTF interface)
+{
+	unsigned char* in = malloc(DISPATCH_CAL_LONG);
+	double hw_s, hw_l, sw_s, sw_l;
+
+	for (int i = 0; i < DISPATCH_CAL_LONG; i++) in[i] = (unsigned char)i;
+
+	for (int alg = 0; alg < DISPATCH_N_ALG; alg++) {
+		hw_s = dispatch_time(alg, 1, in, DISPATCH_CAL_SHORT, interface);
+		hw_l = dispatch_time(alg, 1, in, DISPATCH_CAL_LONG, interface);
+		sw_s = dispatch_time(alg, 0, in, DISPATCH_CAL_SHORT, interface);
+		sw_l = dispatch_time(alg, 0, in, DISPATCH_CAL_LONG, interface);
+
+		dispatch_table[alg] = dispatch_fit(hw_s, hw_l, sw_s, sw_l);
+	}
+
+	free(in);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// CACHE FILE
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- The file set with dispatch_set_cache, or DISPATCH_CACHE_NAME in the user's
+//-- private DISPATCH_CACHE_DIR (created if missing). -1: no persistence.
+static int dispatch_cache_path(char* path, size_t size)
+{
+	char dir[64];
+	struct stat st;
+
+	if (dispatch_cache_set) {
+		if (dispatch_cache[0] == '\0') return -1;
+		snprintf(path, size, "%s", dispatch_cache);
+		return 0;
+	}
+
+	snprintf(dir, sizeof(dir), DISPATCH_CACHE_DIR, (unsigned int)geteuid());
+	if (mkdir(dir, 0700) != 0 && errno != EEXIST) return -1;
+
+	// -- a directory another user could have planted (or can write to) is not used
+	if (lstat(dir, &st) != 0 || !S_ISDIR(st.st_mode) || st.st_uid != geteuid() || (st.st_mode & 077) != 0) {
+		printf("\nDISPATCH FAIL!: %s is not a private directory\n", dir);
+		return -1;
+	}
+	snprintf(path, size, "%s/%s", dir, DISPATCH_CACHE_NAME);
+
+	return 0;
+}
+
+//-- The clock in the cache key: the one set with dispatch_set_clock or, on AXI, the
+//-- PL clock the bitstream runs at now (it can be changed with Set_Clk_Freq)
+static float dispatch_clock_mhz()
+{
+	float mhz = dispatch_clock;
+
+#ifdef AXI
+	if (mhz == 0.0f && !PYNQ_getPLClockFreq(0, &mhz)) mhz = 0.0f;
+#endif
+
+	return mhz;
+}
+
+//-- Format:
+//--	se-qubip-dispatch <version> <transport> <board> <clock MHz>
+//--	<algorithm> <crossover bytes>
+//--	...
+static int dispatch_load()
+{
+	char path[sizeof(dispatch_cache)];
+	char line[128];
+	char name[64];
+	char header[128];
+	unsigned int value;
+	unsigned int found = 0;
+	unsigned int table[DISPATCH_N_ALG];
+	struct stat st;
+	FILE* fp;
+	int fd;
+
+	if (dispatch_cache_path(path, sizeof(path)) != 0) return -1;
+	if ((fd = open(path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC)) < 0) return -1;
+
+	// -- only a regular file of this user that nobody else can write steers the routing
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_uid != geteuid() || (st.st_mode & 022) != 0 || (fp = fdopen(fd, "r")) == NULL) {
+		close(fd);
+		return -1;
+	}
+
+	snprintf(header, sizeof(header), "se-qubip-dispatch %d %s %s %.2f\n", DISPATCH_CACHE_VERSION, DISPATCH_TRANSPORT, DISPATCH_BOARD, dispatch_clock_mhz());
+
+	if (fgets(line, sizeof(line), fp) == NULL || strcmp(line, header) != 0) {
+		fclose(fp);
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		if (sscanf(line, "%63s %u", name, &value) != 2) continue;
+		for (int alg = 0; alg < DISPATCH_N_ALG; alg++) {
+			if (strcmp(name, dispatch_alg[alg].name) == 0 && !((found >> alg) & 1)) {
+				table[alg] = value;
+				found |= 1U << alg;
+			}
+		}
+	}
+
+	fclose(fp);
+
+	if (found != (1U << DISPATCH_N_ALG) - 1) return -1;
+
+	memcpy(dispatch_table, table, sizeof(table));
+
+	return 0;
+}
+
+//-- Written to a new file (mkstemp: O_EXCL, mode 0600) and renamed, so a concurrent
+//-- reader never sees a torn table and no planted name or symlink is written through
+static int dispatch_save()
+{
+	char path[sizeof(dispatch_cache)];
+	char tmp[sizeof(dispatch_cache) + 8];
+	FILE* fp;
+	int fd;
+
+	if (dispatch_cache_path(path, sizeof(path)) != 0) return 0;
+
+	snprintf(tmp, sizeof(tmp), "%s.XXXXXX", path);
+
+	if ((fd = mkstemp(tmp)) < 0 || (fp = fdopen(fd, "w")) == NULL) {
+		printf("\nDISPATCH FAIL!: cannot write %s\n", path);
+		if (fd >= 0) {
+			close(fd);
+			remove(tmp);
+		}
+		return -1;
+	}
+
+	fprintf(fp, "se-qubip-dispatch %d %s %s %.2f\n", DISPATCH_CACHE_VERSION, DISPATCH_TRANSPORT, DISPATCH_BOARD, dispatch_clock_mhz());
+	for (int alg = 0; alg < DISPATCH_N_ALG; alg++) fprintf(fp, "%s %u\n", dispatch_alg[alg].name, dispatch_table[alg]);
+
+	if (fclose(fp) != 0 || rename(tmp, path) != 0) {
+		printf("\nDISPATCH FAIL!: cannot write %s\n", path);
+		remove(tmp);
+		return -1;
+	}
+
+	return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// CONTROL FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static void dispatch_prepare(INTF interface)
+{
+	pthread_mutex_lock(&dispatch_lock);
+
+	if (!dispatch_ready) {
+		if (dispatch_load() != 0) {
+			dispatch_measure(interface);
+			dispatch_save();
+		}
+		__atomic_store_n(&dispatch_ready, 1, __ATOMIC_RELEASE);
+	}
+
+	pthread_mutex_unlock(&dispatch_lock);
+}
+
+void dispatch_set_policy(int policy)
+{
+	__atomic_store_n(&dispatch_policy, policy, __ATOMIC_RELAXED);
+}
+
+int dispatch_get_policy()
+{
+	return __atomic_load_n(&dispatch_policy, __ATOMIC_RELAXED);
+}
+
+//-- NULL or "" disables persistence. Takes effect at the next load/calibration.
+void dispatch_set_cache(const char* path)
+{
+	pthread_mutex_lock(&dispatch_lock);
+
+	if (path == NULL)	dispatch_cache[0] = '\0';
+	else				snprintf(dispatch_cache, sizeof(dispatch_cache), "%s", path);
+	dispatch_cache_set = 1;
+
+	pthread_mutex_unlock(&dispatch_lock);
+}
+
+//-- The next dispatched call loads the table of the new clock (or calibrates it)
+void dispatch_set_clock(float mhz)
+{
+	pthread_mutex_lock(&dispatch_lock);
+
+	dispatch_clock = mhz;
+	__atomic_store_n(&dispatch_ready, 0, __ATOMIC_RELEASE);
+
+	pthread_mutex_unlock(&dispatch_lock);
+}
+
+//-- Measure now and overwrite the cache file
+int dispatch_calibrate(INTF interface)
+{
+	int ret;
+
+	pthread_mutex_lock(&dispatch_lock);
+
+	dispatch_measure(interface);
+	ret = dispatch_save();
+	__atomic_store_n(&dispatch_ready, 1, __ATOMIC_RELEASE);
+
+	pthread_mutex_unlock(&dispatch_lock);
+
+	return ret;
+}
+
+unsigned int dispatch_crossover(int alg, INTF interface)
+{
+	if (alg < 0 || alg >= DISPATCH_N_ALG) return DISPATCH_NEVER;
+
+	if (!__atomic_load_n(&dispatch_ready, __ATOMIC_ACQUIRE)) dispatch_prepare(interface);
+
+	return dispatch_table[alg];
+}
+
+int dispatch_use_hw(int alg, unsigned long long length, INTF interface)
+{
+	int policy = __atomic_load_n(&dispatch_policy, __ATOMIC_RELAXED);
+
+	// -- Beyond what the drivers can frame only the host path is correct
+	if (length > DISPATCH_MAX_HW)												return 0;
+
+	if (policy == DISPATCH_POLICY_HW)											return 1;
+	if (policy == DISPATCH_POLICY_SW)											return 0;
+	if (policy == DISPATCH_POLICY_HW_SECRET && dispatch_alg[alg].secret)		return 1;
+
+	// -- The host takes the traffic of a core whose circuit breaker is open
+	if (!intf_core_available(interface, dispatch_alg[alg].core))				return 0;
+
+	return length >= dispatch_crossover(alg, interface);
+}
+
+//-- After a core call: 1 if its result stands (it succeeded, or the policy keeps the
+//-- algorithm on the SE and the caller gets the wiped output and intf_status), 0 if
+//-- the call has to be redone on the host
+static int dispatch_hw_done(int alg, int ret)
+{
+	int policy = __atomic_load_n(&dispatch_policy, __ATOMIC_RELAXED);
+
+	if (ret == SE_OK)															return 1;
+	if (policy == DISPATCH_POLICY_HW)											return 1;
+	if (policy == DISPATCH_POLICY_HW_SECRET && dispatch_alg[alg].secret)		return 1;
+
+	return 0;
+}
+
+void dispatch_mlkem_set_limits(unsigned int max_depth, unsigned long long max_wait_ns)
+{
+	pthread_mutex_lock(&dispatch_mlkem_lock);
+
+	dispatch_mlkem_max_depth = max_depth;
+	dispatch_mlkem_max_wait = max_wait_ns;
+
+	pthread_mutex_unlock(&dispatch_mlkem_lock);
+}
+
+void dispatch_mlkem_set_hw(int enable)
+{
+	__atomic_store_n(&dispatch_mlkem_hw, enable, __ATOMIC_RELAXED);
+}
+
+void dispatch_mlkem_get_stats(dispatch_mlkem_stats* stats)
+{
+	pthread_mutex_lock(&dispatch_mlkem_lock);
+	memcpy(stats, &dispatch_mlkem, sizeof(dispatch_mlkem_stats));
+	pthread_mutex_unlock(&dispatch_mlkem_lock);
+}
+
+//-- 1: the call takes a place in the core queue (released by dispatch_mlkem_done)
+static int dispatch_mlkem_route(int op, int k, INTF interface)
+{
+	int policy = __atomic_load_n(&dispatch_policy, __ATOMIC_RELAXED);
+	unsigned long long hw_ns, sw_ns, wait;
+	unsigned int depth;
+	int hw;
+
+	if (!__atomic_load_n(&dispatch_mlkem_hw, __ATOMIC_RELAXED))	return 0;
+	if (policy == DISPATCH_POLICY_SW)								return 0;
+
+	pthread_mutex_lock(&dispatch_mlkem_lock);
+
+	depth = dispatch_mlkem.depth;
+	hw_ns = dispatch_mlkem.hw_ns[op][k - 2];
+	sw_ns = dispatch_mlkem.sw_ns[op][k - 2];
+	wait = depth * hw_ns;
+
+	// -- Every ML-KEM call carries key material, so HW_SECRET behaves as HW
+	if (policy != DISPATCH_POLICY_AUTO)				hw = 1;
+	else if (!intf_core_available(interface, SE_CORE_MLKEM))	hw = 0;		// Circuit breaker open
+	else if (depth == 0)							hw = 1;
+	else if (depth >= dispatch_mlkem_max_depth)		hw = 0;
+	else if (dispatch_mlkem_max_wait)				hw = (wait <= dispatch_mlkem_max_wait);
+	else if (sw_ns == 0)							hw = 0;		// Host latency still unknown: measure it
+	else											hw = (wait + hw_ns <= sw_ns);
+
+	if (hw) {
+		dispatch_mlkem.depth++;
+		if (dispatch_mlkem.depth > dispatch_mlkem.depth_max) dispatch_mlkem.depth_max = dispatch_mlkem.depth;
+	}
+	else dispatch_mlkem.diverted++;
+
+	pthread_mutex_unlock(&dispatch_mlkem_lock);
+
+	return hw;
+}
+
+//-- A core call that failed (ret != SE_OK) only releases its place: its latency is
+//-- the watchdog's, not the core's
+static void dispatch_mlkem_done(int hw, int op, int k, unsigned long long ns, int ret)
+{
+	unsigned long long* avg;
+
+	pthread_mutex_lock(&dispatch_mlkem_lock);
+
+	if (hw && ret != SE_OK) {
+		dispatch_mlkem.depth--;
+		if (ret != SE_ERR_DEADLINE) dispatch_mlkem.hw_faults++;
+		pthread_mutex_unlock(&dispatch_mlkem_lock);
+		return;
+	}
+
+	if (hw) {
+		dispatch_mlkem.depth--;
+		dispatch_mlkem.hw_ops++;
+		avg = &dispatch_mlkem.hw_ns[op][k - 2];
+	}
+	else {
+		dispatch_mlkem.sw_ops++;
+		avg = &dispatch_mlkem.sw_ns[op][k - 2];
+	}
+	*avg = (*avg == 0) ? ns : *avg - (*avg >> DISPATCH_MLKEM_EWMA_SHIFT) + (ns >> DISPATCH_MLKEM_EWMA_SHIFT);
+
+	pthread_mutex_unlock(&dispatch_mlkem_lock);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// MAIN FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+int sha3_256_auto_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
+{
+	int ret;
+
+	if (dispatch_use_hw(DISPATCH_SHA3_256, length, interface) && dispatch_hw_done(DISPATCH_SHA3_256, ret = sha3_256_hw_func(in, length, out, interface)))	return ret;
+
+	sha3_256_sw(in, length, out);
+
+	return SE_OK;
+}
+
+int sha3_512_auto_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
+{
+	int ret;
+
+	if (dispatch_use_hw(DISPATCH_SHA3_512, length, interface) && dispatch_hw_done(DISPATCH_SHA3_512, ret = sha3_512_hw_func(in, length, out, interface)))	return ret;
+
+	sha3_512_sw(in, length, out);
+
+	return SE_OK;
+}
+
+int shake128_auto_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, INTF interface)
+{
+	int ret;
+
+	if (dispatch_use_hw(DISPATCH_SHAKE128, length, interface) && dispatch_hw_done(DISPATCH_SHAKE128, ret = shake128_hw_func(in, length, out, length_out, interface)))	return ret;
+
+	shake128_sw(in, length, out, length_out);
+
+	return SE_OK;
+}
+
+int shake256_auto_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, INTF interface)
+{
+	int ret;
+
+	if (dispatch_use_hw(DISPATCH_SHAKE256, length, interface) && dispatch_hw_done(DISPATCH_SHAKE256, ret = shake256_hw_func(in, length, out, length_out, interface)))	return ret;
+
+	shake256_sw(in, length, out, length_out);
+
+	return SE_OK;
+}
+
+int sha_256_auto_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
+{
+	int ret;
+
+	if (dispatch_use_hw(DISPATCH_SHA_256, length, interface) && dispatch_hw_done(DISPATCH_SHA_256, ret = sha_256_hw_func(in, length, out, interface)))	return ret;
+
+	sha_256_sw(in, length, out);
+
+	return SE_OK;
+}
+
+int sha_384_auto_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
+{
+	int ret;
+
+	if (dispatch_use_hw(DISPATCH_SHA_384, length, interface) && dispatch_hw_done(DISPATCH_SHA_384, ret = sha_384_hw_func(in, length, out, interface)))	return ret;
+
+	sha_384_sw(in, length, out);
+
+	return SE_OK;
+}
+
+int sha_512_auto_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
+{
+	int ret;
+
+	if (dispatch_use_hw(DISPATCH_SHA_512, length, interface) && dispatch_hw_done(DISPATCH_SHA_512, ret = sha_512_hw_func(in, length, out, interface)))	return ret;
+
+	sha_512_sw(in, length, out);
+
+	return SE_OK;
+}
+
+int sha_512_256_auto_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
+{
+	int ret;
+
+	if (dispatch_use_hw(DISPATCH_SHA_512_256, length, interface) && dispatch_hw_done(DISPATCH_SHA_512_256, ret = sha_512_256_hw_func(in, length, out, interface)))	return ret;
+
+	sha_512_256_sw(in, length, out);
+
+	return SE_OK;
+}
+
+int cshake128_auto_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* name, unsigned int name_len, unsigned char* custom, unsigned int custom_len, INTF interface)
+{
+	int ret;
+
+	if (dispatch_use_hw(DISPATCH_CSHAKE128, length, interface) && dispatch_hw_done(DISPATCH_CSHAKE128, ret = cshake_hw(in, length, out, length_out, name, name_len, custom, custom_len, 3, interface)))	return ret;
+
+	cshake_sw(in, length, out, length_out, name, name_len, custom, custom_len, 3);
+
+	return SE_OK;
+}
+
+int cshake256_auto_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* name, unsigned int name_len, unsigned char* custom, unsigned int custom_len, INTF interface)
+{
+	int ret;
+
+	if (dispatch_use_hw(DISPATCH_CSHAKE256, length, interface) && dispatch_hw_done(DISPATCH_CSHAKE256, ret = cshake_hw(in, length, out, length_out, name, name_len, custom, custom_len, 4, interface)))	return ret;
+
+	cshake_sw(in, length, out, length_out, name, name_len, custom, custom_len, 4);
+
+	return SE_OK;
+}
+
+int kmac128_auto_func(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface)
+{
+	int ret;
+
+	if (dispatch_use_hw(DISPATCH_KMAC128, length, interface) && dispatch_hw_done(DISPATCH_KMAC128, ret = kmac_hw(key, key_len, in, length, out, length_out, custom, custom_len, 0, 3, interface)))	return ret;
+
+	kmac_sw(key, key_len, in, length, out, length_out, custom, custom_len, 0, 3);
+
+	return SE_OK;
+}
+
+int kmac256_auto_func(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface)
+{
+	int ret;
+
+	if (dispatch_use_hw(DISPATCH_KMAC256, length, interface) && dispatch_hw_done(DISPATCH_KMAC256, ret = kmac_hw(key, key_len, in, length, out, length_out, custom, custom_len, 0, 4, interface)))	return ret;
+
+	kmac_sw(key, key_len, in, length, out, length_out, custom, custom_len, 0, 4);
+
+	return SE_OK;
+}
+
+int kmacxof128_auto_func(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface)
+{
+	int ret;
+
+	if (dispatch_use_hw(DISPATCH_KMAC128, length, interface) && dispatch_hw_done(DISPATCH_KMAC128, ret = kmac_hw(key, key_len, in, length, out, length_out, custom, custom_len, 1, 3, interface)))	return ret;
+
+	kmac_sw(key, key_len, in, length, out, length_out, custom, custom_len, 1, 3);
+
+	return SE_OK;
+}
+
+int kmacxof256_auto_func(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface)
+{
+	int ret;
+
+	if (dispatch_use_hw(DISPATCH_KMAC256, length, interface) && dispatch_hw_done(DISPATCH_KMAC256, ret = kmac_hw(key, key_len, in, length, out, length_out, custom, custom_len, 1, 4, interface)))	return ret;
+
+	kmac_sw(key, key_len, in, length, out, length_out, custom, custom_len, 1, 4);
+
+	return SE_OK;
+}
+
+//-- ML-KEM: the core path is timed from the moment the core lock is taken, so the
+//-- averages hold the service time and depth * average predicts the queue wait
+
+int mlkem_gen_keys_auto(int k, unsigned char* pk, unsigned char* sk, INTF interface)
+{
+	unsigned long long t;
+	int ret;
+
+	if (k < 2 || k > 4) return SE_ERR_ARG;
+
+	if (dispatch_mlkem_route(DISPATCH_MLKEM_KEYGEN, k, interface)) {
+		intf_core_lock(interface, SE_CORE_MLKEM);
+		t = dispatch_ns();
+		ret = mlkem_gen_keys_hw(k, pk, sk, interface);
+		t = dispatch_ns() - t;
+		intf_core_unlock(interface, SE_CORE_MLKEM);
+		dispatch_mlkem_done(1, DISPATCH_MLKEM_KEYGEN, k, t, ret);
+
+		// -- A faulted call is redone on the host unless the policy pins ML-KEM to the SE
+		if (ret == SE_OK || dispatch_get_policy() != DISPATCH_POLICY_AUTO) return ret;
+	}
+
+	t = dispatch_ns();
+	mlkem_gen_keys_sw(k, pk, sk);
+	dispatch_mlkem_done(0, DISPATCH_MLKEM_KEYGEN, k, dispatch_ns() - t, SE_OK);
+
+	return SE_OK;
+}
+
+int mlkem_enc_auto(int k, unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface)
+{
+	unsigned long long t;
+	int ret;
+
+	if (k < 2 || k > 4) return SE_ERR_ARG;
+
+	if (dispatch_mlkem_route(DISPATCH_MLKEM_ENC, k, interface)) {
+		intf_core_lock(interface, SE_CORE_MLKEM);
+		t = dispatch_ns();
+		ret = mlkem_enc_hw(k, pk, ct, ss, interface);
+		t = dispatch_ns() - t;
+		intf_core_unlock(interface, SE_CORE_MLKEM);
+		dispatch_mlkem_done(1, DISPATCH_MLKEM_ENC, k, t, ret);
+
+		// -- A faulted call is redone on the host unless the policy pins ML-KEM to the SE
+		if (ret == SE_OK || dispatch_get_policy() != DISPATCH_POLICY_AUTO) return ret;
+	}
+
+	t = dispatch_ns();
+	mlkem_enc_sw(k, pk, ct, ss);
+	dispatch_mlkem_done(0, DISPATCH_MLKEM_ENC, k, dispatch_ns() - t, SE_OK);
+
+	return SE_OK;
+}
+
+int mlkem_dec_auto(int k, unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface)
+{
+	unsigned long long t;
+	int ret;
+
+	if (k < 2 || k > 4) return SE_ERR_ARG;
+
+	if (dispatch_mlkem_route(DISPATCH_MLKEM_DEC, k, interface)) {
+		intf_core_lock(interface, SE_CORE_MLKEM);
+		t = dispatch_ns();
+		ret = mlkem_dec_hw(k, sk, ct, ss, result, interface);
+		t = dispatch_ns() - t;
+		intf_core_unlock(interface, SE_CORE_MLKEM);
+		dispatch_mlkem_done(1, DISPATCH_MLKEM_DEC, k, t, ret);
+
+		// -- A faulted call is redone on the host unless the policy pins ML-KEM to the SE
+		if (ret == SE_OK || dispatch_get_policy() != DISPATCH_POLICY_AUTO) return ret;
+	}
+
+	t = dispatch_ns();
+	mlkem_dec_sw(k, sk, ct, ss, result);
+	dispatch_mlkem_done(0, DISPATCH_MLKEM_DEC, k, dispatch_ns() - t, SE_OK);
+
+	return SE_OK;
+}
+
+int mlkem_512_gen_keys_auto(unsigned char* pk, unsigned char* sk, INTF interface)		{ return mlkem_gen_keys_auto(2, pk, sk, interface); }
+int mlkem_768_gen_keys_auto(unsigned char* pk, unsigned char* sk, INTF interface)		{ return mlkem_gen_keys_auto(3, pk, sk, interface); }
+int mlkem_1024_gen_keys_auto(unsigned char* pk, unsigned char* sk, INTF interface)	{ return mlkem_gen_keys_auto(4, pk, sk, interface); }
+
+int mlkem_512_enc_auto(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface)		{ return mlkem_enc_auto(2, pk, ct, ss, interface); }
+int mlkem_768_enc_auto(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface)		{ return mlkem_enc_auto(3, pk, ct, ss, interface); }
+int mlkem_1024_enc_auto(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface)	{ return mlkem_enc_auto(4, pk, ct, ss, interface); }
+
+int mlkem_512_dec_auto(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface)		{ return mlkem_dec_auto(2, sk, ct, ss, result, interface); }
+int mlkem_768_dec_auto(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface)		{ return mlkem_dec_auto(3, sk, ct, ss, result, interface); }
+int mlkem_1024_dec_auto(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface)	{ return mlkem_dec_auto(4, sk, ct, ss, result, interface); }
@@ -0,0 +1,195 @@
+/**
+  * @file dispatch.h
+  * @brief HW/SW Auto-Dispatch Layer
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../common/intf.h"
+#include "../common/conf.h"
+#include "../common/extra_func.h"
+#include "../sha3/sha3_shake_hw.h"
+#include "../sha3/sp800_185_hw.h"
+#include "../sha3/sha3_sw.h"
+#include "../sha2/sha2_hw.h"
+#include "../sha2/sha2_sw.h"
+#include "../mlkem/mlkem_hw.h"
+#include "../mlkem/mlkem_sw.h"
+
+/************************ Dispatch Constant Definitions **********************/
+
+//-- Algorithms with both a core and a host implementation
+#define DISPATCH_SHA3_256			0
+#define DISPATCH_SHA3_512			1
+#define DISPATCH_SHAKE128			2
+#define DISPATCH_SHAKE256			3
+#define DISPATCH_SHA_256			4
+#define DISPATCH_SHA_384			5
+#define DISPATCH_SHA_512			6
+#define DISPATCH_SHA_512_256		7
+#define DISPATCH_CSHAKE128			8
+#define DISPATCH_CSHAKE256			9
+#define DISPATCH_KMAC128			10		// Secret-key operation
+#define DISPATCH_KMAC256			11		// Secret-key operation
+#define DISPATCH_N_ALG				12
+
+//-- Routing policy
+#define DISPATCH_POLICY_AUTO		0		// Calibrated crossover for every algorithm
+#define DISPATCH_POLICY_HW_SECRET	1		// As AUTO, but keyed operations never leave the SE
+#define DISPATCH_POLICY_HW			2		// Everything on the SE
+#define DISPATCH_POLICY_SW			3		// Everything on the host
+
+#define DISPATCH_CACHE_DIR			"/var/tmp/se-qubip-%u"	// Per user (uid), mode 0700
+#define DISPATCH_CACHE_NAME			"dispatch"
+#define DISPATCH_CACHE_VERSION		2
+#define DISPATCH_NEVER				0xFFFFFFFFU				// Crossover: the core never wins
+#define DISPATCH_MAX_HW				0x1FFFFFFFULL			// The drivers take the length in bits as unsigned int
+
+#define DISPATCH_CAL_SHORT			64						// Calibration message sizes (bytes)
+#define DISPATCH_CAL_LONG			2048
+#define DISPATCH_CAL_REPS			3						// Best of N measurements
+#define DISPATCH_CAL_MIN_NS			200000ULL				// Min. measured time per sample
+
+//-- ML-KEM operations (the core does one at a time; the host takes the overflow)
+#define DISPATCH_MLKEM_KEYGEN		0
+#define DISPATCH_MLKEM_ENC			1
+#define DISPATCH_MLKEM_DEC			2
+#define DISPATCH_MLKEM_N_OP			3
+#define DISPATCH_MLKEM_MAX_DEPTH	4						// Default queue depth before diverting to the host
+#define DISPATCH_MLKEM_EWMA_SHIFT	3						// Latency average weight 1/8
+
+	//-- ML-KEM scheduler counters
+	typedef struct {
+		unsigned long long hw_ops;							// Completed on the core
+		unsigned long long sw_ops;							// Completed on the host
+		unsigned long long diverted;						// AUTO calls sent to the host because of the queue or an open breaker
+		unsigned long long hw_faults;						// Core calls that timed out (redone on the host under AUTO)
+		unsigned int depth;									// Calls waiting for or running on the core now
+		unsigned int depth_max;								// Highest depth seen
+		unsigned long long hw_ns[DISPATCH_MLKEM_N_OP][3];	// Latency averages per op and k = 2, 3, 4 (0 = not measured)
+		unsigned long long sw_ns[DISPATCH_MLKEM_N_OP][3];
+	} dispatch_mlkem_stats;
+
+	/************************ Control Functions **********************/
+
+	//-- The crossover table is loaded from the cache file (or calibrated against the
+	//-- interface of the first dispatched call and then saved) on first use. A cache
+	//-- written for another transport/board/clock is ignored: the clock is the one set
+	//-- with dispatch_set_clock or, on AXI, the PL clock (FREQ_* via Set_Clk_Freq).
+	//-- The *_auto calls return SE_OK, or the status of a failed core call that the
+	//-- policy keeps on the SE (its output wiped). The default file lives in
+	//-- DISPATCH_CACHE_DIR, which must belong to the user and be closed to others;
+	//-- a cache file not owned by the user, writable by others or reached through a
+	//-- symlink is not loaded, and saving never writes through an existing name.
+	void dispatch_set_policy(int policy);
+	int dispatch_get_policy();
+	void dispatch_set_cache(const char* path);
+	void dispatch_set_clock(float mhz);
+	int dispatch_calibrate(INTF interface);
+	unsigned int dispatch_crossover(int alg, INTF interface);
+	int dispatch_use_hw(int alg, unsigned long long length, INTF interface);
+
+	//-- ML-KEM calls from all threads queue for the core; under DISPATCH_POLICY_AUTO
+	//-- a call goes to the host when max_depth calls are already queued, or when the
+	//-- predicted queue wait exceeds max_wait_ns. With max_wait_ns = 0 the prediction
+	//-- is compared with the measured host latency instead. Under AUTO, a core whose
+	//-- circuit breaker is open gets no calls, and one that times out has the call
+	//-- redone on the host (the other policies return the wiped output).
+	void dispatch_mlkem_set_limits(unsigned int max_depth, unsigned long long max_wait_ns);
+	//-- enable = 0 sends every ML-KEM call to the host (core absent or being reset)
+	void dispatch_mlkem_set_hw(int enable);
+	void dispatch_mlkem_get_stats(dispatch_mlkem_stats* stats);
+
+	/************************ Main Functions **********************/
+
+	int sha3_256_auto_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
+	int sha3_512_auto_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
+	int shake128_auto_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, INTF interface);
+	int shake256_auto_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, INTF interface);
+	int sha_256_auto_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
+	int sha_384_auto_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
+	int sha_512_auto_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
+	int sha_512_256_auto_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
+	int cshake128_auto_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* name, unsigned int name_len, unsigned char* custom, unsigned int custom_len, INTF interface);
+	int cshake256_auto_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* name, unsigned int name_len, unsigned char* custom, unsigned int custom_len, INTF interface);
+	int kmac128_auto_func(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface);
+	int kmac256_auto_func(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface);
+	int kmacxof128_auto_func(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface);
+	int kmacxof256_auto_func(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface);
+
+	int mlkem_gen_keys_auto(int k, unsigned char* pk, unsigned char* sk, INTF interface);
+	int mlkem_enc_auto(int k, unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface);
+	int mlkem_dec_auto(int k, unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface);
+	int mlkem_512_gen_keys_auto(unsigned char* pk, unsigned char* sk, INTF interface);
+	int mlkem_768_gen_keys_auto(unsigned char* pk, unsigned char* sk, INTF interface);
+	int mlkem_1024_gen_keys_auto(unsigned char* pk, unsigned char* sk, INTF interface);
+	int mlkem_512_enc_auto(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface);
+	int mlkem_768_enc_auto(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface);
+	int mlkem_1024_enc_auto(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface);
+	int mlkem_512_dec_auto(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface);
+	int mlkem_768_dec_auto(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface);
+	int mlkem_1024_dec_auto(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface);
+
+#endif
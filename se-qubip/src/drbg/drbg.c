@@ -0,0 +1,730 @@
+/**
+  * @file drbg.c
+  * @brief SP 800-90A CTR_DRBG (AES-256) and Hash_DRBG (SHA-512)
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#include "drbg.h"
+#include "../trng/trng_hw.h"
+#include "../aes/aes_hw.h"
+#include "../sha2/sha2_hw.h"
+#include "../sha2/sha2_sw.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DRBG_AESNI
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// HOST AES-256 (AES-NI)
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- Other hosts (ARM included) have no host AES here: CTR_DRBG runs on the SE AES core
+
+#if defined(DRBG_AESNI)
+
+__attribute__((target("aes,sse2")))
+static inline __m128i drbg_aesni_assist_1(__m128i t1, __m128i t2)
+{
+	__m128i t4;
+
+	t2 = _mm_shuffle_epi32(t2, 0xff);
+	t4 = _mm_slli_si128(t1, 0x4);
+	t1 = _mm_xor_si128(t1, t4);
+	t4 = _mm_slli_si128(t4, 0x4);
+	t1 = _mm_xor_si128(t1, t4);
+	t4 = _mm_slli_si128(t4, 0x4);
+	t1 = _mm_xor_si128(t1, t4);
+
+	return _mm_xor_si128(t1, t2);
+}
+
+__attribute__((target("aes,sse2")))
+static inline __m128i drbg_aesni_assist_2(__m128i t1, __m128i t3)
+{
+	__m128i t2, t4;
+
+	t4 = _mm_aeskeygenassist_si128(t1, 0x0);
+	t2 = _mm_shuffle_epi32(t4, 0xaa);
+	t4 = _mm_slli_si128(t3, 0x4);
+	t3 = _mm_xor_si128(t3, t4);
+	t4 = _mm_slli_si128(t4, 0x4);
+	t3 = _mm_xor_si128(t3, t4);
+	t4 = _mm_slli_si128(t4, 0x4);
+	t3 = _mm_xor_si128(t3, t4);
+
+	return _mm_xor_si128(t3, t2);
+}
+
+#define DRBG_AESNI_ROUND_KEYS(i, rcon)									\
+	t1 = drbg_aesni_assist_1(t1, _mm_aeskeygenassist_si128(t3, rcon));	\
+	k[i] = t1;															\
+	t3 = drbg_aesni_assist_2(t1, t3);									\
+	k[i + 1] = t3;
+
+__attribute__((target("aes,sse2")))
+static void drbg_aes_expand(const unsigned char* key, unsigned char* rk)
+{
+	__m128i k[15];
+	__m128i t1 = _mm_loadu_si128((const __m128i*)key);
+	__m128i t3 = _mm_loadu_si128((const __m128i*)(key + 16));
+
+	k[0] = t1;
+	k[1] = t3;
+	DRBG_AESNI_ROUND_KEYS(2, 0x01)
+	DRBG_AESNI_ROUND_KEYS(4, 0x02)
+	DRBG_AESNI_ROUND_KEYS(6, 0x04)
+	DRBG_AESNI_ROUND_KEYS(8, 0x08)
+	DRBG_AESNI_ROUND_KEYS(10, 0x10)
+	DRBG_AESNI_ROUND_KEYS(12, 0x20)
+	k[14] = drbg_aesni_assist_1(t1, _mm_aeskeygenassist_si128(t3, 0x40));
+
+	for (int i = 0; i < 15; i++) _mm_storeu_si128((__m128i*)(rk + 16 * i), k[i]);
+}
+
+__attribute__((target("aes,sse2")))
+static void drbg_aes_blocks(const unsigned char* rk, const unsigned char* in, unsigned char* out, unsigned int blocks, int chain)
+{
+	__m128i k[15];
+	__m128i x = _mm_setzero_si128();
+
+	for (int i = 0; i < 15; i++) k[i] = _mm_loadu_si128((const __m128i*)(rk + 16 * i));
+
+	for (unsigned int b = 0; b < blocks; b++) {
+		__m128i d = _mm_loadu_si128((const __m128i*)(in + 16 * b));
+		x = chain ? _mm_xor_si128(x, d) : d;
+		x = _mm_xor_si128(x, k[0]);
+		for (int r = 1; r < 14; r++) x = _mm_aesenc_si128(x, k[r]);
+		x = _mm_aesenclast_si128(x, k[14]);
+		_mm_storeu_si128((__m128i*)(out + 16 * b), x);
+	}
+}
+
+int drbg_host_aes()
+{
+	return __builtin_cpu_supports("aes") ? 1 : 0;
+}
+
+#else
+
+static void drbg_aes_expand(const unsigned char* key, unsigned char* rk)
+{
+	(void)key; (void)rk;
+}
+
+static void drbg_aes_blocks(const unsigned char* rk, const unsigned char* in, unsigned char* out, unsigned int blocks, int chain)
+{
+	(void)rk; (void)in; (void)out; (void)blocks; (void)chain;
+}
+
+int drbg_host_aes()
+{
+	return 0;
+}
+
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// PRIMITIVES
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- On the SE the key is loaded once and the blocks are streamed through the AES
+//-- core: -1 if the core faulted (out is then incomplete).
+static int drbg_aes_se(drbg_ctx* ctx, const unsigned char* key, const unsigned char* in, unsigned char* out, unsigned int blocks, int chain)
+{
+	unsigned char k[32], x[16];
+	int faulted;
+
+	memcpy(k, key, 32);
+	memset(x, 0, 16);
+	intf_core_lock(ctx->interface, SE_CORE_AES);
+	aes_init((AES_256 << 1) + AES_ENC, k, ctx->interface);
+	for (unsigned int b = 0; b < blocks; b++) {
+		if (chain) {
+			for (int j = 0; j < 16; j++) x[j] ^= in[16 * b + j];
+			aes_op(x, x, ctx->interface);
+			memcpy(out + 16 * b, x, 16);
+		}
+		else aes_op((unsigned char*)in + 16 * b, out + 16 * b, ctx->interface);
+	}
+	faulted = intf_core_faulted(ctx->interface, SE_CORE_AES);
+	intf_core_unlock(ctx->interface, SE_CORE_AES);
+	memset(k, 0, sizeof(k));
+	memset(x, 0, sizeof(x));
+
+	return (faulted) ? -1 : 0;
+}
+
+//-- ECB (chain = 0) or CBC with a zero IV (chain = 1) under a 256-bit key. A
+//-- faulted AES core never yields output: the blocks are redone on the host, or
+//-- the instance is marked faulted and torn down by drbg_check.
+static void drbg_aes(drbg_ctx* ctx, const unsigned char* key, const unsigned char* in, unsigned char* out, unsigned int blocks, int chain)
+{
+	unsigned char rk[240];
+
+	if (ctx->backend != DRBG_BACKEND_HOST && drbg_aes_se(ctx, key, in, out, blocks, chain) == 0) return;
+	if (!drbg_host_aes()) ctx->fault = 1;
+
+	drbg_aes_expand(key, rk);
+	drbg_aes_blocks(rk, in, out, blocks, chain);
+	memset(rk, 0, sizeof(rk));
+}
+
+static void drbg_sha512(drbg_ctx* ctx, const unsigned char* in, unsigned int len, unsigned char* out)
+{
+	if (ctx->backend == DRBG_BACKEND_HOST)	sha_512_sw(in, len, out);
+	else if (sha2_hw(ctx->interface, (unsigned char*)in, out, 8ULL * len, 3, 0) != SE_OK)	sha_512_sw(in, len, out);
+}
+
+//-- Big-endian v (v_len bytes) += x (x_len bytes), mod 2^(8 v_len)
+static void drbg_add(unsigned char* v, unsigned int v_len, const unsigned char* x, unsigned int x_len)
+{
+	unsigned int carry = 0;
+
+	for (unsigned int i = 0; i < v_len; i++) {
+		carry += v[v_len - 1 - i];
+		if (i < x_len) carry += x[x_len - 1 - i];
+		v[v_len - 1 - i] = (unsigned char)carry;
+		carry >>= 8;
+	}
+}
+
+static void drbg_add_u64(unsigned char* v, unsigned int v_len, unsigned long long n)
+{
+	unsigned char x[8];
+
+	for (int i = 0; i < 8; i++) x[i] = (unsigned char)(n >> (56 - 8 * i));
+	drbg_add(v, v_len, x, 8);
+}
+
+static unsigned int drbg_cat(unsigned char* buf, const unsigned char* a, unsigned int a_len, const unsigned char* b, unsigned int b_len, const unsigned char* c, unsigned int c_len)
+{
+	if (a_len) memcpy(buf, a, a_len);
+	if (b_len) memcpy(buf + a_len, b, b_len);
+	if (c_len) memcpy(buf + a_len + b_len, c, c_len);
+
+	return a_len + b_len + c_len;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// CTR_DRBG (AES-256, derivation function)
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#define DRBG_CTR_CHUNK		256		// Counter blocks per AES call
+
+static void drbg_ctr_inc(unsigned char* v)
+{
+	for (int i = 15; i >= 0; i--) if (++v[i] != 0) break;
+}
+
+static void drbg_ctr_update(drbg_ctx* ctx, const unsigned char* provided)
+{
+	unsigned char ctr[DRBG_CTR_SEEDLEN], temp[DRBG_CTR_SEEDLEN];
+
+	for (int i = 0; i < 3; i++) {
+		drbg_ctr_inc(ctx->v);
+		memcpy(ctr + 16 * i, ctx->v, 16);
+	}
+	drbg_aes(ctx, ctx->key, ctr, temp, 3, 0);
+	if (provided != NULL) for (int i = 0; i < DRBG_CTR_SEEDLEN; i++) temp[i] ^= provided[i];
+
+	memcpy(ctx->key, temp, 32);
+	memcpy(ctx->v, temp + 32, 16);
+	memset(temp, 0, sizeof(temp));
+}
+
+//-- Block_Cipher_df: BCC is the last block of a zero-IV CBC encryption
+static void drbg_ctr_df(drbg_ctx* ctx, const unsigned char* in, unsigned int in_len, unsigned char* out)
+{
+	static const unsigned char k0[32] = {
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+		0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f };
+	unsigned char s[16 + 8 + 3 * DRBG_MAX_INPUT + 16];
+	unsigned char cbc[sizeof(s)];
+	unsigned char temp[DRBG_CTR_SEEDLEN], zero[DRBG_CTR_SEEDLEN];
+	unsigned int len;
+
+	// -- IV || L || N || input || 0x80 || zero padding
+	memset(s, 0, sizeof(s));
+	s[16] = (unsigned char)(in_len >> 24); s[17] = (unsigned char)(in_len >> 16);
+	s[18] = (unsigned char)(in_len >> 8);  s[19] = (unsigned char)in_len;
+	s[23] = DRBG_CTR_SEEDLEN;
+	memcpy(s + 24, in, in_len);
+	s[24 + in_len] = 0x80;
+	len = (24 + in_len + 1 + 15) & ~15u;
+
+	for (int i = 0; i < 3; i++) {
+		s[3] = (unsigned char)i;
+		drbg_aes(ctx, k0, s, cbc, len / 16, 1);
+		memcpy(temp + 16 * i, cbc + len - 16, 16);
+	}
+
+	// -- X chained under the new K: CBC over zero blocks with X as first block
+	memset(zero, 0, sizeof(zero));
+	memcpy(zero, temp + 32, 16);
+	drbg_aes(ctx, temp, zero, out, 3, 1);
+
+	memset(s, 0, sizeof(s));
+	memset(cbc, 0, sizeof(cbc));
+	memset(temp, 0, sizeof(temp));
+	memset(zero, 0, sizeof(zero));
+}
+
+static void drbg_ctr_seed(drbg_ctx* ctx, const unsigned char* seed_material, unsigned int len, int instantiate)
+{
+	unsigned char seed[DRBG_CTR_SEEDLEN];
+
+	drbg_ctr_df(ctx, seed_material, len, seed);
+	if (instantiate) {
+		memset(ctx->key, 0, 32);
+		memset(ctx->v, 0, 16);
+	}
+	drbg_ctr_update(ctx, seed);
+	memset(seed, 0, sizeof(seed));
+}
+
+static void drbg_ctr_generate(drbg_ctx* ctx, unsigned char* out, unsigned int len, const unsigned char* add, unsigned int add_len)
+{
+	unsigned char a[DRBG_CTR_SEEDLEN];
+	unsigned char ctr[16 * DRBG_CTR_CHUNK];
+	unsigned int done = 0;
+
+	memset(a, 0, sizeof(a));
+	if (add_len) {
+		drbg_ctr_df(ctx, add, add_len, a);
+		drbg_ctr_update(ctx, a);
+	}
+
+	while (done < len) {
+		unsigned int bytes = (len - done < sizeof(ctr)) ? (len - done) : (unsigned int)sizeof(ctr);
+		unsigned int blocks = (bytes + 15) / 16;
+		for (unsigned int b = 0; b < blocks; b++) {
+			drbg_ctr_inc(ctx->v);
+			memcpy(ctr + 16 * b, ctx->v, 16);
+		}
+		drbg_aes(ctx, ctx->key, ctr, ctr, blocks, 0);
+		memcpy(out + done, ctr, bytes);
+		done += bytes;
+	}
+
+	drbg_ctr_update(ctx, a);
+	memset(ctr, 0, sizeof(ctr));
+	memset(a, 0, sizeof(a));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// HASH_DRBG (SHA-512)
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static void drbg_hash_df(drbg_ctx* ctx, const unsigned char* in, unsigned int in_len, unsigned char* out)
+{
+	unsigned char buf[5 + 1 + DRBG_HASH_SEEDLEN + 2 * DRBG_MAX_INPUT];
+	unsigned char temp[128];
+
+	buf[1] = 0x00; buf[2] = 0x00;
+	buf[3] = (unsigned char)((DRBG_HASH_SEEDLEN * 8) >> 8);
+	buf[4] = (unsigned char)(DRBG_HASH_SEEDLEN * 8);
+	memcpy(buf + 5, in, in_len);
+
+	for (int i = 0; i < 2; i++) {
+		buf[0] = (unsigned char)(i + 1);
+		drbg_sha512(ctx, buf, 5 + in_len, temp + 64 * i);
+	}
+	memcpy(out, temp, DRBG_HASH_SEEDLEN);
+
+	memset(buf, 0, sizeof(buf));
+	memset(temp, 0, sizeof(temp));
+}
+
+//-- V from seed_material, then C = Hash_df(0x00 || V)
+static void drbg_hash_seed(drbg_ctx* ctx, const unsigned char* seed_material, unsigned int len)
+{
+	unsigned char buf[1 + DRBG_HASH_SEEDLEN];
+
+	drbg_hash_df(ctx, seed_material, len, ctx->v);
+	buf[0] = 0x00;
+	memcpy(buf + 1, ctx->v, DRBG_HASH_SEEDLEN);
+	drbg_hash_df(ctx, buf, sizeof(buf), ctx->c);
+	memset(buf, 0, sizeof(buf));
+}
+
+static void drbg_hash_generate(drbg_ctx* ctx, unsigned char* out, unsigned int len, const unsigned char* add, unsigned int add_len)
+{
+	unsigned char buf[1 + DRBG_HASH_SEEDLEN + DRBG_MAX_INPUT];
+	unsigned char data[DRBG_HASH_SEEDLEN];
+	unsigned char w[64];
+	unsigned int done = 0;
+
+	if (add_len) {
+		buf[0] = 0x02;
+		memcpy(buf + 1, ctx->v, DRBG_HASH_SEEDLEN);
+		memcpy(buf + 1 + DRBG_HASH_SEEDLEN, add, add_len);
+		drbg_sha512(ctx, buf, 1 + DRBG_HASH_SEEDLEN + add_len, w);
+		drbg_add(ctx->v, DRBG_HASH_SEEDLEN, w, 64);
+	}
+
+	// -- Hashgen
+	memcpy(data, ctx->v, DRBG_HASH_SEEDLEN);
+	while (done < len) {
+		unsigned int bytes = (len - done < 64) ? (len - done) : 64;
+		drbg_sha512(ctx, data, DRBG_HASH_SEEDLEN, w);
+		memcpy(out + done, w, bytes);
+		drbg_add_u64(data, DRBG_HASH_SEEDLEN, 1);
+		done += bytes;
+	}
+
+	// -- V = V + H(0x03 || V) + C + reseed_counter
+	buf[0] = 0x03;
+	memcpy(buf + 1, ctx->v, DRBG_HASH_SEEDLEN);
+	drbg_sha512(ctx, buf, 1 + DRBG_HASH_SEEDLEN, w);
+	drbg_add(ctx->v, DRBG_HASH_SEEDLEN, w, 64);
+	drbg_add(ctx->v, DRBG_HASH_SEEDLEN, ctx->c, DRBG_HASH_SEEDLEN);
+	drbg_add_u64(ctx->v, DRBG_HASH_SEEDLEN, ctx->reseed_counter);
+
+	memset(buf, 0, sizeof(buf));
+	memset(data, 0, sizeof(data));
+	memset(w, 0, sizeof(w));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// INSTANCE FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static int drbg_setup(drbg_ctx* ctx, int type, int backend, INTF interface)
+{
+	if (type != DRBG_CTR_AES256 && type != DRBG_HASH_SHA512) {
+		printf("\n DRBG FAIL!: unknown type %d\n", type);
+		return DRBG_ERR;
+	}
+
+	if (backend == DRBG_BACKEND_AUTO)
+		backend = (type == DRBG_HASH_SHA512 || drbg_host_aes()) ? DRBG_BACKEND_HOST : DRBG_BACKEND_HW;
+	else if (backend == DRBG_BACKEND_HOST && type == DRBG_CTR_AES256 && !drbg_host_aes()) {
+		printf("\n DRBG FAIL!: no AES instructions on this host\n");
+		return DRBG_ERR;
+	}
+
+	memset(ctx, 0, sizeof(drbg_ctx));
+	ctx->type = type;
+	ctx->backend = backend;
+	ctx->reseed_interval = DRBG_RESEED_INTERVAL;
+	ctx->interface = interface;
+
+	return DRBG_OK;
+}
+
+static void drbg_instantiate(drbg_ctx* ctx, const unsigned char* entropy, unsigned int entropy_len,
+	const unsigned char* nonce, unsigned int nonce_len, const unsigned char* pers, unsigned int pers_len)
+{
+	unsigned char seed_material[3 * DRBG_MAX_INPUT];
+	unsigned int len = drbg_cat(seed_material, entropy, entropy_len, nonce, nonce_len, pers, pers_len);
+
+	if (ctx->type == DRBG_CTR_AES256)	drbg_ctr_seed(ctx, seed_material, len, 1);
+	else								drbg_hash_seed(ctx, seed_material, len);
+
+	ctx->reseed_counter = 1;
+	memset(seed_material, 0, sizeof(seed_material));
+}
+
+static void drbg_reseed_with(drbg_ctx* ctx, const unsigned char* entropy, unsigned int entropy_len, const unsigned char* add, unsigned int add_len, int forced)
+{
+	unsigned char seed_material[1 + DRBG_HASH_SEEDLEN + 2 * DRBG_MAX_INPUT];
+	unsigned int len;
+
+	if (ctx->type == DRBG_CTR_AES256) {
+		len = drbg_cat(seed_material, entropy, entropy_len, add, add_len, NULL, 0);
+		drbg_ctr_seed(ctx, seed_material, len, 0);
+	}
+	else {
+		seed_material[0] = 0x01;
+		len = 1 + drbg_cat(seed_material + 1, ctx->v, DRBG_HASH_SEEDLEN, entropy, entropy_len, add, add_len);
+		drbg_hash_seed(ctx, seed_material, len);
+	}
+	ctx->reseed_counter = 1;
+	memset(seed_material, 0, sizeof(seed_material));
+
+	// -- interval statistics
+	ctx->st.reseeds++;
+	if (forced) ctx->st.reseeds_interval++;
+	if (ctx->st.since_reseed > ctx->st.max_between) ctx->st.max_between = ctx->st.since_reseed;
+	ctx->st.sum_between += ctx->st.since_reseed;
+	ctx->st.since_reseed = 0;
+}
+
+//-- A faulted instance is wiped (uninstantiated) and the call fails
+static int drbg_check(drbg_ctx* ctx)
+{
+	if (!ctx->fault) return DRBG_OK;
+
+	memset(ctx, 0, sizeof(drbg_ctx));
+
+	return DRBG_ERR;
+}
+
+static int drbg_reseed_trng(drbg_ctx* ctx, const unsigned char* add, unsigned int add_len, int forced)
+{
+	unsigned char entropy[DRBG_ENTROPY_BYTES];
+
+	if (trng_hw(entropy, DRBG_ENTROPY_BYTES, ctx->interface) != TRNG_OK) return DRBG_ERR;
+	drbg_reseed_with(ctx, entropy, DRBG_ENTROPY_BYTES, add, add_len, forced);
+	memset(entropy, 0, sizeof(entropy));
+
+	return drbg_check(ctx);
+}
+
+int drbg_init(drbg_ctx* ctx, int type, int backend, const unsigned char* pers, unsigned int pers_len, INTF interface)
+{
+	unsigned char en[DRBG_ENTROPY_BYTES + DRBG_NONCE_BYTES];
+
+	if (pers_len > DRBG_MAX_INPUT) return DRBG_ERR;
+	if (drbg_setup(ctx, type, backend, interface) != DRBG_OK) return DRBG_ERR;
+
+	if (trng_hw(en, sizeof(en), interface) != TRNG_OK) {
+		memset(ctx, 0, sizeof(drbg_ctx));
+		return DRBG_ERR;
+	}
+	drbg_instantiate(ctx, en, DRBG_ENTROPY_BYTES, en + DRBG_ENTROPY_BYTES, DRBG_NONCE_BYTES, pers, pers_len);
+	memset(en, 0, sizeof(en));
+
+	return drbg_check(ctx);
+}
+
+int drbg_init_kat(drbg_ctx* ctx, int type, int backend, const unsigned char* entropy, unsigned int entropy_len,
+	const unsigned char* nonce, unsigned int nonce_len, const unsigned char* pers, unsigned int pers_len, INTF interface)
+{
+	if (entropy_len > DRBG_MAX_INPUT || nonce_len > DRBG_MAX_INPUT || pers_len > DRBG_MAX_INPUT) return DRBG_ERR;
+	if (drbg_setup(ctx, type, backend, interface) != DRBG_OK) return DRBG_ERR;
+
+	ctx->kat = 1;
+	drbg_instantiate(ctx, entropy, entropy_len, nonce, nonce_len, pers, pers_len);
+
+	return drbg_check(ctx);
+}
+
+int drbg_reseed(drbg_ctx* ctx, const unsigned char* add, unsigned int add_len)
+{
+	if (ctx->reseed_counter == 0 || ctx->kat || add_len > DRBG_MAX_INPUT) return DRBG_ERR;
+
+	return drbg_reseed_trng(ctx, add, add_len, 0);
+}
+
+int drbg_reseed_kat(drbg_ctx* ctx, const unsigned char* entropy, unsigned int entropy_len, const unsigned char* add, unsigned int add_len)
+{
+	if (ctx->reseed_counter == 0 || entropy_len > DRBG_MAX_INPUT || add_len > DRBG_MAX_INPUT) return DRBG_ERR;
+
+	drbg_reseed_with(ctx, entropy, entropy_len, add, add_len, 0);
+
+	return drbg_check(ctx);
+}
+
+int drbg_generate(drbg_ctx* ctx, unsigned char* out, unsigned long long len, const unsigned char* add, unsigned int add_len)
+{
+	if (ctx->reseed_counter == 0 || add_len > DRBG_MAX_INPUT) return DRBG_ERR;
+
+	// -- additional input goes with the first request
+	while (len > 0) {
+		unsigned int n = (len < DRBG_MAX_REQUEST) ? (unsigned int)len : DRBG_MAX_REQUEST;
+
+		if (ctx->reseed_counter > ctx->reseed_interval) {
+			if (ctx->kat) return DRBG_RESEED_REQUIRED;
+			if (drbg_reseed_trng(ctx, add, add_len, 1) != DRBG_OK) return DRBG_ERR;
+			add_len = 0;
+		}
+
+		if (ctx->type == DRBG_CTR_AES256)	drbg_ctr_generate(ctx, out, n, add, add_len);
+		else								drbg_hash_generate(ctx, out, n, add, add_len);
+
+		if (ctx->fault) {
+			memset(out, 0, n);
+			return drbg_check(ctx);
+		}
+
+		ctx->reseed_counter++;
+		ctx->st.generates++;
+		ctx->st.bytes += n;
+		ctx->st.since_reseed++;
+
+		add_len = 0;
+		out += n;
+		len -= n;
+	}
+
+	return DRBG_OK;
+}
+
+void drbg_set_reseed_interval(drbg_ctx* ctx, unsigned long long interval)
+{
+	if (interval == 0) interval = 1;
+	if (interval > (1ULL << 48)) interval = 1ULL << 48;
+
+	ctx->reseed_interval = interval;
+}
+
+void drbg_stats(const drbg_ctx* ctx, drbg_stat* st)
+{
+	*st = ctx->st;
+}
+
+void drbg_free(drbg_ctx* ctx)
+{
+	memset(ctx, 0, sizeof(drbg_ctx));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// PER-THREAD FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static __thread drbg_ctx* drbg_tls = NULL;
+static pthread_key_t drbg_tls_key;
+static pthread_once_t drbg_tls_once = PTHREAD_ONCE_INIT;
+static drbg_stat drbg_tstat[DRBG_N_TYPE];
+
+static void drbg_tls_destroy(void* p)
+{
+	if (p == NULL) return;
+	memset(p, 0, DRBG_N_TYPE * sizeof(drbg_ctx));
+	free(p);
+}
+
+//-- The child of a fork runs on the forking thread with a copy of its state:
+//-- the instances are dropped, so the child instantiates fresh ones from the
+//-- TRNG instead of repeating the parent's output.
+static void drbg_tls_atfork_child()
+{
+	if (drbg_tls != NULL) memset(drbg_tls, 0, DRBG_N_TYPE * sizeof(drbg_ctx));
+}
+
+static void drbg_tls_key_init()
+{
+	pthread_key_create(&drbg_tls_key, drbg_tls_destroy);
+	pthread_atfork(NULL, NULL, drbg_tls_atfork_child);
+}
+
+static int drbg_thread_generate(int type, unsigned char* out, unsigned int len, INTF interface)
+{
+	drbg_ctx* ctx;
+	drbg_stat before;
+	int ret;
+
+	pthread_once(&drbg_tls_once, drbg_tls_key_init);
+	if (drbg_tls == NULL) {
+		drbg_tls = calloc(DRBG_N_TYPE, sizeof(drbg_ctx));
+		if (drbg_tls == NULL) return DRBG_ERR;
+		pthread_setspecific(drbg_tls_key, drbg_tls);
+	}
+
+	ctx = &drbg_tls[type];
+	if (ctx->reseed_counter == 0) {
+		// -- personalization: one distinct instance per thread and process
+		pthread_t self = pthread_self();
+		pid_t pid = getpid();
+		unsigned char pers[sizeof(pthread_t) + sizeof(pid_t)];
+		memcpy(pers, &self, sizeof(pthread_t));
+		memcpy(pers + sizeof(pthread_t), &pid, sizeof(pid_t));
+		if (drbg_init(ctx, type, DRBG_BACKEND_AUTO, pers, sizeof(pers), interface) != DRBG_OK) return DRBG_ERR;
+	}
+	ctx->interface = interface;
+
+	before = ctx->st;
+	ret = drbg_generate(ctx, out, len, NULL, 0);
+
+	drbg_stat* g = &drbg_tstat[type];
+	__atomic_add_fetch(&g->generates, ctx->st.generates - before.generates, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&g->bytes, ctx->st.bytes - before.bytes, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&g->reseeds, ctx->st.reseeds - before.reseeds, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&g->reseeds_interval, ctx->st.reseeds_interval - before.reseeds_interval, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&g->sum_between, ctx->st.sum_between - before.sum_between, __ATOMIC_RELAXED);
+	unsigned long long m = __atomic_load_n(&g->max_between, __ATOMIC_RELAXED);
+	while (ctx->st.max_between > m && !__atomic_compare_exchange_n(&g->max_between, &m, ctx->st.max_between, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	return ret;
+}
+
+int ctr_drbg_hw(unsigned char* out, unsigned int len, INTF interface)
+{
+	return drbg_thread_generate(DRBG_CTR_AES256, out, len, interface);
+}
+
+int hash_drbg_hw(unsigned char* out, unsigned int len, INTF interface)
+{
+	return drbg_thread_generate(DRBG_HASH_SHA512, out, len, interface);
+}
+
+void drbg_thread_free()
+{
+	if (drbg_tls == NULL) return;
+
+	pthread_setspecific(drbg_tls_key, NULL);
+	drbg_tls_destroy(drbg_tls);
+	drbg_tls = NULL;
+}
+
+void drbg_thread_stats(int type, drbg_stat* st)
+{
+	memset(st, 0, sizeof(drbg_stat));
+	if (type < 0 || type >= DRBG_N_TYPE) return;
+
+	st->generates = __atomic_load_n(&drbg_tstat[type].generates, __ATOMIC_RELAXED);
+	st->bytes = __atomic_load_n(&drbg_tstat[type].bytes, __ATOMIC_RELAXED);
+	st->reseeds = __atomic_load_n(&drbg_tstat[type].reseeds, __ATOMIC_RELAXED);
+	st->reseeds_interval = __atomic_load_n(&drbg_tstat[type].reseeds_interval, __ATOMIC_RELAXED);
+	st->max_between = __atomic_load_n(&drbg_tstat[type].max_between, __ATOMIC_RELAXED);
+	st->sum_between = __atomic_load_n(&drbg_tstat[type].sum_between, __ATOMIC_RELAXED);
+}
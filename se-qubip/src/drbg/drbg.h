@@ -0,0 +1,152 @@
+/**
+  * @file drbg.h
+  * @brief SP 800-90A CTR_DRBG (AES-256) and Hash_DRBG (SHA-512)
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef DRBG_H
+#define DRBG_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "../common/intf.h"
+#include "../common/conf.h"
+
+/************************ DRBG Constant Definitions **********************/
+
+#define DRBG_CTR_AES256				0		// CTR_DRBG, AES-256, derivation function
+#define DRBG_HASH_SHA512			1		// Hash_DRBG, SHA-512
+#define DRBG_N_TYPE					2
+
+#define DRBG_BACKEND_AUTO			0		// Host instructions when available, else the SE core
+#define DRBG_BACKEND_HW				1		// AES / SHA-2 core of the SE
+#define DRBG_BACKEND_HOST			2		// Host only (AES-NI, host SHA-512)
+
+#define DRBG_OK						0
+#define DRBG_ERR					-1
+#define DRBG_RESEED_REQUIRED		-2		// KAT instance past its reseed interval
+
+#define DRBG_ENTROPY_BYTES			32		// 256-bit security strength
+#define DRBG_NONCE_BYTES			16
+#define DRBG_MAX_INPUT				256		// Entropy, nonce, personalization, additional input
+#define DRBG_MAX_REQUEST			65536	// 2^19 bits per request; longer outputs are split
+#define DRBG_RESEED_INTERVAL		65536	// Requests between reseeds (SP 800-90A allows 2^48)
+
+#define DRBG_CTR_SEEDLEN			48
+#define DRBG_HASH_SEEDLEN			111		// 888 bits for SHA-512
+
+	typedef struct {
+		unsigned long long generates;			// Requests served
+		unsigned long long bytes;				// Bytes generated
+		unsigned long long reseeds;				// Reseeds, explicit or forced
+		unsigned long long reseeds_interval;	// Reseeds forced by the reseed interval
+		unsigned long long since_reseed;		// Requests since the last (re)seed
+		unsigned long long max_between;			// Most requests between two reseeds
+		unsigned long long sum_between;			// Requests over all completed intervals
+	} drbg_stat;
+
+	typedef struct {
+		int type;
+		int backend;							// Resolved: DRBG_BACKEND_HW or DRBG_BACKEND_HOST
+		int kat;								// Deterministic: entropy only from the caller
+		int fault;								// The AES core faulted with no host AES to redo it on
+		unsigned char key[32];					// CTR: Key
+		unsigned char v[DRBG_HASH_SEEDLEN];		// CTR: V (16 bytes) / Hash: V
+		unsigned char c[DRBG_HASH_SEEDLEN];		// Hash: C
+		unsigned long long reseed_counter;
+		unsigned long long reseed_interval;
+		INTF interface;
+		drbg_stat st;
+	} drbg_ctx;
+
+	/************************ Instance Functions **********************/
+
+	//-- Live instances take entropy input and nonce from trng_hw and reseed from it
+	//-- every reseed_interval requests; DRBG_ERR when the TRNG fails its health
+	//-- tests. Calls that reach the SE (TRNG, and the AES / SHA-2 core with
+	//-- DRBG_BACKEND_HW) take the cores they use, like the drivers.
+	int drbg_init(drbg_ctx* ctx, int type, int backend, const unsigned char* pers, unsigned int pers_len, INTF interface);
+	int drbg_reseed(drbg_ctx* ctx, const unsigned char* add, unsigned int add_len);
+
+	//-- Deterministic (KAT) instances: entropy and nonce come from the caller and
+	//-- generate returns DRBG_RESEED_REQUIRED instead of reseeding from the TRNG.
+	int drbg_init_kat(drbg_ctx* ctx, int type, int backend, const unsigned char* entropy, unsigned int entropy_len,
+		const unsigned char* nonce, unsigned int nonce_len, const unsigned char* pers, unsigned int pers_len, INTF interface);
+	int drbg_reseed_kat(drbg_ctx* ctx, const unsigned char* entropy, unsigned int entropy_len, const unsigned char* add, unsigned int add_len);
+
+	//-- Outputs longer than DRBG_MAX_REQUEST are produced as consecutive requests
+	int drbg_generate(drbg_ctx* ctx, unsigned char* out, unsigned long long len, const unsigned char* add, unsigned int add_len);
+	void drbg_set_reseed_interval(drbg_ctx* ctx, unsigned long long interval);
+	void drbg_stats(const drbg_ctx* ctx, drbg_stat* st);
+	void drbg_free(drbg_ctx* ctx);
+
+	//-- 1 when the host has AES instructions (DRBG_BACKEND_AUTO then keeps CTR_DRBG off the bus)
+	int drbg_host_aes();
+
+	/************************ Per-Thread Functions **********************/
+
+	//-- One live instance per thread and type, created on first use with
+	//-- DRBG_BACKEND_AUTO and wiped when the thread exits: no locking on the fast path.
+	//-- The child of a fork drops the copied instances and instantiates its own.
+	int ctr_drbg_hw(unsigned char* out, unsigned int len, INTF interface);
+	int hash_drbg_hw(unsigned char* out, unsigned int len, INTF interface);
+	void drbg_thread_free();
+	void drbg_thread_stats(int type, drbg_stat* st);	// Summed over all threads
+
+#endif
@@ -78,18 +78,19 @@
 // INTERFACE INIT/START & READ/WRITE
 /////////////////////////////////////////////////////////////////////////////////////////////
 
-void eddsa25519_init(unsigned long long operation, INTF interface)
+//-- Core reset and operation select. Without the interface reset the input
+//-- registers (keys) keep their contents.
+static void eddsa25519_reset(unsigned long long operation, int intf_reset, INTF interface)
 {
     unsigned long long control;
     unsigned long long address;
     unsigned long long data_in;
 
     //-- General and Interface Reset
-    control = (ADD_EDDSA << 32) + EDDSA_INTF_RST + EDDSA_RST_ON;
+    control = (intf_reset) ? (ADD_EDDSA << 32) + EDDSA_INTF_RST + EDDSA_RST_ON : (ADD_EDDSA << 32) + EDDSA_RST_ON;
     write_INTF(interface, &control, CONTROL, AXI_BYTES);
 
-    // printf("Press any key to continue...\n");
-    // getchar();
+    if (intf_reset) intf_set_resident(interface, 0);
 
     // Select Operation Mode
     control = (ADD_EDDSA << 32) + EDDSA_INTF_LOAD + EDDSA_RST_ON;
@@ -104,6 +105,49 @@ void eddsa25519_init(unsigned long long operation, INTF interface)
     write_INTF(interface, &control, CONTROL, AXI_BYTES);
 }
 
+//-- Watchdog: a hung or failed core is reset (keys included) and the fault reported
+static int eddsa25519_abort(int err, INTF interface)
+{
+    unsigned long long control = (ADD_EDDSA << 32) + EDDSA_INTF_RST + EDDSA_RST_ON;
+
+    write_INTF(interface, &control, CONTROL, AXI_BYTES);
+    intf_set_resident(interface, 0);
+    return intf_core_fault(interface, SE_CORE_EDDSA, err);
+}
+
+//-- Between message blocks: a call past its deadline stops here, core reset
+static int eddsa25519_expired(INTF interface)
+{
+    if (!intf_deadline_passed(interface)) return 0;
+
+    return eddsa25519_abort(SE_ERR_DEADLINE, interface);
+}
+
+//-- The one FAIL line of a failed call, printed once its retries are over
+static int eddsa25519_fail(const char *what, int err)
+{
+    switch (err)
+    {
+        case SE_ERR_TIMEOUT:    printf("%s FAIL!: TIMEOUT \t%d us\n", what, EDDSA_WAIT_TIME); break;
+        case SE_ERR_CORE:       printf("%s FAIL!: CORE ERROR\n", what); break;
+        case SE_ERR_DEADLINE:   printf("%s FAIL!: DEADLINE\n", what); break;
+        default:                printf("%s FAIL!: MESSAGE CALLBACK ERROR\n", what); break;
+    }
+
+    return -1;
+}
+
+//-- A failed operation is run again only after a watchdog reset, while the breaker stays closed
+static int eddsa25519_retry(int ret, INTF interface)
+{
+    return ret != 0 && intf_core_faulted(interface, SE_CORE_EDDSA) && intf_core_retry(interface, SE_CORE_EDDSA, intf_status(interface));
+}
+
+void eddsa25519_init(unsigned long long operation, INTF interface)
+{
+    eddsa25519_reset(operation, 1, interface);
+}
+
 void eddsa25519_start(INTF interface)
 {
     unsigned long long control = (ADD_EDDSA << 32) + EDDSA_RST_OFF;
@@ -150,22 +194,17 @@ void eddsa25519_read(unsigned long long address, unsigned long long size, void *
 // GENERATE PUBLIC KEY
 /////////////////////////////////////////////////////////////////////////////////////////////
 
-void eddsa25519_genkeys_hw(unsigned char **pri_key, unsigned char **pub_key, unsigned int *pri_len, unsigned int *pub_len, INTF interface)
-{
-
-    *pri_len = EDDSA_BYTES;
-    *pub_len = EDDSA_BYTES;
-
-    *pri_key = (unsigned char*) malloc(*pri_len);
-    *pub_key = (unsigned char*) malloc(*pub_len);
+static int eddsa25519_wait(unsigned long long mask, unsigned long long *info, INTF interface);
 
-    gen_priv_key(*pri_key, *pri_len);
+static int eddsa25519_genkeys_run(unsigned char *pri_key, unsigned char *pub_key, INTF interface)
+{
+    gen_priv_key(pri_key, EDDSA_BYTES);
 
     /*
     printf("Private = 0x");
     for (int i = 0; i < EDDSA_BYTES; i++)
     {
-        printf("%02x", *(*pri_key + i));
+        printf("%02x", *(pri_key + i));
     }
     printf("\n");
     */    
@@ -176,637 +215,615 @@ void eddsa25519_genkeys_hw(unsigned char **pri_key, unsigned char **pub_key, uns
     //////////////////////////////////////////////////////////////
 
     unsigned long long info;
+    int ret;
+
+    intf_core_lock(interface, SE_CORE_EDDSA);
 
     //-- INITIALIZATION: General/Interface Reset & Select Operation
     eddsa25519_init(EDDSA_OP_GEN_KEY, interface);
 
     //-- Write private value
-    eddsa25519_write(EDDSA_ADDR_PRIV, EDDSA_BYTES/AXI_BYTES, *pri_key, EDDSA_RST_ON, interface);
+    eddsa25519_write(EDDSA_ADDR_PRIV, EDDSA_BYTES/AXI_BYTES, pri_key, EDDSA_RST_ON, interface);
 
     //-- Start Core
     eddsa25519_start(interface); 
 
     //-- Detect when finish
-    int count = 0;
+    ret = eddsa25519_wait(0x1, &info, interface);
 
-    while (count < EDDSA_WAIT_TIME)
+    if (ret == EDDSA_CORE_ERROR) ret = eddsa25519_abort(SE_ERR_CORE, interface);
+    if (ret != 0)
     {
-        eddsa25519_read(EDDSA_ADDR_CTRL, 1, &info, interface);
-
-        if (info & 0x1)
-        {
-            // printf("\nexp_RSA PASS!\n\n");
-            break;
-        }
-        else if ((info >> 1) & 0x1)
-        {
-            printf("\nERROR!\n\n");
-        }
-        
-        count++;
+        intf_core_unlock(interface, SE_CORE_EDDSA);
+        return ret;
     }
-    if (count == EDDSA_WAIT_TIME) printf("GEN_KEY FAIL!: TIMEOUT \t%d\n", count);
-    
-    count = 0;
     
     //////////////////////////////////////////////////////////////
     // RESULTS
     //////////////////////////////////////////////////////////////
     
-    eddsa25519_read(EDDSA_ADDR_SIGPUB, EDDSA_BYTES/AXI_BYTES, *pub_key, interface); 
+    eddsa25519_read(EDDSA_ADDR_SIGPUB, EDDSA_BYTES/AXI_BYTES, pub_key, interface); 
+
+    intf_core_unlock(interface, SE_CORE_EDDSA);
 
-    swapEndianness(*pub_key, *pub_len);
+    swapEndianness(pub_key, EDDSA_BYTES);
     
     /*
     printf("Public = 0x");
     for (int i = 0; i < EDDSA_BYTES; i++)
     {
-        printf("%02x", *(*pub_key + i));
+        printf("%02x", *(pub_key + i));
     }
     printf("\n");
     */
 
-    swapEndianness(*pri_key, *pri_len);
-}
+    swapEndianness(pri_key, EDDSA_BYTES);
 
-/////////////////////////////////////////////////////////////////////////////////////////////
-// SIGN
-/////////////////////////////////////////////////////////////////////////////////////////////
+    return 0;
+}
 
-void eddsa25519_sign_hw(unsigned char *msg, unsigned int msg_len, unsigned char *pri_key, unsigned int pri_len, unsigned char *pub_key, unsigned int pub_len, unsigned char **sig, unsigned int *sig_len, INTF interface)
+void eddsa25519_genkeys_hw_buf(unsigned char *pri_key, unsigned char *pub_key, INTF interface)
 {
+    int ret = 0;
 
-    if (msg_len > MAX_MSG_LENGTH) 
+    if ((ret = intf_core_admit(interface, SE_CORE_EDDSA, 1)) == SE_OK)
     {
-        printf("\n\n********************************************************************************");
-        printf("\nERROR: message length (%i bytes) exceeds MAX_MSG_LENTGH (%i bytes)\n", msg_len, MAX_MSG_LENGTH);
-        printf("********************************************************************************\n\n");
-        exit(1);
+        for (int t = 0; t <= SE_RETRY; t++)
+        {
+            ret = eddsa25519_genkeys_run(pri_key, pub_key, interface);
+            if (!eddsa25519_retry(ret, interface)) break;
+        }
     }
-    
-    // pri_len, pub_len, and sig_len are not used.
-    pri_len = EDDSA_BYTES;
-    pub_len = EDDSA_BYTES;
-    *sig_len = SHA_BYTES;
 
-    *sig = (unsigned char*) malloc(*sig_len);
+    if (ret != 0)
+    {
+        eddsa25519_fail("GEN_KEY", ret);
+        memset(pri_key, 0, EDDSA_BYTES);
+        memset(pub_key, 0, EDDSA_BYTES);
+    }
+}
+
+void eddsa25519_genkeys_hw(unsigned char **pri_key, unsigned char **pub_key, unsigned int *pri_len, unsigned int *pub_len, INTF interface)
+{
+    *pri_len = EDDSA_BYTES;
+    *pub_len = EDDSA_BYTES;
 
-    unsigned char MSG[MAX_MSG_LENGTH];
-    memset(MSG, 0, MAX_MSG_LENGTH);
-    memcpy(MSG, msg, msg_len);
+    *pri_key = (unsigned char*) malloc(*pri_len);
+    *pub_key = (unsigned char*) malloc(*pub_len);
 
-    unsigned char M[BLOCK_BYTES];
+    eddsa25519_genkeys_hw_buf(*pri_key, *pub_key, interface);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// MESSAGE STREAMING
+/////////////////////////////////////////////////////////////////////////////////////////////
 
-    memcpy(&M[0], &MSG[0], BLOCK_BYTES);
-    swapEndianness(&M[0], BLOCK_BYTES);
+//-- The core hashes the message in 128-byte blocks, twice when signing:
+//--    1st pass: SHA-512(prefix || M)  -> 96 message bytes in the first block
+//--    2nd pass: SHA-512(R || A || M)  -> 64 message bytes in the first block
+//-- Each block is loaded on demand from the caller's buffer (or callback), so
+//-- the message length is only bounded by the 64-bit length register.
+
+typedef struct {
+    const unsigned char *data;
+    eddsa_read_cb read;
+    void *ctx;
+    unsigned long long length;
+} eddsa_msg;
+
+//-- Block at byte offset of the message, zero-filled past the end, in device word order.
+//-- A callback error is SE_ERR_ARG: the core is left as it is.
+static int eddsa25519_block(const eddsa_msg *msg, unsigned long long offset, unsigned char *M)
+{
+    unsigned long long avail = (offset < msg->length) ? msg->length - offset : 0;
 
-    unsigned long long msg_len_bits = 8 * msg_len;
+    if (avail > BLOCK_BYTES) avail = BLOCK_BYTES;
 
-    /*
-    printf("Private = 0x");
-    for (int i = 0; i < EDDSA_BYTES; i++)
+    if (msg->data != NULL)
     {
-        printf("%02x", pri_key[i]);
+        pack_block(M, (avail) ? msg->data + offset : msg->data, avail, BLOCK_BYTES);
     }
-    printf("\n");
-    printf("Public = 0x");
-    for (int i = 0; i < EDDSA_BYTES; i++)
+    else
     {
-        printf("%02x", pub_key[i]);
+        if (avail && msg->read(msg->ctx, offset, M, (unsigned int)avail) != 0) return SE_ERR_ARG;
+        memset(M + avail, 0, BLOCK_BYTES - avail);
     }
-    printf("\n");
-    printf("Message = 0x");
-    for (int i = 0; i < (msg_len_bits >> 3); i++)
+
+    swapEndianness(M, BLOCK_BYTES);
+
+    return 0;
+}
+
+//-- Poll the control register until one of the mask bits is set.
+//-- Returns 0, EDDSA_CORE_ERROR if the core raised its error flag, or SE_ERR_TIMEOUT
+//-- (SE_ERR_DEADLINE past the caller's deadline) after resetting the core.
+//-- Nothing is printed here: the caller reports the failed call once.
+static int eddsa25519_wait(unsigned long long mask, unsigned long long *info, INTF interface)
+{
+    unsigned long long limit = intf_wait_limit(interface, EDDSA_WAIT_TIME);
+
+    do
+    {
+        eddsa25519_read(EDDSA_ADDR_CTRL, 1, info, interface);
+
+        if (*info & mask)           return 0;
+        if ((*info >> 1) & 0x1)     return EDDSA_CORE_ERROR;
+    } while (intf_clock_ns() < limit);
+
+    return eddsa25519_abort(SE_ERR_TIMEOUT, interface);
+}
+
+//-- Hand the block in EDDSA_ADDR_MSG to the core: block_valid alternates between 1 and 2
+static void eddsa25519_block_valid(unsigned long long operation, int *block_odd, INTF interface)
+{
+    unsigned long long block_valid = operation + ((*block_odd) ? 0x1 : 0x2);
+
+    eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid, EDDSA_RST_OFF, interface);
+    *block_odd = !(*block_odd);
+}
+
+static int eddsa25519_next_block(const eddsa_msg *msg, unsigned long long offset, unsigned char *M, unsigned long long operation, int *block_odd, INTF interface)
+{
+    unsigned long long info;
+    int ret;
+
+    //-- Detect Block Ready
+    if ((ret = eddsa25519_wait(0x4, &info, interface)) != 0) return ret;
+    if ((ret = eddsa25519_expired(interface)) != 0) return ret;
+
+    //-- Write next message block
+    if ((ret = eddsa25519_block(msg, offset, M)) != 0) return ret;
+    eddsa25519_write(EDDSA_ADDR_MSG, BLOCK_BYTES / AXI_BYTES, M, EDDSA_RST_OFF, interface);
+
+    eddsa25519_block_valid(operation, block_odd, interface);
+
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// SIGN
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static int eddsa25519_sign_blocks(const eddsa_msg *msg, unsigned char *M, INTF interface)
+{
+    unsigned long long length = 8 * msg->length + 128;
+    unsigned long long blocks_768 = (length < 768) ? 0 : ((length - 768) >> 10) + 1;
+    unsigned long long blocks_512 = (length < 512) ? 0 : ((length - 512) >> 10) + 1;
+    unsigned long long info;
+    int block_odd = 0;
+    int ret;
+
+    if (length >= 512)
     {
-        printf("%02x", msg[i]);
+        //-- 1st pass
+        for (unsigned long long i = 0; i < blocks_768; i++)
+        {
+            if ((ret = eddsa25519_next_block(msg, 96 + i * BLOCK_BYTES, M, EDDSA_OP_SIGN, &block_odd, interface)) != 0) return ret;
+        }
+
+        //-- 2nd pass: restart from the first block (only reloaded if the 1st pass overwrote it)
+        if ((ret = eddsa25519_wait(0x4, &info, interface)) != 0) return ret;
+        if ((ret = eddsa25519_expired(interface)) != 0) return ret;
+
+        if (blocks_768)
+        {
+            if ((ret = eddsa25519_block(msg, 0, M)) != 0) return ret;
+            eddsa25519_write(EDDSA_ADDR_MSG, BLOCK_BYTES / AXI_BYTES, M, EDDSA_RST_OFF, interface);
+        }
+        eddsa25519_block_valid(EDDSA_OP_SIGN, &block_odd, interface);
+
+        for (unsigned long long i = 0; i < blocks_512; i++)
+        {
+            if ((ret = eddsa25519_next_block(msg, 64 + i * BLOCK_BYTES, M, EDDSA_OP_SIGN, &block_odd, interface)) != 0) return ret;
+        }
     }
-    printf("\n");
-    printf("msg_len = 0x%x\n", msg_len);
-    printf("\n");
-    printf("Len_message_bits = 0x%llx\n", msg_len_bits);
-    */
 
-    swapEndianness(pri_key, pri_len);
-    swapEndianness(pub_key, pub_len);
+    return eddsa25519_wait(0x1, &info, interface);
+}
+
+//-- Keys are given in device word order. With reload = 0 they are already
+//-- loaded in the core and only the core itself is reset. Returns 0 or the SE status.
+static int eddsa25519_sign_stream(const eddsa_msg *msg, const unsigned char *pri_dev, const unsigned char *pub_dev, int reload, unsigned char *sig, INTF interface)
+{
+    unsigned char M[BLOCK_BYTES];
+    unsigned long long msg_len_bits = 8 * msg->length;
+    unsigned long long block_valid_end = EDDSA_OP_SIGN + 0x0;
+    int ret;
+
+    if ((ret = eddsa25519_block(msg, 0, M)) != 0)
+    {
+        memset(sig, 0, SHA_BYTES);
+        return ret;
+    }
 
     //////////////////////////////////////////////////////////////
     // WRITING ON DEVICE
     //////////////////////////////////////////////////////////////
 
-    unsigned long long block_valid_end  = EDDSA_OP_SIGN + 0x0;
-    unsigned long long block_valid_1    = EDDSA_OP_SIGN + 0x1;
-    unsigned long long block_valid_2    = EDDSA_OP_SIGN + 0x2;
-    unsigned long long info;
-
     //-- INITIALIZATION: General/Interface Reset & Select Operation
-    eddsa25519_init(EDDSA_OP_SIGN, interface);
+    eddsa25519_reset(EDDSA_OP_SIGN, reload, interface);
 
     // Write private and public value
-    eddsa25519_write(EDDSA_ADDR_PRIV, EDDSA_BYTES / AXI_BYTES, pri_key, EDDSA_RST_ON, interface);
-    eddsa25519_write(EDDSA_ADDR_PUB, EDDSA_BYTES / AXI_BYTES, pub_key, EDDSA_RST_ON, interface);
+    if (reload)
+    {
+        eddsa25519_write(EDDSA_ADDR_PRIV, EDDSA_BYTES / AXI_BYTES, (void*) pri_dev, EDDSA_RST_ON, interface);
+        eddsa25519_write(EDDSA_ADDR_PUB, EDDSA_BYTES / AXI_BYTES, (void*) pub_dev, EDDSA_RST_ON, interface);
+    }
 
     // Write 1st message block and message length
     eddsa25519_write(EDDSA_ADDR_LEN, 1, &msg_len_bits, EDDSA_RST_ON, interface);
-    eddsa25519_write(EDDSA_ADDR_MSG, BLOCK_BYTES / AXI_BYTES, &M, EDDSA_RST_ON, interface);
+    eddsa25519_write(EDDSA_ADDR_MSG, BLOCK_BYTES / AXI_BYTES, M, EDDSA_RST_ON, interface);
 
     // Start Core
     eddsa25519_start(interface);
 
-    // Data Blocks
-    unsigned long long length = msg_len_bits + 128;
+    ret = eddsa25519_sign_blocks(msg, M, interface);
 
-    // printf("Length: %lld bits\n", length);
+    if (ret == EDDSA_CORE_ERROR) ret = eddsa25519_abort(SE_ERR_CORE, interface);
 
-    unsigned long long blocks_768 = (length < 768) ? 1 : ((length - 768) >> 10) + 1;
-    unsigned long long blocks_512 = (length < 512) ? 1 : ((length - 512) >> 10) + 1;
-    
-    int count = 0;
-    int block_odd = 0;
+    //////////////////////////////////////////////////////////////
+    // RESULTS
+    //////////////////////////////////////////////////////////////
 
-    if (length < 512)
+    if (ret == 0)
     {
-        while (count < EDDSA_WAIT_TIME)
-        {
-            eddsa25519_read(EDDSA_ADDR_CTRL, 1, &info, interface);
-
-            if (info & 0x1)
-            {
-                // printf("\nexp_RSA PASS!\n\n");
-                break;
-            }
-            else if ((info >> 1) & 0x1)
-            {
-                printf("\nERROR!\n\n");
-                exit(1);
-            }
-            /*
-            else if ((info >> 2) & 0x1)
-            {
-                printf("\nERROR IN HASH!\n\n");
-                exit(1);
-            }
-            */
-            count++;
-        }
-
-        if (count == EDDSA_WAIT_TIME) printf("SIGN FAIL!: TIMEOUT \t%d\n", count);
-
-        count = 0;
+        eddsa25519_read(EDDSA_ADDR_SIGPUB, SHA_BYTES / AXI_BYTES, sig, interface);
+        swapEndianness(sig, SHA_BYTES);
     }
-    else if (length >= 768)
+    else
     {
-        // printf("\nblocks_768 = %lli\n", blocks_768);
+        memset(sig, 0, SHA_BYTES);
+    }
 
-        for (int i = 0; i < blocks_768; i++)
-        {
-            // Detect Block Ready
-            while (count < EDDSA_WAIT_TIME)
-            {
-                eddsa25519_read(EDDSA_ADDR_CTRL, 1, &info, interface);
-
-                if ((info >> 2) & 0x1)
-                {
-                    break;
-                }
-                else if ((info >> 1) & 0x1)
-                {
-                    printf("\nERROR!\n\n");
-                    exit(1);
-                }
-                count++;
-            }
-
-            if (count == EDDSA_WAIT_TIME) printf("LOAD MESSAGE FAIL!: TIMEOUT \t%d\n", count);
-
-            count = 0;
-
-            // Write next message block
-            memcpy(&M[0], &MSG[96 + i * 128], BLOCK_BYTES);
-            swapEndianness(&M[0], BLOCK_BYTES);
-
-            eddsa25519_write(EDDSA_ADDR_MSG, BLOCK_BYTES / AXI_BYTES, &M, EDDSA_RST_OFF, interface);
-            
-            // Activate Block Valid
-            if (block_odd)
-            {
-                eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid_1, EDDSA_RST_OFF, interface);
-                block_odd = 0;
-            }
-            else 
-            {
-                eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid_2, EDDSA_RST_OFF, interface);
-                block_odd = 1;
-            }
-        }
+    eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid_end, EDDSA_RST_OFF, interface);
 
-        while (count < EDDSA_WAIT_TIME)
-        {
-            eddsa25519_read(EDDSA_ADDR_CTRL, 1, &info, interface);
-
-            if ((info >> 2) & 0x1)
-            {
-                break;
-            }
-            else if ((info >> 1) & 0x1)
-            {
-                printf("\nERROR!\n\n");
-                exit(1);
-            }
-            count++;
-        }
+    return ret;
+}
 
-        if (count == EDDSA_WAIT_TIME) printf("LOAD MESSAGE FAIL!: TIMEOUT \t%d\n", count);
+//-- The caller's keys are left untouched: the device word order is built in local copies
+static int eddsa25519_sign_keys(const eddsa_msg *msg, const unsigned char *pri_key, const unsigned char *pub_key, unsigned char *sig, INTF interface)
+{
+    unsigned char pri_dev[EDDSA_BYTES];
+    unsigned char pub_dev[EDDSA_BYTES];
+    int ret;
 
-        count = 0;
+    if ((ret = intf_core_admit(interface, SE_CORE_EDDSA, 1 + msg->length / BLOCK_BYTES)) != SE_OK)
+    {
+        memset(sig, 0, SHA_BYTES);
+        return eddsa25519_fail("SIGN", ret);
+    }
 
-        memcpy(&M[0], &MSG[0], BLOCK_BYTES);
-        swapEndianness(&M[0], BLOCK_BYTES);
+    memcpy(pri_dev, pri_key, EDDSA_BYTES);
+    memcpy(pub_dev, pub_key, EDDSA_BYTES);
+    swapEndianness(pri_dev, EDDSA_BYTES);
+    swapEndianness(pub_dev, EDDSA_BYTES);
 
-        eddsa25519_write(EDDSA_ADDR_MSG, BLOCK_BYTES / AXI_BYTES, &M, EDDSA_RST_OFF, interface);
+    intf_core_lock(interface, SE_CORE_EDDSA);
+    for (int t = 0; t <= SE_RETRY; t++)
+    {
+        ret = eddsa25519_sign_stream(msg, pri_dev, pub_dev, 1, sig, interface);
+        if (!eddsa25519_retry(ret, interface)) break;
+    }
+    intf_core_unlock(interface, SE_CORE_EDDSA);
 
-        // Activate Block Valid
-        if (block_odd)
-        {
-            eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid_1, EDDSA_RST_OFF, interface);
-            block_odd = 0;
-        }
-        else
-        {
-            eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid_2, EDDSA_RST_OFF, interface);
-            block_odd = 1;
-        }
+    memset(pri_dev, 0, EDDSA_BYTES);
 
-        // printf("\nblocks_512 = %lli\n", blocks_512);
+    return (ret == 0) ? 0 : eddsa25519_fail("SIGN", ret);
+}
 
-        for (int i = 0; i < blocks_512; i++)
-        {
-            // Detect Block Ready
-            while (count < EDDSA_WAIT_TIME)
-            {
-                eddsa25519_read(EDDSA_ADDR_CTRL, 1, &info, interface);
-
-                if ((info >> 2) & 0x1)
-                {
-                    break;
-                }
-                else if ((info >> 1) & 0x1)
-                {
-                    printf("\nERROR!\n\n");
-                    exit(1);
-                }
-                count++;
-            }
-
-            if (count == EDDSA_WAIT_TIME) printf("LOAD MESSAGE FAIL!: TIMEOUT \t%d\n", count);
-
-            count = 0;
-            // Write next message block
-            memcpy(&M[0], &MSG[64 + i * 128], BLOCK_BYTES);
-            swapEndianness(&M[0], BLOCK_BYTES);
-
-            eddsa25519_write(EDDSA_ADDR_MSG, BLOCK_BYTES / AXI_BYTES, &M, EDDSA_RST_OFF, interface);
-            
-            // Activate Block Valid
-            if (block_odd)
-            {
-                eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid_1, EDDSA_RST_OFF, interface);
-                block_odd = 0;
-            }
-            else
-            {
-                eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid_2, EDDSA_RST_OFF, interface);
-                block_odd = 1;
-            }
-        }
+int eddsa25519_sign_hw_buf(const unsigned char *msg, unsigned long long msg_len, const unsigned char *pri_key, const unsigned char *pub_key, unsigned char *sig, INTF interface)
+{
+    eddsa_msg m = { msg, NULL, NULL, msg_len };
 
-        while (count < EDDSA_WAIT_TIME)
-        {
-            eddsa25519_read(EDDSA_ADDR_CTRL, 1, &info, interface);
-
-            if ((info) & 0x1)
-            {
-                break;
-            }
-            else if ((info >> 1) & 0x1)
-            {
-                printf("\nERROR!\n\n");
-                exit(1);
-            }
-            count++;
-        }
+    return eddsa25519_sign_keys(&m, pri_key, pub_key, sig, interface);
+}
 
-        if (count == EDDSA_WAIT_TIME) printf("SIGN FAIL!: TIMEOUT \t%d\n", count);
+int eddsa25519_sign_hw_cb(eddsa_read_cb read, void *ctx, unsigned long long msg_len, const unsigned char *pri_key, const unsigned char *pub_key, unsigned char *sig, INTF interface)
+{
+    eddsa_msg m = { NULL, read, ctx, msg_len };
 
-        count = 0;
-    }
-    else 
-    {
-        while (count < EDDSA_WAIT_TIME)
-        {
-            eddsa25519_read(EDDSA_ADDR_CTRL, 1, &info, interface);
-
-            if ((info >> 2) & 0x1)
-            {
-                break;
-            }
-            else if ((info >> 1) & 0x1)
-            {
-                printf("\nERROR!\n\n");
-                exit(1);
-            }
-            count++;
-        }
+    return eddsa25519_sign_keys(&m, pri_key, pub_key, sig, interface);
+}
 
-        if (count == EDDSA_WAIT_TIME) printf("LOAD MESSAGE FAIL!: TIMEOUT \t%d\n", count);
+void eddsa25519_sign_hw(unsigned char *msg, unsigned int msg_len, unsigned char *pri_key, unsigned int pri_len, unsigned char *pub_key, unsigned int pub_len, unsigned char **sig, unsigned int *sig_len, INTF interface)
+{
+    *sig_len = SHA_BYTES;
 
-        count = 0;
+    *sig = (unsigned char*) malloc(*sig_len);
 
-        if (block_odd)
-        {
-            eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid_1, EDDSA_RST_OFF, interface);
-            block_odd = 0;
-        }
-        else
-        {
-            eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid_2, EDDSA_RST_OFF, interface);
-            block_odd = 1;
-        }
+    eddsa25519_sign_hw_buf(msg, msg_len, pri_key, pub_key, *sig, interface);
+}
 
-        // printf("\nblocks_512 = %lli\n", blocks_512);
+/////////////////////////////////////////////////////////////////////////////////////////////
+// SIGNING-KEY HANDLES
+/////////////////////////////////////////////////////////////////////////////////////////////
 
-        for (int i = 0; i < blocks_512; i++)
-        {
-            // Detect Block Ready
-            while (count < EDDSA_WAIT_TIME)
-            {
-                eddsa25519_read(EDDSA_ADDR_CTRL, 1, &info, interface);
-
-                if ((info >> 2) & 0x1)
-                {
-                    break;
-                }
-                else if ((info >> 1) & 0x1)
-                {
-                    printf("\nERROR!\n\n");
-                    exit(1);
-                }
-                count++;
-            }
-
-            if (count == EDDSA_WAIT_TIME) printf("LOAD MESSAGE FAIL!: TIMEOUT \t%d\n", count);
-
-            count = 0;
-
-            // Write next message block
-            memcpy(&M[0], &MSG[64 + i*128], BLOCK_BYTES);
-            swapEndianness(&M[0], BLOCK_BYTES);
-
-            eddsa25519_write(EDDSA_ADDR_MSG, BLOCK_BYTES / AXI_BYTES, &M, EDDSA_RST_OFF, interface);
-            
-            // Activate Block Valid
-            if (block_odd)
-            {
-                eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid_1, EDDSA_RST_OFF, interface);
-                block_odd = 0;
-            }
-            else
-            {
-                eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid_2, EDDSA_RST_OFF, interface);
-                block_odd = 1;
-            }
-        }
+static unsigned long long eddsa_key_next_id = 0;
 
-        while (count < EDDSA_WAIT_TIME)
-        {
-            eddsa25519_read(EDDSA_ADDR_CTRL, 1, &info, interface);
-
-            if ((info) & 0x1)
-            {
-                break;
-            }
-            else if ((info >> 1) & 0x1)
-            {
-                printf("\nERROR!\n\n");
-                exit(1);
-            }
-            count++;
-        }
+int eddsa_key_init(eddsa_key *key, const unsigned char *pri_key, const unsigned char *pub_key, int flags)
+{
+    memcpy(key->pri_dev, pri_key, EDDSA_BYTES);
+    memcpy(key->pub_dev, pub_key, EDDSA_BYTES);
+    swapEndianness(key->pri_dev, EDDSA_BYTES);
+    swapEndianness(key->pub_dev, EDDSA_BYTES);
 
-        if (count == EDDSA_WAIT_TIME) printf("SIGN FAIL!: TIMEOUT \t%d\n", count);
+    key->flags = flags;
+    key->id = __atomic_add_fetch(&eddsa_key_next_id, 1, __ATOMIC_RELAXED);
 
-        count = 0;
-    }
+    return 0;
+}
 
-    //////////////////////////////////////////////////////////////
-    // RESULTS
-    //////////////////////////////////////////////////////////////
+void eddsa_key_clear(eddsa_key *key)
+{
+    memset(key, 0, sizeof(eddsa_key));
+}
 
-    eddsa25519_read(EDDSA_ADDR_SIGPUB, SHA_BYTES / AXI_BYTES, *sig, interface);
+static int eddsa25519_sign_handle(const eddsa_msg *msg, const eddsa_key *key, unsigned char *sig, INTF interface)
+{
+    unsigned long long token = EDDSA_RESIDENT_TAG | key->id;
+    int resident;
+    int ret;
 
-    swapEndianness(*sig, *sig_len);
+    if ((ret = intf_core_admit(interface, SE_CORE_EDDSA, 1 + msg->length / BLOCK_BYTES)) != SE_OK)
+    {
+        memset(sig, 0, SHA_BYTES);
+        return eddsa25519_fail("SIGN", ret);
+    }
 
-    /*
-    printf("Signature = 0x");
-    for (int i = 0; i < SHA_BYTES; i++)
+    //-- The resident check and the signature that relies on it are one operation
+    intf_core_lock(interface, SE_CORE_EDDSA);
+
+    for (int t = 0; t <= SE_RETRY; t++)
     {
-        printf("%02x", *(*sig + i));
+        resident = (key->flags & EDDSA_KEY_RESIDENT) && intf_resident(interface) == token;
+        ret = eddsa25519_sign_stream(msg, key->pri_dev, key->pub_dev, !resident, sig, interface);
+        if (!eddsa25519_retry(ret, interface)) break;
     }
-    printf("\n");
-    */
 
-    eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid_end, EDDSA_RST_OFF, interface);
+    if (key->flags & EDDSA_KEY_RESIDENT) intf_set_resident(interface, (ret == 0) ? token : 0);
+
+    intf_core_unlock(interface, SE_CORE_EDDSA);
 
-    swapEndianness(pri_key, pri_len);
-    swapEndianness(pub_key, pub_len);
+    return (ret == 0) ? 0 : eddsa25519_fail("SIGN", ret);
+}
+
+int eddsa25519_sign_key_hw(const unsigned char *msg, unsigned long long msg_len, const eddsa_key *key, unsigned char *sig, INTF interface)
+{
+    eddsa_msg m = { msg, NULL, NULL, msg_len };
+
+    return eddsa25519_sign_handle(&m, key, sig, interface);
+}
+
+int eddsa25519_sign_key_hw_cb(eddsa_read_cb read, void *ctx, unsigned long long msg_len, const eddsa_key *key, unsigned char *sig, INTF interface)
+{
+    eddsa_msg m = { NULL, read, ctx, msg_len };
+
+    return eddsa25519_sign_handle(&m, key, sig, interface);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 // VERIFICATION
 /////////////////////////////////////////////////////////////////////////////////////////////
 
-void eddsa25519_verify_hw(unsigned char *msg, unsigned int msg_len, unsigned char *pub_key, unsigned int pub_len, unsigned char *sig, unsigned int sig_len, unsigned int *result, INTF interface)
+static int eddsa25519_verify_blocks(const eddsa_msg *msg, unsigned char *M, unsigned long long *info, INTF interface)
 {
+    unsigned long long length = 8 * msg->length + 128;
+    unsigned long long blocks_512 = (length < 512) ? 0 : ((length - 512) >> 10) + 1;
+    int block_odd = 0;
+    int ret;
+
+    if (length < 512) return eddsa25519_wait(0x1, info, interface);
+
+    if ((ret = eddsa25519_wait(0x4, info, interface)) != 0) return ret;
 
-    if (msg_len > MAX_MSG_LENGTH)
+    for (unsigned long long i = 0; i < blocks_512; i++)
     {
-        printf("\n\n********************************************************************************");
-        printf("\nERROR: message length (%i bytes) exceeds MAX_MSG_LENTGH (%i bytes)\n", msg_len, MAX_MSG_LENGTH);
-        printf("********************************************************************************\n\n");
-        exit(1);
-    }
+        if ((ret = eddsa25519_expired(interface)) != 0) return ret;
 
-    *result = 0;
+        // Write next message block
+        if ((ret = eddsa25519_block(msg, 64 + i * BLOCK_BYTES, M)) != 0) return ret;
+        eddsa25519_write(EDDSA_ADDR_MSG, BLOCK_BYTES / AXI_BYTES, M, EDDSA_RST_OFF, interface);
 
-    pub_len = EDDSA_BYTES;
-    sig_len = SHA_BYTES;
+        eddsa25519_block_valid(EDDSA_OP_VERIFY, &block_odd, interface);
 
-    unsigned char MSG[MAX_MSG_LENGTH];
-    memset(MSG, 0, MAX_MSG_LENGTH);
-    memcpy(MSG, msg, msg_len);
+        // Detect Block Ready (or end of operation after the last one)
+        if ((ret = eddsa25519_wait(0x5, info, interface)) != 0) return ret;
+    }
 
-    unsigned char M[BLOCK_BYTES] = {0};
+    return 0;
+}
 
-    memcpy(&M[0], &MSG[0], BLOCK_BYTES);
-    swapEndianness(&M[0], BLOCK_BYTES);
+//-- *result = 1 for a valid signature. A rejected signature raises the core error
+//-- flag and is not an error of the call: the return value is 0 in both cases.
+static int eddsa25519_verify_stream(const eddsa_msg *msg, const unsigned char *pub_key, const unsigned char *sig, unsigned int *result, INTF interface)
+{
+    unsigned char pub_dev[EDDSA_BYTES];
+    unsigned char sig_dev[SHA_BYTES];
+    unsigned char M[BLOCK_BYTES];
+    unsigned long long msg_len_bits = 8 * msg->length;
+    unsigned long long block_valid_end = EDDSA_OP_VERIFY + 0x0;
+    unsigned long long info = 0;
+    int ret;
 
-    unsigned long long msg_len_bits = 8 * msg_len;
+    *result = 0;
 
-    /*
-    printf("Public = 0x");
-    for (int i = 0; i < EDDSA_BYTES; i++)
-    {
-        printf("%02x", pub_key[i]);
-    }
-    printf("\n");
-    printf("Message = 0x");
-    for (int i = 0; i < (msg_len_bits >> 3); i++)
-    {
-        printf("%02x", MSG[i]);
-    }
-    printf("\n");
-    printf("Len_message_bits = 0x%llx\n", msg_len_bits);
-    */
+    if ((ret = intf_core_admit(interface, SE_CORE_EDDSA, 1 + msg->length / BLOCK_BYTES)) != SE_OK) return eddsa25519_fail("VERIFICATION", ret);
+    if ((ret = eddsa25519_block(msg, 0, M)) != 0) return eddsa25519_fail("VERIFICATION", ret);
 
-    swapEndianness(pub_key, pub_len);
-    swapEndianness(sig, sig_len);
+    memcpy(pub_dev, pub_key, EDDSA_BYTES);
+    memcpy(sig_dev, sig, SHA_BYTES);
+    swapEndianness(pub_dev, EDDSA_BYTES);
+    swapEndianness(sig_dev, SHA_BYTES);
 
     //////////////////////////////////////////////////////////////
     // WRITING ON DEVICE
     //////////////////////////////////////////////////////////////
 
-    unsigned long long block_valid_end  = EDDSA_OP_VERIFY + 0x0;
-    unsigned long long block_valid_1    = EDDSA_OP_VERIFY + 0x1;
-    unsigned long long block_valid_2    = EDDSA_OP_VERIFY + 0x2;
-    unsigned long long info;
+    intf_core_lock(interface, SE_CORE_EDDSA);
 
-    //-- INITIALIZATION: General/Interface Reset & Select Operation
-    eddsa25519_init(EDDSA_OP_VERIFY, interface);
+    for (int t = 0; t <= SE_RETRY; t++)
+    {
+        //-- INITIALIZATION: General/Interface Reset & Select Operation
+        eddsa25519_init(EDDSA_OP_VERIFY, interface);
 
-    // Write public value
-    eddsa25519_write(EDDSA_ADDR_PUB, EDDSA_BYTES / AXI_BYTES, pub_key, EDDSA_RST_ON, interface);
+        // Write public value
+        eddsa25519_write(EDDSA_ADDR_PUB, EDDSA_BYTES / AXI_BYTES, pub_dev, EDDSA_RST_ON, interface);
 
-    // Write signature to verify
-    eddsa25519_write(EDDSA_ADDR_SIGVER, SHA_BYTES / AXI_BYTES, sig, EDDSA_RST_ON, interface);
+        // Write signature to verify
+        eddsa25519_write(EDDSA_ADDR_SIGVER, SHA_BYTES / AXI_BYTES, sig_dev, EDDSA_RST_ON, interface);
 
-    // Write 1st message block and message length
-    eddsa25519_write(EDDSA_ADDR_LEN, 1, &msg_len_bits, EDDSA_RST_ON, interface);
-    eddsa25519_write(EDDSA_ADDR_MSG, BLOCK_BYTES / AXI_BYTES, &M, EDDSA_RST_ON, interface);
+        // Write 1st message block and message length
+        if (t && (ret = eddsa25519_block(msg, 0, M)) != 0) break;
+        eddsa25519_write(EDDSA_ADDR_LEN, 1, &msg_len_bits, EDDSA_RST_ON, interface);
+        eddsa25519_write(EDDSA_ADDR_MSG, BLOCK_BYTES / AXI_BYTES, M, EDDSA_RST_ON, interface);
 
-    // Start Core
-    eddsa25519_start(interface);
+        // Start Core
+        eddsa25519_start(interface);
 
-    unsigned long long length = msg_len_bits + 128;
+        ret = eddsa25519_verify_blocks(msg, M, &info, interface);
 
-    unsigned long long blocks_512 = (length < 512) ? 1 : ((length - 512) >> 10) + 1;
+        //-- A rejected signature is a result, not a fault
+        if (!eddsa25519_retry((ret == EDDSA_CORE_ERROR) ? 0 : ret, interface)) break;
+    }
 
-    int count = 0;
-    int block_odd = 0;
+    eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid_end, EDDSA_RST_OFF, interface);
 
-    if (length < 512)
-    {
-        while (count < EDDSA_WAIT_TIME)
-        {
-            eddsa25519_read(EDDSA_ADDR_CTRL, 1, &info, interface);
-
-            if (info & 0x1)
-            {
-                // printf("\nexp_RSA PASS!\n\n");
-                break;
-            }
-            else if ((info >> 1) & 0x1)
-            {
-                printf("\nERROR!\n\n");
-                return;
-            }
-
-            count++;
-        }
-        if (count == EDDSA_WAIT_TIME) printf("VERIFICATION FAIL!: TIMEOUT \t%d\n", count);
+    intf_core_unlock(interface, SE_CORE_EDDSA);
 
-        count = 0;
-    }
-    else
-    {
-        while (count < EDDSA_WAIT_TIME)
-        {
-            eddsa25519_read(EDDSA_ADDR_CTRL, 1, &info, interface);
-
-            if ((info >> 2) & 0x1)
-            {
-                break;
-            }
-            else if ((info >> 1) & 0x1)
-            {
-                printf("\nERROR!\n\n");
-                return;
-            }
-            count++;
-        }
+    if (ret == 0 && (info & 0x1)) *result = 1;
+
+    return (ret == 0 || ret == EDDSA_CORE_ERROR) ? 0 : eddsa25519_fail("VERIFICATION", ret);
+}
+
+int eddsa25519_verify_hw_buf(const unsigned char *msg, unsigned long long msg_len, const unsigned char *pub_key, const unsigned char *sig, unsigned int *result, INTF interface)
+{
+    eddsa_msg m = { msg, NULL, NULL, msg_len };
+
+    return eddsa25519_verify_stream(&m, pub_key, sig, result, interface);
+}
+
+int eddsa25519_verify_hw_cb(eddsa_read_cb read, void *ctx, unsigned long long msg_len, const unsigned char *pub_key, const unsigned char *sig, unsigned int *result, INTF interface)
+{
+    eddsa_msg m = { NULL, read, ctx, msg_len };
+
+    return eddsa25519_verify_stream(&m, pub_key, sig, result, interface);
+}
+
+void eddsa25519_verify_hw(unsigned char *msg, unsigned int msg_len, unsigned char *pub_key, unsigned int pub_len, unsigned char *sig, unsigned int sig_len, unsigned int *result, INTF interface)
+{
+    eddsa25519_verify_hw_buf(msg, msg_len, pub_key, sig, result, interface);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// BATCH VERIFICATION
+/////////////////////////////////////////////////////////////////////////////////////////////
 
-        if (count == EDDSA_WAIT_TIME) printf("LOAD MESSAGE FAIL!: TIMEOUT \t%d\n", count);
+typedef struct {
+    const eddsa_batch_item *items;
+    unsigned int *results;
+    unsigned int n;
+    unsigned int *next;
+    int hw;
+    INTF interface;
+} eddsa_batch_job;
+
+//-- Device workers take one signature at a time and stream it through their
+//-- core; host workers take EDDSA_BATCH_CHUNK_SW signatures and check them with
+//-- one randomized batch equation. The core checks the cofactorless equation,
+//-- which implies the cofactored one, so only a signature the device rejects or
+//-- fails to answer is handed to the host check: every result follows the
+//-- cofactored rule of eddsa25519_verify_batch_sw.
+static void* eddsa25519_batch_worker(void *arg)
+{
+    eddsa_batch_job *job = (eddsa_batch_job*) arg;
+    unsigned int chunk = (job->hw) ? 1 : EDDSA_BATCH_CHUNK_SW;
+    unsigned int first, count;
+    const eddsa_batch_item *it;
 
-        count = 0;
+    while (1)
+    {
+        first = __atomic_fetch_add(job->next, chunk, __ATOMIC_RELAXED);
+        if (first >= job->n) break;
+        count = (first + chunk < job->n) ? chunk : job->n - first;
 
-        for (int i = 0; i < blocks_512; i++)
+        if (!job->hw)
         {
-            // Write next message block
-            memcpy(&M[0], &MSG[64 + i * 128], BLOCK_BYTES);
-            swapEndianness(&M[0], BLOCK_BYTES);
-
-            eddsa25519_write(EDDSA_ADDR_MSG, BLOCK_BYTES / AXI_BYTES, &M, EDDSA_RST_OFF, interface);
-
-            // Activate Block Valid
-            if (block_odd)
-            {
-                eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid_1, EDDSA_RST_OFF, interface);
-                block_odd = 0;
-            }
-            else
-            {
-                eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid_2, EDDSA_RST_OFF, interface);
-                block_odd = 1;
-            }
-
-            // Detect Block Ready
-            while (count < EDDSA_WAIT_TIME)
-            {
-                eddsa25519_read(EDDSA_ADDR_CTRL, 1, &info, interface);
-
-                if ((info) & 0x1)
-                {
-                    break;
-                }
-                else if ((info >> 2) & 0x1)
-                {
-                    break;
-                }
-                else if ((info >> 1) & 0x1)
-                {
-                    printf("\nERROR!\n\n");
-                    exit(1);
-                }
-                count++;
-            }
-
-            if (count == EDDSA_WAIT_TIME) printf("LOAD MESSAGE FAIL!: TIMEOUT \t%d\n", count);
-
-            count = 0;
-           
+            eddsa25519_verify_batch_sw(job->items + first, count, job->results + first);
+            continue;
         }
+
+        it = &job->items[first];
+        if (eddsa25519_verify_hw_buf(it->msg, it->msg_len, it->pub_key, it->sig, &job->results[first], job->interface) != 0 || job->results[first] != 1)
+            eddsa25519_verify_batch_sw(it, 1, &job->results[first]);
     }
 
-    eddsa25519_write(EDDSA_ADDR_CTRL, 1, &block_valid_end, EDDSA_RST_OFF, interface);
+    return NULL;
+}
+
+int eddsa25519_verify_batch(const eddsa_batch_item *items, unsigned int n, unsigned int *results, INTF *interface, unsigned int n_interface, unsigned int n_host)
+{
+    unsigned int next = 0;
+
+    if (n_interface == 0 && n_host == 0) n_host = 1;
 
-    swapEndianness(pub_key, pub_len);
-    swapEndianness(sig, sig_len);
+    unsigned int n_job = n_interface + n_host;
+    eddsa_batch_job *job = malloc(n_job * sizeof(eddsa_batch_job));
+    pthread_t *thread = malloc(n_job * sizeof(pthread_t));
+    int *started = calloc(n_job, sizeof(int));
 
-    if (info & 0x1) 
+    if (job == NULL || thread == NULL || started == NULL)
     {
-        *result = 1;
-        return;
+        free(job);
+        free(thread);
+        free(started);
+        return -1;
     }
-    else 
+
+    for (unsigned int j = 0; j < n_job; j++)
     {
-        return;
+        job[j].items     = items;
+        job[j].results   = results;
+        job[j].n         = n;
+        job[j].next      = &next;
+        job[j].hw        = (j < n_interface);
+        if (j < n_interface) job[j].interface = interface[j];
     }
+
+    //-- job 0 runs on the calling thread, as does any job whose thread cannot be created
+    for (unsigned int j = 1; j < n_job; j++) started[j] = (pthread_create(&thread[j], NULL, eddsa25519_batch_worker, &job[j]) == 0);
+    for (unsigned int j = 0; j < n_job; j++) if (!started[j]) eddsa25519_batch_worker(&job[j]);
+    for (unsigned int j = 1; j < n_job; j++) if (started[j]) pthread_join(thread[j], NULL);
+
+    free(job);
+    free(thread);
+    free(started);
+
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Ed25519ph (RFC 8032)
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- The EdDSA core hashes prefix || M and R || A || M with no slot for the dom2
+//-- prefix, so it only computes pure Ed25519. The message is prehashed once on
+//-- the SHA-512 core and the dom2-prefixed signature over the 64-byte digest is
+//-- computed on the host: the message-length dependent work stays in hardware.
+
+int eddsa25519ph_sign_hw(const unsigned char *msg, unsigned long long msg_len, const unsigned char *ctx, unsigned int ctx_len, const unsigned char *pri_key, const unsigned char *pub_key, unsigned char *sig, INTF interface)
+{
+    unsigned char ph[SHA_BYTES];
+
+    if (sha2_hw(interface, (unsigned char*) msg, ph, 8 * msg_len, 3, 0) != SE_OK) return -1;
+
+    return eddsa25519_sign_sw(ph, SHA_BYTES, ctx, ctx_len, EDDSA_VARIANT_PH, pri_key, pub_key, sig);
+}
+
+int eddsa25519ph_verify_hw(const unsigned char *msg, unsigned long long msg_len, const unsigned char *ctx, unsigned int ctx_len, const unsigned char *pub_key, const unsigned char *sig, unsigned int *result, INTF interface)
+{
+    unsigned char ph[SHA_BYTES];
+
+    if (sha2_hw(interface, (unsigned char*) msg, ph, 8 * msg_len, 3, 0) != SE_OK) return -1;
+
+    return eddsa25519_verify_sw(ph, SHA_BYTES, ctx, ctx_len, EDDSA_VARIANT_PH, pub_key, sig, result);
 }
@@ -81,9 +81,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 #include "../common/intf.h"
 #include "../common/conf.h"
 #include "../common/extra_func.h"
+#include "../sha2/sha2_hw.h"
+#include "eddsa_sw.h"
 
 //-- Elements Bit Sizes
 #define BLOCK_BYTES         128
@@ -91,9 +94,6 @@
 #define EDDSA_BYTES         32
 #define AXI_BYTES           8
 
-//-- Max. Message Length
-#define MAX_MSG_LENGTH      2048
-
 //-- Control Operations
 #define EDDSA_RST_OFF       0x00
 #define EDDSA_RST_ON        0x01
@@ -116,11 +116,14 @@
 #define EDDSA_OP_SIGN       0x8
 #define EDDSA_OP_VERIFY     0xC
 
-//-- Debug
+//-- Return code of the internal wait when the core raises its error flag
+#define EDDSA_CORE_ERROR    -2
+
+//-- Watchdog: longest wait for the core's flags (us)
 #ifdef I2C
-    #define EDDSA_WAIT_TIME     50
+    #define EDDSA_WAIT_TIME     1000000
 #else
-    #define EDDSA_WAIT_TIME     5000
+    #define EDDSA_WAIT_TIME     100000
 #endif
 #define EDDSA_N_ITER        1000
 
@@ -132,11 +135,57 @@ void eddsa25519_read(unsigned long long address, unsigned long long size, void *
 
 //-- GENERATE PUBLIC KEY
 void eddsa25519_genkeys_hw(unsigned char **pri_key, unsigned char **pub_key, unsigned int *pri_len, unsigned int *pub_len, INTF interface);
+void eddsa25519_genkeys_hw_buf(unsigned char *pri_key, unsigned char *pub_key, INTF interface);
+
+//-- Message callback for non-contiguous data: copy len bytes of the message
+//-- starting at offset into buf and return 0 (non-zero aborts the operation).
+//-- Signing reads the message twice, so offsets restart from 0 once.
+typedef int (*eddsa_read_cb)(void *ctx, unsigned long long offset, unsigned char *buf, unsigned int len);
 
 //-- SIGN
 void eddsa25519_sign_hw(unsigned char *msg, unsigned int msg_len, unsigned char *pri_key, unsigned int pri_len, unsigned char *pub_key, unsigned int pub_len, unsigned char **sig, unsigned int *sig_len, INTF interface);
+int eddsa25519_sign_hw_buf(const unsigned char *msg, unsigned long long msg_len, const unsigned char *pri_key, const unsigned char *pub_key, unsigned char *sig, INTF interface);
+int eddsa25519_sign_hw_cb(eddsa_read_cb read, void *ctx, unsigned long long msg_len, const unsigned char *pri_key, const unsigned char *pub_key, unsigned char *sig, INTF interface);
+
+//-- SIGNING-KEY HANDLES
+//-- Keys are stored once in device word order and signed from const inputs,
+//-- so one handle can be shared by several threads (one SE access at a time).
+//-- With EDDSA_KEY_RESIDENT the keys are left loaded in the core and the next
+//-- signature on the same device skips loading them, unless another core or
+//-- key was used in between. Tracking is per process: only set this flag when
+//-- no other process uses the SE.
+#define EDDSA_KEY_RESIDENT  0x1
+#define EDDSA_RESIDENT_TAG  (ADD_EDDSA << 56)
+
+typedef struct {
+    unsigned char pri_dev[EDDSA_BYTES];
+    unsigned char pub_dev[EDDSA_BYTES];
+    unsigned long long id;
+    int flags;
+} eddsa_key;
+
+int eddsa_key_init(eddsa_key *key, const unsigned char *pri_key, const unsigned char *pub_key, int flags);
+void eddsa_key_clear(eddsa_key *key);
+int eddsa25519_sign_key_hw(const unsigned char *msg, unsigned long long msg_len, const eddsa_key *key, unsigned char *sig, INTF interface);
+int eddsa25519_sign_key_hw_cb(eddsa_read_cb read, void *ctx, unsigned long long msg_len, const eddsa_key *key, unsigned char *sig, INTF interface);
 
 //-- VERIFY
 void eddsa25519_verify_hw(unsigned char *msg, unsigned int msg_len, unsigned char *pub_key, unsigned int pub_len, unsigned char *sig, unsigned int sig_len, unsigned int *result, INTF interface);
+int eddsa25519_verify_hw_buf(const unsigned char *msg, unsigned long long msg_len, const unsigned char *pub_key, const unsigned char *sig, unsigned int *result, INTF interface);
+int eddsa25519_verify_hw_cb(eddsa_read_cb read, void *ctx, unsigned long long msg_len, const unsigned char *pub_key, const unsigned char *sig, unsigned int *result, INTF interface);
+
+//-- BATCH VERIFY
+//-- Signatures are spread over n_interface SE devices (one at a time per device,
+//-- back to back) and n_host host threads (randomized batch verification in
+//-- chunks of EDDSA_BATCH_CHUNK_SW). results[i] = 1 for a valid signature under
+//-- the cofactored rule of eddsa25519_verify_batch_sw. Return -1 if out of memory.
+#define EDDSA_BATCH_CHUNK_SW    32
+int eddsa25519_verify_batch(const eddsa_batch_item *items, unsigned int n, unsigned int *results, INTF *interface, unsigned int n_interface, unsigned int n_host);
+
+//-- Ed25519ph: SHA-512 prehash on the SHA-2 core, dom2-prefixed signature on the host.
+//-- ctx may be empty (ctx_len = 0) or up to EDDSA_MAX_CTX bytes. Ed25519ctx has no
+//-- prehash and runs on the host only: eddsa25519_sign_sw(..., EDDSA_VARIANT_CTX, ...).
+int eddsa25519ph_sign_hw(const unsigned char *msg, unsigned long long msg_len, const unsigned char *ctx, unsigned int ctx_len, const unsigned char *pri_key, const unsigned char *pub_key, unsigned char *sig, INTF interface);
+int eddsa25519ph_verify_hw(const unsigned char *msg, unsigned long long msg_len, const unsigned char *ctx, unsigned int ctx_len, const unsigned char *pub_key, const unsigned char *sig, unsigned int *result, INTF interface);
 
 #endif
\ No newline at end of file
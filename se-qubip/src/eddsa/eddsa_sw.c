@@ -0,0 +1,716 @@
+/**
+  * @file eddsa_sw.c
+  * @brief Host Software Ed25519 (RFC 8032 Ed25519 / Ed25519ctx / Ed25519ph)
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#include "eddsa_sw.h"
+#include "../trng/trng_pool.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+//-- Field elements mod 2^255-19 as 16 signed 16-bit limbs held in 64-bit words,
+//-- so the same code runs on the 32-bit (PYNQ-Z2) and 64-bit (ZCU104) hosts.
+//-- Every branch and table access is independent of secret data.
+typedef int64_t fe25519[16];
+
+static const fe25519 fe_0 = { 0 };
+static const fe25519 fe_1 = { 1 };
+static const fe25519 fe_d = {
+	0x78a3, 0x1359, 0x4dca, 0x75eb, 0xd8ab, 0x4141, 0x0a4d, 0x0070,
+	0xe898, 0x7779, 0x4079, 0x8cc7, 0xfe73, 0x2b6f, 0x6cee, 0x5203 };
+static const fe25519 fe_d2 = {
+	0xf159, 0x26b2, 0x9b94, 0xebd6, 0xb156, 0x8283, 0x149a, 0x00e0,
+	0xd130, 0xeef3, 0x80f2, 0x198e, 0xfce7, 0x56df, 0xd9dc, 0x2406 };
+static const fe25519 fe_bx = {
+	0xd51a, 0x8f25, 0x2d60, 0xc956, 0xa7b2, 0x9525, 0xc760, 0x692c,
+	0xdc5c, 0xfdd6, 0xe231, 0xc0a4, 0x53fe, 0xcd6e, 0x36d3, 0x2169 };
+static const fe25519 fe_by = {
+	0x6658, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666,
+	0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666 };
+static const fe25519 fe_sqrtm1 = {
+	0xa0b0, 0x4a0e, 0x1b27, 0xc4ee, 0xe478, 0xad2f, 0x1806, 0x2f43,
+	0xd7a7, 0x3dfb, 0x0099, 0x2b4d, 0xdf0b, 0x4fc1, 0x2480, 0x2b83 };
+
+//-- Group order L = 2^252 + 27742317777372353535851937790883648493 (little endian)
+static const int64_t sc_l[32] = {
+	0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10 };
+
+static const unsigned char dom2_tag[32] = "SigEd25519 no Ed25519 collisions";
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// FIELD ARITHMETIC
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static void fe_copy(fe25519 o, const fe25519 a)
+{
+	for (int i = 0; i < 16; i++) o[i] = a[i];
+}
+
+static void fe_carry(fe25519 o)
+{
+	int64_t c;
+
+	for (int i = 0; i < 16; i++) {
+		o[i] += (1LL << 16);
+		c = o[i] >> 16;
+		o[(i + 1) * (i < 15)] += c - 1 + 37 * (c - 1) * (i == 15);
+		o[i] -= c * 65536;
+	}
+}
+
+//-- Swap p and q when b = 1, without branching on b
+static void fe_cswap(fe25519 p, fe25519 q, int b)
+{
+	int64_t t, c = ~(b - 1);
+
+	for (int i = 0; i < 16; i++) {
+		t = c & (p[i] ^ q[i]);
+		p[i] ^= t;
+		q[i] ^= t;
+	}
+}
+
+static void fe_pack(unsigned char* o, const fe25519 n)
+{
+	fe25519 m, t;
+	int b;
+
+	fe_copy(t, n);
+	fe_carry(t);
+	fe_carry(t);
+	fe_carry(t);
+
+	for (int j = 0; j < 2; j++) {
+		m[0] = t[0] - 0xffed;
+		for (int i = 1; i < 15; i++) {
+			m[i] = t[i] - 0xffff - ((m[i - 1] >> 16) & 1);
+			m[i - 1] &= 0xffff;
+		}
+		m[15] = t[15] - 0x7fff - ((m[14] >> 16) & 1);
+		b = (m[15] >> 16) & 1;
+		m[14] &= 0xffff;
+		fe_cswap(t, m, 1 - b);
+	}
+
+	for (int i = 0; i < 16; i++) {
+		o[2 * i] = t[i] & 0xff;
+		o[2 * i + 1] = (t[i] >> 8) & 0xff;
+	}
+}
+
+static void fe_unpack(fe25519 o, const unsigned char* n)
+{
+	for (int i = 0; i < 16; i++) o[i] = n[2 * i] + ((int64_t)n[2 * i + 1] << 8);
+	o[15] &= 0x7fff;
+}
+
+static int fe_neq(const fe25519 a, const fe25519 b)
+{
+	unsigned char c[32], d[32];
+	unsigned int r = 0;
+
+	fe_pack(c, a);
+	fe_pack(d, b);
+	for (int i = 0; i < 32; i++) r |= c[i] ^ d[i];
+
+	return r != 0;
+}
+
+static int fe_parity(const fe25519 a)
+{
+	unsigned char d[32];
+
+	fe_pack(d, a);
+
+	return d[0] & 1;
+}
+
+static void fe_add(fe25519 o, const fe25519 a, const fe25519 b)
+{
+	for (int i = 0; i < 16; i++) o[i] = a[i] + b[i];
+}
+
+static void fe_sub(fe25519 o, const fe25519 a, const fe25519 b)
+{
+	for (int i = 0; i < 16; i++) o[i] = a[i] - b[i];
+}
+
+static void fe_mul(fe25519 o, const fe25519 a, const fe25519 b)
+{
+	int64_t t[31];
+
+	for (int i = 0; i < 31; i++) t[i] = 0;
+	for (int i = 0; i < 16; i++)
+		for (int j = 0; j < 16; j++)
+			t[i + j] += a[i] * b[j];
+	// -- 2^256 = 38 mod p
+	for (int i = 0; i < 15; i++) t[i] += 38 * t[i + 16];
+	for (int i = 0; i < 16; i++) o[i] = t[i];
+
+	fe_carry(o);
+	fe_carry(o);
+}
+
+static void fe_sq(fe25519 o, const fe25519 a)
+{
+	fe_mul(o, a, a);
+}
+
+//-- a^(p-2)
+static void fe_inv(fe25519 o, const fe25519 a)
+{
+	fe25519 c;
+
+	fe_copy(c, a);
+	for (int i = 253; i >= 0; i--) {
+		fe_sq(c, c);
+		if (i != 2 && i != 4) fe_mul(c, c, a);
+	}
+	fe_copy(o, c);
+}
+
+//-- a^((p-5)/8)
+static void fe_pow2523(fe25519 o, const fe25519 a)
+{
+	fe25519 c;
+
+	fe_copy(c, a);
+	for (int i = 250; i >= 0; i--) {
+		fe_sq(c, c);
+		if (i != 1) fe_mul(c, c, a);
+	}
+	fe_copy(o, c);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// GROUP ARITHMETIC (extended twisted Edwards coordinates X, Y, Z, T)
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static void ge_add(fe25519 p[4], fe25519 q[4])
+{
+	fe25519 a, b, c, d, t, e, f, g, h;
+
+	fe_sub(a, p[1], p[0]);
+	fe_sub(t, q[1], q[0]);
+	fe_mul(a, a, t);
+	fe_add(b, p[0], p[1]);
+	fe_add(t, q[0], q[1]);
+	fe_mul(b, b, t);
+	fe_mul(c, p[3], q[3]);
+	fe_mul(c, c, fe_d2);
+	fe_mul(d, p[2], q[2]);
+	fe_add(d, d, d);
+	fe_sub(e, b, a);
+	fe_sub(f, d, c);
+	fe_add(g, d, c);
+	fe_add(h, b, a);
+
+	fe_mul(p[0], e, f);
+	fe_mul(p[1], h, g);
+	fe_mul(p[2], g, f);
+	fe_mul(p[3], e, h);
+}
+
+static void ge_cswap(fe25519 p[4], fe25519 q[4], int b)
+{
+	for (int i = 0; i < 4; i++) fe_cswap(p[i], q[i], b);
+}
+
+static void ge_pack(unsigned char* r, fe25519 p[4])
+{
+	fe25519 tx, ty, zi;
+
+	fe_inv(zi, p[2]);
+	fe_mul(tx, p[0], zi);
+	fe_mul(ty, p[1], zi);
+	fe_pack(r, ty);
+	r[31] ^= fe_parity(tx) << 7;
+}
+
+//-- p = s * q (Montgomery ladder, q is clobbered)
+static void ge_scalarmult(fe25519 p[4], fe25519 q[4], const unsigned char* s)
+{
+	int b;
+
+	fe_copy(p[0], fe_0);
+	fe_copy(p[1], fe_1);
+	fe_copy(p[2], fe_1);
+	fe_copy(p[3], fe_0);
+
+	for (int i = 255; i >= 0; i--) {
+		b = (s[i / 8] >> (i & 7)) & 1;
+		ge_cswap(p, q, b);
+		ge_add(q, p);
+		ge_add(p, p);
+		ge_cswap(p, q, b);
+	}
+}
+
+static void ge_scalarmult_base(fe25519 p[4], const unsigned char* s)
+{
+	fe25519 q[4];
+
+	fe_copy(q[0], fe_bx);
+	fe_copy(q[1], fe_by);
+	fe_copy(q[2], fe_1);
+	fe_mul(q[3], fe_bx, fe_by);
+
+	ge_scalarmult(p, q, s);
+}
+
+//-- Decode a public key as its negation -A. Return -1 for a non-canonical
+//-- encoding or a point that is not on the curve.
+static int ge_unpack_neg(fe25519 r[4], const unsigned char* p)
+{
+	fe25519 t, chk, num, den, den2, den4, den6;
+	unsigned char y[32];
+	unsigned int diff = 0;
+
+	fe_copy(r[2], fe_1);
+	fe_unpack(r[1], p);
+
+	// -- reject y >= p
+	fe_pack(y, r[1]);
+	for (int i = 0; i < 31; i++) diff |= y[i] ^ p[i];
+	diff |= y[31] ^ (p[31] & 0x7f);
+	if (diff) return -1;
+
+	fe_sq(num, r[1]);
+	fe_mul(den, num, fe_d);
+	fe_sub(num, num, r[2]);
+	fe_add(den, r[2], den);
+
+	fe_sq(den2, den);
+	fe_sq(den4, den2);
+	fe_mul(den6, den4, den2);
+	fe_mul(t, den6, num);
+	fe_mul(t, t, den);
+
+	fe_pow2523(t, t);
+	fe_mul(t, t, num);
+	fe_mul(t, t, den);
+	fe_mul(t, t, den);
+	fe_mul(r[0], t, den);
+
+	fe_sq(chk, r[0]);
+	fe_mul(chk, chk, den);
+	if (fe_neq(chk, num)) fe_mul(r[0], r[0], fe_sqrtm1);
+
+	fe_sq(chk, r[0]);
+	fe_mul(chk, chk, den);
+	if (fe_neq(chk, num)) return -1;
+
+	if (fe_parity(r[0]) == (p[31] >> 7)) fe_sub(r[0], fe_0, r[0]);
+
+	fe_mul(r[3], r[0], r[1]);
+
+	return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// SCALAR ARITHMETIC (mod L)
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static void sc_mod_l(unsigned char* r, int64_t x[64])
+{
+	int64_t carry;
+	int i, j;
+
+	for (i = 63; i >= 32; i--) {
+		carry = 0;
+		for (j = i - 32; j < i - 12; j++) {
+			x[j] += carry - 16 * x[i] * sc_l[j - (i - 32)];
+			carry = (x[j] + 128) >> 8;
+			x[j] -= carry * 256;
+		}
+		x[j] += carry;
+		x[i] = 0;
+	}
+
+	carry = 0;
+	for (j = 0; j < 32; j++) {
+		x[j] += carry - (x[31] >> 4) * sc_l[j];
+		carry = x[j] >> 8;
+		x[j] &= 255;
+	}
+	for (j = 0; j < 32; j++) x[j] -= carry * sc_l[j];
+	for (i = 0; i < 32; i++) {
+		x[i + 1] += x[i] >> 8;
+		r[i] = x[i] & 255;
+	}
+}
+
+//-- Reduce a 64-byte SHA-512 output mod L in place (result in r[0..31])
+static void sc_reduce(unsigned char* r)
+{
+	int64_t x[64];
+
+	for (int i = 0; i < 64; i++) x[i] = r[i];
+	for (int i = 0; i < 64; i++) r[i] = 0;
+
+	sc_mod_l(r, x);
+}
+
+//-- r = a * b + c mod L
+static void sc_muladd(unsigned char* r, const unsigned char* a, const unsigned char* b, const unsigned char* c)
+{
+	int64_t x[64];
+
+	for (int i = 0; i < 64; i++) x[i] = 0;
+	for (int i = 0; i < 32; i++) x[i] = c[i];
+	for (int i = 0; i < 32; i++)
+		for (int j = 0; j < 32; j++)
+			x[i + j] += a[i] * (int64_t)b[j];
+
+	sc_mod_l(r, x);
+	memset(x, 0, sizeof(x));
+}
+
+//-- S < L (RFC 8032 5.1.7, rejects malleable signatures)
+static int sc_is_canonical(const unsigned char* s)
+{
+	int c = 0, n = 1;
+
+	for (int i = 31; i >= 0; i--) {
+		c |= ((s[i] - sc_l[i]) >> 8) & n;
+		n &= ((s[i] ^ sc_l[i]) - 1) >> 8;
+	}
+
+	return c != 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// SIGN / VERIFY
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static int eddsa25519_dom2(sha512_sw_ctx* h, const unsigned char* ctx, unsigned int ctx_len, int variant)
+{
+	unsigned char flags[2];
+
+	if (variant == EDDSA_VARIANT_PURE) return 0;
+
+	flags[0] = (variant == EDDSA_VARIANT_PH);
+	flags[1] = (unsigned char)ctx_len;
+
+	sha512_sw_update(h, dom2_tag, sizeof(dom2_tag));
+	sha512_sw_update(h, flags, 2);
+	sha512_sw_update(h, ctx, ctx_len);
+
+	return 0;
+}
+
+static int eddsa25519_check_ctx(unsigned int ctx_len, int variant, unsigned long long msg_len)
+{
+	if (ctx_len > EDDSA_MAX_CTX) return -1;
+
+	switch (variant) {
+	case EDDSA_VARIANT_PURE:	return (ctx_len == 0) ? 0 : -1;
+	case EDDSA_VARIANT_CTX:		return (ctx_len != 0) ? 0 : -1;
+	case EDDSA_VARIANT_PH:		return (msg_len == 64) ? 0 : -1;
+	default:					return -1;
+	}
+}
+
+static void eddsa25519_expand(const unsigned char* pri_key, unsigned char* d)
+{
+	sha_512_sw(pri_key, 32, d);
+	d[0] &= 248;
+	d[31] &= 127;
+	d[31] |= 64;
+}
+
+void eddsa25519_pubkey_sw(const unsigned char* pri_key, unsigned char* pub_key)
+{
+	unsigned char d[64];
+	fe25519 p[4];
+
+	eddsa25519_expand(pri_key, d);
+	ge_scalarmult_base(p, d);
+	ge_pack(pub_key, p);
+
+	memset(d, 0, sizeof(d));
+}
+
+int eddsa25519_sign_sw(const unsigned char* msg, unsigned long long msg_len, const unsigned char* ctx, unsigned int ctx_len, int variant,
+	const unsigned char* pri_key, const unsigned char* pub_key, unsigned char* sig)
+{
+	sha512_sw_ctx h;
+	unsigned char d[64], r[64], k[64];
+	fe25519 p[4];
+
+	if (eddsa25519_check_ctx(ctx_len, variant, msg_len) != 0) return -1;
+
+	eddsa25519_expand(pri_key, d);
+
+	// -- r = SHA-512(dom2 || prefix || M) mod L
+	sha512_sw_init(&h, 64);
+	eddsa25519_dom2(&h, ctx, ctx_len, variant);
+	sha512_sw_update(&h, d + 32, 32);
+	sha512_sw_update(&h, msg, msg_len);
+	sha512_sw_final(&h, r);
+	sc_reduce(r);
+
+	// -- R = r * B
+	ge_scalarmult_base(p, r);
+	ge_pack(sig, p);
+
+	// -- k = SHA-512(dom2 || R || A || M) mod L
+	sha512_sw_init(&h, 64);
+	eddsa25519_dom2(&h, ctx, ctx_len, variant);
+	sha512_sw_update(&h, sig, 32);
+	sha512_sw_update(&h, pub_key, 32);
+	sha512_sw_update(&h, msg, msg_len);
+	sha512_sw_final(&h, k);
+	sc_reduce(k);
+
+	// -- S = r + k * s mod L
+	sc_muladd(sig + 32, k, d, r);
+
+	memset(d, 0, sizeof(d));
+	memset(r, 0, sizeof(r));
+	memset(&h, 0, sizeof(h));
+
+	return 0;
+}
+
+int eddsa25519_verify_sw(const unsigned char* msg, unsigned long long msg_len, const unsigned char* ctx, unsigned int ctx_len, int variant,
+	const unsigned char* pub_key, const unsigned char* sig, unsigned int* result)
+{
+	sha512_sw_ctx h;
+	unsigned char k[64], t[32];
+	unsigned int diff = 0;
+	fe25519 p[4], q[4];
+
+	*result = 0;
+
+	if (eddsa25519_check_ctx(ctx_len, variant, msg_len) != 0) return -1;
+
+	if (!sc_is_canonical(sig + 32)) return 0;
+	if (ge_unpack_neg(q, pub_key) != 0) return 0;
+
+	sha512_sw_init(&h, 64);
+	eddsa25519_dom2(&h, ctx, ctx_len, variant);
+	sha512_sw_update(&h, sig, 32);
+	sha512_sw_update(&h, pub_key, 32);
+	sha512_sw_update(&h, msg, msg_len);
+	sha512_sw_final(&h, k);
+	sc_reduce(k);
+
+	// -- [S]B - [k]A must encode to R
+	ge_scalarmult(p, q, k);
+	ge_scalarmult_base(q, sig + 32);
+	ge_add(p, q);
+	ge_pack(t, p);
+
+	for (int i = 0; i < 32; i++) diff |= t[i] ^ sig[i];
+	*result = (diff == 0);
+
+	return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// BATCH VERIFICATION
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- Straus multi-scalar multiplication with 4-bit windows: the 256 doublings are
+//-- shared by every point, each point costs one addition per window.
+typedef fe25519 ge25519[4];
+
+static void ge_identity(ge25519 p)
+{
+	fe_copy(p[0], fe_0);
+	fe_copy(p[1], fe_1);
+	fe_copy(p[2], fe_1);
+	fe_copy(p[3], fe_0);
+}
+
+static void ge_copy(ge25519 o, ge25519 p)
+{
+	for (int i = 0; i < 4; i++) fe_copy(o[i], p[i]);
+}
+
+//-- sum(s[i] * P[i]), s[i] is 32 bytes little endian. Variable time: public data only.
+static void ge_multiscalar(ge25519 out, ge25519* P, const unsigned char (*s)[32], unsigned int n, ge25519* table)
+{
+	unsigned int w;
+
+	for (unsigned int i = 0; i < n; i++) {
+		ge25519* t = table + 15 * i;
+		ge_copy(t[0], P[i]);
+		for (int j = 1; j < 15; j++) {
+			ge_copy(t[j], t[j - 1]);
+			ge_add(t[j], P[i]);
+		}
+	}
+
+	ge_identity(out);
+	for (int b = 63; b >= 0; b--) {
+		for (int d = 0; d < 4; d++) ge_add(out, out);
+		for (unsigned int i = 0; i < n; i++) {
+			w = (s[i][b >> 1] >> ((b & 1) << 2)) & 0xF;
+			if (w) ge_add(out, table[15 * i + w - 1]);
+		}
+	}
+}
+
+//-- Single-signature form of the batch rule: 8 * ([S]B - R - [k]A) == identity.
+//-- The batch falls back to it, so a signature gets the same answer whichever
+//-- batch it lands in.
+static void eddsa25519_verify_cofactored(const eddsa_batch_item* it, unsigned int* result)
+{
+	sha512_sw_ctx h;
+	unsigned char k[64];
+	ge25519 p, q, r;
+
+	*result = 0;
+
+	if (!sc_is_canonical(it->sig + 32)) return;
+	if (ge_unpack_neg(r, it->sig) != 0 || ge_unpack_neg(q, it->pub_key) != 0) return;
+
+	sha512_sw_init(&h, 64);
+	sha512_sw_update(&h, it->sig, 32);
+	sha512_sw_update(&h, it->pub_key, 32);
+	sha512_sw_update(&h, it->msg, it->msg_len);
+	sha512_sw_final(&h, k);
+	sc_reduce(k);
+
+	ge_scalarmult(p, q, k);
+	ge_scalarmult_base(q, it->sig + 32);
+	ge_add(p, q);
+	ge_add(p, r);
+	for (int d = 0; d < 3; d++) ge_add(p, p);
+
+	*result = !fe_neq(p[0], fe_0) && !fe_neq(p[1], p[2]);
+}
+
+int eddsa25519_verify_batch_sw(const eddsa_batch_item* items, unsigned int n, unsigned int* results)
+{
+	static const unsigned char sc_zero[32] = { 0 };
+	unsigned int m = 0;
+	int ok;
+	unsigned char k[64], z[32];
+	unsigned char (*sc)[32];
+	ge25519 *pt, *table, sum;
+	sha512_sw_ctx h;
+
+	if (n == 0) return 0;
+
+	// -- points: B, then (-R_i, -A_i) per signature that decodes
+	pt		= malloc((2 * n + 1) * sizeof(ge25519));
+	sc		= malloc((2 * n + 1) * 32);
+	table	= malloc((2 * n + 1) * 15 * sizeof(ge25519));
+	ok		= (pt != NULL && sc != NULL && table != NULL);
+
+	// -- results[i]: 0 rejected while decoding, 2 left to the batch equation
+	for (unsigned int i = 0; i < n; i++) results[i] = 2;
+
+	if (ok) {
+		fe_copy(pt[0][0], fe_bx);
+		fe_copy(pt[0][1], fe_by);
+		fe_copy(pt[0][2], fe_1);
+		fe_mul(pt[0][3], fe_bx, fe_by);
+		memset(sc[0], 0, 32);
+	}
+
+	for (unsigned int i = 0; i < n && ok; i++) {
+		const eddsa_batch_item* it = &items[i];
+
+		if (!sc_is_canonical(it->sig + 32) || ge_unpack_neg(pt[1 + 2 * m], it->sig) != 0 || ge_unpack_neg(pt[2 + 2 * m], it->pub_key) != 0) {
+			results[i] = 0;
+			continue;
+		}
+
+		sha512_sw_init(&h, 64);
+		sha512_sw_update(&h, it->sig, 32);
+		sha512_sw_update(&h, it->pub_key, 32);
+		sha512_sw_update(&h, it->msg, it->msg_len);
+		sha512_sw_final(&h, k);
+		sc_reduce(k);
+
+		// -- z_i: 128-bit random weight
+		memset(z, 0, 32);
+		trng_pool_get(z, 16);
+
+		memcpy(sc[1 + 2 * m], z, 32);
+		sc_muladd(sc[2 + 2 * m], z, k, sc_zero);
+		sc_muladd(sc[0], z, it->sig + 32, sc[0]);
+		m++;
+	}
+
+	// -- 8 * ([sum z_i S_i] B - sum z_i R_i - sum z_i k_i A_i) == identity
+	if (ok && m > 0) {
+		ge_multiscalar(sum, pt, (const unsigned char (*)[32])sc, 2 * m + 1, table);
+		for (int d = 0; d < 3; d++) ge_add(sum, sum);
+		ok = !fe_neq(sum[0], fe_0) && !fe_neq(sum[1], sum[2]);
+	}
+
+	free(pt);
+	free(sc);
+	free(table);
+
+	// -- a failed batch only says that some signature is wrong: check one by one
+	for (unsigned int i = 0; i < n; i++) {
+		if (results[i] != 2)	continue;
+		if (ok)					results[i] = 1;
+		else					eddsa25519_verify_cofactored(&items[i], &results[i]);
+	}
+
+	return 0;
+}
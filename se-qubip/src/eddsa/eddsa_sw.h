@@ -0,0 +1,104 @@
+/**
+  * @file eddsa_sw.h
+  * @brief Host Software Ed25519 (RFC 8032 Ed25519 / Ed25519ctx / Ed25519ph)
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef EDDSA_SW_H
+#define EDDSA_SW_H
+
+#include <stdint.h>
+#include <string.h>
+#include "../sha2/sha2_sw.h"
+
+//-- RFC 8032 instances. PURE hashes the message as is; CTX and PH prepend
+//-- dom2(phflag, context) to both internal SHA-512 computations.
+#define EDDSA_VARIANT_PURE      0
+#define EDDSA_VARIANT_CTX       1
+#define EDDSA_VARIANT_PH        2
+
+#define EDDSA_MAX_CTX           255
+
+	//-- Derive the public key of a 32-byte private key.
+	void eddsa25519_pubkey_sw(const unsigned char* pri_key, unsigned char* pub_key);
+
+	//-- For EDDSA_VARIANT_PH, msg must be the 64-byte SHA-512 of the message
+	//-- (PH(M)), e.g. from sha_512_hw_func or a streamed sha512_sw_ctx.
+	//-- Return -1 on an invalid context (longer than 255 bytes, or empty for CTX).
+	int eddsa25519_sign_sw(const unsigned char* msg, unsigned long long msg_len, const unsigned char* ctx, unsigned int ctx_len, int variant,
+		const unsigned char* pri_key, const unsigned char* pub_key, unsigned char* sig);
+
+	//-- *result = 1 for a valid signature; a rejected signature returns 0.
+	int eddsa25519_verify_sw(const unsigned char* msg, unsigned long long msg_len, const unsigned char* ctx, unsigned int ctx_len, int variant,
+		const unsigned char* pub_key, const unsigned char* sig, unsigned int* result);
+
+	//-- Randomized batch verification of pure Ed25519 signatures: one multi-scalar
+	//-- multiplication checks the whole batch; if it fails, every signature is
+	//-- verified on its own to find the bad ones. results[i] = 1 for a valid
+	//-- signature. The batch and its per-signature fallback both use the cofactored
+	//-- equation (RFC 8032 5.1.7, as in ZIP-215), so a signature whose R or A carries
+	//-- a small-order component is accepted here but rejected by eddsa25519_verify_sw.
+	typedef struct {
+		const unsigned char* msg;
+		unsigned long long msg_len;
+		const unsigned char* pub_key;
+		const unsigned char* sig;
+	} eddsa_batch_item;
+
+	int eddsa25519_verify_batch_sw(const eddsa_batch_item* items, unsigned int n, unsigned int* results);
+
+#endif
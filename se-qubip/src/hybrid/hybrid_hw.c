@@ -0,0 +1,214 @@
+/**
+  * @file hybrid_hw.c
+  * @brief Hybrid X25519MLKEM768 Key Exchange
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#include "hybrid_hw.h"
+
+#ifdef SE_PARALLEL_CORES
+#define HYBRID_PARALLEL		1
+#else
+#define HYBRID_PARALLEL		0
+#endif
+
+#define MLKEM768_EK_BYTES	1184
+#define MLKEM768_DK_BYTES	2400
+#define MLKEM768_CT_BYTES	1088
+
+//-- Without PARALLEL_CORES (the default build, PARALLEL_CORES = NO) addressing the
+//-- X25519 core resets the ML-KEM core, so ML-KEM is collected before the X25519
+//-- half starts and the two halves run one after the other. Both cores are admitted
+//-- against the caller's deadline up front, and each half is run again after a
+//-- watchdog reset while its breaker stays closed, as the single calls are. SE_OK,
+//-- SE_ERR_DEADLINE when refused, or the error of the ML-KEM half, else of the
+//-- X25519 half; on failure every output is wiped.
+
+#define HYBRID_FIRST(ret, r)	do { int r_ = (r); if ((ret) == SE_OK) (ret) = r_; } while (0)
+
+//-- One X25519 operation: start, finish, and again after a watchdog reset
+#define HYBRID_X25519(ret, start, finish)	do { int x_ = SE_OK; for (int t_ = 0; t_ <= SE_RETRY; t_++) { start; if (!intf_core_retry(interface, SE_CORE_X25519, x_ = (finish))) break; } HYBRID_FIRST(ret, x_); } while (0)
+
+//-- The ML-KEM half once collected: run it again, alone, after a watchdog reset
+#define HYBRID_MLKEM_RETRY(ml, start, finish)	do { for (int t_ = 0; t_ < SE_RETRY && intf_core_retry(interface, SE_CORE_MLKEM, (ml)); t_++) { start; (ml) = (finish); } } while (0)
+
+static int hybrid_admit(INTF interface, unsigned long long x25519_units) {
+
+	if (intf_core_admit(interface, SE_CORE_MLKEM, 3) != SE_OK) return SE_ERR_DEADLINE;
+
+	return intf_core_admit(interface, SE_CORE_X25519, x25519_units);
+
+}
+
+//-- PARALLEL_CORES: the ML-KEM input and output FIFOs act on ADDRESS changing to a
+//-- nonzero value, and a reselected core switches from the ADDRESS it held to the
+//-- live one. ADDRESS is left at 0 once ML-KEM is started and again before it is
+//-- reselected, so the core sees no change on either side of the X25519 half.
+static void hybrid_park(INTF interface) {
+
+	unsigned long long int reg_addr = 0;
+
+	write_INTF(interface, &reg_addr, ADDRESS, sizeof(unsigned long long int));
+
+}
+
+int x25519mlkem768_gen_keys_hw(unsigned char* pk, unsigned char* sk, INTF interface) {
+
+	int ret = SE_OK;
+	int ml = SE_OK;
+
+	if (hybrid_admit(interface, 1) != SE_OK) {
+		memset(pk, 0, MLKEM768_EK_BYTES + X25519_BYTES);
+		memset(sk, 0, MLKEM768_DK_BYTES + X25519_BYTES);
+		return SE_ERR_DEADLINE;
+	}
+
+	mlkem_gen_keys_hw_start(3, interface);
+	if (HYBRID_PARALLEL)	hybrid_park(interface);
+	else					ml = mlkem_gen_keys_hw_finish(3, pk, sk, interface);
+
+	HYBRID_X25519(ret, x25519_genkeys_hw_start(sk + MLKEM768_DK_BYTES, interface), x25519_hw_finish(pk + MLKEM768_EK_BYTES, interface));
+
+	if (HYBRID_PARALLEL) {
+		hybrid_park(interface);
+		ml = mlkem_gen_keys_hw_finish(3, pk, sk, interface);
+	}
+	HYBRID_MLKEM_RETRY(ml, mlkem_gen_keys_hw_start(3, interface), mlkem_gen_keys_hw_finish(3, pk, sk, interface));
+
+	if (ml != SE_OK) ret = ml;
+
+	if (ret != SE_OK) {
+		memset(pk, 0, MLKEM768_EK_BYTES + X25519_BYTES);
+		memset(sk, 0, MLKEM768_DK_BYTES + X25519_BYTES);
+	}
+
+	return ret;
+
+}
+
+int x25519mlkem768_enc_hw(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface) {
+
+	unsigned char pri_key[X25519_BYTES];
+	int ret = SE_OK;
+	int ml = SE_OK;
+
+	if (hybrid_admit(interface, 2) != SE_OK) {
+		memset(ct, 0, MLKEM768_CT_BYTES + X25519_BYTES);
+		memset(ss, 0, 64);
+		return SE_ERR_DEADLINE;
+	}
+
+	mlkem_enc_hw_start(3, pk, interface);
+	if (HYBRID_PARALLEL)	hybrid_park(interface);
+	else					ml = mlkem_enc_hw_finish(3, ct, ss, interface);
+
+	// -- ephemeral key share, then the shared secret with the peer's share -- //
+	HYBRID_X25519(ret, x25519_genkeys_hw_start(pri_key, interface), x25519_hw_finish(ct + MLKEM768_CT_BYTES, interface));
+	HYBRID_X25519(ret, x25519_ss_gen_hw_start(pk + MLKEM768_EK_BYTES, pri_key, interface), x25519_hw_finish(ss + 32, interface));
+
+	if (HYBRID_PARALLEL) {
+		hybrid_park(interface);
+		ml = mlkem_enc_hw_finish(3, ct, ss, interface);
+	}
+	HYBRID_MLKEM_RETRY(ml, mlkem_enc_hw_start(3, pk, interface), mlkem_enc_hw_finish(3, ct, ss, interface));
+
+	memset(pri_key, 0, X25519_BYTES);
+
+	if (ml != SE_OK) ret = ml;
+
+	if (ret != SE_OK) {
+		memset(ct, 0, MLKEM768_CT_BYTES + X25519_BYTES);
+		memset(ss, 0, 64);
+	}
+
+	return ret;
+
+}
+
+int x25519mlkem768_dec_hw(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface) {
+
+	int ret = SE_OK;
+	int ml = SE_OK;
+
+	if (hybrid_admit(interface, 1) != SE_OK) {
+		memset(ss, 0, 64);
+		*result = 0;
+		return SE_ERR_DEADLINE;
+	}
+
+	mlkem_dec_hw_start(3, sk, ct, interface);
+	if (HYBRID_PARALLEL)	hybrid_park(interface);
+	else					ml = mlkem_dec_hw_finish(3, ss, result, interface);
+
+	HYBRID_X25519(ret, x25519_ss_gen_hw_start(ct + MLKEM768_CT_BYTES, sk + MLKEM768_DK_BYTES, interface), x25519_hw_finish(ss + 32, interface));
+
+	if (HYBRID_PARALLEL) {
+		hybrid_park(interface);
+		ml = mlkem_dec_hw_finish(3, ss, result, interface);
+	}
+	HYBRID_MLKEM_RETRY(ml, mlkem_dec_hw_start(3, sk, ct, interface), mlkem_dec_hw_finish(3, ss, result, interface));
+
+	if (ml != SE_OK) ret = ml;
+
+	if (ret != SE_OK) {
+		memset(ss, 0, 64);
+		*result = 0;
+	}
+
+	return ret;
+
+}
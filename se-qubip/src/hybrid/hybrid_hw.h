@@ -0,0 +1,93 @@
+/**
+  * @file hybrid_hw.h
+  * @brief Hybrid X25519MLKEM768 Key Exchange Header
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef HYBRID_H
+#define HYBRID_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "../common/intf.h"
+#include "../common/conf.h"
+#include "../x25519/x25519_hw.h"
+#include "../mlkem/mlkem_hw.h"
+
+/************************ Hybrid Constant Definitions **********************/
+
+//-- draft-ietf-tls-ecdhe-mlkem: ML-KEM component first, then X25519
+#define X25519MLKEM768_PK_BYTES		1216	// ek (1184) || X25519 public key (32)
+#define X25519MLKEM768_SK_BYTES		2432	// dk (2400) || X25519 private key (32)
+#define X25519MLKEM768_CT_BYTES		1120	// ct (1088) || X25519 public key (32)
+#define X25519MLKEM768_SS_BYTES		64		// ML-KEM shared secret (32) || X25519 shared secret (32)
+
+	/************************ Main Functions **********************/
+
+	//-- With SE_PARALLEL_CORES (bitstream built with PARALLEL_CORES = 1) the ML-KEM
+	//-- core is started first and left computing while the X25519 core is loaded,
+	//-- run and read back, so a hybrid operation costs about max(X25519, ML-KEM).
+	//-- Otherwise, and so in the default build (PARALLEL_CORES = NO), both halves
+	//-- run one after the other on the same SE and a hybrid operation costs
+	//-- X25519 + ML-KEM. Both cores are admitted against the caller's deadline
+	//-- and retried after a watchdog reset like the single calls.
+	int x25519mlkem768_gen_keys_hw(unsigned char* pk, unsigned char* sk, INTF interface);
+	int x25519mlkem768_enc_hw(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface);
+	int x25519mlkem768_dec_hw(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface);
+
+#endif
@@ -0,0 +1,360 @@
+/**
+  * @file memo.c
+  * @brief Memoization of EdDSA verification and static X25519 results
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#include "memo.h"
+#include "../trng/trng_pool.h"
+
+typedef struct {
+	unsigned char key[MEMO_KEY_BYTES];
+	unsigned char val[MEMO_VAL_BYTES];
+	int prev, next;			// LRU list (head = most recent)
+	int chain;				// Hash bucket chain
+} memo_entry;
+
+typedef struct {
+	pthread_mutex_t lock;
+	memo_entry* entry;
+	int* bucket;
+	unsigned int capacity;
+	unsigned int n_bucket;
+	unsigned int count;
+	int head, tail;
+	memo_stat st[MEMO_N_KIND];
+} memo_shard;
+
+static memo_shard* memo_tab = NULL;
+static unsigned char memo_salt[32];
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// LRU SHARDS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static void memo_key(int kind, const unsigned char* a, unsigned int a_len, const unsigned char* b, unsigned int b_len,
+	const unsigned char* c, unsigned long long c_len, unsigned char* key)
+{
+	sha256_sw_ctx ctx;
+	unsigned char tag[9];
+
+	// -- kind and length of the variable-size field keep the encoding injective
+	tag[0] = (unsigned char)kind;
+	for (int i = 0; i < 8; i++) tag[1 + i] = (unsigned char)(c_len >> (8 * i));
+
+	sha256_sw_init(&ctx);
+	sha256_sw_update(&ctx, memo_salt, sizeof(memo_salt));
+	sha256_sw_update(&ctx, tag, sizeof(tag));
+	sha256_sw_update(&ctx, a, a_len);
+	sha256_sw_update(&ctx, b, b_len);
+	if (c_len) sha256_sw_update(&ctx, c, c_len);
+	sha256_sw_final(&ctx, key);
+}
+
+static memo_shard* memo_shard_of(const unsigned char* key)
+{
+	return &memo_tab[key[0] % MEMO_SHARDS];
+}
+
+static unsigned int memo_bucket_of(memo_shard* sh, const unsigned char* key)
+{
+	unsigned int h = (unsigned int)key[1] | ((unsigned int)key[2] << 8) | ((unsigned int)key[3] << 16) | ((unsigned int)key[4] << 24);
+	return h % sh->n_bucket;
+}
+
+static void memo_unlink(memo_shard* sh, int i)
+{
+	memo_entry* e = &sh->entry[i];
+
+	if (e->prev >= 0)	sh->entry[e->prev].next = e->next;
+	else				sh->head = e->next;
+	if (e->next >= 0)	sh->entry[e->next].prev = e->prev;
+	else				sh->tail = e->prev;
+}
+
+static void memo_push_head(memo_shard* sh, int i)
+{
+	memo_entry* e = &sh->entry[i];
+
+	e->prev = -1;
+	e->next = sh->head;
+	if (sh->head >= 0)	sh->entry[sh->head].prev = i;
+	else				sh->tail = i;
+	sh->head = i;
+}
+
+static int memo_find(memo_shard* sh, const unsigned char* key)
+{
+	for (int i = sh->bucket[memo_bucket_of(sh, key)]; i >= 0; i = sh->entry[i].chain)
+		if (!memcmp(sh->entry[i].key, key, MEMO_KEY_BYTES)) return i;
+
+	return -1;
+}
+
+static void memo_drop_chain(memo_shard* sh, int i)
+{
+	int* p = &sh->bucket[memo_bucket_of(sh, sh->entry[i].key)];
+
+	while (*p != i) p = &sh->entry[*p].chain;
+	*p = sh->entry[i].chain;
+}
+
+static int memo_get(int kind, const unsigned char* key, unsigned char* val)
+{
+	memo_shard* sh = memo_shard_of(key);
+	int i;
+
+	pthread_mutex_lock(&sh->lock);
+	i = memo_find(sh, key);
+	if (i >= 0) {
+		memo_unlink(sh, i);
+		memo_push_head(sh, i);
+		if (val != NULL) memcpy(val, sh->entry[i].val, MEMO_VAL_BYTES);
+		sh->st[kind].hits++;
+	}
+	else {
+		sh->st[kind].misses++;
+	}
+	pthread_mutex_unlock(&sh->lock);
+
+	return (i >= 0);
+}
+
+static void memo_put(int kind, const unsigned char* key, const unsigned char* val)
+{
+	memo_shard* sh = memo_shard_of(key);
+	unsigned int b;
+	int i;
+
+	pthread_mutex_lock(&sh->lock);
+	if ((i = memo_find(sh, key)) >= 0) {
+		memo_unlink(sh, i);
+	}
+	else {
+		if (sh->count < sh->capacity) {
+			i = (int)sh->count++;
+		}
+		else {
+			// -- evict the least recently used entry
+			i = sh->tail;
+			memo_unlink(sh, i);
+			memo_drop_chain(sh, i);
+			memset(sh->entry[i].val, 0, MEMO_VAL_BYTES);
+			sh->st[kind].evictions++;
+		}
+		memcpy(sh->entry[i].key, key, MEMO_KEY_BYTES);
+		b = memo_bucket_of(sh, key);
+		sh->entry[i].chain = sh->bucket[b];
+		sh->bucket[b] = i;
+		sh->st[kind].inserts++;
+	}
+	if (val != NULL)	memcpy(sh->entry[i].val, val, MEMO_VAL_BYTES);
+	else				memset(sh->entry[i].val, 0, MEMO_VAL_BYTES);
+	memo_push_head(sh, i);
+	pthread_mutex_unlock(&sh->lock);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// CONTROL FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- Not thread-safe against calls in flight: set up before, tear down after use
+int memo_init(unsigned int capacity)
+{
+	unsigned int per_shard = (capacity + MEMO_SHARDS - 1) / MEMO_SHARDS;
+	memo_shard* tab;
+
+	memo_free();
+	if (capacity == 0) return 0;
+
+	// -- salt: keeps bucket placement unpredictable from the inputs
+	trng_pool_get(memo_salt, sizeof(memo_salt));
+
+	tab = calloc(MEMO_SHARDS, sizeof(memo_shard));
+	if (tab == NULL) return -1;
+
+	for (int s = 0; s < MEMO_SHARDS; s++) {
+		memo_shard* sh = &tab[s];
+		pthread_mutex_init(&sh->lock, NULL);
+		sh->capacity	= per_shard;
+		sh->n_bucket	= per_shard;
+		sh->head		= -1;
+		sh->tail		= -1;
+		sh->entry		= calloc(per_shard, sizeof(memo_entry));
+		sh->bucket		= malloc(per_shard * sizeof(int));
+		if (sh->entry == NULL || sh->bucket == NULL) {
+			printf("\n MEMO FAIL!: out of memory\n");
+			memo_tab = tab;
+			memo_free();
+			return -1;
+		}
+		for (unsigned int b = 0; b < sh->n_bucket; b++) sh->bucket[b] = -1;
+	}
+
+	__atomic_store_n(&memo_tab, tab, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+void memo_free()
+{
+	memo_shard* tab = memo_tab;
+
+	if (tab == NULL) return;
+	__atomic_store_n(&memo_tab, NULL, __ATOMIC_RELEASE);
+
+	for (int s = 0; s < MEMO_SHARDS; s++) {
+		if (tab[s].entry != NULL) memset(tab[s].entry, 0, tab[s].capacity * sizeof(memo_entry));
+		free(tab[s].entry);
+		free(tab[s].bucket);
+		pthread_mutex_destroy(&tab[s].lock);
+	}
+	free(tab);
+	memset(memo_salt, 0, sizeof(memo_salt));
+}
+
+void memo_flush()
+{
+	if (memo_tab == NULL) return;
+
+	for (int s = 0; s < MEMO_SHARDS; s++) {
+		memo_shard* sh = &memo_tab[s];
+		pthread_mutex_lock(&sh->lock);
+		memset(sh->entry, 0, sh->capacity * sizeof(memo_entry));
+		for (unsigned int b = 0; b < sh->n_bucket; b++) sh->bucket[b] = -1;
+		sh->count	= 0;
+		sh->head	= -1;
+		sh->tail	= -1;
+		pthread_mutex_unlock(&sh->lock);
+	}
+}
+
+void memo_stats(int kind, memo_stat* st)
+{
+	memset(st, 0, sizeof(memo_stat));
+	if (memo_tab == NULL || kind < 0 || kind >= MEMO_N_KIND) return;
+
+	for (int s = 0; s < MEMO_SHARDS; s++) {
+		memo_shard* sh = &memo_tab[s];
+		pthread_mutex_lock(&sh->lock);
+		st->hits		+= sh->st[kind].hits;
+		st->misses		+= sh->st[kind].misses;
+		st->inserts		+= sh->st[kind].inserts;
+		st->evictions	+= sh->st[kind].evictions;
+		pthread_mutex_unlock(&sh->lock);
+	}
+}
+
+void memo_reset_stats()
+{
+	if (memo_tab == NULL) return;
+
+	for (int s = 0; s < MEMO_SHARDS; s++) {
+		pthread_mutex_lock(&memo_tab[s].lock);
+		memset(memo_tab[s].st, 0, sizeof(memo_tab[s].st));
+		pthread_mutex_unlock(&memo_tab[s].lock);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// MAIN FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- Only valid signatures are remembered: a rejection is always re-checked
+int eddsa25519_verify_memo(const unsigned char* msg, unsigned long long msg_len, const unsigned char* pub_key, const unsigned char* sig, unsigned int* result, INTF interface)
+{
+	unsigned char key[MEMO_KEY_BYTES];
+	int ret;
+
+	if (__atomic_load_n(&memo_tab, __ATOMIC_ACQUIRE) == NULL)
+		return eddsa25519_verify_hw_buf(msg, msg_len, pub_key, sig, result, interface);
+
+	memo_key(MEMO_VERIFY, pub_key, EDDSA_BYTES, sig, SHA_BYTES, msg, msg_len, key);
+	if (memo_get(MEMO_VERIFY, key, NULL)) {
+		*result = 1;
+		return 0;
+	}
+
+	ret = eddsa25519_verify_hw_buf(msg, msg_len, pub_key, sig, result, interface);
+	if (ret == 0 && *result == 1) memo_put(MEMO_VERIFY, key, NULL);
+
+	return ret;
+}
+
+int x25519_ss_gen_memo(unsigned char* shared_secret, const unsigned char* pub_key, const unsigned char* pri_key, INTF interface)
+{
+	static const unsigned char zero[X25519_BYTES] = { 0 };
+	unsigned char key[MEMO_KEY_BYTES];
+	int ret;
+
+	if (__atomic_load_n(&memo_tab, __ATOMIC_ACQUIRE) == NULL) return x25519_ss_gen_hw_buf(shared_secret, pub_key, pri_key, interface);
+
+	memo_key(MEMO_X25519, pri_key, X25519_BYTES, pub_key, X25519_BYTES, NULL, 0, key);
+	if (memo_get(MEMO_X25519, key, shared_secret)) {
+		memset(key, 0, sizeof(key));
+		return SE_OK;
+	}
+
+	ret = x25519_ss_gen_hw_buf(shared_secret, pub_key, pri_key, interface);
+
+	// -- a failed run or an all-zero secret (small-order peer key) is not worth keeping
+	if (ret == SE_OK && memcmp(shared_secret, zero, X25519_BYTES)) memo_put(MEMO_X25519, key, shared_secret);
+
+	memset(key, 0, sizeof(key));
+
+	return ret;
+}
@@ -0,0 +1,110 @@
+/**
+  * @file memo.h
+  * @brief Memoization of EdDSA verification and static X25519 results
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef MEMO_H
+#define MEMO_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../common/intf.h"
+#include "../common/conf.h"
+#include "../common/extra_func.h"
+#include "../sha2/sha2_sw.h"
+#include "../eddsa/eddsa_hw.h"
+#include "../x25519/x25519_hw.h"
+
+/************************ Memo Constant Definitions **********************/
+
+#define MEMO_VERIFY					0		// EdDSA verification (positive results only)
+#define MEMO_X25519					1		// X25519 shared secrets
+#define MEMO_N_KIND					2
+
+#define MEMO_SHARDS					16		// Independent LRU lists, one lock each
+#define MEMO_KEY_BYTES				32		// SHA-256 of a per-process salt and the inputs
+#define MEMO_VAL_BYTES				32
+
+	typedef struct {
+		unsigned long long hits;
+		unsigned long long misses;
+		unsigned long long inserts;
+		unsigned long long evictions;
+	} memo_stat;
+
+	/************************ Control Functions **********************/
+
+	//-- Entries are keyed by a salted hash of the inputs, so neither messages nor
+	//-- private keys are kept; shared secrets are wiped on eviction, flush and free.
+	//-- capacity = 0 (or no memo_init) turns the layer into a plain pass-through.
+	int memo_init(unsigned int capacity);
+	void memo_free();
+	void memo_flush();
+	void memo_stats(int kind, memo_stat* st);
+	void memo_reset_stats();
+
+	/************************ Main Functions **********************/
+
+	int eddsa25519_verify_memo(const unsigned char* msg, unsigned long long msg_len, const unsigned char* pub_key, const unsigned char* sig, unsigned int* result, INTF interface);
+	int x25519_ss_gen_memo(unsigned char* shared_secret, const unsigned char* pub_key, const unsigned char* pri_key, INTF interface);
+
+#endif
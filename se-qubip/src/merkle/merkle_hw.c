@@ -0,0 +1,390 @@
+/**
+  * @file merkle_hw.c
+  * @brief Merkle-Tree File Hasher over the SHA-2/SHA-3 cores
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "merkle_hw.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// NODE HASHING
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- Interior nodes are 65 bytes: hashing them on the host is cheaper than a bus round-trip
+static void merkle_node(unsigned char* left, unsigned char* right, unsigned char* out, int VERSION)
+{
+	unsigned char buf[1 + 2 * MERKLE_HASH_LEN];
+
+	buf[0] = MERKLE_NODE_PREFIX;
+	memcpy(buf + 1, left, MERKLE_HASH_LEN);
+	memcpy(buf + 1 + MERKLE_HASH_LEN, right, MERKLE_HASH_LEN);
+
+	if (VERSION == MERKLE_SHA2_256)	sha_256_sw(buf, sizeof(buf), out);
+	else							sha3_256_sw(buf, sizeof(buf), out);
+}
+
+void merkle_leaf(const unsigned char* data, unsigned long long length, unsigned char* out, int VERSION)
+{
+	unsigned char prefix = MERKLE_LEAF_PREFIX;
+	sha256_sw_ctx sha2;
+	sha3_sw_ctx sha3;
+
+	if (VERSION == MERKLE_SHA2_256) {
+		sha256_sw_init(&sha2);
+		sha256_sw_update(&sha2, &prefix, 1);
+		sha256_sw_update(&sha2, data, length);
+		sha256_sw_final(&sha2, out);
+	}
+	else {
+		sha3_sw_init(&sha3, SHA3_SW_RATE_256, 0x06);
+		sha3_sw_absorb(&sha3, &prefix, 1);
+		sha3_sw_absorb(&sha3, data, length);
+		sha3_sw_finalize(&sha3);
+		sha3_sw_squeeze(&sha3, out, MERKLE_HASH_LEN);
+	}
+}
+
+//-- Leaf i is done: walk up while this worker is the last child to arrive at the parent.
+//-- pending[] holds the number of children still missing for every interior node.
+static void merkle_complete(merkle_tree* tree, unsigned long long idx)
+{
+	unsigned char* child;
+	unsigned char* parent;
+	unsigned long long p;
+
+	for (unsigned int l = 0; l + 1 < tree->n_levels; l++) {
+		p = idx >> 1;
+		if (__atomic_sub_fetch(&tree->pending[tree->level_off[l + 1] + p], 1, __ATOMIC_ACQ_REL) != 0) return;
+
+		child	= tree->nodes + (tree->level_off[l] + (p << 1)) * MERKLE_HASH_LEN;
+		parent	= tree->nodes + (tree->level_off[l + 1] + p) * MERKLE_HASH_LEN;
+
+		if ((p << 1) + 1 < tree->level_count[l])	merkle_node(child, child + MERKLE_HASH_LEN, parent, tree->VERSION);
+		else										memcpy(parent, child, MERKLE_HASH_LEN);
+
+		idx = p;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// LEAF SCHEDULER
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	merkle_tree* tree;
+	unsigned char* data;
+	unsigned long long* next;
+	int* status;							// First failure of any worker: the others stop
+	int hw;
+	INTF interface;
+} merkle_job;
+
+//-- The drivers take one contiguous message: the prefix and the leaf are copied to buf
+static int merkle_leaf_hw(merkle_job* job, unsigned char* buf, unsigned char* in, unsigned long long len, unsigned char* out)
+{
+	buf[0] = MERKLE_LEAF_PREFIX;
+	memcpy(buf + 1, in, len);
+
+	// -- len <= leaf_size <= MERKLE_MAX_LEAF: (len + 1) * 8 fits the drivers' unsigned int
+	if (job->tree->VERSION == MERKLE_SHA2_256)	return sha_256_hw_func(buf, (unsigned int)(len + 1), out, job->interface);
+	else										return sha3_256_hw_func(buf, (unsigned int)(len + 1), out, job->interface);
+}
+
+//-- Device workers and host workers pull from the same leaf counter. Devices grab
+//-- MERKLE_CHUNK_HW leaves at a time; host threads grab one, so they only take
+//-- the leaves the devices have not reached yet (overflow capacity).
+static void* merkle_leaves(void* arg)
+{
+	merkle_job* job = (merkle_job*)arg;
+	merkle_tree* tree = job->tree;
+	unsigned long long chunk = (job->hw) ? MERKLE_CHUNK_HW : MERKLE_CHUNK_SW;
+	unsigned long long first, last, len, done = 0;
+	unsigned char* buf = NULL;
+	unsigned char* in;
+	unsigned char* out;
+	int ret;
+
+	if (job->hw && (buf = malloc(tree->leaf_size + 1)) == NULL) {
+		__atomic_store_n(job->status, -1, __ATOMIC_RELAXED);
+		return NULL;
+	}
+
+	while (__atomic_load_n(job->status, __ATOMIC_RELAXED) == 0) {
+		first = __atomic_fetch_add(job->next, chunk, __ATOMIC_RELAXED);
+		if (first >= tree->n_leaves) break;
+		last = (first + chunk < tree->n_leaves) ? first + chunk : tree->n_leaves;
+
+		for (unsigned long long i = first; i < last; i++) {
+			in	= job->data + i * tree->leaf_size;
+			len	= (i == tree->n_leaves - 1) ? tree->length - i * tree->leaf_size : tree->leaf_size;
+			out	= tree->nodes + i * MERKLE_HASH_LEN;
+
+			if (job->hw) {
+				// -- a wiped leaf must not make it into a root
+				if ((ret = merkle_leaf_hw(job, buf, in, len, out)) != SE_OK) {
+					__atomic_store_n(job->status, ret, __ATOMIC_RELAXED);
+					break;
+				}
+			}
+			else {
+				merkle_leaf(in, len, out, tree->VERSION);
+			}
+
+			merkle_complete(tree, i);
+			done++;
+		}
+	}
+
+	if (buf != NULL) free(buf);
+
+	if (job->hw)	__atomic_add_fetch(&tree->leaves_hw, done, __ATOMIC_RELAXED);
+	else			__atomic_add_fetch(&tree->leaves_sw, done, __ATOMIC_RELAXED);
+
+	return NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// MAIN FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+int merkle_buffer_hw(merkle_tree* tree, unsigned char* data, unsigned long long length, unsigned long long leaf_size, int VERSION,
+	INTF* interface, unsigned int n_interface, unsigned int n_host)
+{
+	unsigned long long total = 0;
+	unsigned long long next = 0;
+	unsigned int n_job;
+	merkle_job* job;
+	pthread_t* thread;
+	int* started;
+	int status = 0;
+
+	memset(tree, 0, sizeof(merkle_tree));
+
+	if (leaf_size == 0 || leaf_size > MERKLE_MAX_LEAF) {
+		printf("\n MERKLE FAIL!: leaf size must be in (0, %llu] bytes\n", MERKLE_MAX_LEAF);
+		return -1;
+	}
+	if (n_interface == 0 && n_host == 0) n_host = 1;
+
+	tree->VERSION	= VERSION;
+	tree->length	= length;
+	tree->leaf_size	= leaf_size;
+	tree->n_leaves	= (length) ? (length + leaf_size - 1) / leaf_size : 1;	// An empty file is one empty leaf
+
+	// ------- Level layout ------------------------------------ //
+
+	for (unsigned long long c = tree->n_leaves; ; c = (c + 1) / 2) {
+		tree->level_off[tree->n_levels]		= total;
+		tree->level_count[tree->n_levels]	= c;
+		tree->n_levels++;
+		total += c;
+		if (c == 1) break;
+	}
+
+	tree->nodes		= malloc(total * MERKLE_HASH_LEN);
+	tree->pending	= malloc(total * sizeof(unsigned int));
+	if (tree->nodes == NULL || tree->pending == NULL) {
+		printf("\n MERKLE FAIL!: out of memory\n");
+		merkle_free(tree);
+		return -1;
+	}
+
+	for (unsigned int l = 1; l < tree->n_levels; l++) {
+		for (unsigned long long p = 0; p < tree->level_count[l]; p++)
+			tree->pending[tree->level_off[l] + p] = ((p << 1) + 1 < tree->level_count[l - 1]) ? 2 : 1;
+	}
+
+	// ------- Leaf hashing, devices + host overflow ----------- //
+
+	n_job	= n_interface + n_host;
+	job		= malloc(n_job * sizeof(merkle_job));
+	thread	= malloc(n_job * sizeof(pthread_t));
+	started	= calloc(n_job, sizeof(int));
+	if (job == NULL || thread == NULL || started == NULL) {
+		printf("\n MERKLE FAIL!: out of memory\n");
+		status = -1;
+	}
+
+	for (unsigned int j = 0; j < n_job && status == 0; j++) {
+		job[j].tree		= tree;
+		job[j].data		= data;
+		job[j].next		= &next;
+		job[j].status	= &status;
+		job[j].hw		= (j < n_interface);
+		if (j < n_interface) job[j].interface = interface[j];
+	}
+
+	// -- worker 0, and any whose thread cannot be started, runs on this thread
+	if (status == 0) {
+		for (unsigned int j = 1; j < n_job; j++) started[j] = (pthread_create(&thread[j], NULL, merkle_leaves, &job[j]) == 0);
+		for (unsigned int j = 0; j < n_job; j++) if (!started[j]) merkle_leaves(&job[j]);
+		for (unsigned int j = 1; j < n_job; j++) if (started[j]) pthread_join(thread[j], NULL);
+	}
+
+	free(job);
+	free(thread);
+	free(started);
+
+	if (status != 0) {
+		printf("\n MERKLE FAIL!: leaf hashing failed (%d)\n", status);
+		merkle_free(tree);
+		return status;
+	}
+
+	memcpy(tree->root, tree->nodes + tree->level_off[tree->n_levels - 1] * MERKLE_HASH_LEN, MERKLE_HASH_LEN);
+
+	free(tree->pending);
+	tree->pending = NULL;
+
+	return 0;
+}
+
+int merkle_file_hw(merkle_tree* tree, const char* path, unsigned long long leaf_size, int VERSION,
+	INTF* interface, unsigned int n_interface, unsigned int n_host)
+{
+	struct stat st;
+	unsigned char* data = NULL;
+	int fd;
+	int ret;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		printf("\n MERKLE FAIL!: cannot open %s\n", path);
+		return -1;
+	}
+	if (fstat(fd, &st) < 0) {
+		printf("\n MERKLE FAIL!: cannot stat %s\n", path);
+		close(fd);
+		return -1;
+	}
+
+	// -- The leaves are fed to the drivers straight from the page cache
+	if (st.st_size > 0) {
+		data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED) {
+			printf("\n MERKLE FAIL!: cannot map %s\n", path);
+			close(fd);
+			return -1;
+		}
+		madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL | MADV_WILLNEED);
+	}
+	close(fd);
+
+	ret = merkle_buffer_hw(tree, data, (unsigned long long)st.st_size, leaf_size, VERSION, interface, n_interface, n_host);
+
+	if (data != NULL) munmap(data, (size_t)st.st_size);
+
+	return ret;
+}
+
+void merkle_free(merkle_tree* tree)
+{
+	free(tree->nodes);
+	free(tree->pending);
+	tree->nodes = NULL;
+	tree->pending = NULL;
+}
+
+//-- Sibling hashes from the leaf to the root. Promoted nodes have no sibling and
+//-- contribute nothing, so the verifier needs n_leaves to replay the path.
+unsigned int merkle_proof(merkle_tree* tree, unsigned long long leaf, unsigned char* proof)
+{
+	unsigned int n = 0;
+	unsigned long long idx = leaf;
+
+	if (leaf >= tree->n_leaves) return 0;
+
+	for (unsigned int l = 0; l + 1 < tree->n_levels; l++) {
+		if ((idx ^ 1) < tree->level_count[l]) {
+			memcpy(proof + n * MERKLE_HASH_LEN, tree->nodes + (tree->level_off[l] + (idx ^ 1)) * MERKLE_HASH_LEN, MERKLE_HASH_LEN);
+			n++;
+		}
+		idx >>= 1;
+	}
+
+	return n;
+}
+
+int merkle_verify(unsigned char* root, unsigned char* leaf_hash, unsigned long long leaf, unsigned long long n_leaves,
+	unsigned char* proof, unsigned int proof_len, int VERSION)
+{
+	unsigned char h[MERKLE_HASH_LEN];
+	unsigned long long idx = leaf;
+	unsigned long long count = n_leaves;
+	unsigned int n = 0;
+
+	if (leaf >= n_leaves) return 0;
+
+	memcpy(h, leaf_hash, MERKLE_HASH_LEN);
+
+	while (count > 1) {
+		if ((idx ^ 1) < count) {
+			if (n == proof_len) return 0;
+			if (idx & 1)	merkle_node(proof + n * MERKLE_HASH_LEN, h, h, VERSION);
+			else			merkle_node(h, proof + n * MERKLE_HASH_LEN, h, VERSION);
+			n++;
+		}
+		idx >>= 1;
+		count = (count + 1) / 2;
+	}
+
+	return (n == proof_len) && !memcmp(h, root, MERKLE_HASH_LEN);
+}
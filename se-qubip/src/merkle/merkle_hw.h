@@ -0,0 +1,124 @@
+/**
+  * @file merkle_hw.h
+  * @brief Merkle-Tree File Hasher Header
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef MERKLE_HW_H
+#define MERKLE_HW_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "../common/intf.h"
+#include "../common/conf.h"
+#include "../common/extra_func.h"
+#include "../sha3/sha3_shake_hw.h"
+#include "../sha3/sha3_sw.h"
+#include "../sha2/sha2_hw.h"
+#include "../sha2/sha2_sw.h"
+
+/************************ Merkle Constant Definitions **********************/
+
+#define MERKLE_SHA3_256			1
+#define MERKLE_SHA2_256			2
+
+#define MERKLE_HASH_LEN			32
+#define MERKLE_MAX_LEVELS		64
+#define MERKLE_MAX_LEAF			(64ULL * 1024 * 1024)	// Prefix + leaf: the drivers take the length in bits as unsigned int
+#define MERKLE_CHUNK_HW			8						// Leaves claimed per grab by a device worker
+#define MERKLE_CHUNK_SW			1						// Leaves claimed per grab by a host worker
+#define MERKLE_LEAF_PREFIX		0x00					// Leaf: H(0x00 || data)
+#define MERKLE_NODE_PREFIX		0x01					// Interior node: H(0x01 || left || right)
+
+	//-- Tree of a file split in fixed-size leaves. leaf i = H(0x00 || data[i*leaf_size ...]),
+	//-- interior node = H(0x01 || left || right) (RFC 6962 domain separation, so
+	//-- a node cannot pass for a leaf) and a node without right sibling is
+	//-- promoted unchanged. All levels are kept in nodes[] so proofs can be served
+	//-- once the tree is built.
+	typedef struct {
+		int VERSION;
+		unsigned long long length;
+		unsigned long long leaf_size;
+		unsigned long long n_leaves;
+		unsigned int n_levels;
+		unsigned long long level_count[MERKLE_MAX_LEVELS];
+		unsigned long long level_off[MERKLE_MAX_LEVELS];
+		unsigned char* nodes;
+		unsigned int* pending;
+		unsigned char root[MERKLE_HASH_LEN];
+		unsigned long long leaves_hw;
+		unsigned long long leaves_sw;
+	} merkle_tree;
+
+	/************************ Main Functions **********************/
+
+	//-- 0, or -1 / the first failed leaf's SE_ERR_* (tree freed, no root)
+	int merkle_buffer_hw(merkle_tree* tree, unsigned char* data, unsigned long long length, unsigned long long leaf_size, int VERSION,
+		INTF* interface, unsigned int n_interface, unsigned int n_host);
+	int merkle_file_hw(merkle_tree* tree, const char* path, unsigned long long leaf_size, int VERSION,
+		INTF* interface, unsigned int n_interface, unsigned int n_host);
+	void merkle_free(merkle_tree* tree);
+
+	//-- Leaf hash on the host, for verifiers holding the leaf data
+	void merkle_leaf(const unsigned char* data, unsigned long long length, unsigned char* out, int VERSION);
+	unsigned int merkle_proof(merkle_tree* tree, unsigned long long leaf, unsigned char* proof);
+	int merkle_verify(unsigned char* root, unsigned char* leaf_hash, unsigned long long leaf, unsigned long long n_leaves,
+		unsigned char* proof, unsigned int proof_len, int VERSION);
+
+#endif
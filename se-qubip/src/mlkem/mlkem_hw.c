@@ -58,6 +58,9 @@
   * @version 1.0
   **/
 #include "mlkem_hw.h"
+#include "../trng/trng_pool.h"
+#include "../trng/trng_hw.h"
+#include "../pool/kpool.h"
 
 #include <stddef.h>
 #include <stdint.h>
@@ -66,96 +69,203 @@
 
 #if defined(I2C_STM32)
 
-static void randombytes(uint8_t* out, size_t outlen) {
+//-- No OS generator on the MCU: drawn from the TRNG of the SE the last ML-KEM
+//-- call ran on. Like trng_pool_get, a failing generator aborts.
+static INTF mlkem_rng_interface;
 
-	srand(HAL_GetTick());
+void mlkem_randombytes(uint8_t* out, size_t outlen) {
 
-	for (int i = 0; i < outlen; i++) {
-		out[i] = (uint8_t)rand();
+	if (trng_hw(out, (unsigned int)outlen, mlkem_rng_interface) != TRNG_OK) {
+		printf("\n MLKEM FAIL!: TRNG\n");
+		abort();
 	}
+
+}
+
+static void mlkem_coins(uint8_t* out, size_t outlen, INTF interface) {
+
+	mlkem_rng_interface = interface;
+	mlkem_randombytes(out, outlen);
+
 }
 
 #else
-static void randombytes(uint8_t* out, size_t outlen) {
-	static int fd = -1;
-	size_t ret;
+//-- Drawn from the TRNG entropy pool (OS generator until trng_pool_init)
+void mlkem_randombytes(uint8_t* out, size_t outlen) {
 
-	while (fd == -1) {
-		fd = open("/dev/urandom", O_RDONLY);
-		if (fd == -1)
-			continue;
-		else if (fd == -1)
-			abort();
-	}
+	trng_pool_get(out, (unsigned int)outlen);
+
+}
 
-	while (outlen > 0) {
-		ret = read(fd, out, outlen);
-		if (ret == -1)
-			continue;
-		else if (ret == -1)
-			abort();
+static void mlkem_coins(uint8_t* out, size_t outlen, INTF interface) {
+
+	mlkem_randombytes(out, outlen);
 
-		out += ret;
-		outlen -= ret;
-	}
 }
 #endif
 
-void mlkem_512_gen_keys_hw(unsigned char* pk, unsigned char* sk, INTF interface) {
+int mlkem_512_gen_keys_hw(unsigned char* pk, unsigned char* sk, INTF interface) {
 
-	mlkem_gen_keys_hw(2, pk, sk, interface);
+	return mlkem_gen_keys_hw(2, pk, sk, interface);
 
 }
-void mlkem_768_gen_keys_hw(unsigned char* pk, unsigned char* sk, INTF interface) {
+int mlkem_768_gen_keys_hw(unsigned char* pk, unsigned char* sk, INTF interface) {
 
-	mlkem_gen_keys_hw(3, pk, sk, interface);
+	return mlkem_gen_keys_hw(3, pk, sk, interface);
 
 }
-void mlkem_1024_gen_keys_hw(unsigned char* pk, unsigned char* sk, INTF interface) {
+int mlkem_1024_gen_keys_hw(unsigned char* pk, unsigned char* sk, INTF interface) {
 
-	mlkem_gen_keys_hw(4, pk, sk, interface);
+	return mlkem_gen_keys_hw(4, pk, sk, interface);
 
 }
 
-void mlkem_512_enc_hw(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface) {
+int mlkem_512_enc_hw(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface) {
 
-	mlkem_enc_hw(2, pk, ct, ss, interface);
+	return mlkem_enc_hw(2, pk, ct, ss, interface);
 
 }
-void mlkem_768_enc_hw(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface) {
+int mlkem_768_enc_hw(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface) {
 
-	mlkem_enc_hw(3, pk, ct, ss, interface);
+	return mlkem_enc_hw(3, pk, ct, ss, interface);
 
 }
-void mlkem_1024_enc_hw(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface) {
+int mlkem_1024_enc_hw(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface) {
 
-	mlkem_enc_hw(4, pk, ct, ss, interface);
+	return mlkem_enc_hw(4, pk, ct, ss, interface);
 
 }
 
-void mlkem_512_dec_hw(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface) {
+int mlkem_512_dec_hw(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface) {
 
-	mlkem_dec_hw(2, sk, ct, ss, result, interface);
+	return mlkem_dec_hw(2, sk, ct, ss, result, interface);
 	
 }
-void mlkem_768_dec_hw(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface) {
+int mlkem_768_dec_hw(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface) {
 	
-	mlkem_dec_hw(3, sk, ct, ss, result, interface);
+	return mlkem_dec_hw(3, sk, ct, ss, result, interface);
 
 }
-void mlkem_1024_dec_hw(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface) {
+int mlkem_1024_dec_hw(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface) {
 	
-	mlkem_dec_hw(4, sk, ct, ss, result, interface);
+	return mlkem_dec_hw(4, sk, ct, ss, result, interface);
+
+}
+
+int mlkem_512_enc_batch_hw(unsigned int n, unsigned char** pk, unsigned char** ct, unsigned char** ss, INTF* interface, unsigned int n_interface) {
+
+	return mlkem_enc_batch_hw(2, n, pk, ct, ss, interface, n_interface);
+
+}
+int mlkem_768_enc_batch_hw(unsigned int n, unsigned char** pk, unsigned char** ct, unsigned char** ss, INTF* interface, unsigned int n_interface) {
+
+	return mlkem_enc_batch_hw(3, n, pk, ct, ss, interface, n_interface);
+
+}
+int mlkem_1024_enc_batch_hw(unsigned int n, unsigned char** pk, unsigned char** ct, unsigned char** ss, INTF* interface, unsigned int n_interface) {
+
+	return mlkem_enc_batch_hw(4, n, pk, ct, ss, interface, n_interface);
+
+}
+
+int mlkem_512_dec_batch_hw(unsigned int n, unsigned char** sk, unsigned char** ct, unsigned char** ss, unsigned int* result, INTF* interface, unsigned int n_interface) {
+
+	return mlkem_dec_batch_hw(2, n, sk, ct, ss, result, interface, n_interface);
+
+}
+int mlkem_768_dec_batch_hw(unsigned int n, unsigned char** sk, unsigned char** ct, unsigned char** ss, unsigned int* result, INTF* interface, unsigned int n_interface) {
+
+	return mlkem_dec_batch_hw(3, n, sk, ct, ss, result, interface, n_interface);
+
+}
+int mlkem_1024_dec_batch_hw(unsigned int n, unsigned char** sk, unsigned char** ct, unsigned char** ss, unsigned int* result, INTF* interface, unsigned int n_interface) {
+
+	return mlkem_dec_batch_hw(4, n, sk, ct, ss, result, interface, n_interface);
+
+}
+
+//-- Output sizes for k (other values run as ML-KEM-512, like the drivers)
+static unsigned int mlkem_len_ek(int k) { return (k == 3 || k == 4) ? 384 * k + 32 : 800; }
+static unsigned int mlkem_len_dk(int k) { return (k == 3 || k == 4) ? 768 * k + 96 : 1632; }
+static unsigned int mlkem_len_ct(int k) { return (k == 4) ? 1568 : (k == 3) ? 1088 : 768; }
+
+//-- The blocking calls are admitted against the caller's deadline as k units
+int mlkem_gen_keys_hw(int k, unsigned char* pk, unsigned char* sk, INTF interface) {
+
+	int ret = SE_OK;
+
+	// -- a pair made ahead of time by the key pool (kpool_init)
+	if ((k == 2 || k == 3 || k == 4) && kpool_take(KPOOL_MLKEM512 + k - 2, pk, sk) == 0) return SE_OK;
+
+	if (intf_core_admit(interface, SE_CORE_MLKEM, k) != SE_OK) {
+		memset(pk, 0, mlkem_len_ek(k));
+		memset(sk, 0, mlkem_len_dk(k));
+		return SE_ERR_DEADLINE;
+	}
+
+	for (int t = 0; t <= SE_RETRY; t++) {
+		mlkem_gen_keys_hw_start(k, interface);
+		if (!intf_core_retry(interface, SE_CORE_MLKEM, ret = mlkem_gen_keys_hw_finish(k, pk, sk, interface))) break;
+	}
+
+	return ret;
+
+}
+
+//-- One read of END_OP after reselecting the core with the control word it was started with
+static unsigned long long int mlkem_end_op(unsigned long long int op_mode, INTF interface) {
+
+	unsigned long long int op = (unsigned long long int)ADD_MLKEM << 32 | ((op_mode | MLKEM_START) & 0xFFFFFFFF);
+	unsigned long long int end_op = 0;
+
+	write_INTF(interface, &op, CONTROL, sizeof(unsigned long long int));
+	read_INTF(interface, &end_op, END_OP, sizeof(unsigned long long int));
+
+	return end_op;
+
+}
+
+//-- Bounded wait for END_OP (up to the caller's deadline). A hung core is reset,
+//-- reported and released: SE_ERR_TIMEOUT or SE_ERR_DEADLINE is returned.
+static int mlkem_wait(unsigned long long int op_mode, unsigned long long int* end_op, INTF interface) {
+
+	// -- reselect: rewrite the control word the core was started with -- //
+	unsigned long long int op = (unsigned long long int)ADD_MLKEM << 32 | ((op_mode | MLKEM_START) & 0xFFFFFFFF);
+	unsigned long long int limit;
+	int ret;
+
+	*end_op = 0;
+	write_INTF(interface, &op, CONTROL, sizeof(unsigned long long int));
+
+	// wait END_OP
+	limit = intf_wait_limit(interface, MLKEM_WAIT_TIME);
+	do {
+		read_INTF(interface, end_op, END_OP, sizeof(unsigned long long int));
+	} while (!*end_op && intf_clock_ns() < limit);
+	if (*end_op) return SE_OK;
+
+	op = (unsigned long long int)ADD_MLKEM << 32 | ((op_mode | MLKEM_RESET) & 0xFFFFFFFF);
+	write_INTF(interface, &op, CONTROL, sizeof(unsigned long long int));
+	ret = intf_core_fault(interface, SE_CORE_MLKEM, SE_ERR_TIMEOUT);
+	intf_core_unlock(interface, SE_CORE_MLKEM);
+
+	if (ret == SE_ERR_TIMEOUT) printf("\n MLKEM FAIL!: TIMEOUT \t%d us\n", MLKEM_WAIT_TIME);
+
+	return ret;
 
 }
 
-void mlkem_gen_keys_hw(int k, unsigned char* pk, unsigned char* sk, INTF interface) {
+//-- Load and start only: the core computes while the caller drives another module (PARALLEL_CORES)
+void mlkem_gen_keys_hw_start(int k, INTF interface) {
+
+	// -- held until mlkem_gen_keys_hw_finish
+	intf_core_lock(interface, SE_CORE_MLKEM);
 
 	
 	uint8_t d[32]; unsigned long long int d64[4];
 	uint8_t z[32]; unsigned long long int z64[4];
-	randombytes(d, 32); memcpy(d64, d, 32);
-	randombytes(z, 32); memcpy(z64, z, 32);
+	mlkem_coins(d, 32, interface); memcpy(d64, d, 32);
+	mlkem_coins(z, 32, interface); memcpy(z64, z, 32);
 	
 
 	/*
@@ -173,7 +283,6 @@ void mlkem_gen_keys_hw(int k, unsigned char* pk, unsigned char* sk, INTF interfa
 	*/
 
 	unsigned long long int reg_addr;
-	unsigned long long int reg_data_out;
 	unsigned long long int reg_data_in;
 	
 	unsigned long long int op;
@@ -184,19 +293,6 @@ void mlkem_gen_keys_hw(int k, unsigned char* pk, unsigned char* sk, INTF interfa
 	else if (k == 4)		op_mode = MLKEM_GEN_KEYS_1024	<< 4; 
 	else					op_mode = MLKEM_GEN_KEYS_512	<< 4;
 
-	unsigned int LEN_EK;
-	unsigned int LEN_DK;
-
-	if (k == 2)			LEN_EK = 800;
-	else if (k == 3)	LEN_EK = 1184;
-	else if (k == 4)	LEN_EK = 1568;
-	else				LEN_EK = 800;
-
-	if (k == 2)			LEN_DK = 1632;
-	else if (k == 3)	LEN_DK = 2400;
-	else if (k == 4)	LEN_DK = 3168;
-	else				LEN_DK = 1632;
-
 	op = (unsigned long long int)ADD_MLKEM << 32 | ((op_mode | MLKEM_RESET) & 0xFFFFFFFF);
 	write_INTF(interface, &op, CONTROL, sizeof(unsigned long long int));
 
@@ -226,9 +322,57 @@ void mlkem_gen_keys_hw(int k, unsigned char* pk, unsigned char* sk, INTF interfa
 	op = (unsigned long long int)ADD_MLKEM << 32 | ((op_mode | MLKEM_START) & 0xFFFFFFFF); // START
 	write_INTF(interface, &op, CONTROL, sizeof(unsigned long long int));
 
-	unsigned long long int end_op = 0;
-	// wait END_OP
-	while (!end_op) read_INTF(interface, &end_op, END_OP, sizeof(unsigned long long int));
+}
+
+//-- Non-blocking: 1 once the started operation has finished (then call the _finish)
+int mlkem_gen_keys_hw_ready(int k, INTF interface) {
+
+	unsigned long long int op_mode;
+
+	if (k == 3)				op_mode = MLKEM_GEN_KEYS_768	<< 4;
+	else if (k == 4)		op_mode = MLKEM_GEN_KEYS_1024	<< 4;
+	else					op_mode = MLKEM_GEN_KEYS_512	<< 4;
+
+	return mlkem_end_op(op_mode, interface) != 0;
+
+}
+
+//-- Wait for a started key generation and read it back: SE_OK, or SE_ERR_TIMEOUT /
+//-- SE_ERR_DEADLINE with the core reset and the outputs wiped
+int mlkem_gen_keys_hw_finish(int k, unsigned char* pk, unsigned char* sk, INTF interface) {
+
+	unsigned long long int reg_addr;
+	unsigned long long int reg_data_out;
+	
+	unsigned long long int op;
+	unsigned long long int op_mode;
+
+	if (k == 2)				op_mode = MLKEM_GEN_KEYS_512	<< 4; 
+	else if (k == 3)		op_mode = MLKEM_GEN_KEYS_768	<< 4; 
+	else if (k == 4)		op_mode = MLKEM_GEN_KEYS_1024	<< 4; 
+	else					op_mode = MLKEM_GEN_KEYS_512	<< 4;
+
+	unsigned int LEN_EK;
+	unsigned int LEN_DK;
+
+	if (k == 2)			LEN_EK = 800;
+	else if (k == 3)	LEN_EK = 1184;
+	else if (k == 4)	LEN_EK = 1568;
+	else				LEN_EK = 800;
+
+	if (k == 2)			LEN_DK = 1632;
+	else if (k == 3)	LEN_DK = 2400;
+	else if (k == 4)	LEN_DK = 3168;
+	else				LEN_DK = 1632;
+
+	unsigned long long int end_op;
+	int ret = mlkem_wait(op_mode, &end_op, interface);
+
+	if (ret != SE_OK) {
+		memset(pk, 0, LEN_EK);
+		memset(sk, 0, LEN_DK);
+		return ret;
+	}
 
 	// read sk
 	op = (unsigned long long int)ADD_MLKEM << 32 | ((op_mode | MLKEM_READ_SK) & 0xFFFFFFFF);; // MLKEM_START
@@ -252,14 +396,40 @@ void mlkem_gen_keys_hw(int k, unsigned char* pk, unsigned char* sk, INTF interfa
 		memcpy(pk + 8 * i, &reg_data_out, 8);
 	}
 
+	intf_core_unlock(interface, SE_CORE_MLKEM);
+
+	return SE_OK;
 
 }
 
-void mlkem_enc_hw(int k, unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface) {
+int mlkem_enc_hw(int k, unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface) {
+
+	int ret = SE_OK;
+
+	if (intf_core_admit(interface, SE_CORE_MLKEM, k) != SE_OK) {
+		memset(ct, 0, mlkem_len_ct(k));
+		memset(ss, 0, 32);
+		return SE_ERR_DEADLINE;
+	}
+
+	for (int t = 0; t <= SE_RETRY; t++) {
+		mlkem_enc_hw_start(k, pk, interface);
+		if (!intf_core_retry(interface, SE_CORE_MLKEM, ret = mlkem_enc_hw_finish(k, ct, ss, interface))) break;
+	}
+
+	return ret;
+
+}
+
+//-- Load and start only: the core computes while the caller drives another module (PARALLEL_CORES)
+void mlkem_enc_hw_start(int k, unsigned char* pk, INTF interface) {
+
+	// -- held until mlkem_enc_hw_finish
+	intf_core_lock(interface, SE_CORE_MLKEM);
 
 	
 	uint8_t m[32]; unsigned long long int m64[4];
-	randombytes(m, 32); memcpy(m64, m, 32);
+	mlkem_coins(m, 32, interface); memcpy(m64, m, 32);
 	
 
 	/*
@@ -274,7 +444,6 @@ void mlkem_enc_hw(int k, unsigned char* pk, unsigned char* ct, unsigned char* ss
 	unsigned long long int op_mode;
 
 	unsigned long long int reg_addr;
-	unsigned long long int reg_data_out;
 	unsigned long long int reg_data_in;
 
 	if (k == 2)				op_mode = MLKEM_ENCAP_512		<< 4;
@@ -283,18 +452,12 @@ void mlkem_enc_hw(int k, unsigned char* pk, unsigned char* ct, unsigned char* ss
 	else					op_mode = MLKEM_ENCAP_512		<< 4;
 
 	unsigned int LEN_EK;
-	unsigned int LEN_CT;
 
 	if (k == 2)			LEN_EK = 800;
 	else if (k == 3)	LEN_EK = 1184;
 	else if (k == 4)	LEN_EK = 1568;
 	else				LEN_EK = 800;
 
-	if (k == 2)			LEN_CT = 768;
-	else if (k == 3)	LEN_CT = 1088;
-	else if (k == 4)	LEN_CT = 1568;
-	else				LEN_CT = 768;
-
 	op = (unsigned long long int)ADD_MLKEM << 32 | ((op_mode | MLKEM_RESET) & 0xFFFFFFFF); // MLKEM_RESET ON
 	write_INTF(interface, &op, CONTROL, sizeof(unsigned long long int));
 
@@ -336,9 +499,51 @@ void mlkem_enc_hw(int k, unsigned char* pk, unsigned char* ct, unsigned char* ss
 	op = (unsigned long long int)ADD_MLKEM << 32 | ((op_mode | MLKEM_START) & 0xFFFFFFFF); // MLKEM_START
 	write_INTF(interface, &op, CONTROL, sizeof(unsigned long long int));
 
-	unsigned long long int end_op = 0;
-	// wait END_OP
-	while (!end_op) read_INTF(interface, &end_op, END_OP, sizeof(unsigned long long int));
+}
+
+//-- Non-blocking: 1 once the started operation has finished (then call the _finish)
+int mlkem_enc_hw_ready(int k, INTF interface) {
+
+	unsigned long long int op_mode;
+
+	if (k == 3)				op_mode = MLKEM_ENCAP_768	<< 4;
+	else if (k == 4)		op_mode = MLKEM_ENCAP_1024	<< 4;
+	else					op_mode = MLKEM_ENCAP_512	<< 4;
+
+	return mlkem_end_op(op_mode, interface) != 0;
+
+}
+
+//-- Wait for a started encapsulation and read it back: SE_OK, or SE_ERR_TIMEOUT / SE_ERR_DEADLINE
+//-- with the core reset and the outputs wiped
+int mlkem_enc_hw_finish(int k, unsigned char* ct, unsigned char* ss, INTF interface) {
+
+	unsigned long long int op;
+	unsigned long long int op_mode;
+
+	unsigned long long int reg_addr;
+	unsigned long long int reg_data_out;
+
+	if (k == 2)				op_mode = MLKEM_ENCAP_512		<< 4;
+	else if (k == 3)		op_mode = MLKEM_ENCAP_768		<< 4;
+	else if (k == 4)		op_mode = MLKEM_ENCAP_1024		<< 4;
+	else					op_mode = MLKEM_ENCAP_512		<< 4;
+
+	unsigned int LEN_CT;
+
+	if (k == 2)			LEN_CT = 768;
+	else if (k == 3)	LEN_CT = 1088;
+	else if (k == 4)	LEN_CT = 1568;
+	else				LEN_CT = 768;
+
+	unsigned long long int end_op;
+	int ret = mlkem_wait(op_mode, &end_op, interface);
+
+	if (ret != SE_OK) {
+		memset(ct, 0, LEN_CT);
+		memset(ss, 0, 32);
+		return ret;
+	}
 
 	// read ct
 	op = (unsigned long long int)ADD_MLKEM << 32 | ((op_mode | MLKEM_READ_CT) & 0xFFFFFFFF);; // MLKEM_READ_CT
@@ -362,15 +567,41 @@ void mlkem_enc_hw(int k, unsigned char* pk, unsigned char* ct, unsigned char* ss
 		memcpy(ss + 8 * i, &reg_data_out, 8);
 	}
 
+	intf_core_unlock(interface, SE_CORE_MLKEM);
+
+	return SE_OK;
+
+}
+
+int mlkem_dec_hw(int k, unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface) {
+
+	int ret = SE_OK;
+
+	if (intf_core_admit(interface, SE_CORE_MLKEM, k) != SE_OK) {
+		memset(ss, 0, 32);
+		*result = 0;
+		return SE_ERR_DEADLINE;
+	}
+
+	for (int t = 0; t <= SE_RETRY; t++) {
+		mlkem_dec_hw_start(k, sk, ct, interface);
+		if (!intf_core_retry(interface, SE_CORE_MLKEM, ret = mlkem_dec_hw_finish(k, ss, result, interface))) break;
+	}
+
+	return ret;
+
 }
 
-void mlkem_dec_hw(int k, unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface) {
+//-- Load and start only: the core computes while the caller drives another module (PARALLEL_CORES)
+void mlkem_dec_hw_start(int k, unsigned char* sk, unsigned char* ct, INTF interface) {
+
+	// -- held until mlkem_dec_hw_finish
+	intf_core_lock(interface, SE_CORE_MLKEM);
 
 	unsigned long long int op;
 	unsigned long long int op_mode;
 
 	unsigned long long int reg_addr;
-	unsigned long long int reg_data_out;
 	unsigned long long int reg_data_in;
 
 	if (k == 2)				op_mode = MLKEM_DECAP_512 << 4;
@@ -473,9 +704,44 @@ void mlkem_dec_hw(int k, unsigned char* sk, unsigned char* ct, unsigned char* ss
 	op = (unsigned long long int)ADD_MLKEM << 32 | ((op_mode | MLKEM_START) & 0xFFFFFFFF);; // MLKEM_START
 	write_INTF(interface, &op, CONTROL, sizeof(unsigned long long int));
 
-	unsigned long long int end_op = 0;
-	// wait END_OP
-	while (!end_op) read_INTF(interface, &end_op, END_OP, sizeof(unsigned long long int));
+}
+
+//-- Non-blocking: 1 once the started operation has finished (then call the _finish)
+int mlkem_dec_hw_ready(int k, INTF interface) {
+
+	unsigned long long int op_mode;
+
+	if (k == 3)				op_mode = MLKEM_DECAP_768	<< 4;
+	else if (k == 4)		op_mode = MLKEM_DECAP_1024	<< 4;
+	else					op_mode = MLKEM_DECAP_512	<< 4;
+
+	return mlkem_end_op(op_mode, interface) != 0;
+
+}
+
+//-- Wait for a started decapsulation and read it back: SE_OK, or SE_ERR_TIMEOUT / SE_ERR_DEADLINE
+//-- with the core reset and the outputs wiped
+int mlkem_dec_hw_finish(int k, unsigned char* ss, unsigned int* result, INTF interface) {
+
+	unsigned long long int op;
+	unsigned long long int op_mode;
+
+	unsigned long long int reg_addr;
+	unsigned long long int reg_data_out;
+
+	if (k == 2)				op_mode = MLKEM_DECAP_512 << 4;
+	else if (k == 3)		op_mode = MLKEM_DECAP_768 << 4;
+	else if (k == 4)		op_mode = MLKEM_DECAP_1024 << 4;
+	else					op_mode = MLKEM_DECAP_512 << 4;
+
+	unsigned long long int end_op;
+	int ret = mlkem_wait(op_mode, &end_op, interface);
+
+	if (ret != SE_OK) {
+		memset(ss, 0, 32);
+		*result = 0;
+		return ret;
+	}
 
 	*result = end_op; // 01: bad result, 11: good result
 	
@@ -490,5 +756,180 @@ void mlkem_dec_hw(int k, unsigned char* sk, unsigned char* ct, unsigned char* ss
 		memcpy(ss + 8 * i, &reg_data_out, 8);
 	}
 
+	intf_core_unlock(interface, SE_CORE_MLKEM);
+
+	return SE_OK;
+
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// ENCAPSULATION-KEY HANDLES
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+void mlkem_ek_handle_init(mlkem_ek_handle* h, int k, const unsigned char* pk) {
+
+	unsigned int LEN_EK;
+
+	if (k == 2)			LEN_EK = 800;
+	else if (k == 3)	LEN_EK = 1184;
+	else if (k == 4)	LEN_EK = 1568;
+	else				LEN_EK = 800;
+
+	memset(h, 0, sizeof(mlkem_ek_handle));
+	h->k = k;
+	memcpy(h->pk, pk, LEN_EK);
+
+}
+
+void mlkem_ek_handle_clear(mlkem_ek_handle* h) {
+
+	memset(h, 0, sizeof(mlkem_ek_handle));
+
+}
+
+int mlkem_enc_hw_handle(mlkem_ek_handle* h, unsigned char* ct, unsigned char* ss, INTF interface) {
+
+	int ret = SE_OK;
+
+	if (intf_core_admit(interface, SE_CORE_MLKEM, h->k) != SE_OK) {
+		memset(ct, 0, mlkem_len_ct(h->k));
+		memset(ss, 0, 32);
+		return SE_ERR_DEADLINE;
+	}
+
+	for (int t = 0; t <= SE_RETRY; t++) {
+		mlkem_enc_hw_handle_start(h, interface);
+		if (!intf_core_retry(interface, SE_CORE_MLKEM, ret = mlkem_enc_hw_handle_finish(h, ct, ss, interface))) break;
+	}
+
+	return ret;
+
+}
+
+void mlkem_enc_hw_handle_start(mlkem_ek_handle* h, INTF interface) {
+
+	mlkem_enc_hw_start(h->k, h->pk, interface);
+
 }
 
+int mlkem_enc_hw_handle_finish(mlkem_ek_handle* h, unsigned char* ct, unsigned char* ss, INTF interface) {
+
+	return mlkem_enc_hw_finish(h->k, ct, ss, interface);
+
+}
+
+//-- A core holds one operation at a time (loading starts with MLKEM_RESET), so the
+//-- pipeline runs across devices: items are issued round-robin, item i + 1 is loaded
+//-- on the next device while item i computes, and item i is read back while the
+//-- following ones run. With a single device the items simply run back to back.
+//-- The batch holds the ML-KEM core of every device it uses from start to end,
+//-- taken in slot order (the order of se_ctx_of), so two batches given the same
+//-- devices in different orders never wait for each other. A device listed twice
+//-- is used once.
+
+//-- Devices in slot order without repeats, at most n: the count, 0 out of memory
+static unsigned int mlkem_batch_devices(unsigned int n, INTF* interface, unsigned int n_interface, INTF** dev) {
+
+	unsigned int n_dev = 0, j;
+	se_ctx* c;
+
+	*dev = malloc(n_interface * sizeof(INTF));
+	if (*dev == NULL) return 0;
+
+	for (unsigned int i = 0; i < n_interface && n_dev < n; i++) {
+		c = se_ctx_of(interface[i]);
+		for (j = 0; j < n_dev; j++) if (c != NULL && se_ctx_of((*dev)[j]) == c) break;
+		if (j < n_dev) continue;
+
+		// -- insertion by context address (untracked devices, not locked, first)
+		for (j = n_dev; j > 0 && (uintptr_t)se_ctx_of((*dev)[j - 1]) > (uintptr_t)c; j--) (*dev)[j] = (*dev)[j - 1];
+		(*dev)[j] = interface[i];
+		n_dev++;
+	}
+
+	for (unsigned int d = 0; d < n_dev; d++) intf_core_lock((*dev)[d], SE_CORE_MLKEM);
+
+	return n_dev;
+
+}
+
+static void mlkem_batch_release(unsigned int n_dev, INTF* dev) {
+
+	for (unsigned int d = n_dev; d-- > 0;) intf_core_unlock(dev[d], SE_CORE_MLKEM);
+	free(dev);
+
+}
+
+//-- SE_OK, or the first error: a faulted item runs again on its device (up to
+//-- SE_RETRY times) before that device takes the next item, and an item that
+//-- still fails is left wiped (result[i] = 0 for a decapsulation). SE_ERR_ARG,
+//-- with every item wiped, for no device or no memory.
+int mlkem_enc_batch_hw(int k, unsigned int n, unsigned char** pk, unsigned char** ct, unsigned char** ss, INTF* interface, unsigned int n_interface) {
+
+	unsigned int n_dev;
+	INTF* dev;
+	int ret = SE_OK, r;
+
+	if (n == 0) return SE_OK;
+
+	if (n_interface == 0 || (n_dev = mlkem_batch_devices(n, interface, n_interface, &dev)) == 0) {
+		for (unsigned int i = 0; i < n; i++) {
+			memset(ct[i], 0, mlkem_len_ct(k));
+			memset(ss[i], 0, 32);
+		}
+		return SE_ERR_ARG;
+	}
+
+	for (unsigned int i = 0; i < n_dev; i++) mlkem_enc_hw_start(k, pk[i], dev[i]);
+
+	for (unsigned int i = 0; i < n; i++) {
+		INTF d = dev[i % n_dev];
+		r = mlkem_enc_hw_finish(k, ct[i], ss[i], d);
+		for (int t = 0; t < SE_RETRY && intf_core_retry(d, SE_CORE_MLKEM, r); t++) {
+			mlkem_enc_hw_start(k, pk[i], d);
+			r = mlkem_enc_hw_finish(k, ct[i], ss[i], d);
+		}
+		if (ret == SE_OK) ret = r;
+		if (i + n_dev < n) mlkem_enc_hw_start(k, pk[i + n_dev], d);
+	}
+
+	mlkem_batch_release(n_dev, dev);
+
+	return ret;
+
+}
+
+int mlkem_dec_batch_hw(int k, unsigned int n, unsigned char** sk, unsigned char** ct, unsigned char** ss, unsigned int* result, INTF* interface, unsigned int n_interface) {
+
+	unsigned int n_dev;
+	INTF* dev;
+	int ret = SE_OK, r;
+
+	if (n == 0) return SE_OK;
+
+	if (n_interface == 0 || (n_dev = mlkem_batch_devices(n, interface, n_interface, &dev)) == 0) {
+		for (unsigned int i = 0; i < n; i++) {
+			memset(ss[i], 0, 32);
+			result[i] = 0;
+		}
+		return SE_ERR_ARG;
+	}
+
+	for (unsigned int i = 0; i < n_dev; i++) mlkem_dec_hw_start(k, sk[i], ct[i], dev[i]);
+
+	for (unsigned int i = 0; i < n; i++) {
+		INTF d = dev[i % n_dev];
+		r = mlkem_dec_hw_finish(k, ss[i], &result[i], d);
+		for (int t = 0; t < SE_RETRY && intf_core_retry(d, SE_CORE_MLKEM, r); t++) {
+			mlkem_dec_hw_start(k, sk[i], ct[i], d);
+			r = mlkem_dec_hw_finish(k, ss[i], &result[i], d);
+		}
+		if (ret == SE_OK) ret = r;
+		if (i + n_dev < n) mlkem_dec_hw_start(k, sk[i + n_dev], ct[i + n_dev], d);
+	}
+
+	mlkem_batch_release(n_dev, dev);
+
+	return ret;
+
+}
@@ -64,6 +64,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
 #include <math.h>
 #include "../common/intf.h"
 #include "../common/conf.h"
@@ -98,22 +99,69 @@
 #define MLKEM_DECAP_768		0x0e
 #define MLKEM_DECAP_1024	0x0f
 
+//-- Watchdog: longest wait (us) for a started operation before it is declared hung
+#ifdef I2C
+	#define MLKEM_WAIT_TIME		1000000
+#else
+	#define MLKEM_WAIT_TIME		100000
+#endif
+
 /************************ MS2XL Function Definitions **********************/
 
 /************************ Gen Keys Functions **********************/
-void mlkem_512_gen_keys_hw(unsigned char* pk, unsigned char* sk, INTF interface);
-void mlkem_768_gen_keys_hw(unsigned char* pk, unsigned char* sk, INTF interface);
-void mlkem_1024_gen_keys_hw(unsigned char* pk, unsigned char* sk, INTF interface);
-void mlkem_gen_keys_hw(int k, unsigned char* pk, unsigned char* sk, INTF interface);
+//-- The blocking calls return SE_OK, or the error of the last run (SE_ERR_TIMEOUT,
+//-- SE_ERR_CORE, SE_ERR_DEADLINE) with every output wiped.
+int mlkem_512_gen_keys_hw(unsigned char* pk, unsigned char* sk, INTF interface);
+int mlkem_768_gen_keys_hw(unsigned char* pk, unsigned char* sk, INTF interface);
+int mlkem_1024_gen_keys_hw(unsigned char* pk, unsigned char* sk, INTF interface);
+int mlkem_gen_keys_hw(int k, unsigned char* pk, unsigned char* sk, INTF interface);
+void mlkem_gen_keys_hw_start(int k, INTF interface);
+int mlkem_gen_keys_hw_ready(int k, INTF interface);
+int mlkem_gen_keys_hw_finish(int k, unsigned char* pk, unsigned char* sk, INTF interface);
 
 /************************ Encryption Functions **********************/
-void mlkem_512_enc_hw(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface);
-void mlkem_768_enc_hw(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface);
-void mlkem_1024_enc_hw(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface);
-void mlkem_enc_hw(int k, unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface);
+int mlkem_512_enc_hw(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface);
+int mlkem_768_enc_hw(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface);
+int mlkem_1024_enc_hw(unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface);
+int mlkem_enc_hw(int k, unsigned char* pk, unsigned char* ct, unsigned char* ss, INTF interface);
+void mlkem_enc_hw_start(int k, unsigned char* pk, INTF interface);
+int mlkem_enc_hw_ready(int k, INTF interface);
+int mlkem_enc_hw_finish(int k, unsigned char* ct, unsigned char* ss, INTF interface);
+/************************ Encapsulation-Key Handles **********************/
+//-- A handle keeps a copy of the encapsulation key; every encapsulation loads it
+#define MLKEM_EK_MAX_BYTES	1568
+
+typedef struct {
+	int k;
+	unsigned char pk[MLKEM_EK_MAX_BYTES];
+} mlkem_ek_handle;
+
+void mlkem_ek_handle_init(mlkem_ek_handle* h, int k, const unsigned char* pk);
+void mlkem_ek_handle_clear(mlkem_ek_handle* h);
+int mlkem_enc_hw_handle(mlkem_ek_handle* h, unsigned char* ct, unsigned char* ss, INTF interface);
+void mlkem_enc_hw_handle_start(mlkem_ek_handle* h, INTF interface);
+int mlkem_enc_hw_handle_finish(mlkem_ek_handle* h, unsigned char* ct, unsigned char* ss, INTF interface);
 /************************ Decryption Functions **********************/
-void mlkem_512_dec_hw(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface);
-void mlkem_768_dec_hw(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface);
-void mlkem_1024_dec_hw(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface);
-void mlkem_dec_hw(int k, unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface);
+int mlkem_512_dec_hw(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface);
+int mlkem_768_dec_hw(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface);
+int mlkem_1024_dec_hw(unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface);
+int mlkem_dec_hw(int k, unsigned char* sk, unsigned char* ct, unsigned char* ss, unsigned int* result, INTF interface);
+void mlkem_dec_hw_start(int k, unsigned char* sk, unsigned char* ct, INTF interface);
+int mlkem_dec_hw_ready(int k, INTF interface);
+int mlkem_dec_hw_finish(int k, unsigned char* ss, unsigned int* result, INTF interface);
+/************************ Batch Functions **********************/
+//-- pk/sk/ct/ss are arrays of n pointers (the same key may repeat); the items are
+//-- spread round-robin over the n_interface devices with transfers overlapping compute.
+//-- SE_OK, or the first error with the failed items wiped (see mlkem_enc_batch_hw).
+int mlkem_512_enc_batch_hw(unsigned int n, unsigned char** pk, unsigned char** ct, unsigned char** ss, INTF* interface, unsigned int n_interface);
+int mlkem_768_enc_batch_hw(unsigned int n, unsigned char** pk, unsigned char** ct, unsigned char** ss, INTF* interface, unsigned int n_interface);
+int mlkem_1024_enc_batch_hw(unsigned int n, unsigned char** pk, unsigned char** ct, unsigned char** ss, INTF* interface, unsigned int n_interface);
+int mlkem_enc_batch_hw(int k, unsigned int n, unsigned char** pk, unsigned char** ct, unsigned char** ss, INTF* interface, unsigned int n_interface);
+int mlkem_512_dec_batch_hw(unsigned int n, unsigned char** sk, unsigned char** ct, unsigned char** ss, unsigned int* result, INTF* interface, unsigned int n_interface);
+int mlkem_768_dec_batch_hw(unsigned int n, unsigned char** sk, unsigned char** ct, unsigned char** ss, unsigned int* result, INTF* interface, unsigned int n_interface);
+int mlkem_1024_dec_batch_hw(unsigned int n, unsigned char** sk, unsigned char** ct, unsigned char** ss, unsigned int* result, INTF* interface, unsigned int n_interface);
+int mlkem_dec_batch_hw(int k, unsigned int n, unsigned char** sk, unsigned char** ct, unsigned char** ss, unsigned int* result, INTF* interface, unsigned int n_interface);
+/************************ Randomness **********************/
+//-- Coins for the core and for the host path (mlkem_sw)
+void mlkem_randombytes(uint8_t* out, size_t outlen);
 #endif
\ No newline at end of file
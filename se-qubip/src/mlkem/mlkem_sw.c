@@ -0,0 +1,569 @@
+/**
+  * @file mlkem_sw.c
+  * @brief Host ML-KEM (FIPS 203)
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#include "mlkem_sw.h"
+#include "mlkem_hw.h"
+#include "../sha3/sha3_sw.h"
+
+#define MLKEM_QINV		-3327			// q^-1 mod 2^16
+#define MLKEM_MONT2		1353			// 2^32 mod q
+#define MLKEM_FINV		1441			// 2^32 / 128 mod q (inverse NTT scaling)
+
+typedef struct {
+	int16_t c[MLKEM_SW_N];
+} mlkem_poly;
+
+//-- 17^brv7(i) in Montgomery form, centered
+static const int16_t mlkem_zetas[128] = {
+	-1044, -758, -359, -1517, 1493, 1422, 287, 202, -171, 622, 1577, 182, 962, -1202, -1474, 1468,
+	573, -1325, 264, 383, -829, 1458, -1602, -130, -681, 1017, 732, 608, -1542, 411, -205, -1571,
+	1223, 652, -552, 1015, -1293, 1491, -282, -1544, 516, -8, -320, -666, -1618, -1162, 126, 1469,
+	-853, -90, -271, 830, 107, -1421, -247, -951, -398, 961, -1508, -725, 448, -1065, 677, -1275,
+	-1103, 430, 555, 843, -1251, 871, 1550, 105, 422, 587, 177, -235, -291, -460, 1574, 1653,
+	-246, 778, 1159, -147, -777, 1483, -602, 1119, -1590, 644, -872, 349, 418, 329, -156, -75,
+	817, 1097, 603, 610, 1322, -1285, -1465, 384, -1215, -136, 1218, -1335, -874, 220, -1187, -1659,
+	-1185, -1530, -1278, 794, -1510, -854, -870, 478, -108, -308, 996, 991, 958, -1460, 1522, 1628
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// ARITHMETIC
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- a * 2^-16 mod q for |a| < q * 2^15, result in (-q, q)
+static inline int16_t mlkem_montgomery_reduce(int32_t a)
+{
+	int16_t t = (int16_t)((int16_t)a * MLKEM_QINV);
+
+	return (int16_t)((a - (int32_t)t * MLKEM_SW_Q) >> 16);
+}
+
+//-- Centered representative of a mod q
+static inline int16_t mlkem_barrett_reduce(int16_t a)
+{
+	const int16_t v = ((1 << 26) + MLKEM_SW_Q / 2) / MLKEM_SW_Q;
+	int16_t t = (int16_t)(((int32_t)v * a + (1 << 25)) >> 26);
+
+	return a - t * MLKEM_SW_Q;
+}
+
+static inline int16_t mlkem_fqmul(int16_t a, int16_t b)
+{
+	return mlkem_montgomery_reduce((int32_t)a * b);
+}
+
+//-- Representative in [0, q) of a centered value
+static inline uint16_t mlkem_canonical(int16_t a)
+{
+	a += (a >> 15) & MLKEM_SW_Q;
+	return (uint16_t)a;
+}
+
+static void mlkem_poly_reduce(mlkem_poly* r)
+{
+	for (int i = 0; i < MLKEM_SW_N; i++) r->c[i] = mlkem_barrett_reduce(r->c[i]);
+}
+
+static void mlkem_poly_add(mlkem_poly* r, const mlkem_poly* a)
+{
+	for (int i = 0; i < MLKEM_SW_N; i++) r->c[i] += a->c[i];
+}
+
+static void mlkem_poly_tomont(mlkem_poly* r)
+{
+	for (int i = 0; i < MLKEM_SW_N; i++) r->c[i] = mlkem_montgomery_reduce((int32_t)r->c[i] * MLKEM_MONT2);
+}
+
+//-- Forward NTT, bit-reversed output, followed by a reduction
+static void mlkem_ntt(mlkem_poly* r)
+{
+	unsigned int k = 1;
+	int16_t t, zeta;
+
+	for (unsigned int len = 128; len >= 2; len >>= 1) {
+		for (unsigned int start = 0; start < MLKEM_SW_N; start += 2 * len) {
+			zeta = mlkem_zetas[k++];
+			for (unsigned int j = start; j < start + len; j++) {
+				t = mlkem_fqmul(zeta, r->c[j + len]);
+				r->c[j + len] = r->c[j] - t;
+				r->c[j] = r->c[j] + t;
+			}
+		}
+	}
+	mlkem_poly_reduce(r);
+}
+
+//-- Inverse NTT; also multiplies by 2^16, cancelling the 2^-16 of the base multiplication
+static void mlkem_invntt(mlkem_poly* r)
+{
+	unsigned int k = 127;
+	int16_t t, zeta;
+
+	for (unsigned int len = 2; len <= 128; len <<= 1) {
+		for (unsigned int start = 0; start < MLKEM_SW_N; start += 2 * len) {
+			zeta = mlkem_zetas[k--];
+			for (unsigned int j = start; j < start + len; j++) {
+				t = r->c[j];
+				r->c[j] = mlkem_barrett_reduce(t + r->c[j + len]);
+				r->c[j + len] = mlkem_fqmul(zeta, r->c[j + len] - t);
+			}
+		}
+	}
+	for (int j = 0; j < MLKEM_SW_N; j++) r->c[j] = mlkem_fqmul(r->c[j], MLKEM_FINV);
+}
+
+//-- r = sum_j a[j] o b[j] in the NTT domain (scaled by 2^-16), reduced
+static void mlkem_basemul_acc(mlkem_poly* r, const mlkem_poly* a, const mlkem_poly* b, int k)
+{
+	int16_t zeta, r0, r1;
+
+	memset(r, 0, sizeof(mlkem_poly));
+	for (int j = 0; j < k; j++) {
+		for (int i = 0; i < 64; i++) {
+			for (int h = 0; h < 2; h++) {
+				const int16_t* x = &a[j].c[4 * i + 2 * h];
+				const int16_t* y = &b[j].c[4 * i + 2 * h];
+				zeta = h ? -mlkem_zetas[64 + i] : mlkem_zetas[64 + i];
+				r0 = mlkem_fqmul(mlkem_fqmul(x[1], y[1]), zeta) + mlkem_fqmul(x[0], y[0]);
+				r1 = mlkem_fqmul(x[0], y[1]) + mlkem_fqmul(x[1], y[0]);
+				r->c[4 * i + 2 * h] += r0;
+				r->c[4 * i + 2 * h + 1] += r1;
+			}
+		}
+	}
+	mlkem_poly_reduce(r);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// ENCODING
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- ByteEncode_d / ByteDecode_d of 256 d-bit values, least significant bit first
+static void mlkem_pack(unsigned char* r, const uint16_t* a, unsigned int d)
+{
+	uint32_t acc = 0;
+	unsigned int bits = 0, p = 0;
+
+	for (int i = 0; i < MLKEM_SW_N; i++) {
+		acc |= (uint32_t)a[i] << bits;
+		bits += d;
+		while (bits >= 8) {
+			r[p++] = (unsigned char)acc;
+			acc >>= 8;
+			bits -= 8;
+		}
+	}
+}
+
+static void mlkem_unpack(uint16_t* a, const unsigned char* r, unsigned int d)
+{
+	uint32_t acc = 0;
+	unsigned int bits = 0, p = 0;
+
+	for (int i = 0; i < MLKEM_SW_N; i++) {
+		while (bits < d) {
+			acc |= (uint32_t)r[p++] << bits;
+			bits += 8;
+		}
+		a[i] = (uint16_t)(acc & ((1u << d) - 1));
+		acc >>= d;
+		bits -= d;
+	}
+}
+
+static void mlkem_poly_tobytes(unsigned char* r, const mlkem_poly* a)
+{
+	uint16_t t[MLKEM_SW_N];
+
+	for (int i = 0; i < MLKEM_SW_N; i++) t[i] = mlkem_canonical(a->c[i]);
+	mlkem_pack(r, t, 12);
+}
+
+static void mlkem_poly_frombytes(mlkem_poly* r, const unsigned char* a)
+{
+	uint16_t t[MLKEM_SW_N];
+
+	mlkem_unpack(t, a, 12);
+	for (int i = 0; i < MLKEM_SW_N; i++) r->c[i] = (int16_t)t[i];
+}
+
+//-- Compress_d then ByteEncode_d. The division is by a constant, so it compiles to a multiply.
+static void mlkem_poly_compress(unsigned char* r, const mlkem_poly* a, unsigned int d)
+{
+	uint16_t t[MLKEM_SW_N];
+
+	for (int i = 0; i < MLKEM_SW_N; i++)
+		t[i] = (uint16_t)(((((uint32_t)mlkem_canonical(a->c[i]) << d) + MLKEM_SW_Q / 2) / MLKEM_SW_Q) & ((1u << d) - 1));
+	mlkem_pack(r, t, d);
+}
+
+static void mlkem_poly_decompress(mlkem_poly* r, const unsigned char* a, unsigned int d)
+{
+	uint16_t t[MLKEM_SW_N];
+
+	mlkem_unpack(t, a, d);
+	for (int i = 0; i < MLKEM_SW_N; i++) r->c[i] = (int16_t)(((uint32_t)t[i] * MLKEM_SW_Q + (1u << (d - 1))) >> d);
+}
+
+static void mlkem_poly_frommsg(mlkem_poly* r, const unsigned char* m)
+{
+	for (int i = 0; i < 32; i++) {
+		for (int j = 0; j < 8; j++) {
+			int16_t mask = -(int16_t)((m[i] >> j) & 1);
+			r->c[8 * i + j] = mask & ((MLKEM_SW_Q + 1) / 2);
+		}
+	}
+}
+
+static void mlkem_poly_tomsg(unsigned char* m, const mlkem_poly* a)
+{
+	mlkem_poly_compress(m, a, 1);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// SAMPLING
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- Four SHAKE instances over inputs of the same length (< rate)
+static void mlkem_shake_x4_absorb(uint64_t s[25][4], unsigned int rate, unsigned char in[4][MLKEM_SW_SYMBYTES + 2], unsigned int length)
+{
+	memset(s, 0, 25 * 4 * sizeof(uint64_t));
+	for (int l = 0; l < 4; l++) {
+		for (unsigned int i = 0; i < length; i++) s[i >> 3][l] ^= (uint64_t)in[l][i] << (8 * (i & 7));
+		s[length >> 3][l] ^= (uint64_t)0x1F << (8 * (length & 7));
+		s[(rate - 1) >> 3][l] ^= (uint64_t)0x80 << 56;
+	}
+}
+
+static void mlkem_shake_x4_squeeze(uint64_t s[25][4], unsigned int rate, unsigned char* out[4])
+{
+	keccak_f1600_x4_sw(s);
+	for (int l = 0; l < 4; l++)
+		for (unsigned int i = 0; i < rate; i++) out[l][i] = (unsigned char)(s[i >> 3][l] >> (8 * (i & 7)));
+}
+
+//-- SampleNTT: two 12-bit candidates per 3 bytes, kept when below q
+static unsigned int mlkem_rej_uniform(int16_t* r, unsigned int ctr, const unsigned char* buf, unsigned int length)
+{
+	uint16_t v0, v1;
+
+	for (unsigned int p = 0; ctr < MLKEM_SW_N && p + 3 <= length; p += 3) {
+		v0 = (uint16_t)((buf[p] | ((uint16_t)buf[p + 1] << 8)) & 0xFFF);
+		v1 = (uint16_t)(((buf[p + 1] >> 4) | ((uint16_t)buf[p + 2] << 4)) & 0xFFF);
+		if (v0 < MLKEM_SW_Q)							r[ctr++] = (int16_t)v0;
+		if (ctr < MLKEM_SW_N && v1 < MLKEM_SW_Q)		r[ctr++] = (int16_t)v1;
+	}
+
+	return ctr;
+}
+
+//-- a[i*k + j] = A[i][j] = SampleNTT(rho || j || i); the transpose swaps the index bytes.
+//-- Entries are sampled four at a time; spare lanes repeat the first entry of the group.
+static void mlkem_gen_matrix(int k, mlkem_poly* a, const unsigned char* rho, int transposed)
+{
+	uint64_t s[25][4];
+	unsigned char in[4][MLKEM_SW_SYMBYTES + 2];
+	unsigned char buf[4][3 * SHA3_SW_RATE_128];
+	unsigned char* out[4];
+	unsigned int ctr[4], n = k * k, idx;
+	int more;
+
+	for (unsigned int e = 0; e < n; e += 4) {
+		for (int l = 0; l < 4; l++) {
+			idx = (e + l < n) ? e + l : e;
+			memcpy(in[l], rho, MLKEM_SW_SYMBYTES);
+			in[l][32] = (unsigned char)(transposed ? idx / k : idx % k);
+			in[l][33] = (unsigned char)(transposed ? idx % k : idx / k);
+		}
+		mlkem_shake_x4_absorb(s, SHA3_SW_RATE_128, in, MLKEM_SW_SYMBYTES + 2);
+		for (int b = 0; b < 3; b++) {
+			for (int l = 0; l < 4; l++) out[l] = buf[l] + b * SHA3_SW_RATE_128;
+			mlkem_shake_x4_squeeze(s, SHA3_SW_RATE_128, out);
+		}
+		for (int l = 0; l < 4; l++)
+			ctr[l] = (e + l < n) ? mlkem_rej_uniform(a[e + l].c, 0, buf[l], 3 * SHA3_SW_RATE_128) : MLKEM_SW_N;
+
+		// -- 504 bytes cover 256 coefficients with overwhelming probability
+		more = (ctr[0] < MLKEM_SW_N) | (ctr[1] < MLKEM_SW_N) | (ctr[2] < MLKEM_SW_N) | (ctr[3] < MLKEM_SW_N);
+		while (more) {
+			for (int l = 0; l < 4; l++) out[l] = buf[l];
+			mlkem_shake_x4_squeeze(s, SHA3_SW_RATE_128, out);
+			more = 0;
+			for (int l = 0; l < 4; l++) {
+				if (ctr[l] < MLKEM_SW_N) ctr[l] = mlkem_rej_uniform(a[e + l].c, ctr[l], buf[l], SHA3_SW_RATE_128);
+				more |= ctr[l] < MLKEM_SW_N;
+			}
+		}
+	}
+}
+
+//-- SamplePolyCBD_eta over 64 * eta bytes
+static void mlkem_cbd(mlkem_poly* r, const unsigned char* buf, unsigned int eta)
+{
+	uint32_t t, d;
+
+	if (eta == 2) {
+		for (int i = 0; i < MLKEM_SW_N / 8; i++) {
+			t = (uint32_t)buf[4 * i] | ((uint32_t)buf[4 * i + 1] << 8) | ((uint32_t)buf[4 * i + 2] << 16) | ((uint32_t)buf[4 * i + 3] << 24);
+			d = (t & 0x55555555) + ((t >> 1) & 0x55555555);
+			for (int j = 0; j < 8; j++) r->c[8 * i + j] = (int16_t)((d >> (4 * j)) & 3) - (int16_t)((d >> (4 * j + 2)) & 3);
+		}
+	}
+	else {
+		for (int i = 0; i < MLKEM_SW_N / 4; i++) {
+			t = (uint32_t)buf[3 * i] | ((uint32_t)buf[3 * i + 1] << 8) | ((uint32_t)buf[3 * i + 2] << 16);
+			d = (t & 0x00249249) + ((t >> 1) & 0x00249249) + ((t >> 2) & 0x00249249);
+			for (int j = 0; j < 4; j++) r->c[4 * i + j] = (int16_t)((d >> (6 * j)) & 7) - (int16_t)((d >> (6 * j + 3)) & 7);
+		}
+	}
+}
+
+//-- r[i] = CBD_eta(PRF_eta(seed, nonce + i)) for i < count, four PRF calls at a time
+static void mlkem_getnoise(mlkem_poly* r, unsigned int count, const unsigned char* seed, unsigned int nonce, unsigned int eta)
+{
+	uint64_t s[25][4];
+	unsigned char in[4][MLKEM_SW_SYMBYTES + 2];
+	unsigned char buf[4][2 * SHA3_SW_RATE_256];
+	unsigned char* out[4];
+
+	for (unsigned int g = 0; g < count; g += 4) {
+		for (int l = 0; l < 4; l++) {
+			memcpy(in[l], seed, MLKEM_SW_SYMBYTES);
+			in[l][32] = (unsigned char)(nonce + g + l);
+		}
+		mlkem_shake_x4_absorb(s, SHA3_SW_RATE_256, in, MLKEM_SW_SYMBYTES + 1);
+		for (unsigned int b = 0; b * SHA3_SW_RATE_256 < 64 * eta; b++) {
+			for (int l = 0; l < 4; l++) out[l] = buf[l] + b * SHA3_SW_RATE_256;
+			mlkem_shake_x4_squeeze(s, SHA3_SW_RATE_256, out);
+		}
+		for (unsigned int l = 0; l < 4 && g + l < count; l++) mlkem_cbd(&r[g + l], buf[l], eta);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// K-PKE
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static unsigned int mlkem_eta1(int k)	{ return (k == 2) ? 3 : 2; }
+static unsigned int mlkem_du(int k)		{ return (k == 4) ? 11 : 10; }
+static unsigned int mlkem_dv(int k)		{ return (k == 4) ? 5 : 4; }
+
+static void mlkem_pke_keygen(int k, const unsigned char* d, unsigned char* ek, unsigned char* dk)
+{
+	unsigned char in[MLKEM_SW_SYMBYTES + 1], seed[2 * MLKEM_SW_SYMBYTES];
+	mlkem_poly a[16], se[8], t;
+
+	// -- (rho, sigma) = G(d || k)
+	memcpy(in, d, MLKEM_SW_SYMBYTES);
+	in[MLKEM_SW_SYMBYTES] = (unsigned char)k;
+	sha3_512_sw(in, sizeof(in), seed);
+
+	mlkem_gen_matrix(k, a, seed, 0);
+	mlkem_getnoise(se, 2 * k, seed + MLKEM_SW_SYMBYTES, 0, mlkem_eta1(k));		// s || e
+	for (int i = 0; i < 2 * k; i++) mlkem_ntt(&se[i]);
+
+	for (int i = 0; i < k; i++) {
+		mlkem_basemul_acc(&t, &a[i * k], se, k);
+		mlkem_poly_tomont(&t);
+		mlkem_poly_add(&t, &se[k + i]);
+		mlkem_poly_reduce(&t);
+		mlkem_poly_tobytes(ek + 384 * i, &t);
+		mlkem_poly_tobytes(dk + 384 * i, &se[i]);
+	}
+	memcpy(ek + 384 * k, seed, MLKEM_SW_SYMBYTES);
+}
+
+static void mlkem_pke_enc(int k, const unsigned char* ek, const unsigned char* m, const unsigned char* r, unsigned char* ct)
+{
+	mlkem_poly at[16], tt[4], y[4], e[5], u, v, mu;
+	unsigned int du = mlkem_du(k), dv = mlkem_dv(k);
+
+	for (int i = 0; i < k; i++) mlkem_poly_frombytes(&tt[i], ek + 384 * i);
+	mlkem_gen_matrix(k, at, ek + 384 * k, 1);
+
+	mlkem_getnoise(y, k, r, 0, mlkem_eta1(k));
+	mlkem_getnoise(e, k + 1, r, k, 2);											// e1 || e2
+	for (int i = 0; i < k; i++) mlkem_ntt(&y[i]);
+
+	for (int i = 0; i < k; i++) {
+		mlkem_basemul_acc(&u, &at[i * k], y, k);
+		mlkem_invntt(&u);
+		mlkem_poly_add(&u, &e[i]);
+		mlkem_poly_reduce(&u);
+		mlkem_poly_compress(ct + 32 * du * i, &u, du);
+	}
+
+	mlkem_poly_frommsg(&mu, m);
+	mlkem_basemul_acc(&v, tt, y, k);
+	mlkem_invntt(&v);
+	mlkem_poly_add(&v, &e[k]);
+	mlkem_poly_add(&v, &mu);
+	mlkem_poly_reduce(&v);
+	mlkem_poly_compress(ct + 32 * du * k, &v, dv);
+}
+
+static void mlkem_pke_dec(int k, const unsigned char* dk, const unsigned char* ct, unsigned char* m)
+{
+	mlkem_poly u[4], s[4], v, w;
+	unsigned int du = mlkem_du(k), dv = mlkem_dv(k);
+
+	for (int i = 0; i < k; i++) {
+		mlkem_poly_decompress(&u[i], ct + 32 * du * i, du);
+		mlkem_ntt(&u[i]);
+		mlkem_poly_frombytes(&s[i], dk + 384 * i);
+	}
+	mlkem_poly_decompress(&v, ct + 32 * du * k, dv);
+
+	mlkem_basemul_acc(&w, s, u, k);
+	mlkem_invntt(&w);
+	for (int i = 0; i < MLKEM_SW_N; i++) w.c[i] = v.c[i] - w.c[i];
+	mlkem_poly_reduce(&w);
+	mlkem_poly_tomsg(m, &w);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// MAIN FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+void mlkem_gen_keys_sw_derand(int k, const unsigned char* d, const unsigned char* z, unsigned char* pk, unsigned char* sk)
+{
+	unsigned int len_pk = MLKEM_SW_PK_BYTES(k);
+
+	mlkem_pke_keygen(k, d, pk, sk);
+	memcpy(sk + 384 * k, pk, len_pk);
+	sha3_256_sw(pk, len_pk, sk + 384 * k + len_pk);
+	memcpy(sk + 384 * k + len_pk + MLKEM_SW_SYMBYTES, z, MLKEM_SW_SYMBYTES);
+}
+
+void mlkem_gen_keys_sw(int k, unsigned char* pk, unsigned char* sk)
+{
+	unsigned char dz[2 * MLKEM_SW_SYMBYTES];
+
+	mlkem_randombytes(dz, sizeof(dz));
+	mlkem_gen_keys_sw_derand(k, dz, dz + MLKEM_SW_SYMBYTES, pk, sk);
+	memset(dz, 0, sizeof(dz));
+}
+
+void mlkem_enc_sw_derand(int k, const unsigned char* pk, const unsigned char* m, unsigned char* ct, unsigned char* ss)
+{
+	unsigned char buf[2 * MLKEM_SW_SYMBYTES], kr[2 * MLKEM_SW_SYMBYTES];
+
+	// -- (K, r) = G(m || H(ek))
+	memcpy(buf, m, MLKEM_SW_SYMBYTES);
+	sha3_256_sw(pk, MLKEM_SW_PK_BYTES(k), buf + MLKEM_SW_SYMBYTES);
+	sha3_512_sw(buf, sizeof(buf), kr);
+
+	mlkem_pke_enc(k, pk, m, kr + MLKEM_SW_SYMBYTES, ct);
+	memcpy(ss, kr, MLKEM_SW_SYMBYTES);
+}
+
+void mlkem_enc_sw(int k, const unsigned char* pk, unsigned char* ct, unsigned char* ss)
+{
+	unsigned char m[MLKEM_SW_SYMBYTES];
+
+	mlkem_randombytes(m, sizeof(m));
+	mlkem_enc_sw_derand(k, pk, m, ct, ss);
+	memset(m, 0, sizeof(m));
+}
+
+void mlkem_dec_sw(int k, const unsigned char* sk, const unsigned char* ct, unsigned char* ss, unsigned int* result)
+{
+	unsigned char buf[2 * MLKEM_SW_SYMBYTES], kr[2 * MLKEM_SW_SYMBYTES], kbar[MLKEM_SW_SYMBYTES];
+	unsigned char cmp[1568];
+	unsigned int len_pk = MLKEM_SW_PK_BYTES(k), len_ct = MLKEM_SW_CT_BYTES(k);
+	const unsigned char* ek = sk + 384 * k;
+	const unsigned char* h = ek + len_pk;
+	const unsigned char* z = h + MLKEM_SW_SYMBYTES;
+	unsigned char diff = 0, mask;
+	sha3_sw_ctx ctx;
+
+	// -- m' = Dec(dk_pke, c), (K', r') = G(m' || h)
+	mlkem_pke_dec(k, sk, ct, buf);
+	memcpy(buf + MLKEM_SW_SYMBYTES, h, MLKEM_SW_SYMBYTES);
+	sha3_512_sw(buf, sizeof(buf), kr);
+
+	// -- K_bar = J(z || c)
+	sha3_sw_init(&ctx, SHA3_SW_RATE_256, 0x1F);
+	sha3_sw_absorb(&ctx, z, MLKEM_SW_SYMBYTES);
+	sha3_sw_absorb(&ctx, ct, len_ct);
+	sha3_sw_finalize(&ctx);
+	sha3_sw_squeeze(&ctx, kbar, MLKEM_SW_SYMBYTES);
+
+	// -- Re-encrypt and select without branching on the comparison
+	mlkem_pke_enc(k, ek, buf, kr + MLKEM_SW_SYMBYTES, cmp);
+	for (unsigned int i = 0; i < len_ct; i++) diff |= cmp[i] ^ ct[i];
+	mask = (unsigned char)(((uint32_t)diff - 1) >> 8);				// 0xFF when equal
+	for (int i = 0; i < MLKEM_SW_SYMBYTES; i++) ss[i] = (kr[i] & mask) | (kbar[i] & ~mask);
+
+	*result = 1 | (2 & mask);
+	memset(buf, 0, sizeof(buf));
+	memset(kr, 0, sizeof(kr));
+}
+
+void mlkem_512_gen_keys_sw(unsigned char* pk, unsigned char* sk)	{ mlkem_gen_keys_sw(2, pk, sk); }
+void mlkem_768_gen_keys_sw(unsigned char* pk, unsigned char* sk)	{ mlkem_gen_keys_sw(3, pk, sk); }
+void mlkem_1024_gen_keys_sw(unsigned char* pk, unsigned char* sk)	{ mlkem_gen_keys_sw(4, pk, sk); }
+
+void mlkem_512_enc_sw(const unsigned char* pk, unsigned char* ct, unsigned char* ss)	{ mlkem_enc_sw(2, pk, ct, ss); }
+void mlkem_768_enc_sw(const unsigned char* pk, unsigned char* ct, unsigned char* ss)	{ mlkem_enc_sw(3, pk, ct, ss); }
+void mlkem_1024_enc_sw(const unsigned char* pk, unsigned char* ct, unsigned char* ss)	{ mlkem_enc_sw(4, pk, ct, ss); }
+
+void mlkem_512_dec_sw(const unsigned char* sk, const unsigned char* ct, unsigned char* ss, unsigned int* result)		{ mlkem_dec_sw(2, sk, ct, ss, result); }
+void mlkem_768_dec_sw(const unsigned char* sk, const unsigned char* ct, unsigned char* ss, unsigned int* result)		{ mlkem_dec_sw(3, sk, ct, ss, result); }
+void mlkem_1024_dec_sw(const unsigned char* sk, const unsigned char* ct, unsigned char* ss, unsigned int* result)	{ mlkem_dec_sw(4, sk, ct, ss, result); }
@@ -0,0 +1,108 @@
+/**
+  * @file mlkem_sw.h
+  * @brief Host ML-KEM (FIPS 203) Header File
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef MLKEM_SW_H
+#define MLKEM_SW_H
+
+#include <stdint.h>
+#include <string.h>
+
+/************************ Host ML-KEM Constant Definitions **********************/
+
+#define MLKEM_SW_N				256
+#define MLKEM_SW_Q				3329
+#define MLKEM_SW_SYMBYTES		32
+
+//-- Same byte layout as the core: sk = dk_pke || ek || H(ek) || z
+#define MLKEM_SW_PK_BYTES(k)	(384 * (k) + 32)
+#define MLKEM_SW_SK_BYTES(k)	(768 * (k) + 96)
+#define MLKEM_SW_CT_BYTES(k)	((k) == 4 ? 1568 : 320 * (k) + 128)
+
+	//-- Host implementation of the ML-KEM core. It is the overflow capacity of
+	//-- the ML-KEM scheduler (mlkem_*_auto in dispatch) and the fallback when the
+	//-- core is unavailable; inputs and outputs are interchangeable with the _hw
+	//-- functions. The matrix and noise sampling run four SHAKE instances at once
+	//-- (keccak_f1600_x4_sw).
+
+	/************************ Gen Keys Functions **********************/
+	void mlkem_512_gen_keys_sw(unsigned char* pk, unsigned char* sk);
+	void mlkem_768_gen_keys_sw(unsigned char* pk, unsigned char* sk);
+	void mlkem_1024_gen_keys_sw(unsigned char* pk, unsigned char* sk);
+	void mlkem_gen_keys_sw(int k, unsigned char* pk, unsigned char* sk);
+	//-- Deterministic key generation from the 32-byte seeds d and z
+	void mlkem_gen_keys_sw_derand(int k, const unsigned char* d, const unsigned char* z, unsigned char* pk, unsigned char* sk);
+
+	/************************ Encryption Functions **********************/
+	void mlkem_512_enc_sw(const unsigned char* pk, unsigned char* ct, unsigned char* ss);
+	void mlkem_768_enc_sw(const unsigned char* pk, unsigned char* ct, unsigned char* ss);
+	void mlkem_1024_enc_sw(const unsigned char* pk, unsigned char* ct, unsigned char* ss);
+	void mlkem_enc_sw(int k, const unsigned char* pk, unsigned char* ct, unsigned char* ss);
+	//-- Deterministic encapsulation of the 32-byte message m
+	void mlkem_enc_sw_derand(int k, const unsigned char* pk, const unsigned char* m, unsigned char* ct, unsigned char* ss);
+
+	/************************ Decryption Functions **********************/
+	//-- *result follows the core: 3 when the re-encryption matches, 1 when the
+	//-- ciphertext was implicitly rejected (ss is then J(z || ct))
+	void mlkem_512_dec_sw(const unsigned char* sk, const unsigned char* ct, unsigned char* ss, unsigned int* result);
+	void mlkem_768_dec_sw(const unsigned char* sk, const unsigned char* ct, unsigned char* ss, unsigned int* result);
+	void mlkem_1024_dec_sw(const unsigned char* sk, const unsigned char* ct, unsigned char* ss, unsigned int* result);
+	void mlkem_dec_sw(int k, const unsigned char* sk, const unsigned char* ct, unsigned char* ss, unsigned int* result);
+
+#endif
@@ -0,0 +1,714 @@
+/**
+  * @file se_op.c
+  * @brief Non-blocking SE operations: submit / poll / result state machines
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#include "se_op.h"
+#include <errno.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
+
+#define SE_OP_MAX_DEV				16
+
+struct se_op_engine {
+	INTF interface;
+	int fd;
+	int stop;
+	pthread_t thread;
+	pthread_mutex_t lock;					// Queues and stop
+	pthread_cond_t cond;
+	se_op* sq;								// Posted, not yet picked up by the thread
+	se_op** sq_tail;
+	se_op* cq;								// Done, not yet reaped
+	se_op** cq_tail;
+};
+
+static pthread_mutex_t se_op_engine_lock = PTHREAD_MUTEX_INITIALIZER;		// ctx->engine
+
+//-- Per thread and device: cores with one of the thread's ops between LOAD and READ
+static __thread struct {
+	se_ctx* ctx;
+	unsigned int cores;
+} se_op_busy[SE_OP_MAX_DEV];
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// SET-UP FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static void se_op_clear(se_op* op, int kind, int core)
+{
+	memset(op, 0, sizeof(se_op));
+	op->kind = kind;
+	op->core = core;
+	op->state = SE_OP_IDLE;
+	op->status = SE_OP_ERR_STATE;
+}
+
+int se_op_x25519_genkeys(se_op* op, unsigned char* pri_key, unsigned char* pub_key)
+{
+	se_op_clear(op, SE_OP_KIND_X25519_GENKEYS, SE_CORE_X25519);
+	op->out[0] = pri_key;
+	op->out[1] = pub_key;
+
+	return SE_OP_OK;
+}
+
+int se_op_x25519_ss(se_op* op, const unsigned char* pub_key, const unsigned char* pri_key, unsigned char* shared_secret)
+{
+	se_op_clear(op, SE_OP_KIND_X25519_SS, SE_CORE_X25519);
+	op->in[0] = pub_key;
+	op->in[1] = pri_key;
+	op->out[0] = shared_secret;
+
+	return SE_OP_OK;
+}
+
+static int se_op_mlkem(se_op* op, int kind, int k)
+{
+	se_op_clear(op, kind, SE_CORE_MLKEM);
+	op->k = k;
+	if (k < 2 || k > 4) {
+		op->kind = 0;
+		return SE_OP_ERR_ARG;
+	}
+
+	return SE_OP_OK;
+}
+
+int se_op_mlkem_gen_keys(se_op* op, int k, unsigned char* pk, unsigned char* sk)
+{
+	int ret = se_op_mlkem(op, SE_OP_KIND_MLKEM_GENKEYS, k);
+
+	op->out[0] = pk;
+	op->out[1] = sk;
+
+	return ret;
+}
+
+int se_op_mlkem_enc(se_op* op, int k, const unsigned char* pk, unsigned char* ct, unsigned char* ss)
+{
+	int ret = se_op_mlkem(op, SE_OP_KIND_MLKEM_ENC, k);
+
+	op->in[0] = pk;
+	op->out[0] = ct;
+	op->out[1] = ss;
+
+	return ret;
+}
+
+int se_op_mlkem_dec(se_op* op, int k, const unsigned char* sk, const unsigned char* ct, unsigned char* ss, unsigned int* result)
+{
+	int ret = se_op_mlkem(op, SE_OP_KIND_MLKEM_DEC, k);
+
+	op->in[0] = sk;
+	op->in[1] = ct;
+	op->out[0] = ss;
+	op->result = result;
+
+	return ret;
+}
+
+int se_op_sha2(se_op* op, int version, const unsigned char* in, unsigned long long len, unsigned char* out)
+{
+	se_op_clear(op, SE_OP_KIND_SHA2, SE_CORE_SHA2);
+	op->version = version;
+	op->rate = (version == 1) ? 512 : 1024;
+	op->len = len * 8;
+	op->len_out = (version == 2) ? 384 : (version == 3) ? 512 : 256;
+	op->in[0] = in;
+	op->out[0] = out;
+	if (version < 1 || version > 4) {
+		op->kind = 0;
+		return SE_OP_ERR_ARG;
+	}
+
+	return SE_OP_OK;
+}
+
+int se_op_sha3(se_op* op, int version, const unsigned char* in, unsigned long long len, unsigned char* out, unsigned long long len_out)
+{
+	static const unsigned int rate[4] = { 1088, 576, 1344, 1088 };
+	static const unsigned int size[4] = { 256, 512, 128, 256 };
+
+	se_op_clear(op, SE_OP_KIND_SHA3, SE_CORE_SHA3);
+	op->version = version;
+	op->len = len * 8;
+	op->in[0] = in;
+	op->out[0] = out;
+	if (version < 1 || version > 4) {
+		op->kind = 0;
+		return SE_OP_ERR_ARG;
+	}
+	op->rate = rate[version - 1];
+	op->size = size[version - 1];
+	op->len_out = (version <= 2) ? op->size : len_out * 8;
+
+	return SE_OP_OK;
+}
+
+int se_op_run(se_op* op, int core, se_op_fn fn, void* arg)
+{
+	se_op_clear(op, SE_OP_KIND_RUN, core);
+	op->fn = fn;
+	op->arg = arg;
+	if (core < 0 || core >= SE_N_CORE || fn == NULL) {
+		op->kind = 0;
+		return SE_OP_ERR_ARG;
+	}
+
+	return SE_OP_OK;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// CORE ACCESS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static int se_op_slot(se_ctx* ctx)
+{
+	int free_slot = -1;
+
+	for (int i = 0; i < SE_OP_MAX_DEV; i++) {
+		if (se_op_busy[i].cores && se_op_busy[i].ctx == ctx) return i;
+		if (!se_op_busy[i].cores && free_slot < 0) free_slot = i;
+	}
+	if (free_slot >= 0) se_op_busy[free_slot].ctx = ctx;
+
+	return free_slot;
+}
+
+//-- A core the SE resets while unaddressed only runs alone; the others only
+//-- next to each other, one op per core
+static int se_op_may_start(unsigned int cores, int core)
+{
+	if (cores & (1U << core)) return 0;
+	if (!intf_core_shared(core)) return cores == 0;
+	for (int c = 0; c < SE_N_CORE; c++)
+		if (((cores >> c) & 1) && !intf_core_shared(c)) return 0;
+
+	return 1;
+}
+
+static int se_op_acquire(se_op* op)
+{
+	int i = se_op_slot(se_ctx_of(op->interface));
+
+	if (i < 0 || !se_op_may_start(se_op_busy[i].cores, op->core)) return -1;
+	if (intf_core_trylock(op->interface, op->core) != 0) return -1;
+	se_op_busy[i].cores |= 1U << op->core;
+
+	return 0;
+}
+
+static void se_op_release(se_op* op)
+{
+	se_ctx* ctx = se_ctx_of(op->interface);
+
+	intf_core_unlock(op->interface, op->core);
+	for (int i = 0; i < SE_OP_MAX_DEV; i++)
+		if (se_op_busy[i].cores && se_op_busy[i].ctx == ctx) se_op_busy[i].cores &= ~(1U << op->core);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// STATE MACHINE
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static unsigned long long se_op_units(const se_op* op)
+{
+	// -- as the blocking hash calls admit themselves: one unit per block
+	switch (op->kind) {
+	case SE_OP_KIND_SHA2:			return (op->len + 2 * 64 + op->rate) / op->rate;
+	case SE_OP_KIND_SHA3:			return op->len / op->rate + 1 + op->len_out / op->rate;
+	}
+
+	return (op->core == SE_CORE_MLKEM) ? (unsigned long long)op->k : 1;
+}
+
+static int se_op_status(int ret)
+{
+	return (ret == SE_OK) ? SE_OP_OK : (ret == SE_ERR_DEADLINE) ? SE_OP_ERR_DEADLINE : SE_OP_ERR_TIMEOUT;
+}
+
+//-- Absorbed blocks, the padded one included (the message length and its
+//-- padding for SHA-2, the padding byte for SHA-3)
+static unsigned long long se_op_hash_blocks(const se_op* op)
+{
+	if (op->kind == SE_OP_KIND_SHA2) return (op->len + op->rate / 8) / op->rate + 1;
+
+	return op->len / op->rate + 1;
+}
+
+//-- SHA-3 shake flag of block op->hb: 1 a squeeze, 2 a SHAKE output longer than the digest
+static int se_op_shake(const se_op* op)
+{
+	if (op->hb > se_op_hash_blocks(op)) return 1;
+
+	return (op->len_out > op->size) ? 2 : 0;
+}
+
+//-- Loads and starts the next block: past the padded one, the next squeeze
+static int se_op_hash_start(se_op* op)
+{
+	unsigned long long buffer_in[SHA3_MAX_BLOCK / 64];
+	unsigned long long hb_num = se_op_hash_blocks(op);
+	unsigned long long ind;
+	int ret;
+
+	op->hb++;
+	if (op->kind == SE_OP_KIND_SHA2) {
+		sha2_block_pack(buffer_in, op->in[0], op->len, op->hb, op->version);
+		ret = sha2_block_start(op->interface, buffer_in, op->version, 0);
+		op->limit = intf_wait_limit(op->interface, SHA2_WAIT_TIME);
+
+		return ret;
+	}
+
+	if (op->hb <= hb_num) {
+		ind = (op->hb - 1) * (op->rate / 8);
+		pack_block((unsigned char*)buffer_in, op->in[0] + ind, (ind < op->len / 8) ? op->len / 8 - ind : 0, op->rate / 8);
+	}
+	ret = sha3_shake_block_start(buffer_in, op->interface, (op->len % op->rate) / 8, op->hb >= hb_num, se_op_shake(op), op->version, op->rate, 0);
+	op->limit = intf_wait_limit(op->interface, SHA3_WAIT_TIME);
+
+	return ret;
+}
+
+//-- Ends the block the core was on and starts the next one: SE_OP_PENDING
+//-- until the output is complete
+static int se_op_hash_next(se_op* op)
+{
+	unsigned long long hb_num = se_op_hash_blocks(op);
+	unsigned long long bytes_out = (op->len_out + 7) / 8;
+	unsigned long long copy;
+	int ret;
+
+	if (op->kind == SE_OP_KIND_SHA2) {
+		ret = sha2_block_finish(op->interface, op->block, op->hb == hb_num, op->version, 0);
+		if (ret == SE_OK && op->hb == hb_num) {
+			sha2_block_digest(op->out[0], op->block, op->version);
+			return SE_OP_OK;
+		}
+	}
+	else {
+		ret = sha3_shake_block_finish(op->block, op->interface, op->hb >= hb_num, se_op_shake(op), op->version, op->size, op->rate, 0);
+		if (ret == SE_OK && op->hb >= hb_num) {
+			copy = (bytes_out - op->pos > op->rate / 8) ? op->rate / 8 : bytes_out - op->pos;
+			memcpy(op->out[0] + op->pos, op->block, copy);
+			op->pos += copy;
+			if (op->pos == bytes_out) return SE_OP_OK;
+		}
+	}
+	if (ret == SE_OK) ret = se_op_hash_start(op);
+
+	return (ret == SE_OK) ? SE_OP_PENDING : se_op_status(ret);
+}
+
+//-- LOAD: the split drivers take the core again (recursively) and keep it until their _finish
+static void se_op_load(se_op* op)
+{
+	int ret;
+
+	op->limit = intf_wait_limit(op->interface, (op->core == SE_CORE_X25519) ? X25519_WAIT_TIME : MLKEM_WAIT_TIME);
+
+	switch (op->kind) {
+	case SE_OP_KIND_RUN:
+		op->status = op->fn(op->arg, op->interface);
+		if (intf_status(op->interface) == SE_ERR_DEADLINE) op->status = SE_OP_ERR_DEADLINE;
+		break;
+	case SE_OP_KIND_X25519_GENKEYS:	x25519_genkeys_hw_start(op->out[0], op->interface);						break;
+	case SE_OP_KIND_X25519_SS:		x25519_ss_gen_hw_start(op->in[0], op->in[1], op->interface);				break;
+	case SE_OP_KIND_MLKEM_GENKEYS:	mlkem_gen_keys_hw_start(op->k, op->interface);							break;
+	case SE_OP_KIND_MLKEM_ENC:		mlkem_enc_hw_start(op->k, (unsigned char*)op->in[0], op->interface);		break;
+	case SE_OP_KIND_MLKEM_DEC:		mlkem_dec_hw_start(op->k, (unsigned char*)op->in[0], (unsigned char*)op->in[1], op->interface);	break;
+	case SE_OP_KIND_SHA2:
+	case SE_OP_KIND_SHA3:
+		op->hb = 0;
+		op->pos = 0;
+		if (op->kind == SE_OP_KIND_SHA2)	sha2_interface_init(op->interface, op->len, op->version, 0);
+		else								sha3_shake_interface_init(op->interface, op->version);
+		if ((ret = se_op_hash_start(op)) != SE_OK) op->status = se_op_status(ret);
+		break;
+	}
+}
+
+//-- WAIT: a single END_OP read. Past the blocking driver's budget (or the
+//-- deadline) the op goes on to its _finish, whose bounded wait resets a hung core.
+static int se_op_ready(se_op* op)
+{
+	if (op->status != SE_OP_PENDING || intf_clock_ns() >= op->limit) return 1;
+
+	switch (op->kind) {
+	case SE_OP_KIND_X25519_GENKEYS:
+	case SE_OP_KIND_X25519_SS:		return x25519_hw_ready(op->interface);
+	case SE_OP_KIND_MLKEM_GENKEYS:	return mlkem_gen_keys_hw_ready(op->k, op->interface);
+	case SE_OP_KIND_MLKEM_ENC:		return mlkem_enc_hw_ready(op->k, op->interface);
+	case SE_OP_KIND_MLKEM_DEC:		return mlkem_dec_hw_ready(op->k, op->interface);
+	case SE_OP_KIND_SHA2:			return sha2_block_ready(op->interface);
+	case SE_OP_KIND_SHA3:			return sha3_shake_block_ready(op->interface);
+	}
+
+	return 1;
+}
+
+static void se_op_read(se_op* op)
+{
+	unsigned int result;
+	int ret = SE_OK;
+
+	switch (op->kind) {
+	case SE_OP_KIND_RUN:			return;
+	case SE_OP_KIND_X25519_GENKEYS:	ret = x25519_hw_finish(op->out[1], op->interface);							break;
+	case SE_OP_KIND_X25519_SS:		ret = x25519_hw_finish(op->out[0], op->interface);							break;
+	case SE_OP_KIND_MLKEM_GENKEYS:	ret = mlkem_gen_keys_hw_finish(op->k, op->out[0], op->out[1], op->interface);	break;
+	case SE_OP_KIND_MLKEM_ENC:		ret = mlkem_enc_hw_finish(op->k, op->out[0], op->out[1], op->interface);		break;
+	case SE_OP_KIND_MLKEM_DEC:
+		ret = mlkem_dec_hw_finish(op->k, op->out[0], &result, op->interface);
+		if (op->result != NULL) *op->result = result;
+		break;
+	case SE_OP_KIND_SHA2:
+	case SE_OP_KIND_SHA3:
+		if (op->status == SE_OP_PENDING) op->status = se_op_hash_next(op);
+		if (op->status != SE_OP_OK && op->status != SE_OP_PENDING) memset(op->out[0], 0, (op->len_out + 7) / 8);
+		return;
+	}
+	op->status = se_op_status(ret);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// MAIN FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+int se_op_submit(se_op* op, INTF interface)
+{
+	if (op->kind == 0) return SE_OP_ERR_ARG;
+	if (op->state != SE_OP_IDLE && op->state != SE_OP_DONE) return SE_OP_ERR_STATE;
+
+	op->interface = interface;
+	op->deadline = intf_get_deadline(interface);
+	op->tries = 0;
+	op->status = SE_OP_PENDING;
+	op->state = SE_OP_QUEUED;
+
+	return SE_OP_OK;
+}
+
+static int se_op_step(se_op* op)
+{
+	switch (op->state) {
+	case SE_OP_QUEUED:
+		if (intf_deadline_passed(op->interface)) {
+			op->status = SE_OP_ERR_DEADLINE;
+			op->state = SE_OP_DONE;
+			break;
+		}
+		if (!intf_core_available(op->interface, op->core)) {
+			op->status = SE_OP_ERR_OPEN;
+			op->state = SE_OP_DONE;
+			break;
+		}
+		if (se_op_acquire(op) != 0) return SE_OP_PENDING;
+		op->state = SE_OP_LOAD;
+		// fall through
+	case SE_OP_LOAD:
+		// -- the blocking calls admit themselves; the split ones are admitted here
+		if (op->kind != SE_OP_KIND_RUN && intf_core_admit(op->interface, op->core, se_op_units(op)) != SE_OK) {
+			se_op_release(op);
+			op->status = SE_OP_ERR_DEADLINE;
+			op->state = SE_OP_DONE;
+			break;
+		}
+		se_op_load(op);
+		op->state = SE_OP_WAIT;
+		// fall through
+	case SE_OP_WAIT:
+		if (!se_op_ready(op)) return SE_OP_PENDING;
+		op->state = SE_OP_READ;
+		// fall through
+	case SE_OP_READ:
+		se_op_read(op);
+		// -- a hash op holds its core from block to block
+		if (op->status == SE_OP_PENDING) {
+			op->state = SE_OP_WAIT;
+			return SE_OP_PENDING;
+		}
+		se_op_release(op);
+		op->state = SE_OP_DONE;
+		// -- the core was reset: run the op again while its breaker stays closed
+		if (op->status == SE_OP_ERR_TIMEOUT && op->tries < SE_RETRY && intf_core_retry(op->interface, op->core, SE_ERR_TIMEOUT)) {
+			op->tries++;
+			op->status = SE_OP_PENDING;
+			op->state = SE_OP_QUEUED;
+		}
+	}
+
+	return op->status;
+}
+
+//-- Each step runs under the op's deadline, not the polling thread's
+int se_op_poll(se_op* op)
+{
+	unsigned long long deadline;
+	int ret;
+
+	if (op->state == SE_OP_IDLE || op->state == SE_OP_DONE) return op->status;
+
+	deadline = intf_get_deadline(op->interface);
+	intf_set_deadline(op->interface, op->deadline);
+	ret = se_op_step(op);
+	intf_set_deadline(op->interface, deadline);
+
+	return ret;
+}
+
+int se_op_result(const se_op* op)
+{
+	return op->status;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// COMPLETION THREAD
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static void se_op_kick(int fd)
+{
+	uint64_t one = 1;
+
+	while (write(fd, &one, sizeof(one)) < 0 && errno == EINTR);
+}
+
+static void se_op_drain_fd(int fd)
+{
+	uint64_t v;
+
+	while (read(fd, &v, sizeof(v)) < 0 && errno == EINTR);
+}
+
+//-- Polls its ops in posting order, so ops waiting for the same core start in that order
+static void* se_op_engine_run(void* arg)
+{
+	struct se_op_engine* e = arg;
+	se_op* run = NULL;
+	se_op** run_tail = &run;
+	se_op* done;
+	se_op** done_tail;
+	se_op** p;
+	int progress;
+
+	pthread_mutex_lock(&e->lock);
+	for (;;) {
+		if (e->sq != NULL) {
+			*run_tail = e->sq;
+			run_tail = e->sq_tail;
+			e->sq = NULL;
+			e->sq_tail = &e->sq;
+		}
+		if (run == NULL) {
+			if (e->stop) break;
+			pthread_cond_wait(&e->cond, &e->lock);
+			continue;
+		}
+		pthread_mutex_unlock(&e->lock);
+
+		done = NULL;
+		done_tail = &done;
+		progress = 0;
+		for (p = &run; *p != NULL; ) {
+			se_op* op = *p;
+			int state = op->state;
+			unsigned long long hb = op->hb;
+
+			if (se_op_poll(op) == SE_OP_PENDING) {
+				if (op->state != state || op->hb != hb) progress = 1;
+				p = &op->next;
+				continue;
+			}
+			*p = op->next;
+			op->next = NULL;
+			*done_tail = op;
+			done_tail = &op->next;
+		}
+		run_tail = &run;
+		while (*run_tail != NULL) run_tail = &(*run_tail)->next;
+
+		pthread_mutex_lock(&e->lock);
+		if (done != NULL) {
+			*e->cq_tail = done;
+			e->cq_tail = done_tail;
+			se_op_kick(e->fd);
+		}
+		else if (!progress) {
+			pthread_mutex_unlock(&e->lock);
+			usleep(SE_OP_POLL_US);
+			pthread_mutex_lock(&e->lock);
+		}
+	}
+	pthread_mutex_unlock(&e->lock);
+
+	return NULL;
+}
+
+//-- The device's engine, started on first use
+static struct se_op_engine* se_op_engine(se_ctx* ctx)
+{
+	struct se_op_engine* e;
+
+	if (ctx == NULL) return NULL;
+	if ((e = __atomic_load_n(&ctx->engine, __ATOMIC_ACQUIRE)) != NULL) return e;
+
+	pthread_mutex_lock(&se_op_engine_lock);
+	if ((e = ctx->engine) == NULL && (e = calloc(1, sizeof(struct se_op_engine))) != NULL) {
+		e->interface = se_intf(ctx);
+		e->sq_tail = &e->sq;
+		e->cq_tail = &e->cq;
+		pthread_mutex_init(&e->lock, NULL);
+		pthread_cond_init(&e->cond, NULL);
+		if ((e->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+			free(e);
+			e = NULL;
+		}
+		else if (pthread_create(&e->thread, NULL, se_op_engine_run, e) != 0) {
+			close(e->fd);
+			free(e);
+			e = NULL;
+		}
+		else __atomic_store_n(&ctx->engine, e, __ATOMIC_RELEASE);
+	}
+	pthread_mutex_unlock(&se_op_engine_lock);
+
+	return e;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// COMPLETION FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+int se_op_post(se_ctx* ctx, se_op* op, unsigned long long cookie)
+{
+	struct se_op_engine* e;
+	int ret;
+
+	if (op->kind == 0) return SE_OP_ERR_ARG;
+	if ((e = se_op_engine(ctx)) == NULL) return SE_OP_ERR_SYS;
+
+	pthread_mutex_lock(&e->lock);
+	if ((ret = se_op_submit(op, e->interface)) == SE_OP_OK) {
+		op->cookie = cookie;
+		op->next = NULL;
+		*e->sq_tail = op;
+		e->sq_tail = &op->next;
+		pthread_cond_signal(&e->cond);
+	}
+	pthread_mutex_unlock(&e->lock);
+
+	return ret;
+}
+
+int se_op_fd(se_ctx* ctx)
+{
+	struct se_op_engine* e = se_op_engine(ctx);
+
+	return (e != NULL) ? e->fd : -1;
+}
+
+int se_op_reap(se_ctx* ctx, se_op_cqe* cqe, unsigned int max)
+{
+	struct se_op_engine* e = (ctx != NULL) ? __atomic_load_n(&ctx->engine, __ATOMIC_ACQUIRE) : NULL;
+	unsigned int n = 0;
+
+	if (e == NULL) return 0;
+
+	pthread_mutex_lock(&e->lock);
+	while (n < max && e->cq != NULL) {
+		se_op* op = e->cq;
+
+		e->cq = op->next;
+		op->next = NULL;
+		cqe[n].cookie = op->cookie;
+		cqe[n].status = op->status;
+		cqe[n].op = op;
+		n++;
+	}
+	if (e->cq == NULL) {
+		e->cq_tail = &e->cq;
+		se_op_drain_fd(e->fd);
+	}
+	pthread_mutex_unlock(&e->lock);
+
+	return (int)n;
+}
+
+void se_op_stop(se_ctx* ctx)
+{
+	struct se_op_engine* e;
+
+	if (ctx == NULL) return;
+
+	pthread_mutex_lock(&se_op_engine_lock);
+	if ((e = ctx->engine) != NULL) {
+		pthread_mutex_lock(&e->lock);
+		e->stop = 1;
+		pthread_cond_signal(&e->cond);
+		pthread_mutex_unlock(&e->lock);
+		pthread_join(e->thread, NULL);
+		__atomic_store_n(&ctx->engine, NULL, __ATOMIC_RELEASE);
+		close(e->fd);
+		pthread_mutex_destroy(&e->lock);
+		pthread_cond_destroy(&e->cond);
+		free(e);
+	}
+	pthread_mutex_unlock(&se_op_engine_lock);
+}
@@ -0,0 +1,206 @@
+/**
+  * @file se_op.h
+  * @brief Non-blocking SE operations: submit / poll / result state machines
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef SE_OP_H
+#define SE_OP_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "../common/intf.h"
+#include "../common/conf.h"
+#include "../x25519/x25519_hw.h"
+#include "../mlkem/mlkem_hw.h"
+#include "../sha2/sha2_hw.h"
+#include "../sha3/sha3_shake_hw.h"
+
+/************************ Op Constant Definitions **********************/
+
+//-- Status (se_op_poll / se_op_result)
+#define SE_OP_OK					0
+#define SE_OP_PENDING				1		// Queued or running
+#define SE_OP_ERR_ARG				-1		// Bad parameter set or core
+#define SE_OP_ERR_STATE				-2		// Not set up, or submitted while in flight
+#define SE_OP_ERR_SYS				-3		// No completion thread / eventfd
+#define SE_OP_ERR_TIMEOUT			-4		// The core hung and was reset (outputs wiped)
+#define SE_OP_ERR_OPEN				-5		// The core's circuit breaker is open
+#define SE_OP_ERR_DEADLINE			-6		// Refused or stopped at its deadline (outputs wiped)
+
+//-- States
+#define SE_OP_IDLE					0		// Set up, not submitted
+#define SE_OP_QUEUED				1		// Waiting for its core
+#define SE_OP_LOAD					2		// Core held: inputs written, operation started
+#define SE_OP_WAIT					3		// Core computing
+#define SE_OP_READ					4		// Results read, core released
+#define SE_OP_DONE					5
+
+//-- Kinds
+#define SE_OP_KIND_RUN				1
+#define SE_OP_KIND_X25519_GENKEYS	2
+#define SE_OP_KIND_X25519_SS		3
+#define SE_OP_KIND_MLKEM_GENKEYS	4
+#define SE_OP_KIND_MLKEM_ENC		5
+#define SE_OP_KIND_MLKEM_DEC		6
+#define SE_OP_KIND_SHA2				7
+#define SE_OP_KIND_SHA3				8		// SHA3-256 / SHA3-512 / SHAKE-128 / SHAKE-256
+
+#define SE_OP_POLL_US				20		// Completion thread: back-off while every op is waiting
+
+	//-- Whole driver call for SE_OP_KIND_RUN: 0 or a negative error
+	typedef int (*se_op_fn)(void* arg, INTF interface);
+
+	//-- Caller-owned; the buffers it points to must stay valid until the op is done
+	typedef struct se_op {
+		int kind;
+		int state;
+		int status;
+		int core;
+		int k;								// ML-KEM parameter set
+		unsigned long long limit;			// Past it the current run goes on to its _finish
+		unsigned long long deadline;		// Absolute CLOCK_MONOTONIC ns, 0: none
+		unsigned int tries;					// Runs after a watchdog reset
+		INTF interface;
+		const unsigned char* in[2];
+		unsigned char* out[2];
+		unsigned int* result;				// ML-KEM decapsulation (may be NULL)
+		int version;						// Hash: the driver's VERSION
+		unsigned int rate;					// Hash: block size (bits)
+		unsigned int size;					// SHA-3: digest size (bits)
+		unsigned long long len;				// Hash: message (bits)
+		unsigned long long len_out;			// Hash: output (bits)
+		unsigned long long hb;				// Hash: blocks started, squeezes included
+		unsigned long long pos;				// SHA-3 / SHAKE: output bytes written
+		unsigned long long block[SHA3_MAX_BLOCK / 64];	// Hash: output words of the last block
+		se_op_fn fn;
+		void* arg;
+		unsigned long long cookie;			// The caller's, returned by se_op_reap
+		struct se_op* next;					// Completion queue link
+	} se_op;
+
+	//-- One completion
+	typedef struct {
+		unsigned long long cookie;
+		int status;
+		se_op* op;
+	} se_op_cqe;
+
+	/************************ Set-up Functions **********************/
+
+	//-- Each fills in an op to be submitted (and resubmitted once done) later
+	int se_op_x25519_genkeys(se_op* op, unsigned char* pri_key, unsigned char* pub_key);
+	int se_op_x25519_ss(se_op* op, const unsigned char* pub_key, const unsigned char* pri_key, unsigned char* shared_secret);
+	int se_op_mlkem_gen_keys(se_op* op, int k, unsigned char* pk, unsigned char* sk);
+	int se_op_mlkem_enc(se_op* op, int k, const unsigned char* pk, unsigned char* ct, unsigned char* ss);
+	int se_op_mlkem_dec(se_op* op, int k, const unsigned char* sk, const unsigned char* ct, unsigned char* ss, unsigned int* result);
+	//-- version as in sha2_hw (1: SHA-256, 2: SHA-384, 3: SHA-512, 4: SHA-512/256)
+	//-- and sha3_shake_hw (1: SHA3-256, 2: SHA3-512, 3: SHAKE-128, 4: SHAKE-256);
+	//-- len and len_out (SHAKE only) in bytes. One block per poll step.
+	int se_op_sha2(se_op* op, int version, const unsigned char* in, unsigned long long len, unsigned char* out);
+	int se_op_sha3(se_op* op, int version, const unsigned char* in, unsigned long long len, unsigned char* out, unsigned long long len_out);
+	//-- Any other driver call: fn(arg, interface) runs in a single poll step
+	//-- (AES, EdDSA, the TRNG and whole protocol calls block that step to the end)
+	int se_op_run(se_op* op, int core, se_op_fn fn, void* arg);
+
+	/************************ Main Functions **********************/
+
+	//-- se_op_submit queues the op without touching the device. Each
+	//-- se_op_poll advances it as far as it goes without waiting: it takes the
+	//-- core with intf_core_trylock, loads and starts the operation, reads
+	//-- END_OP once, and reads the results and frees the core once the core has
+	//-- finished (a hash op goes back to waiting for each further block it
+	//-- absorbs or squeezes). It returns SE_OP_PENDING until then and the
+	//-- final status after. One thread can keep ops in flight on several cores and devices
+	//-- and poll whichever it likes; the cores the SE resets while unaddressed
+	//-- are started only when no other op of the thread is running on that
+	//-- device. Once started, an op holds its core until done: poll it from
+	//-- the thread that started it, and don't call blocking drivers on that
+	//-- device from there in between. An op whose core hangs gets to the
+	//-- driver's bounded wait once the blocking call's *_WAIT_TIME has gone by;
+	//-- the core is reset and the op requeued up to SE_RETRY times
+	//-- (SE_OP_ERR_TIMEOUT after that). Ops queued for a core whose circuit
+	//-- breaker is open end with SE_OP_ERR_OPEN, for the caller to route them
+	//-- to another device. se_op_submit takes the submitting thread's
+	//-- intf_set_deadline, which holds for the op wherever it is polled: an op
+	//-- still queued at its deadline, refused at LOAD or cut short while
+	//-- running ends with SE_OP_ERR_DEADLINE.
+	int se_op_submit(se_op* op, INTF interface);
+	int se_op_poll(se_op* op);
+	int se_op_result(const se_op* op);
+
+	/************************ Completion Functions **********************/
+
+	//-- se_op_post hands an op to the device's completion thread, started on
+	//-- first use, which polls every posted op in turn (backing off
+	//-- SE_OP_POLL_US while all of them wait for their cores). se_op_fd returns
+	//-- an eventfd that is readable while completed ops wait to be reaped, for
+	//-- epoll / poll / select; se_op_reap takes up to max of them, with the
+	//-- cookie they were posted with, and clears the fd once none is left. A
+	//-- posted op belongs to the thread until reaped: don't poll it. se_op_stop,
+	//-- once nothing posts any more, waits for the posted ops, stops the thread
+	//-- and closes the fd (ops not yet reaped stay readable through
+	//-- se_op_result). se_op_post returns
+	//-- SE_OP_ERR_SYS and se_op_fd -1 if the thread or eventfd cannot be set up.
+	int se_op_post(se_ctx* ctx, se_op* op, unsigned long long cookie);
+	int se_op_fd(se_ctx* ctx);
+	int se_op_reap(se_ctx* ctx, se_op_cqe* cqe, unsigned int max);
+	void se_op_stop(se_ctx* ctx);
+
+#endif
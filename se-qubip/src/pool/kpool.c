@@ -0,0 +1,343 @@
+/**
+  * @file kpool.c
+  * @brief Precomputed ephemeral key-pair pools (X25519 / ML-KEM)
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#include "kpool.h"
+
+typedef struct {
+	unsigned int len_a, len_b;			// x25519: pri, pub / ML-KEM: pk, sk
+	unsigned int depth, head, count;
+	unsigned char* slot;				// depth * (len_a + len_b)
+	kpool_stat st;
+} kpool_ring;
+
+//-- depth is 0 (no ring) until kpool_init
+static kpool_ring kpool[KPOOL_N_KIND] = {
+	{ .len_a = 32,   .len_b = 32,   .depth = 0 },
+	{ .len_a = 800,  .len_b = 1632, .depth = 0 },
+	{ .len_a = 1184, .len_b = 2400, .depth = 0 },
+	{ .len_a = 1568, .len_b = 3168, .depth = 0 }
+};
+
+static INTF kpool_interface;
+static int kpool_running = 0;
+static int kpool_stop = 0;
+static int kpool_forked = 0;			// Child of a fork: the filler is started again on demand
+static __thread int kpool_filling = 0;	// The filler's own calls generate on the SE
+static pthread_t kpool_thread;
+static pthread_mutex_t kpool_mutex = PTHREAD_MUTEX_INITIALIZER;		// Rings and stats
+static pthread_cond_t kpool_cond = PTHREAD_COND_INITIALIZER;
+static pthread_once_t kpool_once = PTHREAD_ONCE_INIT;
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// DEVICE ACCESS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- Every core of the pool's SE, in the nesting order of intf_core_lock
+void kpool_lock()
+{
+	intf_core_lock(kpool_interface, SE_CORE_MLKEM);
+	intf_core_lock(kpool_interface, SE_CORE_X25519);
+	for (int c = 0; c < SE_N_CORE; c++) intf_core_lock(kpool_interface, c);
+}
+
+void kpool_unlock()
+{
+	for (int c = 0; c < SE_N_CORE; c++) intf_core_unlock(kpool_interface, c);
+	intf_core_unlock(kpool_interface, SE_CORE_X25519);
+	intf_core_unlock(kpool_interface, SE_CORE_MLKEM);
+}
+
+static int kpool_core(int kind)
+{
+	return (kind == KPOOL_X25519) ? SE_CORE_X25519 : SE_CORE_MLKEM;
+}
+
+static int kpool_generate(int kind, unsigned char* a, unsigned char* b, INTF interface)
+{
+	switch (kind) {
+	case KPOOL_X25519:		return x25519_genkeys_hw_buf(a, b, interface);
+	case KPOOL_MLKEM512:	return mlkem_512_gen_keys_hw(a, b, interface);
+	case KPOOL_MLKEM768:	return mlkem_768_gen_keys_hw(a, b, interface);
+	default:				return mlkem_1024_gen_keys_hw(a, b, interface);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// FILLER
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- Kind with the lowest fill ratio, -1 when every ring is at its high-water mark
+static int kpool_neediest()
+{
+	int kind = -1;
+
+	for (int k = 0; k < KPOOL_N_KIND; k++) {
+		if (kpool[k].count >= kpool[k].depth) continue;
+		if (kind < 0 || (unsigned long long)kpool[k].count * kpool[kind].depth < (unsigned long long)kpool[kind].count * kpool[k].depth) kind = k;
+	}
+
+	return kind;
+}
+
+static void* kpool_filler(void* arg)
+{
+	unsigned char a[3168], b[3168];
+	int kind, ret;
+
+	(void)arg;
+
+	kpool_filling = 1;
+
+	pthread_mutex_lock(&kpool_mutex);
+	while (!kpool_stop) {
+		if ((kind = kpool_neediest()) < 0) {
+			pthread_cond_wait(&kpool_cond, &kpool_mutex);
+			continue;
+		}
+		pthread_mutex_unlock(&kpool_mutex);
+
+		// -- only idle core time: back off while a foreground call waits or runs
+		if (intf_core_trylock(kpool_interface, kpool_core(kind)) != 0) {
+			usleep(KPOOL_BUSY_WAIT_US);
+			pthread_mutex_lock(&kpool_mutex);
+			continue;
+		}
+		ret = kpool_generate(kind, a, b, kpool_interface);
+		intf_core_unlock(kpool_interface, kpool_core(kind));
+
+		// -- a failed run left wiped outputs: drop them and give the core a rest
+		if (ret != SE_OK) usleep(KPOOL_BUSY_WAIT_US);
+
+		pthread_mutex_lock(&kpool_mutex);
+		kpool_ring* r = &kpool[kind];
+		if (ret != SE_OK) {
+			r->st.failed++;
+		}
+		else if (r->count < r->depth) {
+			unsigned char* s = r->slot + (unsigned long long)((r->head + r->count) % r->depth) * (r->len_a + r->len_b);
+			memcpy(s, a, r->len_a);
+			memcpy(s + r->len_a, b, r->len_b);
+			r->count++;
+			r->st.generated++;
+		}
+		memset(a, 0, sizeof(a));
+		memset(b, 0, sizeof(b));
+	}
+	pthread_mutex_unlock(&kpool_mutex);
+
+	return NULL;
+}
+
+//-- The child of a fork gets a copy of the rings: the parent hands the same key
+//-- pairs out, so the child wipes them and refills on its own first request.
+static void kpool_atfork_child()
+{
+	for (int k = 0; k < KPOOL_N_KIND; k++) {
+		kpool_ring* r = &kpool[k];
+		if (r->slot != NULL) memset(r->slot, 0, (unsigned long long)r->depth * (r->len_a + r->len_b));
+		r->head = 0;
+		r->count = 0;
+	}
+	kpool_forked = kpool_running;
+	pthread_mutex_init(&kpool_mutex, NULL);
+	pthread_cond_init(&kpool_cond, NULL);
+}
+
+static void kpool_atfork()
+{
+	pthread_atfork(NULL, NULL, kpool_atfork_child);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// CONTROL FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+int kpool_init(INTF interface, const unsigned int* depth)
+{
+	kpool_free();
+	pthread_once(&kpool_once, kpool_atfork);
+
+	for (int k = 0; k < KPOOL_N_KIND; k++) {
+		kpool_ring* r = &kpool[k];
+		memset(&r->st, 0, sizeof(kpool_stat));
+		r->depth = depth[k];
+		r->head = 0;
+		r->count = 0;
+		r->slot = NULL;
+		if (r->depth == 0) continue;
+		r->slot = calloc(r->depth, r->len_a + r->len_b);
+		if (r->slot == NULL) {
+			printf("\n KPOOL FAIL!: out of memory\n");
+			kpool_free();
+			return -1;
+		}
+		r->st.depth = r->depth;
+		r->st.min_count = r->depth;
+	}
+
+	kpool_interface = interface;
+	kpool_stop = 0;
+	if (pthread_create(&kpool_thread, NULL, kpool_filler, NULL) != 0) {
+		kpool_free();
+		return -1;
+	}
+	__atomic_store_n(&kpool_running, 1, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+void kpool_free()
+{
+	if (__atomic_exchange_n(&kpool_running, 0, __ATOMIC_ACQ_REL) && !__atomic_exchange_n(&kpool_forked, 0, __ATOMIC_ACQ_REL)) {
+		pthread_mutex_lock(&kpool_mutex);
+		kpool_stop = 1;
+		pthread_cond_signal(&kpool_cond);
+		pthread_mutex_unlock(&kpool_mutex);
+		pthread_join(kpool_thread, NULL);
+	}
+
+	pthread_mutex_lock(&kpool_mutex);
+	for (int k = 0; k < KPOOL_N_KIND; k++) {
+		kpool_ring* r = &kpool[k];
+		if (r->slot != NULL) memset(r->slot, 0, (unsigned long long)r->depth * (r->len_a + r->len_b));
+		free(r->slot);
+		r->slot = NULL;
+		r->depth = 0;
+		r->count = 0;
+	}
+	pthread_mutex_unlock(&kpool_mutex);
+}
+
+void kpool_stats(int kind, kpool_stat* st)
+{
+	memset(st, 0, sizeof(kpool_stat));
+	if (kind < 0 || kind >= KPOOL_N_KIND) return;
+
+	pthread_mutex_lock(&kpool_mutex);
+	*st = kpool[kind].st;
+	st->count = kpool[kind].count;
+	pthread_mutex_unlock(&kpool_mutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// MAIN FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- O(1) pop of a ready key pair for x25519_genkeys_hw_buf and mlkem_gen_keys_hw:
+//-- -1 when the pool is not running or the ring is empty, and the caller
+//-- generates in line on its own SE.
+int kpool_take(int kind, unsigned char* a, unsigned char* b)
+{
+	kpool_ring* r = &kpool[kind];
+	unsigned char* s;
+
+	if (kpool_filling || !__atomic_load_n(&kpool_running, __ATOMIC_ACQUIRE)) return -1;
+
+	// -- first request in the child of a fork: the parent's filler did not come along
+	if (__atomic_exchange_n(&kpool_forked, 0, __ATOMIC_ACQ_REL)) {
+		if (pthread_create(&kpool_thread, NULL, kpool_filler, NULL) != 0) {
+			__atomic_store_n(&kpool_running, 0, __ATOMIC_RELEASE);
+			return -1;
+		}
+	}
+
+	pthread_mutex_lock(&kpool_mutex);
+	if (r->count > 0) {
+		s = r->slot + (unsigned long long)r->head * (r->len_a + r->len_b);
+		memcpy(a, s, r->len_a);
+		memcpy(b, s + r->len_a, r->len_b);
+		memset(s, 0, r->len_a + r->len_b);
+		r->head = (r->head + 1) % r->depth;
+		r->count--;
+		r->st.hits++;
+		if (r->count < r->st.min_count) r->st.min_count = r->count;
+		pthread_cond_signal(&kpool_cond);
+		pthread_mutex_unlock(&kpool_mutex);
+		return 0;
+	}
+	if (r->depth) {
+		r->st.misses++;
+		r->st.min_count = 0;
+		pthread_cond_signal(&kpool_cond);
+	}
+	pthread_mutex_unlock(&kpool_mutex);
+
+	return -1;
+}
+
+int x25519_genkeys_pool(unsigned char* pri_key, unsigned char* pub_key, INTF interface)
+{
+	return x25519_genkeys_hw_buf(pri_key, pub_key, interface);
+}
+
+int mlkem_512_gen_keys_pool(unsigned char* pk, unsigned char* sk, INTF interface)
+{
+	return mlkem_512_gen_keys_hw(pk, sk, interface);
+}
+
+int mlkem_768_gen_keys_pool(unsigned char* pk, unsigned char* sk, INTF interface)
+{
+	return mlkem_768_gen_keys_hw(pk, sk, interface);
+}
+
+int mlkem_1024_gen_keys_pool(unsigned char* pk, unsigned char* sk, INTF interface)
+{
+	return mlkem_1024_gen_keys_hw(pk, sk, interface);
+}
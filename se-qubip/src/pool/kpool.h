@@ -0,0 +1,124 @@
+/**
+  * @file kpool.h
+  * @brief Precomputed ephemeral key-pair pools (X25519 / ML-KEM)
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef KPOOL_H
+#define KPOOL_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../common/intf.h"
+#include "../common/conf.h"
+#include "../common/extra_func.h"
+#include "../x25519/x25519_hw.h"
+#include "../mlkem/mlkem_hw.h"
+
+/************************ Pool Constant Definitions **********************/
+
+#define KPOOL_X25519				0
+#define KPOOL_MLKEM512				1
+#define KPOOL_MLKEM768				2
+#define KPOOL_MLKEM1024				3
+#define KPOOL_N_KIND				4
+
+#define KPOOL_BUSY_WAIT_US			1000	// Filler back-off while the core is in use
+
+	typedef struct {
+		unsigned int depth;					// High-water mark
+		unsigned int count;					// Key pairs ready now
+		unsigned int min_count;				// Lowest occupancy seen at a pop
+		unsigned long long hits;			// Pops served from the pool
+		unsigned long long misses;			// Pops that had to generate in line
+		unsigned long long generated;		// Key pairs made by the filler
+		unsigned long long failed;			// Filler runs dropped on a device error
+	} kpool_stat;
+
+	/************************ Control Functions **********************/
+
+	//-- depth[kind] key pairs per parameter set are kept ready by a background
+	//-- thread that generates on the given SE between foreground operations: it
+	//-- takes the X25519 / ML-KEM core with intf_core_trylock and steps aside
+	//-- while a foreground call waits for it. A run that fails is dropped, never
+	//-- pooled. Key pairs are handed out once and their slot is wiped; the child
+	//-- of a fork wipes its copy of the rings and refills them itself.
+	//-- kpool_lock/unlock hold every core of the pool's SE, for callers that need
+	//-- several calls in a row to themselves; single driver calls need no
+	//-- bracketing.
+	int kpool_init(INTF interface, const unsigned int* depth);
+	void kpool_free();
+	void kpool_stats(int kind, kpool_stat* st);
+	void kpool_lock();
+	void kpool_unlock();
+
+	/************************ Main Functions **********************/
+
+	//-- While the pool runs, x25519_genkeys_hw_buf and mlkem_gen_keys_hw (and the
+	//-- calls built on them) take a ready pair from it first: kpool_take returns 0
+	//-- with the pair copied out, -1 when there is none and the caller generates in
+	//-- line on its own SE. The _pool names are kept for existing callers.
+	int kpool_take(int kind, unsigned char* a, unsigned char* b);
+	int x25519_genkeys_pool(unsigned char* pri_key, unsigned char* pub_key, INTF interface);
+	int mlkem_512_gen_keys_pool(unsigned char* pk, unsigned char* sk, INTF interface);
+	int mlkem_768_gen_keys_pool(unsigned char* pk, unsigned char* sk, INTF interface);
+	int mlkem_1024_gen_keys_pool(unsigned char* pk, unsigned char* sk, INTF interface);
+
+#endif
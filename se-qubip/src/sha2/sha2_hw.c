@@ -61,24 +61,24 @@
 #include "sha2_hw.h"
 
 
-void sha_256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
+int sha_256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
 {
-	sha2_hw(interface, in, out, length * 8, 1, 0);
+	return sha2_hw(interface, in, out, length * 8, 1, 0);
 }
 
-void sha_384_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
+int sha_384_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
 {
-	sha2_hw(interface, in, out, length * 8, 2, 0);
+	return sha2_hw(interface, in, out, length * 8, 2, 0);
 }
 
-void sha_512_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
+int sha_512_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
 {
-	sha2_hw(interface, in, out, length * 8, 3, 0);
+	return sha2_hw(interface, in, out, length * 8, 3, 0);
 }
 
-void sha_512_256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
+int sha_512_256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
 {
-	sha2_hw(interface, in, out, length * 8, 4, 0);
+	return sha2_hw(interface, in, out, length * 8, 4, 0);
 }
 
 
@@ -129,23 +129,62 @@ void sha2_interface_init(INTF interface, unsigned long long int length, int VERS
 
 }
 
-void sha2_interface(INTF interface, unsigned long long int* a, unsigned long long int* b, unsigned long long int length, int last_hb, int VERSION, int DBG) {
+static unsigned long long int sha2_op_version(int VERSION) {
+
+	if (VERSION == 1)		return 0 << 2; // SHA-256
+	else if (VERSION == 2)	return 1 << 2; // SHA-384
+	else if (VERSION == 3)	return 2 << 2; // SHA-512
+	else if (VERSION == 4)	return 3 << 2; // SHA-512/256
+	else					return 0 << 2;
+}
+
+//-- Block hb (from 1) of a length-bit message as the core takes it: full
+//-- blocks packed straight from the input, the tail zero-filled
+void sha2_block_pack(unsigned long long int* buffer_in, const unsigned char* in, unsigned long long int length, unsigned long long int hb, int VERSION) {
+
+	unsigned int block_size = (VERSION == 1) ? 512 : 1024;
+	unsigned long long int ind = (hb - 1) * (block_size / 8);
+	unsigned char in_prev[1024 / 8];
+	const unsigned char* block;
+
+	if (ind + (block_size / 8) <= (length / 8)) {
+		block = in + ind;
+	}
+	else {
+		pack_block(in_prev, in + ind, (ind < (length / 8)) ? (length / 8) - ind : 0, block_size / 8);
+		block = in_prev;
+	}
+
+	if (VERSION == 1)	pack_be32(buffer_in, block, 16);
+	else				pack_be64(buffer_in, block, 16);
+}
+
+//-- Digest words of the last block to bytes
+void sha2_block_digest(unsigned char* out, const unsigned long long int* b, int VERSION) {
+
+	if (VERSION == 1)		unpack_be32(out, b, 8);
+	else if (VERSION == 2)	unpack_be64(out, b, 6);
+	else if (VERSION == 4)	unpack_be64(out, b, 4);
+	else					unpack_be64(out, b, 8);
+}
+
+//-- Loads and starts one block. SE_OK, or SE_ERR_DEADLINE with the core reset
+//-- (the caller holds SE_CORE_SHA2)
+int sha2_block_start(INTF interface, unsigned long long int* a, int VERSION, int DBG) {
 
-	unsigned long long int end_op = 0;
 	unsigned long long int reg_addr;
 	unsigned long long int reg_data_in;
-	unsigned long long int reg_data_out;
 	unsigned long long tic = 0, toc;
 
 	unsigned long long int op;
-	unsigned long long int op_version;
-
-	if (VERSION == 1)		op_version = 0 << 2; // SHA-256
-	else if (VERSION == 2)	op_version = 1 << 2; // SHA-384
-	else if (VERSION == 3)	op_version = 2 << 2; // SHA-512
-	else if (VERSION == 4)	op_version = 3 << 2; // SHA-512/256
-	else					op_version = 0 << 2;
+	unsigned long long int op_version = sha2_op_version(VERSION);
 
+	// -- past the caller's deadline a multi-block job stops here, between blocks
+	if (intf_deadline_passed(interface)) {
+		op = (unsigned long long int)ADD_SHA2 << 32 | ((op_version | 0) & 0xFFFFFFFF); // RESET
+		write_INTF(interface, &op, CONTROL, sizeof(unsigned long long int));
+		return intf_core_fault(interface, SE_CORE_SHA2, SE_ERR_DEADLINE);
+	}
 
 	// ----------- LOAD ------------------ //
 	if (DBG == 2) {
@@ -169,17 +208,55 @@ void sha2_interface(INTF interface, unsigned long long int* a, unsigned long lon
 		printf("(%3llu us.)\n", toc);
 	}
 
+	op = (unsigned long long int)ADD_SHA2 << 32 | ((op_version | START_SHA2) & 0xFFFFFFFF); // START
+	write_INTF(interface, &op, CONTROL, sizeof(unsigned long long int));
+
+	return SE_OK;
+}
+
+//-- Non-blocking: 1 once the started block has been hashed
+int sha2_block_ready(INTF interface) {
+
+	unsigned long long int end_op = 0;
+
+	read_INTF(interface, &end_op, END_OP, sizeof(unsigned long long int));
+
+	return end_op != 0;
+}
+
+//-- Waits for the started block and, for the last one, reads the digest words.
+//-- SE_OK, or SE_ERR_TIMEOUT / SE_ERR_DEADLINE with the core reset
+int sha2_block_finish(INTF interface, unsigned long long int* b, int last_hb, int VERSION, int DBG) {
+
+	unsigned long long int end_op = 0;
+	unsigned long long int reg_addr;
+	unsigned long long int reg_data_out;
+	unsigned long long tic = 0, toc;
+	unsigned long long limit;
+	int ret;
+
+	unsigned long long int op;
+	unsigned long long int op_version = sha2_op_version(VERSION);
+
 	// ----------- OPERATING ------------- //
 	if (DBG == 2) {
 		printf("  -- sha2_interface - Operating .............. \n");
 		tic = Wtime();
 	}
 
-	op = (unsigned long long int)ADD_SHA2 << 32 | ((op_version | START_SHA2) & 0xFFFFFFFF); // LOAD
-	write_INTF(interface, &op, CONTROL, sizeof(unsigned long long int));
-
 	// wait END_OP
-	while (!end_op) read_INTF(interface, &end_op, END_OP, sizeof(unsigned long long int));
+	limit = intf_wait_limit(interface, SHA2_WAIT_TIME);
+	do {
+		read_INTF(interface, &end_op, END_OP, sizeof(unsigned long long int));
+	} while (!end_op && intf_clock_ns() < limit);
+
+	if (!end_op) {
+		op = (unsigned long long int)ADD_SHA2 << 32 | ((op_version | 0) & 0xFFFFFFFF); // RESET
+		write_INTF(interface, &op, CONTROL, sizeof(unsigned long long int));
+		ret = intf_core_fault(interface, SE_CORE_SHA2, SE_ERR_TIMEOUT);
+		if (ret == SE_ERR_TIMEOUT) printf("\n SHA2 FAIL!: TIMEOUT \t%d us\n", SHA2_WAIT_TIME);
+		return ret;
+	}
 
 	if (DBG == 2) {
 		toc = Wtime() - tic;
@@ -206,40 +283,42 @@ void sha2_interface(INTF interface, unsigned long long int* a, unsigned long lon
 			printf("(%3llu us.)\n", toc);
 		}
 	}
-	
+
+	return SE_OK;
 }
 
+//-- SE_OK, or SE_ERR_TIMEOUT / SE_ERR_DEADLINE with the core reset (the caller holds SE_CORE_SHA2)
+int sha2_interface(INTF interface, unsigned long long int* a, unsigned long long int* b, unsigned long long int length, int last_hb, int VERSION, int DBG) {
+
+	int ret;
 
+	(void)length;
 
-void sha2_hw(INTF interface, unsigned char* in, unsigned char* out, unsigned long long int length, unsigned int VERSION, int DBG) {
+	ret = sha2_block_start(interface, a, VERSION, DBG);
+	if (ret != SE_OK) return ret;
+
+	return sha2_block_finish(interface, b, last_hb, VERSION, DBG);
+}
+
+
+
+static int sha2_hw_run(INTF interface, unsigned char* in, unsigned char* out, unsigned long long int length, unsigned int VERSION, int DBG) {
 
 	unsigned long long int hb_num;
-	unsigned long long int ind;
 	int last_hb = 0;
 
 	unsigned long long int buffer_in[16];
 	unsigned long long int buffer_out[8];
-	unsigned long long int buf_1, buf_2;
 
-	unsigned char in_prev[1024 / 8];
-
-	unsigned long long tic = 0, toc;
+	int ret = SE_OK;
 
 	// ------- Number of hash blocks ----- //
-	unsigned long long int op_version;
-
-	if (VERSION == 1)		op_version = 0 << 2; // SHA-256
-	else if (VERSION == 2)	op_version = 1 << 2; // SHA-384
-	else if (VERSION == 3)	op_version = 2 << 2; // SHA-512
-	else if (VERSION == 4)	op_version = 3 << 2; // SHA-512/256
-	else					op_version = 0 << 2;
-
 	unsigned int size_len;
-	if (!op_version)	size_len = 64;
+	if (VERSION == 1)	size_len = 64;
 	else				size_len = 128;
 
 	unsigned int block_size;
-	if (!op_version)	block_size = 512;
+	if (VERSION == 1)	block_size = 512;
 	else				block_size = 1024;
 
 	hb_num = (unsigned long long int)((length+size_len) / block_size) + 1; //3 bits for padding
@@ -249,102 +328,58 @@ void sha2_hw(INTF interface, unsigned char* in, unsigned char* out, unsigned lon
 		printf("\n length = %lld", length);
 	}
 
+	intf_core_lock(interface, SE_CORE_SHA2);
+
 	// ------- SHA2 Initialization --------//
 
 	sha2_interface_init(interface, length, VERSION, DBG);
 
 	// ------- Operation ---------------- //
 	for (unsigned int hb = 1; hb <= hb_num; hb++) {
-		ind = (hb - 1) * (block_size / 8);
-		for (int j = 0; j < (block_size / 8); j++) {
-			if ((ind + j) >= (length / 8))	in_prev[j] = 0x00;
-			else							in_prev[j] = in[ind + j];
-		}
-		// memcpy(in_prev, in + ind, sizeof(unsigned char) * (SIZE_BLOCK / 8));
-		ind = 0;
-		for (int i = 0; i < 16; i++) {
-			if (!op_version) {
-
-				buffer_in[i] =
-					0x00000000 |
-					((unsigned long long)(in_prev[ind + 3]) << 0) |
-					((unsigned long long)(in_prev[ind + 2]) << 8) |
-					((unsigned long long)(in_prev[ind + 1]) << 16) |
-					((unsigned long long)(in_prev[ind + 0]) << 24);
-				ind = ind + 4;
-			}
-			else {
-				buffer_in[i] =
-					((unsigned long long)(in_prev[ind + 7]) << 0) |
-					((unsigned long long)(in_prev[ind + 6]) << 8) |
-					((unsigned long long)(in_prev[ind + 5]) << 16) |
-					((unsigned long long)(in_prev[ind + 4]) << 24) |
-					((unsigned long long)(in_prev[ind + 3]) << 32) |
-					((unsigned long long)(in_prev[ind + 2]) << 40) |
-					((unsigned long long)(in_prev[ind + 1]) << 48) |
-					((unsigned long long)(in_prev[ind + 0]) << 56);
-				ind = ind + 8;
-			}
-
-			if (DBG == 1) printf("in[%lld] = %02x \t in[%lld] = %02x \t in[%lld] = %02x \t in[%lld] = %02x \n", ind, in_prev[ind], ind + 1, in_prev[ind + 1], ind + 2, in_prev[ind + 2], ind + 3, in_prev[ind + 3]);
-			if (DBG == 1) printf("buffer_in[%d] = %02llx \n", i, buffer_in[i]);
+		sha2_block_pack(buffer_in, in, length, hb, VERSION);
+
+		if (DBG == 1) {
+			for (int i = 0; i < 16; i++) printf("buffer_in[%d] = %02llx \n", i, buffer_in[i]);
 		}
 
 		if (hb == hb_num) last_hb = 1;
-		sha2_interface(interface, buffer_in, buffer_out, length, last_hb, VERSION, DBG);
+		ret = sha2_interface(interface, buffer_in, buffer_out, length, last_hb, VERSION, DBG);
+		if (ret != SE_OK) break;
+	}
+
+	if (ret != SE_OK) {
+		intf_core_unlock(interface, SE_CORE_SHA2);
+		return ret;
 	}
 
 
 	// ---- Read ----- //
-	if (VERSION == 1) {
-		for (int i = 0; i < 8; i++) {
-			ind = i * 4;
-			out[ind + 3] = (buffer_out[i] & 0x00000000000000FF) >> 0;
-			out[ind + 2] = (buffer_out[i] & 0x000000000000FF00) >> 8;
-			out[ind + 1] = (buffer_out[i] & 0x0000000000FF0000) >> 16;
-			out[ind + 0] = (buffer_out[i] & 0x00000000FF000000) >> 24;
-		}
-	}
-	else if (VERSION == 2) {
-		for (int i = 0; i < 6; i++) {
-			ind = i * 8;
-			out[ind + 7] = (buffer_out[i] & 0x00000000000000FF) >> 0;
-			out[ind + 6] = (buffer_out[i] & 0x000000000000FF00) >> 8;
-			out[ind + 5] = (buffer_out[i] & 0x0000000000FF0000) >> 16;
-			out[ind + 4] = (buffer_out[i] & 0x00000000FF000000) >> 24;
-			out[ind + 3] = (buffer_out[i] & 0x000000FF00000000) >> 32;
-			out[ind + 2] = (buffer_out[i] & 0x0000FF0000000000) >> 40;
-			out[ind + 1] = (buffer_out[i] & 0x00FF000000000000) >> 48;
-			out[ind + 0] = (buffer_out[i] & 0xFF00000000000000) >> 56;
-		}
-	}
-	else if (VERSION == 4) {
-		for (int i = 0; i < 4; i++) {
-			ind = i * 8;
-			out[ind + 7] = (buffer_out[i] & 0x00000000000000FF) >> 0;
-			out[ind + 6] = (buffer_out[i] & 0x000000000000FF00) >> 8;
-			out[ind + 5] = (buffer_out[i] & 0x0000000000FF0000) >> 16;
-			out[ind + 4] = (buffer_out[i] & 0x00000000FF000000) >> 24;
-			out[ind + 3] = (buffer_out[i] & 0x000000FF00000000) >> 32;
-			out[ind + 2] = (buffer_out[i] & 0x0000FF0000000000) >> 40;
-			out[ind + 1] = (buffer_out[i] & 0x00FF000000000000) >> 48;
-			out[ind + 0] = (buffer_out[i] & 0xFF00000000000000) >> 56;
-		}
+	sha2_block_digest(out, buffer_out, VERSION);
+
+	intf_core_unlock(interface, SE_CORE_SHA2);
+
+	return SE_OK;
+}
+
+//-- Idempotent: a block the core hung on resets it and the hash runs again. On
+//-- failure out is wiped and SE_ERR_TIMEOUT or SE_ERR_DEADLINE is returned.
+int sha2_hw(INTF interface, unsigned char* in, unsigned char* out, unsigned long long int length, unsigned int VERSION, int DBG) {
+
+	unsigned long long block = (VERSION == 1) ? 512 : 1024;
+	int ret = SE_OK;
+
+	// -- one unit per block, padding included
+	if (intf_core_admit(interface, SE_CORE_SHA2, (length + 2 * 64 + block) / block) != SE_OK) {
+		memset(out, 0, (VERSION == 2) ? 48 : (VERSION == 3) ? 64 : 32);
+		return SE_ERR_DEADLINE;
 	}
-	else {
-		for (int i = 0; i < 8; i++) {
-			ind = i * 8;
-			out[ind + 7] = (buffer_out[i] & 0x00000000000000FF) >> 0;
-			out[ind + 6] = (buffer_out[i] & 0x000000000000FF00) >> 8;
-			out[ind + 5] = (buffer_out[i] & 0x0000000000FF0000) >> 16;
-			out[ind + 4] = (buffer_out[i] & 0x00000000FF000000) >> 24;
-			out[ind + 3] = (buffer_out[i] & 0x000000FF00000000) >> 32;
-			out[ind + 2] = (buffer_out[i] & 0x0000FF0000000000) >> 40;
-			out[ind + 1] = (buffer_out[i] & 0x00FF000000000000) >> 48;
-			out[ind + 0] = (buffer_out[i] & 0xFF00000000000000) >> 56;
-		}
+
+	for (int t = 0; t <= SE_RETRY; t++) {
+		ret = sha2_hw_run(interface, in, out, length, VERSION, DBG);
+		if (!intf_core_retry(interface, SE_CORE_SHA2, ret)) break;
 	}
-	
 
+	if (ret != SE_OK) memset(out, 0, (VERSION == 2) ? 48 : (VERSION == 3) ? 64 : 32);
 
+	return ret;
 }
@@ -72,17 +72,33 @@
 #define LOAD_SHA2					2
 #define START_SHA2					3
 
+//-- Watchdog: longest wait for END_OP per block (us) before the core is declared hung
+#ifdef I2C
+	#define SHA2_WAIT_TIME			100000
+#else
+	#define SHA2_WAIT_TIME			10000
+#endif
+
 /************************ interface Function Definitions **********************/
 
 void sha2_interface_init(INTF interface, unsigned long long int length, int VERSION, int DBG);
-void sha2_interface(INTF interface, unsigned long long int* a, unsigned long long int* b, unsigned long long int length, int last_hb, int VERSION, int DBG);
-void sha2_hw(INTF interface, unsigned char* in, unsigned char* out, unsigned long long int length, unsigned int VERSION, int DBG);
+int sha2_interface(INTF interface, unsigned long long int* a, unsigned long long int* b, unsigned long long int length, int last_hb, int VERSION, int DBG);
+int sha2_hw(INTF interface, unsigned char* in, unsigned char* out, unsigned long long int length, unsigned int VERSION, int DBG);
+
+//-- sha2_interface split for the non-blocking ops (se_op): sha2_block_start
+//-- loads and starts a block, sha2_block_ready reads END_OP once and
+//-- sha2_block_finish waits for it and reads the digest after the last one
+void sha2_block_pack(unsigned long long int* buffer_in, const unsigned char* in, unsigned long long int length, unsigned long long int hb, int VERSION);
+void sha2_block_digest(unsigned char* out, const unsigned long long int* b, int VERSION);
+int sha2_block_start(INTF interface, unsigned long long int* a, int VERSION, int DBG);
+int sha2_block_ready(INTF interface);
+int sha2_block_finish(INTF interface, unsigned long long int* b, int last_hb, int VERSION, int DBG);
 
 /************************ Main Functions **********************/
 
-void sha_256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
-void sha_384_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
-void sha_512_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
-void sha_512_256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
+int sha_256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
+int sha_384_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
+int sha_512_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
+int sha_512_256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
 
 #endif
@@ -0,0 +1,301 @@
+/**
+  * @file sha2_sw.c
+  * @brief Host Software SHA-256
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#include "sha2_sw.h"
+
+static const uint32_t sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTR32(x, n)	(((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_sw_block(uint32_t h[8], const unsigned char* p)
+{
+	uint32_t w[64], a, b, c, d, e, f, g, k, t1, t2;
+
+	for (int i = 0; i < 16; i++)
+		w[i] = ((uint32_t)p[4 * i] << 24) | ((uint32_t)p[4 * i + 1] << 16) | ((uint32_t)p[4 * i + 2] << 8) | (uint32_t)p[4 * i + 3];
+	for (int i = 16; i < 64; i++)
+		w[i] = (ROTR32(w[i - 2], 17) ^ ROTR32(w[i - 2], 19) ^ (w[i - 2] >> 10)) + w[i - 7]
+			 + (ROTR32(w[i - 15], 7) ^ ROTR32(w[i - 15], 18) ^ (w[i - 15] >> 3)) + w[i - 16];
+
+	a = h[0]; b = h[1]; c = h[2]; d = h[3]; e = h[4]; f = h[5]; g = h[6]; k = h[7];
+
+	for (int i = 0; i < 64; i++) {
+		t1 = k + (ROTR32(e, 6) ^ ROTR32(e, 11) ^ ROTR32(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+		t2 = (ROTR32(a, 2) ^ ROTR32(a, 13) ^ ROTR32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+		k = g; g = f; f = e; e = d + t1;
+		d = c; c = b; b = a; a = t1 + t2;
+	}
+
+	h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e; h[5] += f; h[6] += g; h[7] += k;
+}
+
+void sha256_sw_init(sha256_sw_ctx* ctx)
+{
+	static const uint32_t iv[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+	};
+	memcpy(ctx->h, iv, sizeof(iv));
+	ctx->pos = 0;
+	ctx->length = 0;
+}
+
+void sha256_sw_update(sha256_sw_ctx* ctx, const unsigned char* in, unsigned long long length)
+{
+	unsigned int n;
+
+	ctx->length += length;
+
+	if (ctx->pos) {
+		n = (length < 64 - ctx->pos) ? (unsigned int)length : 64 - ctx->pos;
+		memcpy(ctx->block + ctx->pos, in, n);
+		ctx->pos += n; in += n; length -= n;
+		if (ctx->pos < 64) return;
+		sha256_sw_block(ctx->h, ctx->block);
+		ctx->pos = 0;
+	}
+
+	// -- full blocks straight from the caller buffer (no copy)
+	while (length >= 64) {
+		sha256_sw_block(ctx->h, in);
+		in += 64; length -= 64;
+	}
+
+	memcpy(ctx->block, in, length);
+	ctx->pos = (unsigned int)length;
+}
+
+void sha256_sw_final(sha256_sw_ctx* ctx, unsigned char* out)
+{
+	unsigned long long bits = ctx->length * 8;
+
+	ctx->block[ctx->pos++] = 0x80;
+	if (ctx->pos > 56) {
+		memset(ctx->block + ctx->pos, 0, 64 - ctx->pos);
+		sha256_sw_block(ctx->h, ctx->block);
+		ctx->pos = 0;
+	}
+	memset(ctx->block + ctx->pos, 0, 56 - ctx->pos);
+	for (int i = 0; i < 8; i++) ctx->block[63 - i] = (unsigned char)(bits >> (8 * i));
+	sha256_sw_block(ctx->h, ctx->block);
+
+	for (int i = 0; i < 8; i++) {
+		out[4 * i + 0] = (unsigned char)(ctx->h[i] >> 24);
+		out[4 * i + 1] = (unsigned char)(ctx->h[i] >> 16);
+		out[4 * i + 2] = (unsigned char)(ctx->h[i] >> 8);
+		out[4 * i + 3] = (unsigned char)(ctx->h[i] >> 0);
+	}
+}
+
+void sha_256_sw(const unsigned char* in, unsigned long long length, unsigned char* out)
+{
+	sha256_sw_ctx ctx;
+
+	sha256_sw_init(&ctx);
+	sha256_sw_update(&ctx, in, length);
+	sha256_sw_final(&ctx, out);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// SHA-512 / SHA-384 / SHA-512/256
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static const uint64_t sha512_k[80] = {
+	0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL, 0x3956c25bf348b538ULL,
+	0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL, 0xd807aa98a3030242ULL, 0x12835b0145706fbeULL,
+	0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL, 0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL,
+	0xc19bf174cf692694ULL, 0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+	0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL, 0x983e5152ee66dfabULL,
+	0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL, 0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL,
+	0x06ca6351e003826fULL, 0x142929670a0e6e70ULL, 0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL,
+	0x53380d139d95b3dfULL, 0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+	0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL, 0xd192e819d6ef5218ULL,
+	0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL, 0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL,
+	0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL, 0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL,
+	0x682e6ff3d6b2b8a3ULL, 0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+	0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL, 0xca273eceea26619cULL,
+	0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL, 0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL,
+	0x113f9804bef90daeULL, 0x1b710b35131c471bULL, 0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL,
+	0x431d67c49c100d4cULL, 0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+};
+
+#define ROTR64(x, n)	(((x) >> (n)) | ((x) << (64 - (n))))
+
+static void sha512_sw_block(uint64_t h[8], const unsigned char* p)
+{
+	uint64_t w[80], a, b, c, d, e, f, g, k, t1, t2;
+
+	for (int i = 0; i < 16; i++) {
+		w[i] = 0;
+		for (int j = 0; j < 8; j++) w[i] = (w[i] << 8) | p[8 * i + j];
+	}
+	for (int i = 16; i < 80; i++)
+		w[i] = (ROTR64(w[i - 2], 19) ^ ROTR64(w[i - 2], 61) ^ (w[i - 2] >> 6)) + w[i - 7]
+			 + (ROTR64(w[i - 15], 1) ^ ROTR64(w[i - 15], 8) ^ (w[i - 15] >> 7)) + w[i - 16];
+
+	a = h[0]; b = h[1]; c = h[2]; d = h[3]; e = h[4]; f = h[5]; g = h[6]; k = h[7];
+
+	for (int i = 0; i < 80; i++) {
+		t1 = k + (ROTR64(e, 14) ^ ROTR64(e, 18) ^ ROTR64(e, 41)) + ((e & f) ^ (~e & g)) + sha512_k[i] + w[i];
+		t2 = (ROTR64(a, 28) ^ ROTR64(a, 34) ^ ROTR64(a, 39)) + ((a & b) ^ (a & c) ^ (b & c));
+		k = g; g = f; f = e; e = d + t1;
+		d = c; c = b; b = a; a = t1 + t2;
+	}
+
+	h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e; h[5] += f; h[6] += g; h[7] += k;
+}
+
+void sha512_sw_init(sha512_sw_ctx* ctx, unsigned int out_len)
+{
+	static const uint64_t iv_512[8] = {
+		0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+		0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+	};
+	static const uint64_t iv_384[8] = {
+		0xcbbb9d5dc1059ed8ULL, 0x629a292a367cd507ULL, 0x9159015a3070dd17ULL, 0x152fecd8f70e5939ULL,
+		0x67332667ffc00b31ULL, 0x8eb44a8768581511ULL, 0xdb0c2e0d64f98fa7ULL, 0x47b5481dbefa4fa4ULL
+	};
+	static const uint64_t iv_512_256[8] = {
+		0x22312194fc2bf72cULL, 0x9f555fa3c84c64c2ULL, 0x2393b86b6f53b151ULL, 0x963877195940eabdULL,
+		0x96283ee2a88effe3ULL, 0xbe5e1e2553863992ULL, 0x2b0199fc2c85b8aaULL, 0x0eb72ddc81c52ca2ULL
+	};
+
+	if (out_len == 48)		memcpy(ctx->h, iv_384, sizeof(iv_384));
+	else if (out_len == 32)	memcpy(ctx->h, iv_512_256, sizeof(iv_512_256));
+	else					memcpy(ctx->h, iv_512, sizeof(iv_512));
+	ctx->out_len = (out_len == 48 || out_len == 32) ? out_len : 64;
+	ctx->pos = 0;
+	ctx->length = 0;
+}
+
+void sha512_sw_update(sha512_sw_ctx* ctx, const unsigned char* in, unsigned long long length)
+{
+	unsigned int n;
+
+	ctx->length += length;
+
+	if (ctx->pos) {
+		n = (length < 128 - ctx->pos) ? (unsigned int)length : 128 - ctx->pos;
+		memcpy(ctx->block + ctx->pos, in, n);
+		ctx->pos += n; in += n; length -= n;
+		if (ctx->pos < 128) return;
+		sha512_sw_block(ctx->h, ctx->block);
+		ctx->pos = 0;
+	}
+
+	// -- full blocks straight from the caller buffer (no copy)
+	while (length >= 128) {
+		sha512_sw_block(ctx->h, in);
+		in += 128; length -= 128;
+	}
+
+	memcpy(ctx->block, in, length);
+	ctx->pos = (unsigned int)length;
+}
+
+void sha512_sw_final(sha512_sw_ctx* ctx, unsigned char* out)
+{
+	unsigned long long bits = ctx->length * 8;
+
+	// -- 128-bit length field: the upper 64 bits are always zero here
+	ctx->block[ctx->pos++] = 0x80;
+	if (ctx->pos > 112) {
+		memset(ctx->block + ctx->pos, 0, 128 - ctx->pos);
+		sha512_sw_block(ctx->h, ctx->block);
+		ctx->pos = 0;
+	}
+	memset(ctx->block + ctx->pos, 0, 120 - ctx->pos);
+	for (int i = 0; i < 8; i++) ctx->block[127 - i] = (unsigned char)(bits >> (8 * i));
+	sha512_sw_block(ctx->h, ctx->block);
+
+	for (unsigned int i = 0; i < ctx->out_len; i++) out[i] = (unsigned char)(ctx->h[i / 8] >> (56 - 8 * (i % 8)));
+}
+
+static void sha512_sw(const unsigned char* in, unsigned long long length, unsigned char* out, unsigned int out_len)
+{
+	sha512_sw_ctx ctx;
+
+	sha512_sw_init(&ctx, out_len);
+	sha512_sw_update(&ctx, in, length);
+	sha512_sw_final(&ctx, out);
+}
+
+void sha_384_sw(const unsigned char* in, unsigned long long length, unsigned char* out)
+{
+	sha512_sw(in, length, out, 48);
+}
+
+void sha_512_sw(const unsigned char* in, unsigned long long length, unsigned char* out)
+{
+	sha512_sw(in, length, out, 64);
+}
+
+void sha_512_256_sw(const unsigned char* in, unsigned long long length, unsigned char* out)
+{
+	sha512_sw(in, length, out, 32);
+}
@@ -0,0 +1,101 @@
+/**
+  * @file sha2_sw.h
+  * @brief Host Software SHA-256 Header
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef SHA2_SW_H
+#define SHA2_SW_H
+
+#include <stdint.h>
+#include <string.h>
+
+	//-- Incremental SHA-256 on the host. Used where the hardware core cannot
+	//-- be fed (overflow capacity of the hash scheduler, Merkle interior nodes).
+	typedef struct {
+		uint32_t h[8];
+		unsigned char block[64];
+		unsigned int pos;
+		unsigned long long length;
+	} sha256_sw_ctx;
+
+	void sha256_sw_init(sha256_sw_ctx* ctx);
+	void sha256_sw_update(sha256_sw_ctx* ctx, const unsigned char* in, unsigned long long length);
+	void sha256_sw_final(sha256_sw_ctx* ctx, unsigned char* out);
+
+	//-- Incremental SHA-512 family. out_len selects the variant: 64 (SHA-512),
+	//-- 48 (SHA-384) or 32 (SHA-512/256).
+	typedef struct {
+		uint64_t h[8];
+		unsigned char block[128];
+		unsigned int pos;
+		unsigned int out_len;
+		unsigned long long length;
+	} sha512_sw_ctx;
+
+	void sha512_sw_init(sha512_sw_ctx* ctx, unsigned int out_len);
+	void sha512_sw_update(sha512_sw_ctx* ctx, const unsigned char* in, unsigned long long length);
+	void sha512_sw_final(sha512_sw_ctx* ctx, unsigned char* out);
+
+	/************************ Main Functions **********************/
+
+	void sha_256_sw(const unsigned char* in, unsigned long long length, unsigned char* out);
+	void sha_384_sw(const unsigned char* in, unsigned long long length, unsigned char* out);
+	void sha_512_sw(const unsigned char* in, unsigned long long length, unsigned char* out);
+	void sha_512_256_sw(const unsigned char* in, unsigned long long length, unsigned char* out);
+
+#endif
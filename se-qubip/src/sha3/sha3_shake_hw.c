@@ -60,24 +60,24 @@
 
 #include "sha3_shake_hw.h"
 
-void sha3_256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
+int sha3_256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
 {
-	sha3_shake_hw(in, out, length*8, 256, 1, 1088, 256, interface, 0);
+	return sha3_shake_hw(in, out, length*8, 256, 1, 1088, 256, interface, 0);
 }
 
-void sha3_512_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
+int sha3_512_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface)
 {
-	sha3_shake_hw(in, out, length*8, 512, 2, 576, 512, interface, 0);
+	return sha3_shake_hw(in, out, length*8, 512, 2, 576, 512, interface, 0);
 }
 
-void shake128_hw_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, INTF interface)
+int shake128_hw_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, INTF interface)
 {
-	sha3_shake_hw(in, out, length*8, length_out*8, 3, 1344, 128, interface, 0);
+	return sha3_shake_hw(in, out, length*8, length_out*8, 3, 1344, 128, interface, 0);
 }
 
-void shake256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, INTF interface)
+int shake256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, INTF interface)
 {
-	sha3_shake_hw(in, out, length*8, length_out*8, 4, 1088, 256, interface, 0);
+	return sha3_shake_hw(in, out, length*8, length_out*8, 4, 1088, 256, interface, 0);
 }
 
 void sha3_shake_interface_init(INTF interface, int VERSION) {
@@ -95,21 +95,30 @@ void sha3_shake_interface_init(INTF interface, int VERSION) {
 
 }
 
-void sha3_shake_interface(unsigned long long int* a, unsigned long long int* b, INTF interface, unsigned int pos_pad, int pad, int shake, int VERSION, int SIZE_SHA3, int SIZE_BLOCK, int DBG) {
+static unsigned long long int sha3_shake_op_version(int VERSION) {
+
+	if (VERSION == 1)	return 2 << 2; // SHA3-256
+	else if (VERSION == 2)	return 3 << 2; // SHA3-512
+	else if (VERSION == 3)	return 0 << 2; // SHAKE-128
+	else if (VERSION == 4)	return 1 << 2; // SHAKE-256
+	else					return 2 << 2;
+}
+
+//-- Loads and starts one block (shake = 1: starts the next squeeze). SE_OK, or
+//-- SE_ERR_DEADLINE with the core reset (the caller holds SE_CORE_SHA3)
+int sha3_shake_block_start(unsigned long long int* a, INTF interface, unsigned int pos_pad, int pad, int shake, int VERSION, int SIZE_BLOCK, int DBG) {
 
 	unsigned long long int op;
-	unsigned long long int op_version;
-	unsigned long long int end_op = 0;
+	unsigned long long int op_version = sha3_shake_op_version(VERSION);
 	unsigned long long int reg_addr;
 	unsigned long long int reg_data_in;
-	unsigned long long int reg_data_out;
 	unsigned long long tic = 0, toc;
 
-	if (VERSION == 1)	op_version = 2 << 2; // SHA3-256
-	else if (VERSION == 2)	op_version = 3 << 2; // SHA3-512
-	else if (VERSION == 3)	op_version = 0 << 2; // SHAKE-128
-	else if (VERSION == 4)	op_version = 1 << 2; // SHAKE-256
-	else					op_version = 2 << 2;
+	// -- past the caller's deadline a multi-block job stops here, between blocks
+	if (intf_deadline_passed(interface)) {
+		sha3_shake_interface_init(interface, VERSION);
+		return intf_core_fault(interface, SE_CORE_SHA3, SE_ERR_DEADLINE);
+	}
 
 	if (shake != 1) {
 		if (pad) {
@@ -158,6 +167,35 @@ void sha3_shake_interface(unsigned long long int* a, unsigned long long int* b,
 		}
 	}
 
+	op = (unsigned long long int)ADD_SHA3 << 32 | ((op_version | START) & 0xFFFFFFFF);; // START
+	write_INTF(interface, &op, CONTROL, sizeof(unsigned long long int));
+
+	return SE_OK;
+}
+
+//-- Non-blocking: 1 once the started block has been absorbed or squeezed
+int sha3_shake_block_ready(INTF interface) {
+
+	unsigned long long int end_op = 0;
+
+	read_INTF(interface, &end_op, END_OP, sizeof(unsigned long long int));
+
+	return end_op != 0;
+}
+
+//-- Waits for the started block and, past the padded one (pad), reads the
+//-- output words and enables the next squeeze. SE_OK, or SE_ERR_TIMEOUT /
+//-- SE_ERR_DEADLINE with the core reset
+int sha3_shake_block_finish(unsigned long long int* b, INTF interface, int pad, int shake, int VERSION, int SIZE_SHA3, int SIZE_BLOCK, int DBG) {
+
+	unsigned long long int op;
+	unsigned long long int op_version = sha3_shake_op_version(VERSION);
+	unsigned long long int end_op = 0;
+	unsigned long long int reg_addr;
+	unsigned long long int reg_data_out;
+	unsigned long long tic = 0, toc;
+	unsigned long long limit;
+	int ret;
 
 	// ----------- OPERATING ------------- //
 	if (DBG == 2) {
@@ -165,12 +203,18 @@ void sha3_shake_interface(unsigned long long int* a, unsigned long long int* b,
 		tic = Wtime();
 	}
 
-	op = (unsigned long long int)ADD_SHA3 << 32 | ((op_version | START) & 0xFFFFFFFF);; // START
-	write_INTF(interface, &op, CONTROL, sizeof(unsigned long long int));
-
 	// wait END_OP
-	while (!end_op) read_INTF(interface, &end_op, END_OP, sizeof(unsigned long long int));
-
+	limit = intf_wait_limit(interface, SHA3_WAIT_TIME);
+	do {
+		read_INTF(interface, &end_op, END_OP, sizeof(unsigned long long int));
+	} while (!end_op && intf_clock_ns() < limit);
+
+	if (!end_op) {
+		sha3_shake_interface_init(interface, VERSION);
+		ret = intf_core_fault(interface, SE_CORE_SHA3, SE_ERR_TIMEOUT);
+		if (ret == SE_ERR_TIMEOUT) printf("\n SHA3 FAIL!: TIMEOUT \t%d us\n", SHA3_WAIT_TIME);
+		return ret;
+	}
 
 	if (DBG == 2) {
 		toc = Wtime() - tic;
@@ -214,39 +258,47 @@ void sha3_shake_interface(unsigned long long int* a, unsigned long long int* b,
 		write_INTF(interface, &op, CONTROL, sizeof(unsigned long long int));
 
 	}
+
+	return SE_OK;
+}
+
+//-- SE_OK, or SE_ERR_TIMEOUT / SE_ERR_DEADLINE with the core reset (the caller holds SE_CORE_SHA3)
+int sha3_shake_interface(unsigned long long int* a, unsigned long long int* b, INTF interface, unsigned int pos_pad, int pad, int shake, int VERSION, int SIZE_SHA3, int SIZE_BLOCK, int DBG) {
+
+	int ret;
+
+	ret = sha3_shake_block_start(a, interface, pos_pad, pad, shake, VERSION, SIZE_BLOCK, DBG);
+	if (ret != SE_OK) return ret;
+
+	return sha3_shake_block_finish(b, interface, pad, shake, VERSION, SIZE_SHA3, SIZE_BLOCK, DBG);
 }
 
-void sha3_shake_hw(unsigned char* in, unsigned char* out, unsigned int length, unsigned int length_out, int VERSION, int SIZE_BLOCK, int SIZE_SHA3, INTF interface, int DBG) {
+static int sha3_shake_hw_run(unsigned char* in, unsigned char* out, unsigned int length, unsigned int length_out, int VERSION, int SIZE_BLOCK, int SIZE_SHA3, INTF interface, int DBG) {
 
 	unsigned int hb_num;
-	unsigned int hb_num_out;
 	unsigned int pos_pad;
 	unsigned int ind;
+	unsigned int copy;
+	unsigned int bytes_out = (length_out + 7) / 8;
 	int last_hb = 0;
 	int shake = 0;
+	int ret = SE_OK;
 
-	unsigned long long int* buffer_in;
-	unsigned long long int* buffer_out;
-
-	buffer_in = malloc(sizeof(unsigned long long int) * (SIZE_BLOCK / 64));
-	buffer_out = malloc(sizeof(unsigned long long int) * (SIZE_BLOCK / 64));
-
-	unsigned char in_prev[1344 / 8];
-	// memset(in_prev, 0, sizeof(unsigned char) * (1344 / 8));
-	// in_prev = malloc(sizeof(unsigned char) * ((SIZE_BLOCK / 8) + 1));
+	unsigned long long int buffer_in[SHA3_MAX_BLOCK / 64];
+	unsigned long long int buffer_out[SHA3_MAX_BLOCK / 64];
 
 	// ------- Number of hash blocks ----- //
 	hb_num = (length / SIZE_BLOCK) + 1;
-	hb_num_out = (length_out / SIZE_BLOCK) + 1;
 	pos_pad = length % SIZE_BLOCK;
 
 	if (DBG == 1) {
 		printf("\n hb_num = %d \n", hb_num);
-		printf("\n hb_num_out = %d \n", hb_num_out);
 		printf("\n length = %d \n", length);
 		printf("\n pos_pad = %d \n", pos_pad);
 	}
 
+	intf_core_lock(interface, SE_CORE_SHA3);
+
 	// ------- SHA3 Initialization --------//
 
 	sha3_shake_interface_init(interface, VERSION);
@@ -256,19 +308,10 @@ void sha3_shake_hw(unsigned char* in, unsigned char* out, unsigned int length, u
 	for (unsigned int hb = 1; hb <= hb_num; hb++) {
 
 		ind = (hb - 1) * (SIZE_BLOCK / 8);
-		for (int j = 0; j < (SIZE_BLOCK / 8); j++) {
-			if ((ind + j) >= (length / 8))	in_prev[j] = 0x00;
-			else							in_prev[j] = in[ind + j];
-		}
-		// memcpy(in_prev, in + ind, sizeof(unsigned char) * (SIZE_BLOCK / 8));
-		ind = 0;
-		for (int i = 0; i < (SIZE_BLOCK / 64); i++) {
-			
-			memcpy(buffer_in + i, in_prev + ind, 8);
+		pack_block((unsigned char*)buffer_in, in + ind, (ind < (length / 8)) ? (length / 8) - ind : 0, SIZE_BLOCK / 8);
 
-			if (DBG == 1) printf("in[%d] = %02x \t in[%d] = %02x \t in[%d] = %02x \t in[%d] = %02x \n", ind, in_prev[ind], ind + 1, in_prev[ind + 1], ind + 2, in_prev[ind + 2], ind + 3, in_prev[ind + 3]);
-			if (DBG == 1) printf("buffer_in[%d] = %02llx \n", i, buffer_in[i]);
-			ind = ind + 8;
+		if (DBG == 1) {
+			for (int i = 0; i < (SIZE_BLOCK / 64); i++) printf("buffer_in[%d] = %02llx \n", i, buffer_in[i]);
 		}
 
 		if (hb == hb_num)						last_hb = 1;
@@ -281,41 +324,52 @@ void sha3_shake_hw(unsigned char* in, unsigned char* out, unsigned int length, u
 			printf("\n last_hb = %d \n", last_hb);
 		}
 
-		sha3_shake_interface(buffer_in, buffer_out, interface, (pos_pad / 8), last_hb, shake, VERSION, SIZE_SHA3, SIZE_BLOCK, DBG); // shake = 0
+		ret = sha3_shake_interface(buffer_in, buffer_out, interface, (pos_pad / 8), last_hb, shake, VERSION, SIZE_SHA3, SIZE_BLOCK, DBG); // shake = 0
+		if (ret != SE_OK) break;
 	}
 
-	// ------- Change Out Format --------- //
-	if (hb_num_out > hb_num) {
-		for (int i = 0; i < (SIZE_BLOCK / 64); i++) {
-			ind = i * 8;
-			/*
-			out[ind + 0] = (buffer_out[i] & 0x00000000000000FF) >> 0;
-			out[ind + 1] = (buffer_out[i] & 0x000000000000FF00) >> 8;
-			out[ind + 2] = (buffer_out[i] & 0x0000000000FF0000) >> 16;
-			out[ind + 3] = (buffer_out[i] & 0x00000000FF000000) >> 24;
-			out[ind + 4] = (buffer_out[i] & 0x000000FF00000000) >> 32;
-			out[ind + 5] = (buffer_out[i] & 0x0000FF0000000000) >> 40;
-			out[ind + 6] = (buffer_out[i] & 0x00FF000000000000) >> 48;
-			out[ind + 7] = (buffer_out[i] & 0xFF00000000000000) >> 56;
-			*/
-			memcpy(out + ind, buffer_out + i, 8 * sizeof(unsigned char));
-		}
+	if (ret != SE_OK) {
+		intf_core_unlock(interface, SE_CORE_SHA3);
+		return ret;
+	}
 
-		int hb_shake = 0;
-		for (unsigned int hb = hb_num; hb < hb_num_out; hb++) {
-			sha3_shake_interface(buffer_in, buffer_out, interface, (pos_pad / 8), last_hb, 1, VERSION, SIZE_SHA3, SIZE_BLOCK, DBG);
-			hb_shake++;
-			for (int i = 0; i < (SIZE_BLOCK / 64); i++) {
-				ind = i * 8 + hb_shake * (SIZE_BLOCK / 8);
-				memcpy(out + ind, buffer_out + i, 8 * sizeof(unsigned char));
-			}
-		}
+	// ------- Squeeze ------------------- //
+	//-- Exactly bytes_out bytes reach out: a rate block at a time, the last one cut short
+
+	ind = 0;
+	while (ret == SE_OK) {
+		copy = (bytes_out - ind > (unsigned int)(SIZE_BLOCK / 8)) ? (unsigned int)(SIZE_BLOCK / 8) : bytes_out - ind;
+		memcpy(out + ind, buffer_out, copy);
+		ind += copy;
+
+		if (ind == bytes_out) break;
+
+		ret = sha3_shake_interface(buffer_in, buffer_out, interface, (pos_pad / 8), last_hb, 1, VERSION, SIZE_SHA3, SIZE_BLOCK, DBG);
 	}
-	else {
-		for (int i = 0; i < (int)ceil((double)length_out / (double)64); i++) {
-			ind = i * 8;
-			memcpy(out + ind, buffer_out + i, 8 * sizeof(unsigned char));
-		}
+
+	intf_core_unlock(interface, SE_CORE_SHA3);
+
+	return ret;
+}
+
+//-- Idempotent: a block the core hung on resets it and the hash runs again. On
+//-- failure out is wiped and SE_ERR_TIMEOUT or SE_ERR_DEADLINE is returned.
+int sha3_shake_hw(unsigned char* in, unsigned char* out, unsigned int length, unsigned int length_out, int VERSION, int SIZE_BLOCK, int SIZE_SHA3, INTF interface, int DBG) {
+
+	int ret = SE_OK;
+
+	// -- one unit per absorbed or squeezed block
+	if (intf_core_admit(interface, SE_CORE_SHA3, length / SIZE_BLOCK + 1 + length_out / SIZE_BLOCK) != SE_OK) {
+		memset(out, 0, (length_out + 7) / 8);
+		return SE_ERR_DEADLINE;
+	}
+
+	for (int t = 0; t <= SE_RETRY; t++) {
+		ret = sha3_shake_hw_run(in, out, length, length_out, VERSION, SIZE_BLOCK, SIZE_SHA3, interface, DBG);
+		if (!intf_core_retry(interface, SE_CORE_SHA3, ret)) break;
 	}
 
+	if (ret != SE_OK) memset(out, 0, (length_out + 7) / 8);
+
+	return ret;
 }
@@ -75,14 +75,31 @@
 #define LOAD					2
 #define START					3
 
+#define SHA3_MAX_BLOCK			1344	//-- SHAKE-128 rate: largest block, sizes the stack buffers
+
+//-- Watchdog: longest wait for END_OP per block (us) before the core is declared hung
+#ifdef I2C
+	#define SHA3_WAIT_TIME		100000
+#else
+	#define SHA3_WAIT_TIME		10000
+#endif
+
     void sha3_shake_interface_init(INTF interface, int VERSION);
-    void sha3_shake_interface(unsigned long long int* a, unsigned long long int* b, INTF interface, unsigned int pos_pad, int pad, int shake, int VERSION, int SIZE_SHA3, int SIZE_BLOCK, int DBG);
-    void sha3_shake_hw(unsigned char* in, unsigned char* out, unsigned int length, unsigned int length_out, int VERSION, int SIZE_BLOCK, int SIZE_SHA3, INTF interface, int DBG);
+    int sha3_shake_interface(unsigned long long int* a, unsigned long long int* b, INTF interface, unsigned int pos_pad, int pad, int shake, int VERSION, int SIZE_SHA3, int SIZE_BLOCK, int DBG);
+    int sha3_shake_hw(unsigned char* in, unsigned char* out, unsigned int length, unsigned int length_out, int VERSION, int SIZE_BLOCK, int SIZE_SHA3, INTF interface, int DBG);
+
+    //-- sha3_shake_interface split for the non-blocking ops (se_op):
+    //-- sha3_shake_block_start loads and starts a block, sha3_shake_block_ready
+    //-- reads END_OP once and sha3_shake_block_finish waits for it and reads
+    //-- the output of the padded block and of each squeeze
+    int sha3_shake_block_start(unsigned long long int* a, INTF interface, unsigned int pos_pad, int pad, int shake, int VERSION, int SIZE_BLOCK, int DBG);
+    int sha3_shake_block_ready(INTF interface);
+    int sha3_shake_block_finish(unsigned long long int* b, INTF interface, int pad, int shake, int VERSION, int SIZE_SHA3, int SIZE_BLOCK, int DBG);
 
     /************************ Main Functions **********************/
 
-    void sha3_256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
-    void sha3_512_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
-    void shake128_hw_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, INTF interface);
-    void shake256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, INTF interface);
+    int sha3_256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
+    int sha3_512_hw_func(unsigned char* in, unsigned int length, unsigned char* out, INTF interface);
+    int shake128_hw_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, INTF interface);
+    int shake256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, INTF interface);
 #endif
\ No newline at end of file
@@ -0,0 +1,236 @@
+/**
+  * @file sha3_sw.c
+  * @brief Host Software Keccak / SHA3 / SHAKE
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#include "sha3_sw.h"
+
+static const uint64_t keccak_rc[24] = {
+	0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+	0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+	0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+	0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+	0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+	0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+static const unsigned int keccak_rho[24] = {
+	1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
+};
+
+static const unsigned int keccak_pi[24] = {
+	10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1
+};
+
+#define ROTL64(x, n) (((x) << (n)) | ((x) >> (64 - (n))))
+
+void keccak_f1600_sw(uint64_t s[25])
+{
+	uint64_t c[5], t;
+
+	for (int r = 0; r < 24; r++) {
+		// -- theta
+		for (int x = 0; x < 5; x++) c[x] = s[x] ^ s[x + 5] ^ s[x + 10] ^ s[x + 15] ^ s[x + 20];
+		for (int x = 0; x < 5; x++) {
+			t = c[(x + 4) % 5] ^ ROTL64(c[(x + 1) % 5], 1);
+			for (int y = 0; y < 25; y += 5) s[y + x] ^= t;
+		}
+		// -- rho & pi
+		t = s[1];
+		for (int i = 0; i < 24; i++) {
+			uint64_t u = s[keccak_pi[i]];
+			s[keccak_pi[i]] = ROTL64(t, keccak_rho[i]);
+			t = u;
+		}
+		// -- chi
+		for (int y = 0; y < 25; y += 5) {
+			for (int x = 0; x < 5; x++) c[x] = s[y + x];
+			for (int x = 0; x < 5; x++) s[y + x] = c[x] ^ ((~c[(x + 1) % 5]) & c[(x + 2) % 5]);
+		}
+		// -- iota
+		s[0] ^= keccak_rc[r];
+	}
+}
+
+//-- Four independent states side by side (state word w of instance l is s[w][l]).
+//-- Every step is a loop over the four instances, which the compiler maps onto
+//-- SSE2/AVX2 or NEON registers at -O3 without target-specific code.
+void keccak_f1600_x4_sw(uint64_t s[25][4])
+{
+	uint64_t c[5][4], t[4], u[4];
+
+	for (int r = 0; r < 24; r++) {
+		// -- theta
+		for (int x = 0; x < 5; x++)
+			for (int l = 0; l < 4; l++) c[x][l] = s[x][l] ^ s[x + 5][l] ^ s[x + 10][l] ^ s[x + 15][l] ^ s[x + 20][l];
+		for (int x = 0; x < 5; x++) {
+			for (int l = 0; l < 4; l++) t[l] = c[(x + 4) % 5][l] ^ ROTL64(c[(x + 1) % 5][l], 1);
+			for (int y = 0; y < 25; y += 5)
+				for (int l = 0; l < 4; l++) s[y + x][l] ^= t[l];
+		}
+		// -- rho & pi
+		for (int l = 0; l < 4; l++) t[l] = s[1][l];
+		for (int i = 0; i < 24; i++) {
+			for (int l = 0; l < 4; l++) {
+				u[l] = s[keccak_pi[i]][l];
+				s[keccak_pi[i]][l] = ROTL64(t[l], keccak_rho[i]);
+				t[l] = u[l];
+			}
+		}
+		// -- chi
+		for (int y = 0; y < 25; y += 5) {
+			for (int x = 0; x < 5; x++)
+				for (int l = 0; l < 4; l++) c[x][l] = s[y + x][l];
+			for (int x = 0; x < 5; x++)
+				for (int l = 0; l < 4; l++) s[y + x][l] = c[x][l] ^ ((~c[(x + 1) % 5][l]) & c[(x + 2) % 5][l]);
+		}
+		// -- iota
+		for (int l = 0; l < 4; l++) s[0][l] ^= keccak_rc[r];
+	}
+}
+
+//-- Lanes are little-endian, so byte i of the rate sits in lane i/8 at bit 8*(i%8)
+static inline void sha3_sw_xor_byte(uint64_t s[25], unsigned int i, unsigned char b)
+{
+	s[i >> 3] ^= (uint64_t)b << (8 * (i & 7));
+}
+
+void sha3_sw_init(sha3_sw_ctx* ctx, unsigned int rate, unsigned char suffix)
+{
+	memset(ctx->s, 0, sizeof(ctx->s));
+	ctx->rate = rate;
+	ctx->pos = 0;
+	ctx->suffix = suffix;
+}
+
+void sha3_sw_absorb(sha3_sw_ctx* ctx, const unsigned char* in, unsigned long long length)
+{
+	uint64_t w;
+
+	// -- unaligned head
+	while (length && (ctx->pos & 7)) {
+		sha3_sw_xor_byte(ctx->s, ctx->pos++, *in++);
+		length--;
+		if (ctx->pos == ctx->rate) { keccak_f1600_sw(ctx->s); ctx->pos = 0; }
+	}
+
+	// -- full lanes
+	while (length >= 8) {
+		memcpy(&w, in, 8);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		w = __builtin_bswap64(w);
+#endif
+		ctx->s[ctx->pos >> 3] ^= w;
+		ctx->pos += 8; in += 8; length -= 8;
+		if (ctx->pos == ctx->rate) { keccak_f1600_sw(ctx->s); ctx->pos = 0; }
+	}
+
+	// -- tail
+	while (length) {
+		sha3_sw_xor_byte(ctx->s, ctx->pos++, *in++);
+		length--;
+		if (ctx->pos == ctx->rate) { keccak_f1600_sw(ctx->s); ctx->pos = 0; }
+	}
+}
+
+void sha3_sw_finalize(sha3_sw_ctx* ctx)
+{
+	sha3_sw_xor_byte(ctx->s, ctx->pos, ctx->suffix);
+	sha3_sw_xor_byte(ctx->s, ctx->rate - 1, 0x80);
+	keccak_f1600_sw(ctx->s);
+	ctx->pos = 0;
+}
+
+void sha3_sw_squeeze(sha3_sw_ctx* ctx, unsigned char* out, unsigned long long length_out)
+{
+	while (length_out--) {
+		if (ctx->pos == ctx->rate) { keccak_f1600_sw(ctx->s); ctx->pos = 0; }
+		*out++ = (unsigned char)(ctx->s[ctx->pos >> 3] >> (8 * (ctx->pos & 7)));
+		ctx->pos++;
+	}
+}
+
+static void sha3_sw(const unsigned char* in, unsigned long long length, unsigned char* out, unsigned long long length_out, unsigned int rate, unsigned char suffix)
+{
+	sha3_sw_ctx ctx;
+
+	sha3_sw_init(&ctx, rate, suffix);
+	sha3_sw_absorb(&ctx, in, length);
+	sha3_sw_finalize(&ctx);
+	sha3_sw_squeeze(&ctx, out, length_out);
+}
+
+void sha3_256_sw(const unsigned char* in, unsigned long long length, unsigned char* out)
+{
+	sha3_sw(in, length, out, 32, SHA3_SW_RATE_256, 0x06);
+}
+
+void sha3_512_sw(const unsigned char* in, unsigned long long length, unsigned char* out)
+{
+	sha3_sw(in, length, out, 64, SHA3_SW_RATE_512, 0x06);
+}
+
+void shake128_sw(const unsigned char* in, unsigned long long length, unsigned char* out, unsigned long long length_out)
+{
+	sha3_sw(in, length, out, length_out, SHA3_SW_RATE_128, 0x1F);
+}
+
+void shake256_sw(const unsigned char* in, unsigned long long length, unsigned char* out, unsigned long long length_out)
+{
+	sha3_sw(in, length, out, length_out, SHA3_SW_RATE_256, 0x1F);
+}
@@ -0,0 +1,98 @@
+/**
+  * @file sha3_sw.h
+  * @brief Host Software Keccak / SHA3 / SHAKE Header
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef SHA3_SW_H
+#define SHA3_SW_H
+
+#include <stdint.h>
+#include <string.h>
+
+/************************ Host Keccak Constant Definitions **********************/
+
+#define SHA3_SW_RATE_128		168		// SHAKE-128 rate in bytes
+#define SHA3_SW_RATE_256		136		// SHA3-256 / SHAKE-256 rate in bytes
+#define SHA3_SW_RATE_512		72		// SHA3-512 rate in bytes
+
+	//-- Incremental sponge. Used by the host paths (overflow capacity of the
+	//-- hash scheduler, Merkle interior nodes) where a bus round-trip to the
+	//-- core would cost more than the permutation itself.
+	typedef struct {
+		uint64_t s[25];
+		unsigned int rate;
+		unsigned int pos;
+		unsigned char suffix;
+	} sha3_sw_ctx;
+
+	void keccak_f1600_sw(uint64_t s[25]);
+	void keccak_f1600_x4_sw(uint64_t s[25][4]);
+
+	void sha3_sw_init(sha3_sw_ctx* ctx, unsigned int rate, unsigned char suffix);
+	void sha3_sw_absorb(sha3_sw_ctx* ctx, const unsigned char* in, unsigned long long length);
+	void sha3_sw_finalize(sha3_sw_ctx* ctx);
+	void sha3_sw_squeeze(sha3_sw_ctx* ctx, unsigned char* out, unsigned long long length_out);
+
+	/************************ Main Functions **********************/
+
+	void sha3_256_sw(const unsigned char* in, unsigned long long length, unsigned char* out);
+	void sha3_512_sw(const unsigned char* in, unsigned long long length, unsigned char* out);
+	void shake128_sw(const unsigned char* in, unsigned long long length, unsigned char* out, unsigned long long length_out);
+	void shake256_sw(const unsigned char* in, unsigned long long length, unsigned char* out, unsigned long long length_out);
+
+#endif
@@ -0,0 +1,542 @@
+/**
+  * @file sp800_185_hw.c
+  * @brief SP 800-185 (cSHAKE, KMAC, ParallelHash) HW File
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#include "sp800_185_hw.h"
+
+static unsigned char sp800_185_zeros[SP800_185_RATE_128];
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// MAIN FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+int cshake128_hw_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* name, unsigned int name_len, unsigned char* custom, unsigned int custom_len, INTF interface)
+{
+	return cshake_hw(in, length, out, length_out, name, name_len, custom, custom_len, 3, interface);
+}
+
+int cshake256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* name, unsigned int name_len, unsigned char* custom, unsigned int custom_len, INTF interface)
+{
+	return cshake_hw(in, length, out, length_out, name, name_len, custom, custom_len, 4, interface);
+}
+
+int kmac128_hw_func(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface)
+{
+	return kmac_hw(key, key_len, in, length, out, length_out, custom, custom_len, 0, 3, interface);
+}
+
+int kmac256_hw_func(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface)
+{
+	return kmac_hw(key, key_len, in, length, out, length_out, custom, custom_len, 0, 4, interface);
+}
+
+int kmacxof128_hw_func(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface)
+{
+	return kmac_hw(key, key_len, in, length, out, length_out, custom, custom_len, 1, 3, interface);
+}
+
+int kmacxof256_hw_func(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface)
+{
+	return kmac_hw(key, key_len, in, length, out, length_out, custom, custom_len, 1, 4, interface);
+}
+
+int parallelhash128_hw_func(unsigned char* in, unsigned int length, unsigned int block_size, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface)
+{
+	return parallelhash_hw(in, length, block_size, out, length_out, custom, custom_len, 0, 3, &interface, 1);
+}
+
+int parallelhash256_hw_func(unsigned char* in, unsigned int length, unsigned int block_size, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface)
+{
+	return parallelhash_hw(in, length, block_size, out, length_out, custom, custom_len, 0, 4, &interface, 1);
+}
+
+int parallelhash128_multi_hw_func(unsigned char* in, unsigned int length, unsigned int block_size, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF* interface, unsigned int n_interface)
+{
+	return parallelhash_hw(in, length, block_size, out, length_out, custom, custom_len, 0, 3, interface, n_interface);
+}
+
+int parallelhash256_multi_hw_func(unsigned char* in, unsigned int length, unsigned int block_size, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF* interface, unsigned int n_interface)
+{
+	return parallelhash_hw(in, length, block_size, out, length_out, custom, custom_len, 0, 4, interface, n_interface);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// ENCODING FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+void sp800_185_init(sp800_185_msg* msg)
+{
+	msg->n_seg = 0;
+	msg->total = 0;
+	msg->pad_start = 0;
+	msg->err = 0;
+}
+
+//-- A segment that does not fit marks the message, which sp800_185_hw / _sw then refuse
+int sp800_185_add_bytes(sp800_185_msg* msg, unsigned char* data, unsigned long long len)
+{
+	if (len == 0) return 0;
+	if (msg->n_seg == SP800_185_MAX_SEG) {
+		msg->err = 1;
+		return SE_ERR_ARG;
+	}
+
+	msg->ptr[msg->n_seg] = data;
+	msg->len[msg->n_seg] = len;
+	msg->n_seg++;
+	msg->total += len;
+
+	return SE_OK;
+}
+
+static int sp800_185_encode(sp800_185_msg* msg, unsigned long long x, int right)
+{
+	unsigned char* enc;
+	unsigned int n = 1;
+
+	if (msg->n_seg == SP800_185_MAX_SEG) {
+		msg->err = 1;
+		return SE_ERR_ARG;
+	}
+	enc = msg->enc[msg->n_seg];
+
+	// -- n is the smallest number of bytes (at least one) that represents x
+	while (n < 8 && (x >> (8 * n)) != 0) n++;
+
+	if (right) {
+		for (unsigned int i = 0; i < n; i++) enc[i] = (unsigned char)(x >> (8 * (n - 1 - i)));
+		enc[n] = (unsigned char)n;
+	}
+	else {
+		enc[0] = (unsigned char)n;
+		for (unsigned int i = 0; i < n; i++) enc[i + 1] = (unsigned char)(x >> (8 * (n - 1 - i)));
+	}
+
+	return sp800_185_add_bytes(msg, enc, n + 1);
+}
+
+int sp800_185_left_encode(sp800_185_msg* msg, unsigned long long x)
+{
+	return sp800_185_encode(msg, x, 0);
+}
+
+int sp800_185_right_encode(sp800_185_msg* msg, unsigned long long x)
+{
+	return sp800_185_encode(msg, x, 1);
+}
+
+int sp800_185_encode_string(sp800_185_msg* msg, unsigned char* str, unsigned long long len)
+{
+	if (sp800_185_left_encode(msg, len * 8) != SE_OK) return SE_ERR_ARG;
+
+	return sp800_185_add_bytes(msg, str, len);
+}
+
+int sp800_185_bytepad_start(sp800_185_msg* msg, unsigned int w)
+{
+	msg->pad_start = msg->total;
+
+	return sp800_185_left_encode(msg, w);
+}
+
+int sp800_185_bytepad_end(sp800_185_msg* msg, unsigned int w)
+{
+	unsigned long long used = (msg->total - msg->pad_start) % w;
+
+	return (used) ? sp800_185_add_bytes(msg, sp800_185_zeros, w - used) : SE_OK;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// KECCAK FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- Copy the next rate bytes of the framed message into block, zero-filling past the end
+static void sp800_185_fill(sp800_185_msg* msg, unsigned int* seg, unsigned long long* off, unsigned char* block, unsigned int rate)
+{
+	unsigned int pos = 0;
+	unsigned long long n;
+
+	while (pos < rate && *seg < msg->n_seg) {
+		n = msg->len[*seg] - *off;
+		if (n > rate - pos) n = rate - pos;
+		memcpy(block + pos, msg->ptr[*seg] + *off, n);
+		pos += n;
+		*off += n;
+		if (*off == msg->len[*seg]) {
+			(*seg)++;
+			*off = 0;
+		}
+	}
+
+	if (pos < rate) memset(block + pos, 0, rate - pos);
+}
+
+static int sp800_185_hw_run(sp800_185_msg* msg, unsigned char* out, unsigned int length_out, int cshake, int VERSION, INTF interface, int DBG)
+{
+	unsigned int rate = (VERSION == 3) ? SP800_185_RATE_128 : SP800_185_RATE_256;
+	unsigned int size_sha3 = (VERSION == 3) ? 128 : 256;
+
+	unsigned long long int buffer_in[SP800_185_RATE_128 / 8];
+	unsigned long long int buffer_out[SP800_185_RATE_128 / 8];
+	unsigned char block[SP800_185_RATE_128];
+
+	unsigned long long hb_num = (msg->total / rate) + 1;
+	unsigned int pos_pad = msg->total % rate;
+	unsigned int seg = 0;
+	unsigned long long off = 0;
+	unsigned int copy;
+	unsigned int ind = 0;
+	int ret = SE_OK;
+
+	if (DBG == 1) {
+		printf("\n hb_num = %lld \n", hb_num);
+		printf("\n length = %lld \n", msg->total);
+		printf("\n pos_pad = %d \n", pos_pad);
+	}
+
+	intf_core_lock(interface, SE_CORE_SHA3);
+
+	// ------- SHA3 Initialization --------//
+
+	sha3_shake_interface_init(interface, VERSION);
+
+	// ------- Absorb -------------------- //
+
+	for (unsigned long long hb = 1; hb <= hb_num; hb++) {
+
+		sp800_185_fill(msg, &seg, &off, block, rate);
+
+		if (hb == hb_num && cshake) {
+			// The core adds the SHAKE suffix 0x1F on top of the padding byte, but cSHAKE
+			// uses 0x04. Loading 0x04 - 0x1F in that byte and 0xFF in the bytes above it
+			// makes the carry of the core's addition overflow out of the 64-bit word,
+			// leaving 0x04 followed by zeros.
+			block[pos_pad] = (unsigned char)(0x04 - 0x1F);
+			for (unsigned int j = pos_pad + 1; (j % 8) != 0; j++) block[j] = 0xFF;
+		}
+
+		memcpy(buffer_in, block, rate);
+
+		ret = sha3_shake_interface(buffer_in, buffer_out, interface, pos_pad, (hb == hb_num), 2, VERSION, size_sha3, rate * 8, DBG);
+		if (ret != SE_OK) break;
+	}
+
+	// ------- Squeeze ------------------- //
+
+	while (ret == SE_OK) {
+		copy = (length_out - ind > rate) ? rate : length_out - ind;
+		memcpy(out + ind, buffer_out, copy);
+		ind += copy;
+
+		if (ind == length_out) break;
+
+		ret = sha3_shake_interface(buffer_in, buffer_out, interface, pos_pad, 1, 1, VERSION, size_sha3, rate * 8, DBG);
+	}
+
+	intf_core_unlock(interface, SE_CORE_SHA3);
+
+	return ret;
+}
+
+//-- The framed message is only read, so a run the core hung on is repeated
+//-- from the start. On failure out is wiped and the error returned.
+int sp800_185_hw(sp800_185_msg* msg, unsigned char* out, unsigned int length_out, int cshake, int VERSION, INTF interface, int DBG)
+{
+	unsigned int rate = (VERSION == 3) ? SP800_185_RATE_128 : SP800_185_RATE_256;
+	int ret = SE_OK;
+
+	if (msg->err) {
+		memset(out, 0, length_out);
+		return SE_ERR_ARG;
+	}
+
+	// -- one unit per absorbed or squeezed block
+	if (intf_core_admit(interface, SE_CORE_SHA3, msg->total / rate + 1 + length_out / rate) != SE_OK) {
+		memset(out, 0, length_out);
+		return SE_ERR_DEADLINE;
+	}
+
+	for (int t = 0; t <= SE_RETRY; t++) {
+		ret = sp800_185_hw_run(msg, out, length_out, cshake, VERSION, interface, DBG);
+		if (!intf_core_retry(interface, SE_CORE_SHA3, ret)) break;
+	}
+
+	if (ret != SE_OK) memset(out, 0, length_out);
+
+	return ret;
+}
+
+//-- Absorb the framed message into the host sponge (dispatcher software path)
+int sp800_185_sw(sp800_185_msg* msg, unsigned char* out, unsigned int length_out, int cshake, int VERSION)
+{
+	unsigned int rate = (VERSION == 3) ? SP800_185_RATE_128 : SP800_185_RATE_256;
+	sha3_sw_ctx ctx;
+
+	if (msg->err) {
+		memset(out, 0, length_out);
+		return SE_ERR_ARG;
+	}
+
+	sha3_sw_init(&ctx, rate, (cshake) ? 0x04 : 0x1F);
+	for (unsigned int i = 0; i < msg->n_seg; i++) sha3_sw_absorb(&ctx, msg->ptr[i], msg->len[i]);
+	sha3_sw_finalize(&ctx);
+	sha3_sw_squeeze(&ctx, out, length_out);
+
+	return SE_OK;
+}
+
+//-- Returns 1 if the message needs the cSHAKE padding, 0 if it reduces to plain SHAKE
+static int cshake_frame(sp800_185_msg* msg, unsigned char* in, unsigned int length, unsigned char* name, unsigned int name_len,
+	unsigned char* custom, unsigned int custom_len, int VERSION)
+{
+	unsigned int rate = (VERSION == 3) ? SP800_185_RATE_128 : SP800_185_RATE_256;
+
+	sp800_185_init(msg);
+
+	// -- cSHAKE with empty N and S is plain SHAKE
+	if (name_len == 0 && custom_len == 0) {
+		sp800_185_add_bytes(msg, in, length);
+		return 0;
+	}
+
+	sp800_185_bytepad_start(msg, rate);
+	sp800_185_encode_string(msg, name, name_len);
+	sp800_185_encode_string(msg, custom, custom_len);
+	sp800_185_bytepad_end(msg, rate);
+	sp800_185_add_bytes(msg, in, length);
+
+	return 1;
+}
+
+static void kmac_frame(sp800_185_msg* msg, unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned int length_out,
+	unsigned char* custom, unsigned int custom_len, int xof, int VERSION)
+{
+	unsigned int rate = (VERSION == 3) ? SP800_185_RATE_128 : SP800_185_RATE_256;
+
+	sp800_185_init(msg);
+
+	sp800_185_bytepad_start(msg, rate);
+	sp800_185_encode_string(msg, (unsigned char*)"KMAC", 4);
+	sp800_185_encode_string(msg, custom, custom_len);
+	sp800_185_bytepad_end(msg, rate);
+
+	sp800_185_bytepad_start(msg, rate);
+	sp800_185_encode_string(msg, key, key_len);
+	sp800_185_bytepad_end(msg, rate);
+
+	sp800_185_add_bytes(msg, in, length);
+	sp800_185_right_encode(msg, (xof) ? 0 : (unsigned long long)length_out * 8);
+}
+
+int cshake_hw(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* name, unsigned int name_len,
+	unsigned char* custom, unsigned int custom_len, int VERSION, INTF interface)
+{
+	sp800_185_msg msg;
+	int cshake = cshake_frame(&msg, in, length, name, name_len, custom, custom_len, VERSION);
+
+	return sp800_185_hw(&msg, out, length_out, cshake, VERSION, interface, 0);
+}
+
+int cshake_sw(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* name, unsigned int name_len,
+	unsigned char* custom, unsigned int custom_len, int VERSION)
+{
+	sp800_185_msg msg;
+	int cshake = cshake_frame(&msg, in, length, name, name_len, custom, custom_len, VERSION);
+
+	return sp800_185_sw(&msg, out, length_out, cshake, VERSION);
+}
+
+int kmac_hw(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out,
+	unsigned char* custom, unsigned int custom_len, int xof, int VERSION, INTF interface)
+{
+	sp800_185_msg msg;
+
+	kmac_frame(&msg, key, key_len, in, length, length_out, custom, custom_len, xof, VERSION);
+	return sp800_185_hw(&msg, out, length_out, 1, VERSION, interface, 0);
+}
+
+int kmac_sw(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out,
+	unsigned char* custom, unsigned int custom_len, int xof, int VERSION)
+{
+	sp800_185_msg msg;
+
+	kmac_frame(&msg, key, key_len, in, length, length_out, custom, custom_len, xof, VERSION);
+	return sp800_185_sw(&msg, out, length_out, 1, VERSION);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// PARALLELHASH
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	unsigned char* in;
+	unsigned int length;
+	unsigned int block_size;
+	unsigned char* leaves;
+	unsigned int leaf_len;
+	unsigned int first;
+	unsigned int step;
+	unsigned int n_leaves;
+	int VERSION;
+	INTF interface;
+	int ret;								// First failed leaf's status
+} parallelhash_job;
+
+//-- Leaf i is cSHAKE(X[i], 2*security, "", ""), i.e. plain SHAKE on the same core
+static void* parallelhash_leaves(void* arg)
+{
+	parallelhash_job* job = (parallelhash_job*)arg;
+	unsigned char* in;
+	unsigned char* leaf;
+	unsigned int len;
+
+	for (unsigned int i = job->first; i < job->n_leaves && job->ret == SE_OK; i += job->step) {
+		in = job->in + (unsigned long long)i * job->block_size;
+		leaf = job->leaves + (unsigned long long)i * job->leaf_len;
+		len = (i == job->n_leaves - 1) ? job->length - i * job->block_size : job->block_size;
+		if (job->VERSION == 3)	job->ret = shake128_hw_func(in, len, leaf, job->leaf_len, job->interface);
+		else					job->ret = shake256_hw_func(in, len, leaf, job->leaf_len, job->interface);
+	}
+
+	return NULL;
+}
+
+//-- SE_OK, or the first error of a leaf or of the final cSHAKE (out wiped)
+int parallelhash_hw(unsigned char* in, unsigned int length, unsigned int block_size, unsigned char* out, unsigned int length_out,
+	unsigned char* custom, unsigned int custom_len, int xof, int VERSION, INTF* interface, unsigned int n_interface)
+{
+	unsigned int rate = (VERSION == 3) ? SP800_185_RATE_128 : SP800_185_RATE_256;
+	unsigned int leaf_len = (VERSION == 3) ? 32 : 64;
+	unsigned int n_leaves;
+	unsigned char* leaves;
+	parallelhash_job* job;
+	pthread_t* thread;
+	int* started;
+	sp800_185_msg msg;
+	int ret = SE_OK;
+
+	if (block_size == 0) {
+		printf("\nPARALLELHASH FAIL!: block size must be > 0\n");
+		memset(out, 0, length_out);
+		return SE_ERR_ARG;
+	}
+	n_leaves = (unsigned int)(((unsigned long long)length + block_size - 1) / block_size);
+
+	if (n_interface == 0) n_interface = 1;
+	if (n_interface > n_leaves && n_leaves > 0) n_interface = n_leaves;
+
+	leaves = malloc((n_leaves) ? (size_t)n_leaves * leaf_len : 1);
+	job = malloc(n_interface * sizeof(parallelhash_job));
+	thread = malloc(n_interface * sizeof(pthread_t));
+	started = calloc(n_interface, sizeof(int));
+	if (leaves == NULL || job == NULL || thread == NULL || started == NULL) {
+		ret = SE_ERR_ARG;
+		goto end;
+	}
+
+	// ------- Leaf hashes, interleaved over the devices --------- //
+
+	for (unsigned int d = 0; d < n_interface; d++) {
+		job[d].in			= in;
+		job[d].length		= length;
+		job[d].block_size	= block_size;
+		job[d].leaves		= leaves;
+		job[d].leaf_len		= leaf_len;
+		job[d].first		= d;
+		job[d].step			= n_interface;
+		job[d].n_leaves		= n_leaves;
+		job[d].VERSION		= VERSION;
+		job[d].interface	= interface[d];
+		job[d].ret			= SE_OK;
+	}
+
+	// -- a device whose thread cannot be started is run from this one
+	for (unsigned int d = 1; d < n_interface; d++) started[d] = (pthread_create(&thread[d], NULL, parallelhash_leaves, &job[d]) == 0);
+	for (unsigned int d = 0; d < n_interface; d++) if (!started[d]) parallelhash_leaves(&job[d]);
+	for (unsigned int d = 1; d < n_interface; d++) if (started[d]) pthread_join(thread[d], NULL);
+
+	for (unsigned int d = 0; d < n_interface && ret == SE_OK; d++) ret = job[d].ret;
+	if (ret != SE_OK) goto end;
+
+	// ------- Final cSHAKE over the leaf hashes ----------------- //
+
+	sp800_185_init(&msg);
+
+	sp800_185_bytepad_start(&msg, rate);
+	sp800_185_encode_string(&msg, (unsigned char*)"ParallelHash", 12);
+	sp800_185_encode_string(&msg, custom, custom_len);
+	sp800_185_bytepad_end(&msg, rate);
+
+	sp800_185_left_encode(&msg, block_size);
+	sp800_185_add_bytes(&msg, leaves, (unsigned long long)n_leaves * leaf_len);
+	sp800_185_right_encode(&msg, n_leaves);
+	sp800_185_right_encode(&msg, (xof) ? 0 : (unsigned long long)length_out * 8);
+
+	ret = sp800_185_hw(&msg, out, length_out, 1, VERSION, interface[0], 0);
+
+end:
+	if (ret != SE_OK) memset(out, 0, length_out);
+	if (leaves != NULL) memset(leaves, 0, (n_leaves) ? (size_t)n_leaves * leaf_len : 1);
+	free(leaves);
+	free(job);
+	free(thread);
+	free(started);
+
+	return ret;
+}
@@ -0,0 +1,133 @@
+/**
+  * @file sp800_185_hw.h
+  * @brief SP 800-185 (cSHAKE, KMAC, ParallelHash) HW header
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef SP800_185_H
+#define SP800_185_H
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "../common/intf.h"
+#include "../common/conf.h"
+#include "../common/extra_func.h"
+#include "sha3_shake_hw.h"
+#include "sha3_sw.h"
+
+/************************ SP 800-185 Constant Definitions **********************/
+
+#define SP800_185_MAX_SEG		16		// Max. number of segments of a framed message
+#define SP800_185_RATE_128		168		// Keccak[256] rate in bytes
+#define SP800_185_RATE_256		136		// Keccak[512] rate in bytes
+
+	//-- Framed message: the encodings of SP 800-185 are kept as a list of segments so
+	//-- the caller data is streamed to the core without being copied into a new buffer.
+	typedef struct {
+		unsigned char* ptr[SP800_185_MAX_SEG];
+		unsigned long long len[SP800_185_MAX_SEG];
+		unsigned char enc[SP800_185_MAX_SEG][9];
+		unsigned int n_seg;
+		unsigned long long total;
+		unsigned long long pad_start;
+		int err;							// A segment did not fit: the message is refused
+	} sp800_185_msg;
+
+	/************************ Encoding Functions **********************/
+
+	void sp800_185_init(sp800_185_msg* msg);
+	//-- Each returns SE_OK, or SE_ERR_ARG once the message has no segment left
+	int sp800_185_add_bytes(sp800_185_msg* msg, unsigned char* data, unsigned long long len);
+	int sp800_185_left_encode(sp800_185_msg* msg, unsigned long long x);
+	int sp800_185_right_encode(sp800_185_msg* msg, unsigned long long x);
+	int sp800_185_encode_string(sp800_185_msg* msg, unsigned char* str, unsigned long long len);
+	int sp800_185_bytepad_start(sp800_185_msg* msg, unsigned int w);
+	int sp800_185_bytepad_end(sp800_185_msg* msg, unsigned int w);
+
+	/************************ Keccak Functions **********************/
+
+	int sp800_185_hw(sp800_185_msg* msg, unsigned char* out, unsigned int length_out, int cshake, int VERSION, INTF interface, int DBG);
+	int cshake_hw(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* name, unsigned int name_len,
+		unsigned char* custom, unsigned int custom_len, int VERSION, INTF interface);
+	int kmac_hw(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out,
+		unsigned char* custom, unsigned int custom_len, int xof, int VERSION, INTF interface);
+	int parallelhash_hw(unsigned char* in, unsigned int length, unsigned int block_size, unsigned char* out, unsigned int length_out,
+		unsigned char* custom, unsigned int custom_len, int xof, int VERSION, INTF* interface, unsigned int n_interface);
+
+	//-- Same framing absorbed by the host sponge (used by the HW/SW dispatcher)
+	int sp800_185_sw(sp800_185_msg* msg, unsigned char* out, unsigned int length_out, int cshake, int VERSION);
+	int cshake_sw(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* name, unsigned int name_len,
+		unsigned char* custom, unsigned int custom_len, int VERSION);
+	int kmac_sw(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out,
+		unsigned char* custom, unsigned int custom_len, int xof, int VERSION);
+
+	/************************ Main Functions **********************/
+
+	int cshake128_hw_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* name, unsigned int name_len, unsigned char* custom, unsigned int custom_len, INTF interface);
+	int cshake256_hw_func(unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* name, unsigned int name_len, unsigned char* custom, unsigned int custom_len, INTF interface);
+	int kmac128_hw_func(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface);
+	int kmac256_hw_func(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface);
+	int kmacxof128_hw_func(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface);
+	int kmacxof256_hw_func(unsigned char* key, unsigned int key_len, unsigned char* in, unsigned int length, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface);
+	int parallelhash128_hw_func(unsigned char* in, unsigned int length, unsigned int block_size, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface);
+	int parallelhash256_hw_func(unsigned char* in, unsigned int length, unsigned int block_size, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF interface);
+	int parallelhash128_multi_hw_func(unsigned char* in, unsigned int length, unsigned int block_size, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF* interface, unsigned int n_interface);
+	int parallelhash256_multi_hw_func(unsigned char* in, unsigned int length, unsigned int block_size, unsigned char* out, unsigned int length_out, unsigned char* custom, unsigned int custom_len, INTF* interface, unsigned int n_interface);
+
+#endif
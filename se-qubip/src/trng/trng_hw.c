@@ -60,6 +60,112 @@
 
 #include "trng_hw.h"
 
+/////////////////////////////////////////////////////////////////////////////////////////////
+// HEALTH TESTS (SP 800-90B 4.4)
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- Test state of a device (se_ctx.trng, allocated on its first use). It is only
+//-- touched under the TRNG core lock, so it is plain; only the counters read by
+//-- trng_health_stats are atomic.
+//-- Samples are the bits of each 64-bit word, LSB first.
+struct trng_ht_state {
+	trng_health_stat st;
+	unsigned long long words;			// Tested in the current call
+	unsigned int rct_val;
+	unsigned int rct_len;
+	unsigned int apt_ref;
+	unsigned int apt_cnt;
+	unsigned int apt_pos;
+};
+
+//-- Interfaces not opened with open_INTF / se_open share this one
+static struct trng_ht_state trng_ht_untracked;
+
+static struct trng_ht_state* trng_ht_of(INTF interface)
+{
+	se_ctx* c = se_ctx_of(interface);
+	struct trng_ht_state* ht;
+	struct trng_ht_state* none = NULL;
+
+	if (c == NULL) return &trng_ht_untracked;
+	if ((ht = __atomic_load_n(&c->trng, __ATOMIC_ACQUIRE)) != NULL) return ht;
+
+	// -- trng_health_stats may race the first TRNG call: the first one to publish wins
+	if ((ht = calloc(1, sizeof(struct trng_ht_state))) == NULL) return &trng_ht_untracked;
+	if (!__atomic_compare_exchange_n(&c->trng, &none, ht, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+		free(ht);
+		ht = none;
+	}
+
+	return ht;
+}
+
+#if TRNG_HT_RCT_CUTOFF <= 32 || TRNG_HT_RCT_CUTOFF > 64
+#error "trng_ht_runs covers cutoffs of 33 to 64 samples"
+#endif
+
+//-- Bit i set iff bits i .. i + TRNG_HT_RCT_CUTOFF - 1 of x are all set
+static inline uint64_t trng_ht_runs(uint64_t x)
+{
+	x &= x >> 1;
+	x &= x >> 2;
+	x &= x >> 4;
+	x &= x >> 8;
+	x &= x >> 16;
+
+	return x & (x >> (TRNG_HT_RCT_CUTOFF - 32));
+}
+
+static void trng_ht_fail(struct trng_ht_state* ht, unsigned long long* counter)
+{
+	__atomic_add_fetch(counter, 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&ht->st.failed, 1, __ATOMIC_RELAXED);
+}
+
+//-- Both tests over a word with popcount / count-zeros and masks, no per-bit loop
+static inline void trng_health_word(struct trng_ht_state* ht, const unsigned char* p)
+{
+	uint64_t w;
+	uint64_t same;
+	unsigned int pre, top;
+	int fail;
+
+	memcpy(&w, p, sizeof(w));
+	ht->words++;
+
+	// -- Repetition Count: the run carried from the previous word, then any run inside this one
+	same = ht->rct_val ? w : ~w;
+	pre = (~same == 0) ? 64 : (unsigned int)__builtin_ctzll(~same);
+	ht->rct_len += pre;
+	fail = (ht->rct_len >= TRNG_HT_RCT_CUTOFF);
+	if (pre < 64) {
+		fail |= ((trng_ht_runs(w) | trng_ht_runs(~w)) != 0);
+		top = (unsigned int)(w >> 63);
+		same = top ? ~w : w;
+		ht->rct_val = top;
+		ht->rct_len = (same == 0) ? 64 : (unsigned int)__builtin_clzll(same);
+	}
+	if (fail) {
+		// -- one failure per word; the count restarts
+		trng_ht_fail(ht, &ht->st.rct_fail);
+		ht->rct_len = 0;
+	}
+
+	// -- Adaptive Proportion: the first sample of a window is the reference
+	if (ht->apt_pos == 0) {
+		ht->apt_ref = (unsigned int)(w & 1);
+		ht->apt_cnt = 0;
+	}
+	ht->apt_cnt += ht->apt_ref ? (unsigned int)__builtin_popcountll(w) : 64 - (unsigned int)__builtin_popcountll(w);
+	ht->apt_pos += 64;
+	if (ht->apt_pos == TRNG_HT_APT_WINDOW) {
+		if (ht->apt_cnt >= TRNG_HT_APT_CUTOFF) trng_ht_fail(ht, &ht->st.apt_fail);
+		if (ht->apt_cnt > ht->st.apt_max) __atomic_store_n(&ht->st.apt_max, ht->apt_cnt, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&ht->st.windows, 1, __ATOMIC_RELAXED);
+		ht->apt_pos = 0;
+	}
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////
 // INTERFACE INIT/START & READ/WRITE
 /////////////////////////////////////////////////////////////////////////////////////////////
@@ -108,6 +214,8 @@ void trng_read(unsigned char* out, unsigned int bytes, INTF interface)
     unsigned long long in_data;
 	unsigned long long control;
 	unsigned long long addr;
+	unsigned char last[AXI_BYTES];
+	struct trng_ht_state* ht = trng_ht_of(interface);
 	
 	int loop = (bytes % AXI_BYTES == 0) ? (bytes / AXI_BYTES) : (bytes / AXI_BYTES + 1); 
 	
@@ -127,9 +235,17 @@ void trng_read(unsigned char* out, unsigned int bytes, INTF interface)
 		write_INTF(interface, &control, CONTROL, AXI_BYTES);
 		write_INTF(interface, &addr, ADDRESS, AXI_BYTES);
 		
-		read_INTF(interface, out + AXI_BYTES * i, DATA_OUT, AXI_BYTES);
-		
-		
+		//-- Straight into out; only a partial last word goes through last
+		if (AXI_BYTES * (i + 1) <= bytes) {
+			read_INTF(interface, out + AXI_BYTES * i, DATA_OUT, AXI_BYTES);
+			trng_health_word(ht, out + AXI_BYTES * i);
+		}
+		else {
+			read_INTF(interface, last, DATA_OUT, AXI_BYTES);
+			trng_health_word(ht, last);
+			memcpy(out + AXI_BYTES * i, last, bytes - AXI_BYTES * i);
+			memset(last, 0, AXI_BYTES);
+		}
     }
 }
 
@@ -137,80 +253,113 @@ void trng_read(unsigned char* out, unsigned int bytes, INTF interface)
 // TRNG FUNCTION
 /////////////////////////////////////////////////////////////////////////////////////////////
 
-void trng_hw(unsigned char* out, unsigned int bytes, INTF interface){
-	
-	unsigned int block_num = 0; 
-	unsigned int block_total = bytes / TRNG_MAX_BYTES;
-	unsigned int last_bytes = (bytes % TRNG_MAX_BYTES);
+static int trng_burst(unsigned char* out, unsigned int bytes, INTF interface)
+{
+	unsigned long long info = 0;
+	unsigned long long limit;
 
-	// printf("\n %d %d %d", bytes, block_total, last_bytes);
+	//-- Checked before each burst: a long request stops between bursts
+	if (intf_core_admit(interface, SE_CORE_TRNG, 1) != SE_OK) return TRNG_ERR_DEADLINE;
 
-	unsigned char out_trng[TRNG_MAX_BYTES]; 
+	trng_init(interface);
 
-	/*
-	if (bytes > TRNG_MAX_BYTES) {
-		 printf("\nTRNG FAIL: Max bytes = %d\n ", TRNG_MAX_BYTES);
-		 exit(1);
-	}
-	*/
-	if (block_total != 0) { // blocks of TRNG_MAX_BYTES
-		for (block_num = 0; block_num < block_total; block_num++) {
-			trng_init(interface);
+	trng_start(bytes, interface);
 
-			trng_start(TRNG_MAX_BYTES, interface);
+	//-- Detect when finish
+	limit = intf_wait_limit(interface, TRNG_WAIT_TIME);
+	do
+	{
+		read_INTF(interface, &info, END_OP, AXI_BYTES);
+	} while (!(info & 0x1) && intf_clock_ns() < limit);
 
-			//-- Detect when finish
-			unsigned long long info;
-			int count = 0;
+	if (!(info & 0x1)) {
+		trng_init(interface);
+		if (intf_core_fault(interface, SE_CORE_TRNG, SE_ERR_TIMEOUT) == SE_ERR_DEADLINE) return TRNG_ERR_DEADLINE;
+		printf("\nTRNG FAIL!: TIMEOUT \t%d us\n", TRNG_WAIT_TIME);
+		return TRNG_ERR_TIMEOUT;
+	}
 
-			while (count < TRNG_WAIT_TIME)
-			{
-				read_INTF(interface, &info, END_OP, AXI_BYTES);
+	trng_read(out, bytes, interface);
 
-				if (info & 0x1) break;
+	return TRNG_OK;
+}
 
-				count++;
-			}
-			if (count == TRNG_WAIT_TIME)
-				printf("\nTRNG FAIL!: TIMEOUT \t%d\n", count);
+//-- Blocks of TRNG_MAX_BYTES, the last one shorter. A burst the core hung on is
+//-- drawn again after its reset while the breaker stays closed.
+static int trng_run(unsigned char* out, unsigned int bytes, INTF interface)
+{
+	struct trng_ht_state* ht = trng_ht_of(interface);
+	unsigned long long words = __atomic_load_n(&ht->st.words, __ATOMIC_RELAXED);
+	int ret = TRNG_OK;
+
+	for (unsigned int done = 0; done < bytes && ret == TRNG_OK; done += TRNG_MAX_BYTES) {
+		unsigned int len = (bytes - done < TRNG_MAX_BYTES) ? (bytes - done) : TRNG_MAX_BYTES;
+		ret = trng_burst(out + done, len, interface);
+		for (int t = 0; t < SE_RETRY && ret == TRNG_ERR_TIMEOUT && intf_core_available(interface, SE_CORE_TRNG); t++)
+			ret = trng_burst(out + done, len, interface);
+	}
+	__atomic_store_n(&ht->st.words, words + ht->words, __ATOMIC_RELAXED);
+	ht->words = 0;
 
-			count = 0;
+	if (ret == TRNG_OK && __atomic_load_n(&ht->st.failed, __ATOMIC_RELAXED)) ret = TRNG_ERR_HEALTH;
+	if (ret != TRNG_OK) memset(out, 0, bytes);
 
-			trng_read(out_trng, TRNG_MAX_BYTES, interface);
+	return ret;
+}
 
-			memcpy(out + TRNG_MAX_BYTES * block_num, out_trng, TRNG_MAX_BYTES);
+int trng_health_startup(INTF interface)
+{
+	unsigned char buf[TRNG_HT_STARTUP / 8];
+	struct trng_ht_state* ht = trng_ht_of(interface);
+	int ret;
 
-		}
-	}
+	intf_core_lock(interface, SE_CORE_TRNG);
 
-	// last one or block less than TRNG_MAX_BYTES
-	if (last_bytes != 0) {
+	ht->rct_val = 0;
+	ht->rct_len = 0;
+	ht->apt_ref = 0;
+	ht->apt_cnt = 0;
+	ht->apt_pos = 0;
+	__atomic_store_n(&ht->st.failed, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&ht->st.started, 0, __ATOMIC_RELAXED);
 
-		trng_init(interface);
+	ret = trng_run(buf, sizeof(buf), interface);
+	memset(buf, 0, sizeof(buf));
+	if (ret == TRNG_OK) __atomic_store_n(&ht->st.started, 1, __ATOMIC_RELEASE);
 
-		trng_start(last_bytes, interface);
+	intf_core_unlock(interface, SE_CORE_TRNG);
 
-		//-- Detect when finish
-		unsigned long long info;
-		int count = 0;
+	return ret;
+}
 
-		while (count < TRNG_WAIT_TIME)
-		{
-			read_INTF(interface, &info, END_OP, AXI_BYTES);
+void trng_health_stats(INTF interface, trng_health_stat* st)
+{
+	struct trng_ht_state* ht = trng_ht_of(interface);
+
+	memset(st, 0, sizeof(trng_health_stat));
+	st->words = __atomic_load_n(&ht->st.words, __ATOMIC_RELAXED);
+	st->windows = __atomic_load_n(&ht->st.windows, __ATOMIC_RELAXED);
+	st->rct_fail = __atomic_load_n(&ht->st.rct_fail, __ATOMIC_RELAXED);
+	st->apt_fail = __atomic_load_n(&ht->st.apt_fail, __ATOMIC_RELAXED);
+	st->apt_max = __atomic_load_n(&ht->st.apt_max, __ATOMIC_RELAXED);
+	st->started = __atomic_load_n(&ht->st.started, __ATOMIC_ACQUIRE);
+	st->failed = __atomic_load_n(&ht->st.failed, __ATOMIC_RELAXED);
+}
 
-			if (info & 0x1) break;
+int trng_hw(unsigned char* out, unsigned int bytes, INTF interface)
+{
+	struct trng_ht_state* ht = trng_ht_of(interface);
+	int ret;
 
-			count++;
-		}
-		if (count == TRNG_WAIT_TIME)
-			printf("\nTRNG FAIL!: TIMEOUT \t%d\n", count);
+	intf_core_lock(interface, SE_CORE_TRNG);
 
-		count = 0;
+	if (!__atomic_load_n(&ht->st.started, __ATOMIC_ACQUIRE) && trng_health_startup(interface) != TRNG_OK) {
+		memset(out, 0, bytes);
+		ret = TRNG_ERR_HEALTH;
+	}
+	else ret = trng_run(out, bytes, interface);
 
-		trng_read(out_trng, last_bytes, interface);
+	intf_core_unlock(interface, SE_CORE_TRNG);
 
-		memcpy(out + TRNG_MAX_BYTES * block_num, out_trng, last_bytes);
-	
-	}
+	return ret;
 }
-
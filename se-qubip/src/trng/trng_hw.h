@@ -85,20 +85,50 @@
 #define TRNG_PUF_ADDW    		0x0
 #define TRNG_PUF_OUT   	 		0x1
 
-//-- Debug
+//-- Watchdog: longest wait for END_OP per burst (us)
 #ifdef I2C
-    #define TRNG_WAIT_TIME 5000
+    #define TRNG_WAIT_TIME 1000000
 #else
-    #define TRNG_WAIT_TIME 500000
+    #define TRNG_WAIT_TIME 100000
 #endif
 
+//-- Return Codes
+#define TRNG_OK                 0
+#define TRNG_ERR_TIMEOUT        -1
+#define TRNG_ERR_HEALTH         -2
+#define TRNG_ERR_DEADLINE       -3      // A burst would end past the caller's deadline (intf_set_deadline)
+
+//-- SP 800-90B Health Tests: binary samples, H = 0.8 bit/sample, alpha = 2^-40
+#define TRNG_HT_RCT_CUTOFF      51      // 1 + ceil(40 / H)
+#define TRNG_HT_APT_WINDOW      1024    // 16 words
+#define TRNG_HT_APT_CUTOFF      699     // 1 + CRITBINOM(1024, 2^-H, 1 - 2^-40)
+#define TRNG_HT_STARTUP         1024    // Samples tested before first use
+
+typedef struct {
+    unsigned long long words;           // 64-bit words tested
+    unsigned long long windows;         // Completed APT windows
+    unsigned long long rct_fail;        // Repetition Count Test failures
+    unsigned long long apt_fail;        // Adaptive Proportion Test failures
+    unsigned int apt_max;               // Highest APT count in a completed window
+    int started;                        // Start-up test passed
+    int failed;                         // Latched until trng_health_startup passes again
+} trng_health_stat;
+
 //-- INTERFACE INIT/START & READ/WRITE
 void trng_init(INTF interface);
 void trng_start(unsigned int bytes, INTF interface);
 void trng_read(unsigned char* out, unsigned int bytes, INTF interface);
 
-//-- TRNG Function
-void trng_hw(unsigned char* out, unsigned int bytes, INTF interface);
+//-- TRNG Function: TRNG_OK, TRNG_ERR_TIMEOUT, or TRNG_ERR_HEALTH (out is wiped).
+//-- Every word read is run through the continuous health tests; a failure latches
+//-- and later calls fail until a new start-up test passes. The start-up test runs
+//-- on the first call. Test state, latch and counters are kept per device.
+int trng_hw(unsigned char* out, unsigned int bytes, INTF interface);
+
+//-- Health Tests: resets the tests and the latch and tests TRNG_HT_STARTUP
+//-- fresh samples, which are discarded.
+int trng_health_startup(INTF interface);
+void trng_health_stats(INTF interface, trng_health_stat* st);
 
 
 #endif
\ No newline at end of file
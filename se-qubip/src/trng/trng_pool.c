@@ -0,0 +1,357 @@
+/**
+  * @file trng_pool.c
+  * @brief Background TRNG entropy pool
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#include "trng_pool.h"
+#include "trng_hw.h"
+#include "../pool/kpool.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+
+//-- Single producer (the filler), any number of consumers. head and tail count
+//-- bytes since init; the ring holds [tail, head). A consumer copies its bytes
+//-- first and then claims them with a CAS on tail, so a torn copy is always
+//-- discarded by a failed CAS. It then wipes what it claimed and, in claim
+//-- order, advances clean: the filler only overwrites bytes below clean, so a
+//-- byte is never handed out twice nor left in the ring once consumed.
+static unsigned char* tpool_ring = NULL;
+static unsigned int tpool_size = 0;
+static unsigned int tpool_low = 0;
+static unsigned long long tpool_head = 0;
+static unsigned long long tpool_tail = 0;
+static unsigned long long tpool_clean = 0;
+static trng_pool_stat tpool_st;
+
+static INTF tpool_interface;
+static int tpool_running = 0;
+static int tpool_users = 0;			// Consumers inside the ring: trng_pool_free waits for them
+static int tpool_forked = 0;		// Child of a fork: the filler is started again on demand
+static int tpool_stop = 0;
+static int tpool_wake = 0;
+static int tpool_failed = 0;
+static pthread_t tpool_thread;
+static pthread_mutex_t tpool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t tpool_cond = PTHREAD_COND_INITIALIZER;
+static pthread_once_t tpool_once = PTHREAD_ONCE_INIT;
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// OS GENERATOR
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static void trng_pool_os(unsigned char* out, unsigned int bytes)
+{
+	static int fd = -1;
+	ssize_t ret;
+
+	if (__atomic_load_n(&fd, __ATOMIC_ACQUIRE) < 0) {
+		int f = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+		int none = -1;
+		if (f < 0) {
+			printf("\n TRNG POOL FAIL!: no entropy source\n");
+			abort();
+		}
+		if (!__atomic_compare_exchange_n(&fd, &none, f, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) close(f);
+	}
+
+	while (bytes > 0) {
+		ret = read(fd, out, bytes);
+		if (ret < 0 && errno == EINTR) continue;
+		if (ret <= 0) {
+			printf("\n TRNG POOL FAIL!: entropy source read failed\n");
+			abort();
+		}
+		out += ret;
+		bytes -= (unsigned int)ret;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// FILLER
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+//-- Bursts land in the ring itself: head advances in whole bursts and the ring
+//-- is a multiple of TRNG_MAX_BYTES, so a burst never wraps.
+static int trng_pool_burst()
+{
+	unsigned long long h = tpool_head;
+	unsigned char* dst = tpool_ring + (h & (tpool_size - 1));
+	int ret;
+
+	// -- only idle core time: back off while a foreground call waits or runs
+	while (intf_core_trylock(tpool_interface, SE_CORE_TRNG) != 0) {
+		if (__atomic_load_n(&tpool_stop, __ATOMIC_ACQUIRE)) return 0;
+		usleep(KPOOL_BUSY_WAIT_US);
+	}
+	ret = trng_hw(dst, TRNG_MAX_BYTES, tpool_interface);
+	intf_core_unlock(tpool_interface, SE_CORE_TRNG);
+
+	if (ret != TRNG_OK) {
+		__atomic_add_fetch(&tpool_st.rejected, 1, __ATOMIC_RELAXED);
+		if (ret == TRNG_ERR_HEALTH) __atomic_store_n(&tpool_failed, 1, __ATOMIC_RELEASE);
+		return -1;
+	}
+
+	__atomic_store_n(&tpool_head, h + TRNG_MAX_BYTES, __ATOMIC_RELEASE);
+	__atomic_add_fetch(&tpool_st.bursts, 1, __ATOMIC_RELAXED);
+
+	return 0;
+}
+
+static void* trng_pool_filler(void* arg)
+{
+	(void)arg;
+
+	pthread_mutex_lock(&tpool_mutex);
+	while (!tpool_stop) {
+		unsigned long long level = tpool_head - __atomic_load_n(&tpool_tail, __ATOMIC_ACQUIRE);
+		if ((level >= tpool_low || __atomic_load_n(&tpool_failed, __ATOMIC_ACQUIRE)) && !__atomic_load_n(&tpool_wake, __ATOMIC_ACQUIRE)) {
+			pthread_cond_wait(&tpool_cond, &tpool_mutex);
+			continue;
+		}
+		__atomic_store_n(&tpool_wake, 0, __ATOMIC_RELEASE);
+		pthread_mutex_unlock(&tpool_mutex);
+
+		// -- top up to capacity once the low-water mark is crossed
+		while (!__atomic_load_n(&tpool_stop, __ATOMIC_ACQUIRE) && !__atomic_load_n(&tpool_failed, __ATOMIC_ACQUIRE) &&
+			tpool_size - (tpool_head - __atomic_load_n(&tpool_clean, __ATOMIC_ACQUIRE)) >= TRNG_MAX_BYTES)
+			if (trng_pool_burst() != 0) break;
+
+		pthread_mutex_lock(&tpool_mutex);
+	}
+	pthread_mutex_unlock(&tpool_mutex);
+
+	return NULL;
+}
+
+static void trng_pool_kick()
+{
+	// -- first kick in the child of a fork: the parent's filler did not come along
+	if (__atomic_exchange_n(&tpool_forked, 0, __ATOMIC_ACQ_REL)) {
+		if (pthread_create(&tpool_thread, NULL, trng_pool_filler, NULL) != 0) {
+			__atomic_store_n(&tpool_running, 0, __ATOMIC_SEQ_CST);
+			return;
+		}
+	}
+
+	if (__atomic_exchange_n(&tpool_wake, 1, __ATOMIC_ACQ_REL)) return;
+
+	pthread_mutex_lock(&tpool_mutex);
+	pthread_cond_signal(&tpool_cond);
+	pthread_mutex_unlock(&tpool_mutex);
+}
+
+//-- The child of a fork gets a copy of the ring: the parent hands the same bytes
+//-- out, so the child drops them and refills from the TRNG on its first request.
+static void trng_pool_atfork_child()
+{
+	if (tpool_ring != NULL) memset(tpool_ring, 0, tpool_size);
+	tpool_head = 0;
+	tpool_tail = 0;
+	tpool_clean = 0;
+	tpool_users = 0;
+	tpool_stop = 0;
+	tpool_wake = 1;
+	tpool_forked = tpool_running;
+	pthread_mutex_init(&tpool_mutex, NULL);
+	pthread_cond_init(&tpool_cond, NULL);
+}
+
+static void trng_pool_atfork()
+{
+	pthread_atfork(NULL, NULL, trng_pool_atfork_child);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// CONTROL FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+int trng_pool_init(INTF interface, unsigned int size, unsigned int low_water)
+{
+	unsigned int cap = 2 * TRNG_MAX_BYTES;
+
+	trng_pool_free();
+	pthread_once(&tpool_once, trng_pool_atfork);
+
+	int ret = trng_health_startup(interface);
+	if (ret != TRNG_OK) return ret;
+
+	while (cap < size) cap <<= 1;
+
+	tpool_ring = calloc(cap, 1);
+	if (tpool_ring == NULL) {
+		printf("\n TRNG POOL FAIL!: out of memory\n");
+		return -1;
+	}
+
+	memset(&tpool_st, 0, sizeof(trng_pool_stat));
+	tpool_size = cap;
+	tpool_low = (low_water < cap) ? low_water : cap - TRNG_MAX_BYTES;
+	tpool_head = 0;
+	tpool_tail = 0;
+	tpool_clean = 0;
+	tpool_interface = interface;
+	tpool_stop = 0;
+	tpool_failed = 0;
+	tpool_wake = 1;			// first fill
+
+	if (pthread_create(&tpool_thread, NULL, trng_pool_filler, NULL) != 0) {
+		trng_pool_free();
+		return -1;
+	}
+	__atomic_store_n(&tpool_running, 1, __ATOMIC_SEQ_CST);
+
+	return 0;
+}
+
+//-- New requests go to the OS generator as soon as running drops; the ring is
+//-- released once the consumers already inside have left.
+void trng_pool_free()
+{
+	if (__atomic_exchange_n(&tpool_running, 0, __ATOMIC_SEQ_CST)) {
+		while (__atomic_load_n(&tpool_users, __ATOMIC_SEQ_CST)) sched_yield();
+		if (!__atomic_exchange_n(&tpool_forked, 0, __ATOMIC_ACQ_REL)) {
+			pthread_mutex_lock(&tpool_mutex);
+			__atomic_store_n(&tpool_stop, 1, __ATOMIC_RELEASE);
+			pthread_cond_signal(&tpool_cond);
+			pthread_mutex_unlock(&tpool_mutex);
+			pthread_join(tpool_thread, NULL);
+		}
+	}
+
+	if (tpool_ring != NULL) memset(tpool_ring, 0, tpool_size);
+	free(tpool_ring);
+	tpool_ring = NULL;
+	tpool_size = 0;
+	tpool_head = 0;
+	tpool_tail = 0;
+	tpool_clean = 0;
+}
+
+void trng_pool_stats(trng_pool_stat* st)
+{
+	memset(st, 0, sizeof(trng_pool_stat));
+	st->hits = __atomic_load_n(&tpool_st.hits, __ATOMIC_RELAXED);
+	st->misses = __atomic_load_n(&tpool_st.misses, __ATOMIC_RELAXED);
+	st->bursts = __atomic_load_n(&tpool_st.bursts, __ATOMIC_RELAXED);
+	st->rejected = __atomic_load_n(&tpool_st.rejected, __ATOMIC_RELAXED);
+	st->bytes_out = __atomic_load_n(&tpool_st.bytes_out, __ATOMIC_RELAXED);
+	st->size = tpool_size;
+	st->level = (unsigned int)(__atomic_load_n(&tpool_head, __ATOMIC_ACQUIRE) - __atomic_load_n(&tpool_tail, __ATOMIC_ACQUIRE));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// MAIN FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+static int trng_pool_pop(unsigned char* out, unsigned int bytes)
+{
+	unsigned long long t, h, c;
+	unsigned int pos, first;
+
+	t = __atomic_load_n(&tpool_tail, __ATOMIC_ACQUIRE);
+	do {
+		h = __atomic_load_n(&tpool_head, __ATOMIC_ACQUIRE);
+		if (h - t < bytes) return -1;
+
+		pos = (unsigned int)(t & (tpool_size - 1));
+		first = (tpool_size - pos < bytes) ? (tpool_size - pos) : bytes;
+		memcpy(out, tpool_ring + pos, first);
+		memcpy(out + first, tpool_ring, bytes - first);
+	} while (!__atomic_compare_exchange_n(&tpool_tail, &t, t + bytes, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+	// -- [t, t + bytes) is ours: wipe it, then pass clean on once the earlier claims are wiped
+	memset(tpool_ring + pos, 0, first);
+	memset(tpool_ring, 0, bytes - first);
+	c = t;
+	while (!__atomic_compare_exchange_n(&tpool_clean, &c, t + bytes, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+		c = t;
+		sched_yield();
+	}
+
+	if (h - t - bytes < tpool_low) trng_pool_kick();
+
+	return 0;
+}
+
+void trng_pool_get(unsigned char* out, unsigned int bytes)
+{
+	int ret = -1;
+
+	if (bytes == 0) return;
+
+	__atomic_add_fetch(&tpool_users, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&tpool_running, __ATOMIC_SEQ_CST)) {
+		ret = trng_pool_pop(out, bytes);
+		if (ret != 0) {
+			__atomic_add_fetch(&tpool_st.misses, 1, __ATOMIC_RELAXED);
+			trng_pool_kick();
+		}
+		else {
+			__atomic_add_fetch(&tpool_st.hits, 1, __ATOMIC_RELAXED);
+			__atomic_add_fetch(&tpool_st.bytes_out, bytes, __ATOMIC_RELAXED);
+		}
+	}
+	__atomic_sub_fetch(&tpool_users, 1, __ATOMIC_SEQ_CST);
+
+	if (ret != 0) trng_pool_os(out, bytes);
+}
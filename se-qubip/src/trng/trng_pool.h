@@ -0,0 +1,109 @@
+/**
+  * @file trng_pool.h
+  * @brief Background TRNG entropy pool
+  *
+  * @section License
+  *
+  * Secure Element for QUBIP Project
+  *
+  * This Secure Element repository for QUBIP Project is subject to the
+  * BSD 3-Clause License below.
+  *
+  * Copyright (c) 2024,
+  *         Eros Camacho-Ruiz
+  *         Pablo Navarro-Torrero
+  *         Pau Ortega-Castro
+  *         Apurba Karmakar
+  *         Macarena C. Martínez-Rodríguez
+  *         Piedad Brox
+  *
+  * All rights reserved.
+  *
+  * This Secure Element was developed by Instituto de Microelectrónica de
+  * Sevilla - IMSE (CSIC/US) as part of the QUBIP Project, co-funded by the
+  * European Union under the Horizon Europe framework programme
+  * [grant agreement no. 101119746].
+  *
+  * -----------------------------------------------------------------------
+  *
+  * Redistribution and use in source and binary forms, with or without
+  * modification, are permitted provided that the following conditions are met:
+  *
+  * 1. Redistributions of source code must retain the above copyright notice, this
+  *    list of conditions and the following disclaimer.
+  *
+  * 2. Redistributions in binary form must reproduce the above copyright notice,
+  *    this list of conditions and the following disclaimer in the documentation
+  *    and/or other materials provided with the distribution.
+  *
+  * 3. Neither the name of the copyright holder nor the names of its
+  *    contributors may be used to endorse or promote products derived from
+  *    this software without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  *
+  *
+  *
+  * @author Eros Camacho-Ruiz (camacho@imse-cnm.csic.es)
+  * @version 1.0
+  **/
+
+#ifndef TRNG_POOL_H
+#define TRNG_POOL_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../common/intf.h"
+#include "../common/conf.h"
+
+/************************ Pool Constant Definitions **********************/
+
+#define TRNG_POOL_DEFAULT_SIZE		16384	// Ring size in bytes (rounded up to a power of two)
+#define TRNG_POOL_DEFAULT_LOW		4096	// Refill when fewer bytes are left
+
+	typedef struct {
+		unsigned int size;					// Ring capacity
+		unsigned int level;					// Bytes ready now
+		unsigned long long hits;			// Requests served from the ring
+		unsigned long long misses;			// Requests served by the OS generator
+		unsigned long long bursts;			// TRNG runs of TRNG_MAX_BYTES
+		unsigned long long rejected;		// Bursts dropped on a health-test failure
+		unsigned long long bytes_out;		// Bytes handed out from the ring
+	} trng_pool_stat;
+
+	/************************ Control Functions **********************/
+
+	//-- A background thread keeps a ring of size bytes filled from the TRNG of the
+	//-- given SE, in bursts of TRNG_MAX_BYTES, whenever fewer than low_water bytes
+	//-- are left. The filler takes the TRNG core with intf_core_trylock and steps
+	//-- aside while a foreground call waits for it. Bytes are handed out once.
+	//-- The TRNG start-up health test runs first: TRNG_ERR_HEALTH (pool not
+	//-- started) when it fails. A burst that fails the continuous tests never
+	//-- reaches the ring and stops the filler until the pool is initialised again.
+	//-- The child of a fork drops its copy of the ring and starts its own filler on
+	//-- its first request. trng_pool_free waits for the requests inside the ring.
+	int trng_pool_init(INTF interface, unsigned int size, unsigned int low_water);
+	void trng_pool_free();
+	void trng_pool_stats(trng_pool_stat* st);
+
+	/************************ Main Functions **********************/
+
+	//-- Lock-free: a memcpy from the ring, which is wiped behind it. When the pool
+	//-- is not running or holds fewer than bytes, the request is served by the OS
+	//-- generator (/dev/urandom) and the filler is woken; a failing OS generator
+	//-- aborts. Used for every key and coin the library draws.
+	void trng_pool_get(unsigned char* out, unsigned int bytes);
+
+#endif
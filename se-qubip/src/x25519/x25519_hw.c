@@ -73,6 +73,7 @@
 ////////////////////////////////////////////////////////////////////////////////////
 
 #include "x25519_hw.h"
+#include "../pool/kpool.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 // INTERFACE INIT/START & READ/WRITE
@@ -134,25 +135,37 @@ void x25519_read(unsigned long long address, unsigned long long size, void *data
 // GENERATE PUBLIC KEY
 /////////////////////////////////////////////////////////////////////////////////////////////
 
-void x25519_genkeys_hw(unsigned char **pri_key, unsigned char **pub_key, unsigned int *pri_len, unsigned int *pub_len, INTF interface)
+int x25519_genkeys_hw_buf(unsigned char *pri_key, unsigned char *pub_key, INTF interface)
 {
+    int ret;
 
-    *pri_len = X25519_BYTES;
-    *pub_len = X25519_BYTES;
-
-    *pri_key = (unsigned char*) malloc(*pri_len);
-    *pub_key = (unsigned char*) malloc(*pub_len);
+    //-- A pair made ahead of time by the key pool (kpool_init)
+    if (kpool_take(KPOOL_X25519, pri_key, pub_key) == 0) return SE_OK;
 
-    gen_priv_key(*pri_key, *pri_len);
+    ret = intf_core_admit(interface, SE_CORE_X25519, 1);
+    if (ret != SE_OK)
+    {
+        memset(pri_key, 0, X25519_BYTES);
+        memset(pub_key, 0, X25519_BYTES);
+        return ret;
+    }
 
-    /*
-    printf("Private = 0x");
-    for (int i = 0; i < X25519_BYTES; i++)
+    for (int t = 0; t <= SE_RETRY; t++)
     {
-        printf("%02x", *(*pri_key + i));
+        x25519_genkeys_hw_start(pri_key, interface);
+        ret = x25519_hw_finish(pub_key, interface);
+        if (!intf_core_retry(interface, SE_CORE_X25519, ret)) break;
     }
-    printf("\n");
-    */
+
+    if (ret != SE_OK) memset(pri_key, 0, X25519_BYTES);
+
+    return ret;
+}
+
+//-- Load and start only: the core computes while the caller drives another module (PARALLEL_CORES)
+void x25519_genkeys_hw_start(unsigned char *pri_key, INTF interface)
+{
+    gen_priv_key(pri_key, X25519_BYTES);
 
     //////////////////////////////////////////////////////////////
     // WRITING ON DEVICE
@@ -163,138 +176,150 @@ void x25519_genkeys_hw(unsigned char **pri_key, unsigned char **pub_key, unsigne
                                            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
                                            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09};
 
-    unsigned long long info;
+    //-- Held until x25519_hw_finish
+    intf_core_lock(interface, SE_CORE_X25519);
 
     //-- INITIALIZATION: General/Interface Reset & Select Operation
     x25519_init(interface);
 
     //-- Write Scalar and Input Point
-    x25519_write(X25519_SCALAR, X25519_BYTES / AXI_BYTES, *pri_key, X25519_RST_ON, interface);
+    x25519_write(X25519_SCALAR, X25519_BYTES / AXI_BYTES, pri_key, X25519_RST_ON, interface);
     x25519_write(X25519_POINT_IN, X25519_BYTES / AXI_BYTES, x25519_base_point, X25519_RST_ON, interface);
 
     //-- Start Execution
     x25519_start(interface);
 
-    //-- Detect when finish
-    int count = 0;
+    swapEndianness(pri_key, X25519_BYTES);
+}
+
+//-- Non-blocking: 1 once a started scalar multiplication has finished
+int x25519_hw_ready(INTF interface)
+{
+    unsigned long long info = 0;
 
-    while (count < X25519_WAIT_TIME)
+    //-- Reselect the core with the control word it was started with
+    x25519_start(interface);
+
+    read_INTF(interface, &info, END_OP, AXI_BYTES);
+
+    return (info & 0x1) != 0;
+}
+
+//-- Wait for a started scalar multiplication and read the resulting point.
+//-- SE_OK, or SE_ERR_TIMEOUT / SE_ERR_DEADLINE with the core reset and out wiped.
+int x25519_hw_finish(unsigned char *out, INTF interface)
+{
+    unsigned long long info = 0;
+    unsigned long long limit;
+    int ret;
+
+    //-- Reselect the core with the control word it was started with
+    x25519_start(interface);
+
+    //-- Detect when finish
+    limit = intf_wait_limit(interface, X25519_WAIT_TIME);
+    do
     {
         read_INTF(interface, &info, END_OP, AXI_BYTES);
+    } while (!(info & 0x1) && intf_clock_ns() < limit);
 
-        if (info & 0x1) break;
+    if (!(info & 0x1))
+    {
+        x25519_init(interface);
+        ret = intf_core_fault(interface, SE_CORE_X25519, SE_ERR_TIMEOUT);
+        intf_core_unlock(interface, SE_CORE_X25519);
 
-        count++;
-    }
+        if (ret == SE_ERR_TIMEOUT) printf("X25519 FAIL!: TIMEOUT \t%d us\n", X25519_WAIT_TIME);
 
-    if (count == X25519_WAIT_TIME) printf("X25519 FAIL!: TIMEOUT \t%d\n", count);
+        memset(out, 0, X25519_BYTES);
 
-    count = 0;
+        return ret;
+    }
 
     //////////////////////////////////////////////////////////////
     // RESULTS
     //////////////////////////////////////////////////////////////
 
-    x25519_read(X25519_POINT_OUT, X25519_BYTES / AXI_BYTES, *pub_key, interface);
+    x25519_read(X25519_POINT_OUT, X25519_BYTES / AXI_BYTES, out, interface);
 
-    /*
-    printf("point_out = 0x");
-    for (int i = 0; i < X25519_BYTES; i++)
-    {
-        printf("%02x", *(*pub_key + i));
-    }
-    printf("\n");
-    */
+    intf_core_unlock(interface, SE_CORE_X25519);
 
-    swapEndianness(*pub_key, *pub_len);
-    swapEndianness(*pri_key, *pri_len);
+    swapEndianness(out, X25519_BYTES);
+
+    return SE_OK;
+}
+
+int x25519_genkeys_hw(unsigned char **pri_key, unsigned char **pub_key, unsigned int *pri_len, unsigned int *pub_len, INTF interface)
+{
+    *pri_len = X25519_BYTES;
+    *pub_len = X25519_BYTES;
+
+    *pri_key = (unsigned char*) malloc(*pri_len);
+    *pub_key = (unsigned char*) malloc(*pub_len);
+
+    return x25519_genkeys_hw_buf(*pri_key, *pub_key, interface);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 // X25519
 /////////////////////////////////////////////////////////////////////////////////////////////
 
-void x25519_ss_gen_hw(unsigned char **shared_secret, unsigned int *shared_secret_len, unsigned char *pub_key, unsigned int pub_len, unsigned char *pri_key, unsigned int pri_len, INTF interface)
+int x25519_ss_gen_hw_buf(unsigned char *shared_secret, const unsigned char *pub_key, const unsigned char *pri_key, INTF interface)
 {
+    int ret = intf_core_admit(interface, SE_CORE_X25519, 1);
 
-    pub_len = X25519_BYTES;
-    pri_len = X25519_BYTES;
-    *shared_secret_len = X25519_BYTES;
-
-    *shared_secret = (unsigned char *) malloc(*shared_secret_len);
-
-    unsigned long long info;
-
-    /*
-    //-- Scalar
-    printf("pri_key = 0x");
-    for (int i = 0; i < X25519_BYTES; i++)
+    if (ret != SE_OK)
     {
-        printf("%02x", *pri_key + i);
+        memset(shared_secret, 0, X25519_BYTES);
+        return ret;
     }
-    printf("\n");
-    */
 
-    /*
-    //-- Point_in
-    printf("point_in = 0x");
-    for (int i = 0; i < X25519_BYTES; i++)
+    for (int t = 0; t <= SE_RETRY; t++)
     {
-        printf("%02x", *pub_key + i);
+        x25519_ss_gen_hw_start(pub_key, pri_key, interface);
+        ret = x25519_hw_finish(shared_secret, interface);
+        if (!intf_core_retry(interface, SE_CORE_X25519, ret)) break;
     }
-    printf("\n");
-    */
 
-    swapEndianness(pri_key, X25519_BYTES);
-    swapEndianness(pub_key, X25519_BYTES);
+    return ret;
+}
+
+//-- The caller's keys are left untouched: the device word order is built in local copies
+void x25519_ss_gen_hw_start(const unsigned char *pub_key, const unsigned char *pri_key, INTF interface)
+{
+    unsigned char pri_dev[X25519_BYTES];
+    unsigned char pub_dev[X25519_BYTES];
+
+    memcpy(pri_dev, pri_key, X25519_BYTES);
+    memcpy(pub_dev, pub_key, X25519_BYTES);
+    swapEndianness(pri_dev, X25519_BYTES);
+    swapEndianness(pub_dev, X25519_BYTES);
 
     //////////////////////////////////////////////////////////////
     // WRITING ON DEVICE
     //////////////////////////////////////////////////////////////
 
+    //-- Held until x25519_hw_finish
+    intf_core_lock(interface, SE_CORE_X25519);
+
     //-- INITIALIZATION: General/Interface Reset & Select Operation
     x25519_init(interface);
 
     //-- Write Scalar and Input Point
-    x25519_write(X25519_SCALAR, X25519_BYTES / AXI_BYTES, pri_key, X25519_RST_ON, interface);
-    x25519_write(X25519_POINT_IN, X25519_BYTES / AXI_BYTES, pub_key, X25519_RST_ON, interface);
+    x25519_write(X25519_SCALAR, X25519_BYTES / AXI_BYTES, pri_dev, X25519_RST_ON, interface);
+    x25519_write(X25519_POINT_IN, X25519_BYTES / AXI_BYTES, pub_dev, X25519_RST_ON, interface);
 
     //-- Start Execution
     x25519_start(interface);
 
-    //-- Detect when finish
-    int count = 0;
-
-    while (count < X25519_WAIT_TIME)
-    {
-        read_INTF(interface, &info, END_OP, AXI_BYTES);
-
-        if (info & 0x1) break;
-
-        count++;
-    }
-    
-    if (count == X25519_WAIT_TIME) printf("X25519 FAIL!: TIMEOUT \t%d\n", count);
+    memset(pri_dev, 0, X25519_BYTES);
+}
 
-    count = 0;
+int x25519_ss_gen_hw(unsigned char **shared_secret, unsigned int *shared_secret_len, unsigned char *pub_key, unsigned int pub_len, unsigned char *pri_key, unsigned int pri_len, INTF interface)
+{
+    *shared_secret_len = X25519_BYTES;
 
-    //////////////////////////////////////////////////////////////
-    // RESULTS
-    //////////////////////////////////////////////////////////////
+    *shared_secret = (unsigned char *) malloc(*shared_secret_len);
 
-    x25519_read(X25519_POINT_OUT, X25519_BYTES / AXI_BYTES, *shared_secret, interface);
-    
-    /*
-    printf("Point_out = 0x");
-    for (int i = 0; i < SHA_BYTES; i++)
-    {
-        printf("%02x", *(point_out + i));
-    }
-    printf("\n");
-    */
-    
-    swapEndianness(pri_key, X25519_BYTES);
-    swapEndianness(pub_key, X25519_BYTES);
-    swapEndianness(*shared_secret, X25519_BYTES);
+    return x25519_ss_gen_hw_buf(*shared_secret, pub_key, pri_key, interface);
 }
-
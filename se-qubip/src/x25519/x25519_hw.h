@@ -102,11 +102,11 @@
 #define X25519_POINT_IN    0x4
 #define X25519_POINT_OUT   0x0
 
-//-- Debug
+//-- Watchdog: longest wait for END_OP (us)
 #ifdef I2C
-    #define X25519_WAIT_TIME    50
+    #define X25519_WAIT_TIME    1000000
 #else
-    #define X25519_WAIT_TIME    5000
+    #define X25519_WAIT_TIME    100000
 #endif
 #define X25519_N_ITER       1000
 
@@ -117,9 +117,19 @@ void x25519_write(unsigned long long address, unsigned long long size, void *dat
 void x25519_read(unsigned long long address, unsigned long long size, void *data, INTF interface);
 
 //-- GENERATE PUBLIC KEY
-void x25519_genkeys_hw(unsigned char **pri_key, unsigned char **pub_key, unsigned int *pri_len, unsigned int *pub_len, INTF interface);
+//-- The blocking calls return SE_OK, or the error of the last run (SE_ERR_TIMEOUT,
+//-- SE_ERR_CORE, SE_ERR_DEADLINE) with every output wiped.
+int x25519_genkeys_hw(unsigned char **pri_key, unsigned char **pub_key, unsigned int *pri_len, unsigned int *pub_len, INTF interface);
+int x25519_genkeys_hw_buf(unsigned char *pri_key, unsigned char *pub_key, INTF interface);
+void x25519_genkeys_hw_start(unsigned char *pri_key, INTF interface);
 
 //-- ECDH X25519 OPERATION
-void x25519_ss_gen_hw(unsigned char **shared_secret, unsigned int *shared_secret_len, unsigned char *pub_key, unsigned int pub_len, unsigned char *pri_key, unsigned int pri_len, INTF interface);
+int x25519_ss_gen_hw(unsigned char **shared_secret, unsigned int *shared_secret_len, unsigned char *pub_key, unsigned int pub_len, unsigned char *pri_key, unsigned int pri_len, INTF interface);
+int x25519_ss_gen_hw_buf(unsigned char *shared_secret, const unsigned char *pub_key, const unsigned char *pri_key, INTF interface);
+void x25519_ss_gen_hw_start(const unsigned char *pub_key, const unsigned char *pri_key, INTF interface);
+
+//-- SPLIT OPERATION: wait for a started operation and read the point
+int x25519_hw_ready(INTF interface);
+int x25519_hw_finish(unsigned char *out, INTF interface);
 
 #endif
\ No newline at end of file